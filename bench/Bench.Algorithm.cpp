@@ -0,0 +1,159 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.Algorithm.cpp
+
+Abstract:
+    Benchmark sort and radix_sort against std::sort, and the vector find,
+    count and mismatch against their std counterparts.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+namespace
+{
+    constexpr size_t key_count = 1u << 20;
+
+    enum class pattern
+    {
+        random,
+        sorted,
+        reversed,
+        organ_pipe,
+    };
+
+    std::vector<uint64_t> make_input (pattern p)
+    {
+        std::vector<uint64_t> keys(key_count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < key_count; ++i)
+        {
+            switch (p)
+            {
+            case pattern::random:
+                state ^= state << 13;
+                state ^= state >> 7;
+                state ^= state << 17;
+                keys[i] = state;
+                break;
+            case pattern::sorted:
+                keys[i] = i;
+                break;
+            case pattern::reversed:
+                keys[i] = key_count - i;
+                break;
+            case pattern::organ_pipe:
+                keys[i] = i < key_count / 2 ? i : key_count - i;
+                break;
+            }
+        }
+        return keys;
+    }
+
+    // ns per element, the copy of the input is part of every run
+    template<class Sort>
+    void sort_keys (bench::state &state, pattern p, Sort sort)
+    {
+        const auto input = make_input(p);
+        std::vector<uint64_t> keys(key_count);
+        state.measure(key_count, [&] {
+            std::copy(input.begin(), input.end(), keys.begin());
+            sort(keys.begin(), keys.end());
+            bench::do_not_optimize(keys.data());
+        });
+    }
+
+    // ns per element of random keys of type K
+    template<class K, class Sort>
+    void sort_random_keys (bench::state &state, Sort sort)
+    {
+        const auto wide = make_input(pattern::random);
+        const std::vector<K> input(wide.begin(), wide.end());
+        std::vector<K> keys(key_count);
+        state.measure(key_count, [&] {
+            std::copy(input.begin(), input.end(), keys.begin());
+            sort(keys.begin(), keys.end());
+            bench::do_not_optimize(keys.data());
+        });
+    }
+
+    const auto std_sort   = [] (auto first, auto last) { std::sort(first, last); };
+    const auto dstl_sort  = [] (auto first, auto last) { dstl::sort(first, last); };
+    const auto radix_sort = [] (auto first, auto last) { dstl::radix_sort(first, last); };
+
+    // a comparator sort does not recognize, which keeps sort on the pdqsort path
+    const auto pdq_sort = [] (auto first, auto last) { dstl::sort(first, last, [] (auto a, auto b) { return a < b; }); };
+
+    constexpr size_t column_size = 1u << 16;
+
+    // ns per element scanned, a column with its only sentinel in the last slot
+    template<class T, class Find>
+    void find_sentinel (bench::state &state, Find find)
+    {
+        std::vector<T> column(column_size, T(1));
+        column.back() = T(0);
+        state.measure(column_size, [&] {
+            auto it = find(column.begin(), column.end(), T(0));
+            bench::do_not_optimize(it);
+        });
+    }
+
+    // ns per element compared, two columns that differ in the last slot
+    template<class T, class Mismatch>
+    void mismatch_columns (bench::state &state, Mismatch mismatch)
+    {
+        std::vector<T> a(column_size, T(1));
+        std::vector<T> b(a);
+        b.back() = T(2);
+        state.measure(column_size, [&] {
+            auto it = mismatch(a.begin(), a.end(), b.begin());
+            bench::do_not_optimize(it);
+        });
+    }
+
+    const auto std_find       = [] (auto first, auto last, auto value) { return std::find(first, last, value); };
+    const auto dstl_find      = [] (auto first, auto last, auto value) { return dstl::find(first, last, value); };
+    const auto std_count      = [] (auto first, auto last, auto value) { return std::count(first, last, value); };
+    const auto dstl_count     = [] (auto first, auto last, auto value) { return dstl::count(first, last, value); };
+    const auto std_mismatch   = [] (auto first1, auto last1, auto first2) { return std::mismatch(first1, last1, first2).first; };
+    const auto dstl_mismatch  = [] (auto first1, auto last1, auto first2) { return dstl::mismatch(first1, last1, first2).first; };
+}
+
+BENCH_CASE("sort/random/std") { sort_keys(state, pattern::random, std_sort); }
+BENCH_CASE("sort/random/dstl") { sort_keys(state, pattern::random, dstl_sort); }
+BENCH_CASE("sort/sorted/std") { sort_keys(state, pattern::sorted, std_sort); }
+BENCH_CASE("sort/sorted/dstl") { sort_keys(state, pattern::sorted, dstl_sort); }
+BENCH_CASE("sort/reversed/std") { sort_keys(state, pattern::reversed, std_sort); }
+BENCH_CASE("sort/reversed/dstl") { sort_keys(state, pattern::reversed, dstl_sort); }
+BENCH_CASE("sort/organ_pipe/std") { sort_keys(state, pattern::organ_pipe, std_sort); }
+BENCH_CASE("sort/organ_pipe/dstl") { sort_keys(state, pattern::organ_pipe, dstl_sort); }
+
+BENCH_CASE("sort/u32/std") { sort_random_keys<uint32_t>(state, std_sort); }
+BENCH_CASE("sort/u32/pdqsort") { sort_random_keys<uint32_t>(state, pdq_sort); }
+BENCH_CASE("sort/u32/radix") { sort_random_keys<uint32_t>(state, radix_sort); }
+BENCH_CASE("sort/u64/std") { sort_random_keys<uint64_t>(state, std_sort); }
+BENCH_CASE("sort/u64/pdqsort") { sort_random_keys<uint64_t>(state, pdq_sort); }
+BENCH_CASE("sort/u64/radix") { sort_random_keys<uint64_t>(state, radix_sort); }
+BENCH_CASE("sort/f64/std") { sort_random_keys<double>(state, std_sort); }
+BENCH_CASE("sort/f64/radix") { sort_random_keys<double>(state, radix_sort); }
+
+BENCH_CASE("find/u8/std") { find_sentinel<uint8_t>(state, std_find); }
+BENCH_CASE("find/u8/dstl") { find_sentinel<uint8_t>(state, dstl_find); }
+BENCH_CASE("find/i32/std") { find_sentinel<int32_t>(state, std_find); }
+BENCH_CASE("find/i32/dstl") { find_sentinel<int32_t>(state, dstl_find); }
+BENCH_CASE("find/f64/std") { find_sentinel<double>(state, std_find); }
+BENCH_CASE("find/f64/dstl") { find_sentinel<double>(state, dstl_find); }
+BENCH_CASE("count/u8/std") { find_sentinel<uint8_t>(state, std_count); }
+BENCH_CASE("count/u8/dstl") { find_sentinel<uint8_t>(state, dstl_count); }
+BENCH_CASE("count/i32/std") { find_sentinel<int32_t>(state, std_count); }
+BENCH_CASE("count/i32/dstl") { find_sentinel<int32_t>(state, dstl_count); }
+BENCH_CASE("mismatch/i32/std") { mismatch_columns<int32_t>(state, std_mismatch); }
+BENCH_CASE("mismatch/i32/dstl") { mismatch_columns<int32_t>(state, dstl_mismatch); }
+BENCH_CASE("mismatch/f64/std") { mismatch_columns<double>(state, std_mismatch); }
+BENCH_CASE("mismatch/f64/dstl") { mismatch_columns<double>(state, dstl_mismatch); }
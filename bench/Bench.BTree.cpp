@@ -0,0 +1,106 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.BTree.cpp
+
+Abstract:
+    Benchmark btree_map against std::map as an index of timestamps that
+    grows at its end and is read at random.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <map>
+#include <vector>
+
+namespace
+{
+    constexpr size_t lookup_count = 1u << 16;
+
+    // ascending nanosecond timestamps with irregular gaps
+    std::vector<std::pair<int64_t, int64_t>> make_series (size_t size)
+    {
+        std::vector<std::pair<int64_t, int64_t>> series;
+        series.reserve(size);
+        int64_t time   = 1700000000000000000;
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < size; ++i)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            time += 1 + static_cast<int64_t>(state % 1000);
+            series.emplace_back(time, static_cast<int64_t>(i));
+        }
+        return series;
+    }
+
+    // timestamps of the series in no particular order
+    std::vector<int64_t> make_lookups (const std::vector<std::pair<int64_t, int64_t>> &series)
+    {
+        std::vector<int64_t> keys(lookup_count);
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+        for (int64_t &key : keys)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            key = series[state % series.size()].first;
+        }
+        return keys;
+    }
+
+    // ns per lookup
+    template<class Map>
+    void lookup_series (bench::state &state, size_t size)
+    {
+        const auto series = make_series(size);
+        const Map map(series.begin(), series.end());
+        const std::vector<int64_t> keys = make_lookups(series);
+        state.measure(lookup_count, [&] {
+            int64_t sum = 0;
+            for (int64_t key : keys)
+                sum += map.find(key)->second;
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per timestamp, inserted one at a time in arrival order
+    template<class Map>
+    void append_series (bench::state &state, size_t size)
+    {
+        const auto series = make_series(size);
+        state.measure(size, [&] {
+            Map map;
+            for (const auto &[time, value] : series)
+                map.try_emplace(time, value);
+            bench::do_not_optimize(map);
+        });
+    }
+
+    // ns per timestamp, built from the sorted series at once
+    void bulk_series (bench::state &state, size_t size)
+    {
+        const auto series = make_series(size);
+        state.measure(size, [&] {
+            dstl::btree_map<int64_t, int64_t> map(dstl::sorted_unique, series.begin(), series.end());
+            bench::do_not_optimize(map);
+        });
+    }
+}
+
+#define BENCH_BTREE_CASES(size)                                                                                            \
+    BENCH_CASE("btree/lookup/" #size "/std_map") { lookup_series<std::map<int64_t, int64_t>>(state, size); }               \
+    BENCH_CASE("btree/lookup/" #size "/btree_map") { lookup_series<dstl::btree_map<int64_t, int64_t>>(state, size); }      \
+    BENCH_CASE("btree/append/" #size "/std_map") { append_series<std::map<int64_t, int64_t>>(state, size); }               \
+    BENCH_CASE("btree/append/" #size "/btree_map") { append_series<dstl::btree_map<int64_t, int64_t>>(state, size); }      \
+    BENCH_CASE("btree/bulk/" #size "/btree_map") { bulk_series(state, size); }
+
+BENCH_BTREE_CASES(4096)
+BENCH_BTREE_CASES(1048576)
@@ -0,0 +1,180 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.ConcurrentQueue.cpp
+
+Abstract:
+    Benchmark spsc_queue and mpmc_queue against a mutex protected queue.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    constexpr size_t messages_per_run = 1 << 20;
+
+    struct mutex_queue
+    {
+        std::mutex mutex_;
+        std::deque<uint64_t> items_;
+
+        size_t push_n (const uint64_t *src, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            items_.insert(items_.end(), src, src + count);
+            return count;
+        }
+
+        bool try_push (uint64_t value) { return push_n(&value, 1) == 1; }
+
+        bool try_pop (uint64_t &value) { return pop_n(&value, 1) == 1; }
+
+        size_t pop_n (uint64_t *dst, size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            size_t n = count < items_.size() ? count : items_.size();
+            std::copy_n(items_.begin(), n, dst);
+            items_.erase(items_.begin(), items_.begin() + ptrdiff_t(n));
+            return n;
+        }
+    };
+
+    // ns per message handed from a producer thread to the measuring thread
+    template<class Queue>
+    void hand_off (bench::state &state, size_t batch)
+    {
+        state.measure(messages_per_run, [batch] {
+            auto q = std::make_unique<Queue>();
+            std::thread producer([&q, batch] {
+                uint64_t buffer[64];
+                for (size_t sent = 0; sent < messages_per_run;)
+                {
+                    size_t n = messages_per_run - sent < batch ? messages_per_run - sent : batch;
+                    for (size_t i = 0; i < n; ++i)
+                        buffer[i] = sent + i;
+                    if (size_t pushed = q->push_n(buffer, n))
+                        sent += pushed;
+                    else
+                        std::this_thread::yield();
+                }
+            });
+            uint64_t sum = 0;
+            uint64_t buffer[64];
+            for (size_t received = 0; received < messages_per_run;)
+            {
+                size_t n = q->pop_n(buffer, batch);
+                if (n == 0)
+                    std::this_thread::yield();
+                for (size_t i = 0; i < n; ++i)
+                    sum += buffer[i];
+                received += n;
+            }
+            producer.join();
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    using spsc = dstl::spsc_queue<uint64_t, 4096>;
+
+    constexpr size_t fan_in_messages = 1 << 18;
+    constexpr size_t fan_in_capacity = 1024;
+
+    // the try_ operations, yielding while the queue is full or empty
+    struct spinning
+    {
+        template<class Queue>
+        static void push (Queue &q, uint64_t value)
+        {
+            while (!q.try_push(value))
+                std::this_thread::yield();
+        }
+
+        template<class Queue>
+        static void pop (Queue &q, uint64_t &value)
+        {
+            while (!q.try_pop(value))
+                std::this_thread::yield();
+        }
+    };
+
+    // the waiting push and pop of blocking_mpmc_queue
+    struct blocking
+    {
+        template<class Queue>
+        static void push (Queue &q, uint64_t value) { q.push(value); }
+
+        template<class Queue>
+        static void pop (Queue &q, uint64_t &value) { q.pop(value); }
+    };
+
+    // ns per message with threads producers and as many consumers, each handling an equal share
+    template<class Queue, class Wait>
+    void fan_in (bench::state &state, size_t threads)
+    {
+        state.measure(fan_in_messages, [threads] {
+            std::unique_ptr<Queue> q;
+            if constexpr (dstl::is_constructible_v<Queue, size_t>)
+                q = std::make_unique<Queue>(fan_in_capacity);
+            else
+                q = std::make_unique<Queue>();
+
+            const size_t share = fan_in_messages / threads;
+            std::atomic<uint64_t> sum{0};
+            std::vector<std::thread> workers;
+            for (size_t t = 0; t < threads; ++t)
+            {
+                workers.emplace_back([&q, share] {
+                    for (size_t i = 0; i < share; ++i)
+                        Wait::push(*q, i);
+                });
+                workers.emplace_back([&q, &sum, share] {
+                    uint64_t local = 0;
+                    uint64_t value = 0;
+                    for (size_t i = 0; i < share; ++i)
+                    {
+                        Wait::pop(*q, value);
+                        local += value;
+                    }
+                    sum.fetch_add(local, std::memory_order_relaxed);
+                });
+            }
+            for (auto &w : workers)
+                w.join();
+            bench::do_not_optimize(sum.load());
+        });
+    }
+
+    using mpmc          = dstl::mpmc_queue<uint64_t>;
+    using blocking_mpmc = dstl::blocking_mpmc_queue<uint64_t>;
+}
+
+BENCH_CASE("spsc_queue/hand_off/mutex/1")  { hand_off<mutex_queue>(state, 1); }
+BENCH_CASE("spsc_queue/hand_off/dstl/1")   { hand_off<spsc>(state, 1); }
+BENCH_CASE("spsc_queue/hand_off/mutex/64") { hand_off<mutex_queue>(state, 64); }
+BENCH_CASE("spsc_queue/hand_off/dstl/64")  { hand_off<spsc>(state, 64); }
+
+#define BENCH_FAN_IN_CASES(threads)                                                                                         \
+    BENCH_CASE("mpmc_queue/fan_in/mutex/" #threads) { fan_in<mutex_queue, spinning>(state, threads); }                    \
+    BENCH_CASE("mpmc_queue/fan_in/dstl/" #threads) { fan_in<mpmc, spinning>(state, threads); }                            \
+    BENCH_CASE("mpmc_queue/fan_in/dstl_blocking/" #threads) { fan_in<blocking_mpmc, blocking>(state, threads); }
+
+BENCH_FAN_IN_CASES(1)
+BENCH_FAN_IN_CASES(2)
+BENCH_FAN_IN_CASES(4)
+BENCH_FAN_IN_CASES(8)
+BENCH_FAN_IN_CASES(16)
+BENCH_FAN_IN_CASES(32)
+BENCH_FAN_IN_CASES(64)
@@ -0,0 +1,82 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.Execution.cpp
+
+Abstract:
+    Benchmark the parallel algorithms against their sequential versions.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+namespace
+{
+    constexpr size_t element_count = 1u << 22;
+
+    std::vector<uint64_t> make_keys ()
+    {
+        std::vector<uint64_t> keys(element_count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto &key : keys)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            key = state;
+        }
+        return keys;
+    }
+
+    // ns per element, the copy of the input is part of every run. the comparator keeps the
+    // sequential sort on pdqsort rather than radix_sort
+    template<class Policy>
+    void sort_keys (bench::state &state, Policy policy)
+    {
+        const auto input = make_keys();
+        std::vector<uint64_t> keys(element_count);
+        state.measure(element_count, [&] {
+            std::copy(input.begin(), input.end(), keys.begin());
+            dstl::sort(policy, keys.begin(), keys.end(), [] (uint64_t a, uint64_t b) { return a < b; });
+            bench::do_not_optimize(keys.data());
+        });
+    }
+
+    template<class Policy>
+    void reduce_keys (bench::state &state, Policy policy)
+    {
+        const auto input = make_keys();
+        state.measure(element_count, [&] {
+            uint64_t sum = dstl::reduce(policy, input.begin(), input.end(), uint64_t(0));
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // an element operation heavy enough that the stage is compute bound
+    template<class Policy>
+    void transform_keys (bench::state &state, Policy policy)
+    {
+        const auto input = make_keys();
+        std::vector<uint64_t> output(element_count);
+        state.measure(element_count, [&] {
+            dstl::transform(policy, input.begin(), input.end(), output.begin(), [] (uint64_t x) {
+                for (int i = 0; i < 16; ++i)
+                    x = x * 0x9E3779B97F4A7C15ULL ^ (x >> 29);
+                return x;
+            });
+            bench::do_not_optimize(output.data());
+        });
+    }
+}
+
+BENCH_CASE("execution/sort/seq") { sort_keys(state, dstl::execution::seq); }
+BENCH_CASE("execution/sort/par") { sort_keys(state, dstl::execution::par); }
+BENCH_CASE("execution/reduce/seq") { reduce_keys(state, dstl::execution::seq); }
+BENCH_CASE("execution/reduce/par") { reduce_keys(state, dstl::execution::par); }
+BENCH_CASE("execution/transform/seq") { transform_keys(state, dstl::execution::seq); }
+BENCH_CASE("execution/transform/par") { transform_keys(state, dstl::execution::par); }
@@ -0,0 +1,125 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.FlatMap.cpp
+
+Abstract:
+    Benchmark flat_map against std::map and a branchy binary search for a
+    routing table that is built once and then only read.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <algorithm>
+#include <map>
+#include <vector>
+
+namespace
+{
+    constexpr size_t lookup_count = 1u << 16;
+
+    // sorted, sparse route keys
+    std::vector<std::pair<uint32_t, uint32_t>> make_routes (size_t size)
+    {
+        std::vector<std::pair<uint32_t, uint32_t>> routes;
+        routes.reserve(size);
+        for (size_t i = 0; i < size; ++i)
+            routes.emplace_back(static_cast<uint32_t>(i * 7 + 3), static_cast<uint32_t>(i));
+        return routes;
+    }
+
+    // keys of existing routes in no particular order
+    std::vector<uint32_t> make_lookups (size_t size)
+    {
+        std::vector<uint32_t> keys(lookup_count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (uint32_t &key : keys)
+        {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+            key = static_cast<uint32_t>((state % size) * 7 + 3);
+        }
+        return keys;
+    }
+
+    struct std_map
+    {
+        std::map<uint32_t, uint32_t> map_;
+
+        explicit std_map (const std::vector<std::pair<uint32_t, uint32_t>> &routes) : map_(routes.begin(), routes.end()) {}
+
+        uint32_t lookup (uint32_t key) const { return map_.find(key)->second; }
+    };
+
+    struct flat_map
+    {
+        dstl::flat_map<uint32_t, uint32_t> map_;
+
+        explicit flat_map (const std::vector<std::pair<uint32_t, uint32_t>> &routes)
+            : map_(dstl::sorted_unique, routes.begin(), routes.end())
+        {
+        }
+
+        uint32_t lookup (uint32_t key) const { return map_.find(key)->second; }
+    };
+
+    // the same arrays as flat_map, searched with the branching std::lower_bound
+    struct branchy_search
+    {
+        dstl::flat_map<uint32_t, uint32_t> map_;
+
+        explicit branchy_search (const std::vector<std::pair<uint32_t, uint32_t>> &routes)
+            : map_(dstl::sorted_unique, routes.begin(), routes.end())
+        {
+        }
+
+        uint32_t lookup (uint32_t key) const
+        {
+            const auto &keys = map_.keys();
+            return map_.values()[static_cast<size_t>(std::lower_bound(keys.begin(), keys.end(), key) - keys.begin())];
+        }
+    };
+
+    // ns per lookup
+    template<class Table>
+    void lookup_routes (bench::state &state, size_t size)
+    {
+        const Table table(make_routes(size));
+        const std::vector<uint32_t> keys = make_lookups(size);
+        state.measure(lookup_count, [&] {
+            uint32_t sum = 0;
+            for (uint32_t key : keys)
+                sum += table.lookup(key);
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per route
+    template<class Table>
+    void build_routes (bench::state &state, size_t size)
+    {
+        const auto routes = make_routes(size);
+        state.measure(size, [&] {
+            Table table(routes);
+            bench::do_not_optimize(table);
+        });
+    }
+}
+
+#define BENCH_FLAT_MAP_CASES(size)                                                                                \
+    BENCH_CASE("flat_map/lookup/" #size "/std_map") { lookup_routes<std_map>(state, size); }                     \
+    BENCH_CASE("flat_map/lookup/" #size "/branchy") { lookup_routes<branchy_search>(state, size); }              \
+    BENCH_CASE("flat_map/lookup/" #size "/flat_map") { lookup_routes<flat_map>(state, size); }                   \
+    BENCH_CASE("flat_map/build/" #size "/std_map") { build_routes<std_map>(state, size); }                       \
+    BENCH_CASE("flat_map/build/" #size "/flat_map") { build_routes<flat_map>(state, size); }
+
+BENCH_FLAT_MAP_CASES(64)
+BENCH_FLAT_MAP_CASES(4096)
+BENCH_FLAT_MAP_CASES(262144)
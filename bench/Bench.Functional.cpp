@@ -0,0 +1,96 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.Functional.cpp
+
+Abstract:
+    Benchmark function and move_only_function against std::function on
+    registering a callback that captures three pointers and calling it
+    once, the pattern of a per request completion handler, and calls
+    through function_ref.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <functional>
+#include <vector>
+
+namespace
+{
+    constexpr size_t request_count = 1u << 12;
+
+    struct request
+    {
+        int64_t id_     = 0;
+        int64_t status_ = 0;
+    };
+
+    // ns per request: the handler is wrapped, stored, called and destroyed
+    template<class Handler>
+    void register_handlers (bench::state &state)
+    {
+        std::vector<request> requests(request_count);
+        for (size_t i = 0; i < request_count; ++i)
+            requests[i].id_ = static_cast<int64_t>(i);
+        std::vector<Handler> handlers(request_count);
+        int64_t completed = 0;
+        int64_t bytes     = 0;
+        state.measure(request_count, [&] {
+            for (size_t i = 0; i < request_count; ++i)
+            {
+                request *r = &requests[i];
+                handlers[i] = [r, &completed, &bytes] (int64_t status) {
+                    r->status_ = status;
+                    ++completed;
+                    bytes += r->id_;
+                };
+            }
+            for (Handler &handler : handlers)
+                handler(200);
+            for (Handler &handler : handlers)
+                handler = nullptr;
+            bench::do_not_optimize(bytes);
+        });
+    }
+
+    // ns per call of a stored callable
+    template<class Handler>
+    void call_handler (bench::state &state)
+    {
+        int64_t sum  = 0;
+        int64_t step = 3;
+        const Handler handler = [&sum, &step] (int64_t x) { sum += x * step; };
+        state.measure(request_count, [&] {
+            for (size_t i = 0; i < request_count; ++i)
+                handler(static_cast<int64_t>(i));
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per call through function_ref
+    void call_function_ref (bench::state &state)
+    {
+        int64_t sum  = 0;
+        int64_t step = 3;
+        auto body = [&sum, &step] (int64_t x) { sum += x * step; };
+        const dstl::function_ref<void(int64_t)> handler = body;
+        state.measure(request_count, [&] {
+            for (size_t i = 0; i < request_count; ++i)
+                handler(static_cast<int64_t>(i));
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+BENCH_CASE("functional/register/std_function") { register_handlers<std::function<void(int64_t)>>(state); }
+BENCH_CASE("functional/register/dstl_function") { register_handlers<dstl::function<void(int64_t)>>(state); }
+BENCH_CASE("functional/register/dstl_move_only_function") { register_handlers<dstl::move_only_function<void(int64_t)>>(state); }
+BENCH_CASE("functional/call/std_function") { call_handler<std::function<void(int64_t)>>(state); }
+BENCH_CASE("functional/call/dstl_function") { call_handler<dstl::function<void(int64_t)>>(state); }
+BENCH_CASE("functional/call/dstl_function_ref") { call_function_ref(state); }
@@ -0,0 +1,222 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.Hash.cpp
+
+Abstract:
+    Benchmark hash_bytes against the std::hash of string views, string keys
+    in hash tables, hash_n against a plain loop on long and on short keys,
+    and bytewise hashing and equality of padding free records against
+    working field by field.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace
+{
+    constexpr size_t record_count = 1u << 12;
+
+    // 40 bytes, no padding
+    struct record
+    {
+        uint64_t key_;
+        uint32_t shard_;
+        uint32_t flags_;
+        uint64_t stamp_;
+        uint64_t size_;
+        uint64_t offset_;
+
+        bool operator== (const record &) const = default;
+    };
+
+    inline void hash_combine (size_t &seed, size_t value) noexcept
+    {
+        seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+    }
+
+    struct fieldwise_hash
+    {
+        size_t operator() (const record &r) const noexcept
+        {
+            size_t seed = 0;
+            hash_combine(seed, std::hash<uint64_t>()(r.key_));
+            hash_combine(seed, std::hash<uint32_t>()(r.shard_));
+            hash_combine(seed, std::hash<uint32_t>()(r.flags_));
+            hash_combine(seed, std::hash<uint64_t>()(r.stamp_));
+            hash_combine(seed, std::hash<uint64_t>()(r.size_));
+            hash_combine(seed, std::hash<uint64_t>()(r.offset_));
+            return seed;
+        }
+    };
+
+    std::vector<record> make_records ()
+    {
+        std::vector<record> records(record_count);
+        for (size_t i = 0; i < record_count; ++i)
+            records[i] = record{i * 2654435761u, uint32_t(i % 13), uint32_t(i & 3), i * 1000, 4096, i * 4096};
+        return records;
+    }
+
+    template<class Hash>
+    void hash_records (bench::state &state)
+    {
+        const std::vector<record> records = make_records();
+        state.measure(record_count, [&records] {
+            Hash hash;
+            size_t sum = 0;
+            for (const record &r : records)
+                sum += hash(r);
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    template<class Table>
+    void find_records (bench::state &state)
+    {
+        const std::vector<record> records = make_records();
+        Table table;
+        for (const record &r : records)
+            table.emplace(r, 1);
+        state.measure(record_count, [&records, &table] {
+            size_t found = 0;
+            for (const record &r : records)
+                found += table.find(r) != table.end();
+            bench::do_not_optimize(found);
+        });
+    }
+
+    template<bool Bytewise>
+    void equal_records (bench::state &state, size_t length)
+    {
+        const std::vector<record> a = make_records();
+        const std::vector<record> b = a;
+        state.measure(length, [&a, &b, length] {
+            bool same;
+            if constexpr (Bytewise)
+                same = dstl::equal(a.begin(), a.begin() + length, b.begin());
+            else
+                same = std::equal(a.begin(), a.begin() + length, b.begin());
+            bench::do_not_optimize(same);
+        });
+    }
+
+    template<bool Dstl>
+    void hash_span (bench::state &state, size_t size)
+    {
+        constexpr size_t rounds = 256;
+
+        const std::string bytes(size, 'k');
+        state.measure(rounds, [&bytes] {
+            for (size_t i = 0; i < rounds; ++i)
+            {
+                size_t hash;
+                if constexpr (Dstl)
+                    hash = static_cast<size_t>(dstl::hash_bytes(bytes.data(), bytes.size()));
+                else
+                    hash = std::hash<std::string_view>()(bytes);
+                bench::do_not_optimize(hash);
+            }
+        });
+    }
+
+    // 20 to 40 character keys, shuffled so that their heap bytes are visited in no particular order
+    std::vector<std::string> make_words (size_t count)
+    {
+        std::vector<std::string> words;
+        words.reserve(count);
+        for (size_t i = 0; i < count; ++i)
+            words.push_back("customer/" + std::to_string(i * 2654435761u) + std::string(i % 20, '#'));
+        std::shuffle(words.begin(), words.end(), std::mt19937_64(7));
+        return words;
+    }
+
+    template<class Table>
+    void find_words (bench::state &state)
+    {
+        const std::vector<std::string> words = make_words(1u << 14);
+        Table table;
+        for (const std::string &w : words)
+            table.emplace(w, 1);
+        state.measure(words.size(), [&words, &table] {
+            size_t found = 0;
+            for (const std::string &w : words)
+                found += table.find(w) != table.end();
+            bench::do_not_optimize(found);
+        });
+    }
+
+    template<bool Batched>
+    void hash_words (bench::state &state)
+    {
+        const std::vector<std::string> words = make_words(1u << 18);
+        std::vector<size_t> hashes(words.size());
+        state.measure(words.size(), [&words, &hashes] {
+            if constexpr (Batched)
+                dstl::hash_n(words.data(), words.size(), hashes.data());
+            else
+                for (size_t i = 0; i < words.size(); ++i)
+                    hashes[i] = dstl::hash<std::string>()(words[i]);
+            bench::do_not_optimize(hashes.data());
+        });
+    }
+
+    // ns per key of 3 to 14 chars, which std::string keeps inline, so hash_n has nothing to prefetch
+    template<bool Batched>
+    void hash_short_words (bench::state &state)
+    {
+        std::vector<std::string> words;
+        for (size_t i = 0; i < (1u << 16); ++i)
+            words.push_back("id" + std::to_string(i * 2654435761u % 100000) + std::string(i % 8, '#'));
+        std::vector<size_t> hashes(words.size());
+        state.measure(words.size(), [&words, &hashes] {
+            if constexpr (Batched)
+                dstl::hash_n(words.data(), words.size(), hashes.data());
+            else
+                for (size_t i = 0; i < words.size(); ++i)
+                    hashes[i] = dstl::hash<std::string>()(words[i]);
+            bench::do_not_optimize(hashes.data());
+        });
+    }
+
+    using std_word_map  = dstl::flat_hash_map<std::string, int, std::hash<std::string>>;
+    using dstl_word_map = dstl::flat_hash_map<std::string, int>;
+    using fieldwise_map = dstl::flat_hash_map<record, int, fieldwise_hash>;
+    using bytewise_map  = dstl::flat_hash_map<record, int, dstl::hash<record>>;
+}
+
+#define BENCH_SPAN_CASES(size)                                                    \
+    BENCH_CASE("hash/bytes/" #size "/std") { hash_span<false>(state, size); }     \
+    BENCH_CASE("hash/bytes/" #size "/dstl") { hash_span<true>(state, size); }
+
+BENCH_SPAN_CASES(8)
+BENCH_SPAN_CASES(32)
+BENCH_SPAN_CASES(200)
+BENCH_SPAN_CASES(1024)
+BENCH_SPAN_CASES(16384)
+
+BENCH_CASE("hash/find_string/std") { find_words<std_word_map>(state); }
+BENCH_CASE("hash/find_string/dstl") { find_words<dstl_word_map>(state); }
+BENCH_CASE("hash/strings/loop") { hash_words<false>(state); }
+BENCH_CASE("hash/strings/hash_n") { hash_words<true>(state); }
+BENCH_CASE("hash/short_strings/loop") { hash_short_words<false>(state); }
+BENCH_CASE("hash/short_strings/hash_n") { hash_short_words<true>(state); }
+BENCH_CASE("hash/record/fieldwise") { hash_records<fieldwise_hash>(state); }
+BENCH_CASE("hash/record/bytewise") { hash_records<dstl::hash<record>>(state); }
+BENCH_CASE("hash/find/fieldwise") { find_records<fieldwise_map>(state); }
+BENCH_CASE("hash/find/bytewise") { find_records<bytewise_map>(state); }
+BENCH_CASE("hash/equal/16/std") { equal_records<false>(state, 16); }
+BENCH_CASE("hash/equal/16/dstl") { equal_records<true>(state, 16); }
+BENCH_CASE("hash/equal/4096/std") { equal_records<false>(state, 4096); }
+BENCH_CASE("hash/equal/4096/dstl") { equal_records<true>(state, 4096); }
@@ -0,0 +1,97 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.HashTable.cpp
+
+Abstract:
+    Benchmark flat_hash_map against std::unordered_map.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <unordered_map>
+
+namespace
+{
+    constexpr size_t key_count = 1u << 20;
+
+    // distinct pseudo random keys, the odd ones are never inserted and serve as misses
+    std::vector<uint64_t> make_keys (size_t count)
+    {
+        std::vector<uint64_t> keys(count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (auto &key : keys)
+        {
+            state += 0x9E3779B97F4A7C15ULL;
+            uint64_t z = state;
+            z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            key        = (z ^ (z >> 31)) & ~1ULL;
+        }
+        return keys;
+    }
+
+    template<class Map>
+    void insert_keys (bench::state &state)
+    {
+        const auto keys = make_keys(key_count);
+        state.measure(key_count, [&keys] {
+            Map m;
+            for (auto key : keys)
+                m.emplace(key, key);
+            bench::do_not_optimize(m);
+        });
+    }
+
+    template<class Map>
+    void lookup_keys (bench::state &state, uint64_t miss_bit)
+    {
+        const auto keys = make_keys(key_count);
+        Map m;
+        for (auto key : keys)
+            m.emplace(key, key);
+        state.measure(key_count, [&] {
+            size_t found = 0;
+            for (auto key : keys)
+                found += m.find(key | miss_bit) != m.end();
+            bench::do_not_optimize(found);
+        });
+    }
+
+    // a steady state table where each step erases one key and inserts another
+    template<class Map>
+    void erase_heavy (bench::state &state)
+    {
+        const auto keys       = make_keys(key_count);
+        constexpr size_t live = key_count / 4;
+        state.measure(key_count - live, [&keys] {
+            Map m;
+            for (size_t i = 0; i < live; ++i)
+                m.emplace(keys[i], keys[i]);
+            for (size_t i = live; i < key_count; ++i)
+            {
+                m.erase(keys[i - live]);
+                m.emplace(keys[i], keys[i]);
+            }
+            bench::do_not_optimize(m);
+        });
+    }
+
+    using std_map  = std::unordered_map<uint64_t, uint64_t>;
+    using dstl_map = dstl::flat_hash_map<uint64_t, uint64_t>;
+}
+
+BENCH_CASE("hash_map/insert/std") { insert_keys<std_map>(state); }
+BENCH_CASE("hash_map/insert/dstl") { insert_keys<dstl_map>(state); }
+BENCH_CASE("hash_map/find_hit/std") { lookup_keys<std_map>(state, 0); }
+BENCH_CASE("hash_map/find_hit/dstl") { lookup_keys<dstl_map>(state, 0); }
+BENCH_CASE("hash_map/find_miss/std") { lookup_keys<std_map>(state, 1); }
+BENCH_CASE("hash_map/find_miss/dstl") { lookup_keys<dstl_map>(state, 1); }
+BENCH_CASE("hash_map/erase_heavy/std") { erase_heavy<std_map>(state); }
+BENCH_CASE("hash_map/erase_heavy/dstl") { erase_heavy<dstl_map>(state); }
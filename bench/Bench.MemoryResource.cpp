@@ -0,0 +1,68 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.MemoryResource.cpp
+
+Abstract:
+    Benchmark monotonic_buffer_resource against new and delete.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+namespace
+{
+    // a parse tree node, many tiny objects that all die together
+    struct bench_node
+    {
+        bench_node *next_;
+        uint64_t value_;
+    };
+
+    constexpr size_t node_count = 1u << 16;
+
+    void new_delete (bench::state &state)
+    {
+        std::vector<bench_node *> nodes(node_count);
+        state.measure(node_count, [&nodes] {
+            bench_node *prev = nullptr;
+            for (size_t i = 0; i < node_count; ++i)
+                prev = nodes[i] = new bench_node{prev, i};
+            bench::do_not_optimize(prev);
+            for (auto *node : nodes)
+                delete node;
+        });
+    }
+
+    void monotonic (bench::state &state)
+    {
+        state.measure(node_count, [] {
+            dstl::monotonic_buffer_resource arena;
+            bench_node *prev = nullptr;
+            for (size_t i = 0; i < node_count; ++i)
+                prev = arena.create<bench_node>(bench_node{prev, i});
+            bench::do_not_optimize(prev);
+        });
+    }
+
+    void monotonic_stack_buffer (bench::state &state)
+    {
+        state.measure(node_count, [] {
+            alignas(std::max_align_t) unsigned char buffer[64 << 10];
+            dstl::monotonic_buffer_resource arena(buffer, sizeof(buffer));
+            bench_node *prev = nullptr;
+            for (size_t i = 0; i < node_count; ++i)
+                prev = arena.create<bench_node>(bench_node{prev, i});
+            bench::do_not_optimize(prev);
+        });
+    }
+}
+
+BENCH_CASE("memory_resource/tiny_objects/new_delete") { new_delete(state); }
+BENCH_CASE("memory_resource/tiny_objects/monotonic") { monotonic(state); }
+BENCH_CASE("memory_resource/tiny_objects/monotonic_stack") { monotonic_stack_buffer(state); }
@@ -0,0 +1,86 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.ObjectPool.cpp
+
+Abstract:
+    Benchmark object_pool against new and delete.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <thread>
+
+namespace
+{
+    // an order book node
+    struct bench_order
+    {
+        uint64_t id_;
+        uint64_t price_;
+        uint64_t quantity_;
+        bench_order *next_;
+    };
+
+    constexpr size_t ops_per_thread = 1u << 20;
+
+    // every thread keeps a window of live orders and replaces the oldest one per step
+    template<class Alloc, class Free>
+    void churn (bench::state &state, unsigned threads, Alloc alloc, Free free)
+    {
+        state.measure(ops_per_thread * threads, [&] {
+            auto work = [&] {
+                bench_order *window[64] = {};
+                for (size_t i = 0; i < ops_per_thread; ++i)
+                {
+                    bench_order *&slot = window[i % 64];
+                    if (slot != nullptr)
+                        free(slot);
+                    slot = alloc(i);
+                }
+                for (auto *order : window)
+                    free(order);
+                bench::do_not_optimize(window);
+            };
+
+            std::vector<std::thread> pool;
+            for (unsigned t = 1; t < threads; ++t)
+                pool.emplace_back(work);
+            work();
+            for (auto &thread : pool)
+                thread.join();
+        });
+    }
+
+    void new_delete (bench::state &state, unsigned threads)
+    {
+        churn(
+            state, threads, [] (size_t i) { return new bench_order{i, i, i, nullptr}; },
+            [] (bench_order *order) { delete order; });
+    }
+
+    void pooled (bench::state &state, unsigned threads)
+    {
+        dstl::object_pool<bench_order> pool;
+        churn(
+            state, threads, [&pool] (size_t i) { return pool.create(bench_order{i, i, i, nullptr}); },
+            [&pool] (bench_order *order) { pool.destroy(order); });
+    }
+
+    unsigned many_threads ()
+    {
+        const unsigned n = std::thread::hardware_concurrency();
+        return n > 32 ? 32 : (n < 2 ? 2 : n);
+    }
+}
+
+BENCH_CASE("object_pool/churn/1_thread/new_delete") { new_delete(state, 1); }
+BENCH_CASE("object_pool/churn/1_thread/dstl") { pooled(state, 1); }
+BENCH_CASE("object_pool/churn/all_threads/new_delete") { new_delete(state, many_threads()); }
+BENCH_CASE("object_pool/churn/all_threads/dstl") { pooled(state, many_threads()); }
@@ -0,0 +1,45 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.SmallVector.cpp
+
+Abstract:
+    Benchmark small_vector against vector for short lists.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+namespace
+{
+    constexpr size_t message_count = 1u << 16;
+
+    // builds a short attribute list per message and hands a copy on
+    template<class List>
+    void build_and_copy (bench::state &state, size_t attributes)
+    {
+        state.measure(message_count, [attributes] {
+            for (size_t m = 0; m < message_count; ++m)
+            {
+                List list;
+                for (size_t i = 0; i < attributes; ++i)
+                    list.push_back(static_cast<int>(m + i));
+                List copy(list);
+                bench::do_not_optimize(copy);
+            }
+        });
+    }
+
+    using dstl_vector = dstl::vector<int>;
+    using small_8     = dstl::small_vector<int, 8>;
+}
+
+BENCH_CASE("small_vector/build_copy/6/vector") { build_and_copy<dstl_vector>(state, 6); }
+BENCH_CASE("small_vector/build_copy/6/small_vector") { build_and_copy<small_8>(state, 6); }
+BENCH_CASE("small_vector/build_copy/20/vector") { build_and_copy<dstl_vector>(state, 20); }
+BENCH_CASE("small_vector/build_copy/20/small_vector") { build_and_copy<small_8>(state, 20); }
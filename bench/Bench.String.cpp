@@ -0,0 +1,197 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.String.cpp
+
+Abstract:
+    Benchmark basic_string against std::basic_string on identifiers just
+    past the inline capacity of std::string and on searches and compares
+    of log lines, and basic_string_view against std::basic_string_view on
+    grepping a megabyte of log text for a needle it does not hold.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    constexpr size_t identifier_count = 1u << 14;
+    constexpr size_t line_count       = 1u << 10;
+    constexpr size_t text_size        = 1u << 20;
+
+    uint64_t next (uint64_t &state) noexcept
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    }
+
+    // identifiers of 16 to 23 chars, which std::string keeps on the heap and dstl::string inline
+    std::vector<std::string> make_identifiers ()
+    {
+        std::vector<std::string> identifiers;
+        identifiers.reserve(identifier_count);
+        uint64_t state = 0x9E3779B97F4A7C15ULL;
+        for (size_t i = 0; i < identifier_count; ++i)
+        {
+            std::string id = "order.";
+            const size_t length = 16 + next(state) % 8;
+            while (id.size() < length)
+                id += static_cast<char>('a' + next(state) % 26);
+            identifiers.push_back(std::move(id));
+        }
+        return identifiers;
+    }
+
+    // log lines of about 120 chars that end in the same level and code
+    template<class CharT>
+    std::vector<std::basic_string<CharT>> make_lines ()
+    {
+        std::vector<std::basic_string<CharT>> lines;
+        uint64_t state = 0x2545F4914F6CDD1DULL;
+        for (size_t i = 0; i < line_count; ++i)
+        {
+            std::basic_string<CharT> line;
+            while (line.size() < 100)
+                line += static_cast<CharT>(next(state) % 4 == 0 ? ' ' : 'a' + next(state) % 26);
+            for (char ch : std::string_view(" level=warn code=1234"))
+                line += static_cast<CharT>(ch);
+            lines.push_back(std::move(line));
+        }
+        return lines;
+    }
+
+    // the log lines joined by newlines up to text_size chars
+    std::string make_text ()
+    {
+        std::string text;
+        while (text.size() < text_size)
+            for (const std::string &line : make_lines<char>())
+                text += line + '\n';
+        text.resize(text_size);
+        return text;
+    }
+
+    // ns per KiB of text scanned for a needle that does not occur
+    template<class View>
+    void grep_text (bench::state &state, const std::string &text, const std::string &needle)
+    {
+        const View view(text.data(), text.size());
+        state.measure(text.size() / 1024, [&] {
+            size_t found = view.find(needle);
+            bench::do_not_optimize(found);
+        });
+    }
+
+    // ns per KiB
+    void grep_text_searcher (bench::state &state, const std::string &text, const std::string &needle)
+    {
+        const dstl::searcher searcher(needle);
+        state.measure(text.size() / 1024, [&] {
+            size_t found = searcher.find(text);
+            bench::do_not_optimize(found);
+        });
+    }
+
+    const std::string short_needle = "level=error";
+    const std::string long_needle  = "upstream connection refused while reading header";
+
+    // a naive search compares most of the needle at every position of this text
+    const std::string periodic_text   = std::string(text_size, 'a');
+    const std::string periodic_needle = std::string(63, 'a') + 'b';
+
+    // ns per identifier, copied into a new string and destroyed
+    template<class String>
+    void construct_identifiers (bench::state &state)
+    {
+        const std::vector<std::string> identifiers = make_identifiers();
+        state.measure(identifier_count, [&] {
+            size_t sum = 0;
+            for (const std::string &id : identifiers)
+            {
+                String s(id.data(), id.size());
+                bench::do_not_optimize(s);
+                sum += s.size();
+            }
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per line
+    template<class String>
+    void find_in_lines (bench::state &state)
+    {
+        const auto source = make_lines<char>();
+        const std::vector<String> lines(source.begin(), source.end());
+        state.measure(line_count, [&] {
+            size_t sum = 0;
+            for (const String &line : lines)
+                sum += line.find("code=");
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per line
+    template<class String>
+    void find_first_of_in_lines (bench::state &state)
+    {
+        const auto source = make_lines<char>();
+        const std::vector<String> lines(source.begin(), source.end());
+        state.measure(line_count, [&] {
+            size_t sum = 0;
+            for (const String &line : lines)
+                sum += line.find_first_of("=:;");
+            bench::do_not_optimize(sum);
+        });
+    }
+
+    // ns per pair of lines that differ only near their end
+    template<class String, class CharT>
+    void compare_lines (bench::state &state)
+    {
+        const auto source = make_lines<CharT>();
+        std::vector<String> lines;
+        std::vector<String> others;
+        for (const auto &line : source)
+        {
+            lines.emplace_back(line.data(), line.size());
+            auto other = line;
+            other[other.size() - 2] = static_cast<CharT>('5');
+            others.emplace_back(other.data(), other.size());
+        }
+        state.measure(line_count, [&] {
+            int sum = 0;
+            for (size_t i = 0; i < line_count; ++i)
+                sum += lines[i].compare(others[i]);
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+BENCH_CASE("string/construct/std_string") { construct_identifiers<std::string>(state); }
+BENCH_CASE("string/construct/dstl_string") { construct_identifiers<dstl::string>(state); }
+BENCH_CASE("string/find/std_string") { find_in_lines<std::string>(state); }
+BENCH_CASE("string/find/dstl_string") { find_in_lines<dstl::string>(state); }
+BENCH_CASE("string/find_first_of/std_string") { find_first_of_in_lines<std::string>(state); }
+BENCH_CASE("string/find_first_of/dstl_string") { find_first_of_in_lines<dstl::string>(state); }
+BENCH_CASE("string/compare/std_string") { compare_lines<std::string, char>(state); }
+BENCH_CASE("string/compare/dstl_string") { compare_lines<dstl::string, char>(state); }
+BENCH_CASE("string/compare/std_u16string") { compare_lines<std::u16string, char16_t>(state); }
+BENCH_CASE("string/compare/dstl_u16string") { compare_lines<dstl::u16string, char16_t>(state); }
+
+BENCH_CASE("string_view/short/std_string_view") { grep_text<std::string_view>(state, make_text(), short_needle); }
+BENCH_CASE("string_view/short/dstl_string_view") { grep_text<dstl::string_view>(state, make_text(), short_needle); }
+BENCH_CASE("string_view/long/std_string_view") { grep_text<std::string_view>(state, make_text(), long_needle); }
+BENCH_CASE("string_view/long/dstl_string_view") { grep_text<dstl::string_view>(state, make_text(), long_needle); }
+BENCH_CASE("string_view/long/dstl_searcher") { grep_text_searcher(state, make_text(), long_needle); }
+BENCH_CASE("string_view/periodic/std_string_view") { grep_text<std::string_view>(state, periodic_text, periodic_needle); }
+BENCH_CASE("string_view/periodic/dstl_string_view") { grep_text<dstl::string_view>(state, periodic_text, periodic_needle); }
@@ -0,0 +1,59 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.ThreadPool.cpp
+
+Abstract:
+    Benchmark thread_pool submission against std::async.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <future>
+
+namespace
+{
+    constexpr size_t jobs_per_run = 1024;
+
+    // ns per job for a fan-out of small jobs that are all waited for
+    template<class Submit>
+    void fan_out (bench::state &state, Submit submit)
+    {
+        state.measure(jobs_per_run, [&] {
+            uint64_t sum = 0;
+            auto futures = submit();
+            for (auto &f : futures)
+                sum += f.get();
+            bench::do_not_optimize(sum);
+        });
+    }
+}
+
+BENCH_CASE("thread_pool/fan_out/std_async")
+{
+    fan_out(state, [] {
+        std::vector<std::future<uint64_t>> futures;
+        futures.reserve(jobs_per_run);
+        for (size_t i = 0; i < jobs_per_run; ++i)
+            futures.push_back(std::async(std::launch::async, [i] { return uint64_t(i) * i; }));
+        return futures;
+    });
+}
+
+BENCH_CASE("thread_pool/fan_out/dstl")
+{
+    dstl::thread_pool &pool = dstl::default_thread_pool();
+    fan_out(state, [&pool] {
+        std::vector<dstl::future<uint64_t>> futures;
+        futures.reserve(jobs_per_run);
+        for (size_t i = 0; i < jobs_per_run; ++i)
+            futures.push_back(pool.submit([i] { return uint64_t(i) * i; }));
+        return futures;
+    });
+}
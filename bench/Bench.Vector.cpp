@@ -0,0 +1,106 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Bench.Vector.cpp
+
+Abstract:
+    Benchmark Vector against std::vector.
+
+--*/
+
+#include "bench.hpp"
+
+#include "DSTL.hpp"
+
+#include <memory>
+
+// std::unique_ptr with the default deleter is a single pointer, so it can be relocated bitwise
+namespace dstl
+{
+template<class T>
+struct is_trivially_relocatable<std::unique_ptr<T>> : true_type {};
+}
+
+namespace
+{
+    template<size_t Size>
+    struct bench_pod
+    {
+        unsigned char bytes_[Size];
+    };
+
+    // total payload per run, so every element size touches the same amount of memory
+    constexpr size_t payload_bytes = 8u << 20;
+
+    template<class Vector, size_t Size>
+    void push_back_grow (bench::state &state)
+    {
+        constexpr size_t count = payload_bytes / Size;
+        state.measure(count, [] {
+            Vector v;
+            for (size_t i = 0; i < count; ++i)
+                v.push_back(bench_pod<Size>{{static_cast<unsigned char>(i)}});
+            bench::do_not_optimize(v);
+        });
+    }
+
+    template<class Vector>
+    void push_back_unique (bench::state &state)
+    {
+        constexpr size_t count = 1u << 16;
+        // allocate the pointees up front so the run measures growth only
+        std::vector<int> pointees(count);
+        state.measure(count, [&pointees] {
+            Vector v;
+            for (size_t i = 0; i < count; ++i)
+                v.emplace_back(&pointees[i]);
+            for (auto &p : v)
+                (void) p.release();
+            bench::do_not_optimize(v);
+        });
+    }
+
+    template<class Vector, size_t Size>
+    void insert_front (bench::state &state)
+    {
+        constexpr size_t count = 2048;
+        state.measure(count, [] {
+            Vector v;
+            for (size_t i = 0; i < count; ++i)
+                v.insert(v.begin(), bench_pod<Size>{{static_cast<unsigned char>(i)}});
+            bench::do_not_optimize(v);
+        });
+    }
+
+    template<class Vector, size_t Size>
+    void erase_front (bench::state &state)
+    {
+        constexpr size_t count = 2048;
+        Vector v(count);
+        state.measure(count, [&v] {
+            Vector tmp(v);
+            while (!tmp.empty())
+                tmp.erase(tmp.begin());
+            bench::do_not_optimize(tmp);
+        });
+    }
+}
+
+#define BENCH_VECTOR_CASES(size)                                                                                           \
+    BENCH_CASE("vector/push_back/" #size "B/std") { push_back_grow<std::vector<bench_pod<size>>, size>(state); }     \
+    BENCH_CASE("vector/push_back/" #size "B/dstl") { push_back_grow<dstl::vector<bench_pod<size>>, size>(state); }   \
+    BENCH_CASE("vector/insert_front/" #size "B/std") { insert_front<std::vector<bench_pod<size>>, size>(state); }    \
+    BENCH_CASE("vector/insert_front/" #size "B/dstl") { insert_front<dstl::vector<bench_pod<size>>, size>(state); }  \
+    BENCH_CASE("vector/erase_front/" #size "B/std") { erase_front<std::vector<bench_pod<size>>, size>(state); }      \
+    BENCH_CASE("vector/erase_front/" #size "B/dstl") { erase_front<dstl::vector<bench_pod<size>>, size>(state); }
+
+BENCH_VECTOR_CASES(4)
+BENCH_VECTOR_CASES(16)
+BENCH_VECTOR_CASES(64)
+BENCH_VECTOR_CASES(256)
+
+BENCH_CASE("vector/push_back/unique_ptr/std") { push_back_unique<std::vector<std::unique_ptr<int>>>(state); }
+BENCH_CASE("vector/push_back/unique_ptr/dstl") { push_back_unique<dstl::vector<std::unique_ptr<int>>>(state); }
@@ -0,0 +1,19 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    bench.cpp
+
+Abstract:
+    Benchmark Entry.
+
+--*/
+
+#include "bench.hpp"
+
+int main (int argc, char **argv)
+{
+    return bench::run_all(argc, argv);
+}
@@ -0,0 +1,289 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    bench.hpp
+
+Abstract:
+    Minimal Benchmark Harness.
+
+    Each case runs its body for a few warmup runs and then for a number of
+    timed repetitions. The table printed to stdout and the csv or json
+    written to bench_output.txt report the median, p99 and best time per
+    operation over the repetitions, along with cycles, IPC, cache misses
+    and branch misses per operation from dstl::perf_counter. Without
+    perf_event_open, cycles are time stamp counter ticks and the other
+    events are left out.
+
+    usage: dstl.bench [--filter=substring] [--repetitions=N] [--warmup=N]
+                      [--format=csv|json] [--output=path]
+
+--*/
+
+#ifndef DSTL_BENCH_H
+#define DSTL_BENCH_H
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "DSTL.hpp"
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+
+namespace bench
+{
+    // keeps the compiler from discarding value or the computation producing it
+    template<class T>
+    inline void do_not_optimize (const T &value)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "r,m"(value) : "memory");
+#else
+        const volatile char *sink = reinterpret_cast<const volatile char *>(&value);
+        (void) *sink;
+        _ReadWriteBarrier();
+#endif
+    }
+
+    // forces pending writes to memory to be treated as observable
+    inline void clobber_memory ()
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : : "memory");
+#else
+        _ReadWriteBarrier();
+#endif
+    }
+
+    struct options
+    {
+        const char *filter_ = "";
+        const char *output_ = "bench_output.txt";
+        bool json_          = false;
+        int repetitions_    = 10;
+        int warmup_         = 1;
+    };
+
+    inline options &current_options ()
+    {
+        static options opts;
+        return opts;
+    }
+
+    // summary of the repetitions of one benchmark case, in nanoseconds per operation
+    struct result
+    {
+        double median_ = 0.0;
+        double p99_    = 0.0;
+        double best_   = 0.0;
+        size_t runs_   = 0;
+
+        // hardware events per operation, averaged over the repetitions
+        double cycles_        = 0.0;
+        double ipc_           = 0.0;
+        double cache_misses_  = 0.0;
+        double branch_misses_ = 0.0;
+        bool hardware_        = false;
+    };
+
+    // collects the measurements of one benchmark case
+    class state
+    {
+    public:
+        std::vector<double> samples_;
+        dstl::perf_sample counters_;
+        size_t ops_ = 0;
+
+        // runs body for the warmup runs and then once per repetition, recording
+        // the time per operation. ops is the number of operations performed by
+        // one call of body
+        template<class Body>
+        void measure (size_t ops, Body &&body)
+        {
+            const options &opts = current_options();
+            for (int i = 0; i < opts.warmup_; ++i)
+                body();
+
+            samples_.clear();
+            samples_.reserve(static_cast<size_t>(opts.repetitions_));
+            counters_ = {};
+            ops_      = 0;
+            for (int i = 0; i < opts.repetitions_; ++i)
+            {
+                counter_.reset();
+                clobber_memory();
+                counter_.start();
+                body();
+                counter_.stop();
+                clobber_memory();
+
+                const dstl::perf_sample sample = counter_.read();
+                samples_.push_back(static_cast<double>(sample.nanoseconds_) / static_cast<double>(ops));
+                counters_ += sample;
+                ops_ += ops;
+            }
+        }
+
+        result summarize () const
+        {
+            result r;
+            if (samples_.empty())
+                return r;
+
+            std::vector<double> sorted(samples_);
+            std::sort(sorted.begin(), sorted.end());
+            const size_t n = sorted.size();
+            r.runs_        = n;
+            r.best_        = sorted.front();
+            r.median_      = n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+            // nearest rank
+            r.p99_ = sorted[std::min(n - 1, (n * 99 + 99) / 100 - 1)];
+
+            const double ops = static_cast<double>(ops_);
+            r.cycles_        = static_cast<double>(counters_.cycles_) / ops;
+            r.ipc_           = counters_.ipc();
+            r.cache_misses_  = static_cast<double>(counters_.cache_misses_) / ops;
+            r.branch_misses_ = static_cast<double>(counters_.branch_misses_) / ops;
+            r.hardware_      = counters_.hardware_;
+            return r;
+        }
+
+    private:
+        dstl::perf_counter counter_;
+    };
+
+    using bench_func = void (*) (state &);
+
+    struct bench_case
+    {
+        const char *name_;
+        bench_func func_;
+    };
+
+    inline std::vector<bench_case> &registry ()
+    {
+        static std::vector<bench_case> cases;
+        return cases;
+    }
+
+    struct registrar
+    {
+        registrar (const char *name, bench_func func) { registry().push_back({name, func}); }
+    };
+
+    // parses the command line into current_options, returns false on an unknown argument
+    inline bool parse_options (int argc, char **argv)
+    {
+        options &opts = current_options();
+        for (int i = 1; i < argc; ++i)
+        {
+            const char *arg = argv[i];
+            auto value      = [arg] (const char *key) -> const char * {
+                const size_t len = std::strlen(key);
+                return std::strncmp(arg, key, len) == 0 ? arg + len : nullptr;
+            };
+
+            if (const char *v = value("--filter="))
+                opts.filter_ = v;
+            else if (const char *v = value("--output="))
+                opts.output_ = v;
+            else if (const char *v = value("--repetitions="))
+                opts.repetitions_ = std::max(1, std::atoi(v));
+            else if (const char *v = value("--warmup="))
+                opts.warmup_ = std::max(0, std::atoi(v));
+            else if (const char *v = value("--format="))
+                opts.json_ = std::strcmp(v, "json") == 0;
+            else
+                return false;
+        }
+        return true;
+    }
+
+    inline int run_all (int argc, char **argv)
+    {
+        if (!parse_options(argc, argv))
+        {
+            std::fprintf(stderr, "usage: %s [--filter=substring] [--repetitions=N] [--warmup=N] [--format=csv|json] [--output=path]\n", argv[0]);
+            return 1;
+        }
+
+        const options &opts = current_options();
+        std::FILE *out      = std::fopen(opts.output_, "w");
+        if (out == nullptr)
+        {
+            std::fprintf(stderr, "cannot open %s\n", opts.output_);
+            return 1;
+        }
+
+        const bool hardware = dstl::perf_counter().hardware();
+        if (!hardware)
+            std::printf("perf_event_open is unavailable, cycles are time stamp counter ticks\n");
+
+        if (opts.json_)
+            std::fprintf(out, "{\n  \"repetitions\": %d,\n  \"warmup\": %d,\n  \"hardware_counters\": %s,\n  \"results\": [",
+                         opts.repetitions_, opts.warmup_, hardware ? "true" : "false");
+        else
+            std::fprintf(out, "name,median_ns,p99_ns,best_ns,runs,cycles,ipc,cache_misses,branch_misses\n");
+        std::printf("%-48s %12s %12s %12s %10s %6s %10s %10s\n", "benchmark (per op)", "median ns", "p99 ns", "best ns", "cycles", "ipc", "llc miss", "br miss");
+
+        bool first = true;
+        for (const auto &c : registry())
+        {
+            if (std::strstr(c.name_, opts.filter_) == nullptr)
+                continue;
+
+            state s;
+            c.func_(s);
+            const result r = s.summarize();
+            std::printf("%-48s %12.3f %12.3f %12.3f %10.1f", c.name_, r.median_, r.p99_, r.best_, r.cycles_);
+            if (r.hardware_)
+                std::printf(" %6.2f %10.3f %10.3f\n", r.ipc_, r.cache_misses_, r.branch_misses_);
+            else
+                std::printf(" %6s %10s %10s\n", "-", "-", "-");
+
+            if (opts.json_)
+            {
+                std::fprintf(out, "%s\n    {\"name\": \"%s\", \"median_ns\": %.3f, \"p99_ns\": %.3f, \"best_ns\": %.3f, \"runs\": %zu, \"cycles\": %.1f",
+                             first ? "" : ",", c.name_, r.median_, r.p99_, r.best_, r.runs_, r.cycles_);
+                if (r.hardware_)
+                    std::fprintf(out, ", \"ipc\": %.3f, \"cache_misses\": %.4f, \"branch_misses\": %.4f}", r.ipc_, r.cache_misses_, r.branch_misses_);
+                else
+                    std::fprintf(out, ", \"ipc\": null, \"cache_misses\": null, \"branch_misses\": null}");
+            }
+            else
+            {
+                std::fprintf(out, "%s,%.3f,%.3f,%.3f,%zu,%.1f", c.name_, r.median_, r.p99_, r.best_, r.runs_, r.cycles_);
+                if (r.hardware_)
+                    std::fprintf(out, ",%.3f,%.4f,%.4f\n", r.ipc_, r.cache_misses_, r.branch_misses_);
+                else
+                    std::fprintf(out, ",,,\n");
+            }
+            first = false;
+        }
+
+        if (opts.json_)
+            std::fprintf(out, "\n  ]\n}\n");
+        std::fclose(out);
+        return 0;
+    }
+}
+
+#define BENCH_CONCAT_IMPL(a, b) a##b
+#define BENCH_CONCAT(a, b) BENCH_CONCAT_IMPL(a, b)
+
+// registers a benchmark case, the body receives a bench::state named state
+#define BENCH_CASE(name) BENCH_CASE_IMPL(name, BENCH_CONCAT(bench_func_, __COUNTER__))
+#define BENCH_CASE_IMPL(name, func)                                            \
+    static void func (bench::state &state);                                   \
+    static const bench::registrar BENCH_CONCAT(func, _registrar){name, func}; \
+    static void func ([[maybe_unused]] bench::state &state)
+
+#endif // DSTL_BENCH_H
@@ -0,0 +1,280 @@
+#
+# compile-time benchmark driver, run by the dstl.ctbench target in cmake -P mode.
+#
+# generates one translation unit per trait from CTBench.Trait.cpp.in, compiles it with
+# the trait builtins and with the library fallback (DSTL_NO_TRAIT_BUILTINS), and writes
+# the best of REPEAT compile times per trait and mode into the SUMMARY json file.
+#
+# the "baseline" entry compiles the harness and the trait header alone. the cost of a
+# trait (trait_ms) is its compile time less the one of the harness, compiled again with
+# every repeat of the trait, so that a trait is not lost in the time of the headers.
+#
+# when BASELINE names the summary of an earlier run, the run fails if the baseline entry
+# or the cost of any trait got more than TOLERANCE percent (plus a small absolute slack)
+# slower.
+#
+# inputs: COMPILER COMPILER_ID STD_FLAG INCLUDE_DIR TEMPLATE WORK_DIR SUMMARY
+#         TYPES REPEAT BASELINE TOLERANCE
+#
+
+cmake_minimum_required(VERSION 3.20)
+
+# traits to measure, as "name|type expression in T". value traits are wrapped into
+# bool_constant or integral_constant. "baseline" measures the harness alone and must
+# come first.
+# add new traits here so their cost shows up in the summary.
+set(CTBENCH_TRAITS
+    "baseline|T"
+    "is_same|bool_constant<is_same_v<T, ct_type<0>>>"
+    "is_void|bool_constant<is_void_v<T>>"
+    "is_integral|bool_constant<is_integral_v<T>>"
+    "is_floating_point|bool_constant<is_floating_point_v<T>>"
+    "is_arithmetic|bool_constant<is_arithmetic_v<T>>"
+    "is_fundamental|bool_constant<is_fundamental_v<T>>"
+    "is_scalar|bool_constant<is_scalar_v<T>>"
+    "is_object|bool_constant<is_object_v<T>>"
+    "is_compound|bool_constant<is_compound_v<T>>"
+    "is_pointer|bool_constant<is_pointer_v<T *>>"
+    "is_reference|bool_constant<is_reference_v<T &>>"
+    "is_function|bool_constant<is_function_v<T>>"
+    "is_array|bool_constant<is_array_v<T[4]>>"
+    "is_class|bool_constant<is_class_v<T>>"
+    "is_any_of|bool_constant<is_any_of_v<T, char, short, int, long, long long, float, double, ct_type<0>>>"
+    "is_signed|bool_constant<is_signed_v<T>>"
+    "is_trivially_copyable|bool_constant<is_trivially_copyable_v<T>>"
+    "is_constructible|bool_constant<is_constructible_v<T, const T &>>"
+    "is_nothrow_move_constructible|bool_constant<is_nothrow_move_constructible_v<T>>"
+    "is_assignable|bool_constant<is_assignable_v<T &, const T &>>"
+    "is_nothrow_swappable|bool_constant<is_nothrow_swappable_v<T>>"
+    "is_destructible|bool_constant<is_destructible_v<T>>"
+    "is_nothrow_destructible|bool_constant<is_nothrow_destructible_v<T>>"
+    "has_unique_object_representations|bool_constant<has_unique_object_representations_v<T>>"
+    "is_trivially_destructible|bool_constant<is_trivially_destructible_v<T>>"
+    "is_trivially_relocatable|bool_constant<is_trivially_relocatable_v<T>>"
+    "rank|integral_constant<size_t, rank_v<T[2][3]>>"
+    "extent|integral_constant<size_t, extent_v<T[2][3], 1>>"
+    "remove_cv|remove_cv_t<const volatile T>"
+    "remove_reference|remove_reference_t<T &&>"
+    "remove_cvref|remove_cvref_t<const T &>"
+    "remove_pointer|remove_pointer_t<T *const>"
+    "remove_all_extents|remove_all_extents_t<T[2][3]>"
+    "add_pointer|add_pointer_t<T &>"
+    "add_lvalue_reference|add_lvalue_reference_t<T>"
+    "decay|decay_t<const T &>"
+    "decay_array|decay_t<T[4]>"
+    "common_type|common_type_t<T, const T &>"
+    "common_reference|common_reference_t<T &, const T &>"
+    "conditional|conditional_t<is_class_v<T>, T, void>"
+    "conjunction|bool_constant<conjunction_v<is_class<T>, is_object<T>, negation<is_union<T>>, is_destructible<T>>>"
+    "disjunction|bool_constant<disjunction_v<is_void<T>, is_pointer<T>, is_union<T>, is_class<T>>>"
+    )
+
+set(CTBENCH_MODES builtin fallback)
+
+# converts a decimal number of seconds to integer milliseconds
+function (ctbench_seconds_to_ms seconds out)
+    string(REGEX MATCH "^([0-9]*)\\.?([0-9]*)$" _ "${seconds}")
+    set(whole "${CMAKE_MATCH_1}")
+    string(SUBSTRING "${CMAKE_MATCH_2}000" 0 3 fraction)
+    if (whole STREQUAL "")
+        set(whole 0)
+    endif ()
+    math(EXPR ms "${whole} * 1000 + 1${fraction} - 1000")
+    set(${out} ${ms} PARENT_SCOPE)
+endfunction ()
+
+# compiles one generated source and reports the total and template instantiation time
+function (ctbench_compile source object defines out_total out_instantiate out_count)
+    if (COMPILER_ID MATCHES "Clang")
+        set(time_flag -ftime-trace)
+    elseif (COMPILER_ID STREQUAL "GNU")
+        set(time_flag -ftime-report)
+    else ()
+        message(FATAL_ERROR "dstl.ctbench: no timing support for ${COMPILER_ID}")
+    endif ()
+
+    execute_process(
+        COMMAND "${COMPILER}" ${STD_FLAG} ${defines} "-I${INCLUDE_DIR}" ${time_flag} -c "${source}" -o "${object}"
+        RESULT_VARIABLE result
+        OUTPUT_VARIABLE output
+        ERROR_VARIABLE  report
+        )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "dstl.ctbench: failed to compile ${source}\n${report}")
+    endif ()
+
+    set(count -1)
+    if (COMPILER_ID MATCHES "Clang")
+        # the trace is written next to the object file
+        get_filename_component(trace_dir "${object}" DIRECTORY)
+        get_filename_component(trace_name "${object}" NAME_WE)
+        file(READ "${trace_dir}/${trace_name}.json" trace)
+        string(JSON events GET "${trace}" traceEvents)
+        string(JSON length LENGTH "${events}")
+        math(EXPR last "${length} - 1")
+        set(total_us 0)
+        set(instantiate_us 0)
+        set(count 0)
+        foreach (i RANGE ${last})
+            string(JSON name GET "${events}" ${i} name)
+            if (name STREQUAL "Total ExecuteCompiler")
+                string(JSON total_us GET "${events}" ${i} dur)
+            elseif (name STREQUAL "Total InstantiateClass" OR name STREQUAL "Total InstantiateFunction")
+                string(JSON dur GET "${events}" ${i} dur)
+                string(JSON calls GET "${events}" ${i} args count)
+                math(EXPR instantiate_us "${instantiate_us} + ${dur}")
+                math(EXPR count "${count} + ${calls}")
+            endif ()
+        endforeach ()
+        math(EXPR total "${total_us} / 1000")
+        math(EXPR instantiate "${instantiate_us} / 1000")
+    else ()
+        # " TOTAL : usr sys wall mem" and " template instantiation : usr (%) sys (%) wall (%) mem (%)".
+        # the user time is kept, the wall time of a compile varies with the load of the machine
+        if (NOT report MATCHES "TOTAL[ \t]*:[ \t]*([0-9.]+)")
+            message(FATAL_ERROR "dstl.ctbench: unexpected -ftime-report output\n${report}")
+        endif ()
+        ctbench_seconds_to_ms(${CMAKE_MATCH_1} total)
+        set(instantiate 0)
+        if (report MATCHES "template instantiation[ \t]*:[ \t]*([0-9.]+)")
+            ctbench_seconds_to_ms(${CMAKE_MATCH_1} instantiate)
+        endif ()
+    endif ()
+
+    set(${out_total} ${total} PARENT_SCOPE)
+    set(${out_instantiate} ${instantiate} PARENT_SCOPE)
+    set(${out_count} ${count} PARENT_SCOPE)
+endfunction ()
+
+# finds the trait_ms of a trait and mode in a summary, or an empty string
+function (ctbench_find_cost json trait mode out)
+    set(found "")
+    string(JSON length ERROR_VARIABLE missing LENGTH "${json}" results)
+    if (NOT missing AND length GREATER 0)
+        math(EXPR last "${length} - 1")
+        foreach (i RANGE ${last})
+            string(JSON old_trait GET "${json}" results ${i} trait)
+            string(JSON old_mode GET "${json}" results ${i} mode)
+            if (old_trait STREQUAL trait AND old_mode STREQUAL mode)
+                string(JSON found ERROR_VARIABLE missing GET "${json}" results ${i} trait_ms)
+                if (missing)
+                    set(found "")
+                endif ()
+            endif ()
+        endforeach ()
+    endif ()
+    set(${out} "${found}" PARENT_SCOPE)
+endfunction ()
+
+if (NOT DEFINED TYPES OR TYPES STREQUAL "")
+    set(TYPES 256)
+endif ()
+if (NOT DEFINED REPEAT OR REPEAT STREQUAL "")
+    set(REPEAT 3)
+endif ()
+if (NOT DEFINED TOLERANCE OR TOLERANCE STREQUAL "")
+    set(TOLERANCE 10)
+endif ()
+
+set(baseline_json "")
+if (BASELINE)
+    if (NOT EXISTS "${BASELINE}")
+        message(FATAL_ERROR "dstl.ctbench: baseline ${BASELINE} does not exist")
+    endif ()
+    file(READ "${BASELINE}" baseline_json)
+    string(JSON baseline_types GET "${baseline_json}" types)
+    if (NOT baseline_types EQUAL TYPES)
+        message(FATAL_ERROR "dstl.ctbench: baseline was measured with ${baseline_types} types, not ${TYPES}")
+    endif ()
+endif ()
+
+set(results "")
+set(regressions "")
+foreach (mode IN LISTS CTBENCH_MODES)
+    set(defines "")
+    if (mode STREQUAL "fallback")
+        set(defines -DDSTL_NO_TRAIT_BUILTINS)
+    endif ()
+
+    foreach (entry IN LISTS CTBENCH_TRAITS)
+        string(FIND "${entry}" "|" split)
+        string(SUBSTRING "${entry}" 0 ${split} CTBENCH_NAME)
+        math(EXPR split "${split} + 1")
+        string(SUBSTRING "${entry}" ${split} -1 CTBENCH_EXPR)
+        set(CTBENCH_TYPES ${TYPES})
+
+        set(source "${WORK_DIR}/${mode}/CTBench.${CTBENCH_NAME}.cpp")
+        set(object "${WORK_DIR}/${mode}/CTBench.${CTBENCH_NAME}.o")
+        configure_file("${TEMPLATE}" "${source}" @ONLY)
+
+        # the harness is compiled next to every trait, so that both compile times of the
+        # cost of a trait are taken under the same load of the machine
+        set(best_total "")
+        set(best_harness "")
+        foreach (run RANGE 1 ${REPEAT})
+            ctbench_compile("${source}" "${object}" "${defines}" total instantiate count)
+            if (best_total STREQUAL "" OR total LESS best_total)
+                set(best_total ${total})
+                set(best_instantiate ${instantiate})
+                set(best_count ${count})
+            endif ()
+            if (NOT CTBENCH_NAME STREQUAL "baseline")
+                ctbench_compile("${harness_source}" "${harness_object}" "${defines}" harness _ _)
+                if (best_harness STREQUAL "" OR harness LESS best_harness)
+                    set(best_harness ${harness})
+                endif ()
+            endif ()
+        endforeach ()
+
+        # the baseline entry is gated on its own time, a trait on its cost over the harness
+        if (CTBENCH_NAME STREQUAL "baseline")
+            set(harness_source "${source}")
+            set(harness_object "${object}")
+            set(cost ${best_total})
+        else ()
+            math(EXPR cost "${best_total} - ${best_harness}")
+            if (cost LESS 0)
+                set(cost 0)
+            endif ()
+        endif ()
+
+        set(gate "")
+        if (baseline_json)
+            ctbench_find_cost("${baseline_json}" ${CTBENCH_NAME} ${mode} old_cost)
+            if (NOT old_cost STREQUAL "")
+                # a cost is the difference of two compile times, 50 ms of slack keeps the
+                # gate quiet on the cheap traits
+                math(EXPR limit "${old_cost} * (100 + ${TOLERANCE}) / 100 + 50")
+                set(gate " (baseline ${old_cost} ms)")
+                if (cost GREATER limit)
+                    list(APPEND regressions "${CTBENCH_NAME} [${mode}]: ${old_cost} ms -> ${cost} ms")
+                endif ()
+            endif ()
+        endif ()
+
+        message(STATUS "${mode} ${CTBENCH_NAME}: ${best_total} ms, trait ${cost} ms, instantiation ${best_instantiate} ms${gate}")
+        if (best_count LESS 0)
+            set(best_count null)
+        endif ()
+        string(APPEND results
+            "    {\"trait\": \"${CTBENCH_NAME}\", \"mode\": \"${mode}\", \"total_ms\": ${best_total}, "
+            "\"trait_ms\": ${cost}, \"instantiate_ms\": ${best_instantiate}, \"instantiations\": ${best_count}},\n")
+    endforeach ()
+endforeach ()
+
+string(REGEX REPLACE ",\n$" "\n" results "${results}")
+file(WRITE "${SUMMARY}"
+    "{\n"
+    "  \"compiler\": \"${COMPILER_ID}\",\n"
+    "  \"types\": ${TYPES},\n"
+    "  \"repeat\": ${REPEAT},\n"
+    "  \"results\": [\n"
+    "${results}"
+    "  ]\n"
+    "}\n")
+message(STATUS "dstl.ctbench: summary written to ${SUMMARY}")
+
+if (regressions)
+    list(JOIN regressions "\n  " report)
+    message(FATAL_ERROR "dstl.ctbench: compile time regressed by more than ${TOLERANCE}%:\n  ${report}")
+endif ()
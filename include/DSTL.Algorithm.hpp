@@ -0,0 +1,1312 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Algorithm.hpp
+
+Abstract:
+    Algorithms.
+
+    sort is a pattern-defeating quicksort: an introsort that detects
+    already partitioned and nearly sorted ranges, shuffles away patterns
+    that cause unbalanced partitions and falls back to heapsort after too
+    many of them. Arithmetic keys under the default comparators are
+    partitioned in blocks with branchless comparisons, which avoids the
+    branch mispredictions of a classic Hoare partition on random input.
+
+    radix_sort is a least significant digit radix sort on 8 bit digits for
+    integral and floating point keys, optionally projected out of larger
+    elements. Keys are mapped to unsigned integers that order the same way
+    (the sign bit of signed integers is flipped, negative floats are
+    complemented), and digits shared by every key are skipped. Large
+    ranges are first split on their most significant digit so that the
+    remaining passes stay in cache. sort of a large contiguous range of
+    such keys under std::less or std::greater switches to it.
+
+    find, contains, count, mismatch and equal over contiguous ranges of
+    arithmetic types under the default predicate compare 16 (SSE2) or 32
+    (AVX2) bytes per instruction and turn the lane results into a bit mask;
+    find tests four vectors per branch. Compilers leave such early exit
+    loops scalar. equal of two contiguous ranges of a bytewise comparable
+    type is a single memcmp.
+
+    lower_bound and upper_bound halve random access ranges without
+    branching on the comparison: the next half is picked arithmetically
+    (first += comparison * half), so a search costs no branch
+    mispredictions. GCC turns the usual ?: formulation into a branch.
+
+--*/
+
+#ifndef DSTL_ALGORITHM_H
+#define DSTL_ALGORITHM_H
+
+namespace detail
+{
+    // ranges below this size are insertion sorted
+    inline constexpr ptrdiff_t insertion_sort_threshold = 24;
+
+    // ranges above this size take the pseudo median of nine as pivot
+    inline constexpr ptrdiff_t ninther_threshold = 128;
+
+    // partial insertion sort gives up after this many element moves
+    inline constexpr size_t partial_insertion_sort_limit = 8;
+
+    // elements examined per block by the branchless partition, must fit an unsigned char offset
+    inline constexpr size_t partition_block_size = 64;
+
+    // whether comparing T with Compare is a plain < or > on an arithmetic value,
+    // which the branchless partition turns into flag arithmetic
+    template<class T, class Compare>
+    inline constexpr bool is_branchless_sort_v =
+        is_arithmetic_v<T> && is_any_of_v<Compare, std::less<T>, std::less<>, std::greater<T>, std::greater<>>;
+
+    template<class It, class Compare>
+    void insertion_sort (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+        if (begin == end)
+            return;
+
+        for (It cur = begin + 1; cur != end; ++cur)
+        {
+            It sift   = cur;
+            It sift_1 = cur - 1;
+            if (comp(*sift, *sift_1))
+            {
+                T tmp = std::move(*sift);
+                do
+                {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // insertion sort that relies on an element not greater than any in [begin, end) sitting before begin
+    template<class It, class Compare>
+    void unguarded_insertion_sort (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+        if (begin == end)
+            return;
+
+        for (It cur = begin + 1; cur != end; ++cur)
+        {
+            It sift   = cur;
+            It sift_1 = cur - 1;
+            if (comp(*sift, *sift_1))
+            {
+                T tmp = std::move(*sift);
+                do
+                {
+                    *sift-- = std::move(*sift_1);
+                } while (comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+            }
+        }
+    }
+
+    // insertion sorts [begin, end) unless that takes more than partial_insertion_sort_limit
+    // moves, returns whether the range ended up sorted
+    template<class It, class Compare>
+    bool partial_insertion_sort (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+        if (begin == end)
+            return true;
+
+        size_t moves = 0;
+        for (It cur = begin + 1; cur != end; ++cur)
+        {
+            if (moves > partial_insertion_sort_limit)
+                return false;
+
+            It sift   = cur;
+            It sift_1 = cur - 1;
+            if (comp(*sift, *sift_1))
+            {
+                T tmp = std::move(*sift);
+                do
+                {
+                    *sift-- = std::move(*sift_1);
+                } while (sift != begin && comp(tmp, *--sift_1));
+                *sift = std::move(tmp);
+                moves += static_cast<size_t>(cur - sift);
+            }
+        }
+        return true;
+    }
+
+    template<class It, class Compare>
+    void sort2 (It a, It b, Compare &comp)
+    {
+        if (comp(*b, *a))
+            std::iter_swap(a, b);
+    }
+
+    template<class It, class Compare>
+    void sort3 (It a, It b, It c, Compare &comp)
+    {
+        sort2(a, b, comp);
+        sort2(b, c, comp);
+        sort2(a, b, comp);
+    }
+
+    // swaps the elements at first + offsets_l[i] and last - offsets_r[i]. when the counts
+    // differ the elements are rotated through a cyclic permutation, which needs fewer moves
+    template<class It>
+    void swap_offsets (It first, It last, const unsigned char *offsets_l, const unsigned char *offsets_r, size_t count, bool use_swaps)
+    {
+        using T = std::iter_value_t<It>;
+        if (use_swaps)
+        {
+            for (size_t i = 0; i < count; ++i)
+                std::iter_swap(first + offsets_l[i], last - offsets_r[i]);
+        }
+        else if (count > 0)
+        {
+            It l  = first + offsets_l[0];
+            It r  = last - offsets_r[0];
+            T tmp = std::move(*l);
+            *l    = std::move(*r);
+            for (size_t i = 1; i < count; ++i)
+            {
+                l  = first + offsets_l[i];
+                *r = std::move(*l);
+                r  = last - offsets_r[i];
+                *l = std::move(*r);
+            }
+            *r = std::move(tmp);
+        }
+    }
+
+    // partitions [begin, end) around the pivot at begin into elements less than the pivot
+    // and elements not less than it. the comparisons of each block are recorded as offsets
+    // without branching on their result. returns the pivot position and whether the range
+    // was already partitioned
+    template<class It, class Compare>
+    std::pair<It, bool> partition_right_branchless (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+
+        T pivot(std::move(*begin));
+        It first = begin;
+        It last  = end;
+
+        // the median of three pivot selection guarantees an element not less than the pivot
+        while (comp(*++first, pivot))
+            ;
+        if (first - 1 == begin)
+        {
+            while (first < last && !comp(*--last, pivot))
+                ;
+        }
+        else
+        {
+            while (!comp(*--last, pivot))
+                ;
+        }
+
+        const bool already_partitioned = first >= last;
+        if (!already_partitioned)
+        {
+            std::iter_swap(first, last);
+            ++first;
+
+            alignas(64) unsigned char offsets_l[partition_block_size];
+            alignas(64) unsigned char offsets_r[partition_block_size];
+            It offsets_l_base = first;
+            It offsets_r_base = last;
+            size_t num_l      = 0;
+            size_t num_r      = 0;
+            size_t start_l    = 0;
+            size_t start_r    = 0;
+
+            while (first < last)
+            {
+                // fill the empty offset buffers, splitting the rest evenly when both are empty
+                const auto num_unknown   = static_cast<size_t>(last - first);
+                const size_t left_split  = num_l == 0 ? (num_r == 0 ? num_unknown / 2 : num_unknown) : 0;
+                const size_t right_split = num_r == 0 ? num_unknown - left_split : 0;
+
+                if (left_split >= partition_block_size)
+                {
+                    for (size_t i = 0; i < partition_block_size;)
+                    {
+                        for (size_t j = 0; j < 8; ++j, ++i, ++first)
+                        {
+                            offsets_l[num_l] = static_cast<unsigned char>(i);
+                            num_l += !comp(*first, pivot);
+                        }
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < left_split; ++i, ++first)
+                    {
+                        offsets_l[num_l] = static_cast<unsigned char>(i);
+                        num_l += !comp(*first, pivot);
+                    }
+                }
+
+                if (right_split >= partition_block_size)
+                {
+                    for (size_t i = 0; i < partition_block_size;)
+                    {
+                        for (size_t j = 0; j < 8; ++j)
+                        {
+                            offsets_r[num_r] = static_cast<unsigned char>(++i);
+                            num_r += comp(*--last, pivot);
+                        }
+                    }
+                }
+                else
+                {
+                    for (size_t i = 0; i < right_split;)
+                    {
+                        offsets_r[num_r] = static_cast<unsigned char>(++i);
+                        num_r += comp(*--last, pivot);
+                    }
+                }
+
+                const size_t count = num_l < num_r ? num_l : num_r;
+                swap_offsets(offsets_l_base, offsets_r_base, offsets_l + start_l, offsets_r + start_r, count, num_l == num_r);
+                num_l -= count;
+                num_r -= count;
+                start_l += count;
+                start_r += count;
+
+                if (num_l == 0)
+                {
+                    start_l        = 0;
+                    offsets_l_base = first;
+                }
+                if (num_r == 0)
+                {
+                    start_r        = 0;
+                    offsets_r_base = last;
+                }
+            }
+
+            // at most one buffer has leftovers, move them to the partition boundary
+            if (num_l != 0)
+            {
+                while (num_l--)
+                    std::iter_swap(offsets_l_base + offsets_l[start_l + num_l], --last);
+                first = last;
+            }
+            if (num_r != 0)
+            {
+                while (num_r--)
+                {
+                    std::iter_swap(offsets_r_base - offsets_r[start_r + num_r], first);
+                    ++first;
+                }
+                last = first;
+            }
+        }
+
+        It pivot_pos = first - 1;
+        *begin       = std::move(*pivot_pos);
+        *pivot_pos   = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    // same contract as partition_right_branchless, with a classic Hoare partition
+    template<class It, class Compare>
+    std::pair<It, bool> partition_right (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+
+        T pivot(std::move(*begin));
+        It first = begin;
+        It last  = end;
+
+        while (comp(*++first, pivot))
+            ;
+        if (first - 1 == begin)
+        {
+            while (first < last && !comp(*--last, pivot))
+                ;
+        }
+        else
+        {
+            while (!comp(*--last, pivot))
+                ;
+        }
+
+        const bool already_partitioned = first >= last;
+        while (first < last)
+        {
+            std::iter_swap(first, last);
+            while (comp(*++first, pivot))
+                ;
+            while (!comp(*--last, pivot))
+                ;
+        }
+
+        It pivot_pos = first - 1;
+        *begin       = std::move(*pivot_pos);
+        *pivot_pos   = std::move(pivot);
+        return {pivot_pos, already_partitioned};
+    }
+
+    // partitions into elements equal to the pivot at begin and elements greater than it,
+    // used when the element before begin equals the pivot. returns the pivot position
+    template<class It, class Compare>
+    It partition_left (It begin, It end, Compare &comp)
+    {
+        using T = std::iter_value_t<It>;
+
+        T pivot(std::move(*begin));
+        It first = begin;
+        It last  = end;
+
+        while (comp(pivot, *--last))
+            ;
+        if (last + 1 == end)
+        {
+            while (first < last && !comp(pivot, *++first))
+                ;
+        }
+        else
+        {
+            while (!comp(pivot, *++first))
+                ;
+        }
+
+        while (first < last)
+        {
+            std::iter_swap(first, last);
+            while (comp(pivot, *--last))
+                ;
+            while (!comp(pivot, *++first))
+                ;
+        }
+
+        It pivot_pos = last;
+        *begin       = std::move(*pivot_pos);
+        *pivot_pos   = std::move(pivot);
+        return pivot_pos;
+    }
+
+    template<size_t Size> struct radix_unsigned;
+    template<> struct radix_unsigned<1> { using type = unsigned char; };
+    template<> struct radix_unsigned<2> { using type = unsigned short; };
+    template<> struct radix_unsigned<4> { using type = uint32_t; };
+    template<> struct radix_unsigned<8> { using type = uint64_t; };
+
+    // whether radix_sort can order keys of type K
+    template<class K>
+    inline constexpr bool is_radix_key_v =
+        (is_integral_v<K> && (sizeof(K) == 1 || sizeof(K) == 2 || sizeof(K) == 4 || sizeof(K) == 8)) ||
+        (is_floating_point_v<K> && (sizeof(K) == 4 || sizeof(K) == 8) && std::numeric_limits<K>::is_iec559);
+
+    // maps a key to an unsigned integer of the same size that orders the same way
+    template<class K>
+    auto radix_key (K key) noexcept
+    {
+        using U              = typename radix_unsigned<sizeof(K)>::type;
+        constexpr U sign_bit = static_cast<U>(U(1) << (sizeof(U) * 8 - 1));
+        if constexpr (is_floating_point_v<K>)
+        {
+            const U bits = std::bit_cast<U>(key);
+            return static_cast<U>(bits & sign_bit ? ~bits : bits | sign_bit);
+        }
+        else if constexpr (static_cast<K>(-1) < static_cast<K>(0))
+        {
+            return static_cast<U>(static_cast<U>(key) ^ sign_bit);
+        }
+        else
+        {
+            return static_cast<U>(key);
+        }
+    }
+
+    // ranges above this size are split on their most significant digit first, so that the
+    // remaining passes run on buckets that fit in cache
+    inline constexpr size_t radix_msd_threshold = size_t(1) << 16;
+
+    // one row of 256 digit counts per pass
+    using radix_histogram = size_t (*)[256];
+
+    // counts digits [0, passes) of the keys of n elements at data
+    template<class T, class KeyOf>
+    void radix_count (const T *data, size_t n, KeyOf &key_of, radix_histogram counts, size_t passes) noexcept
+    {
+        std::memset(counts, 0, passes * sizeof(*counts));
+        for (size_t i = 0; i < n; ++i)
+        {
+            const auto key = key_of(data[i]);
+            for (size_t p = 0; p < passes; ++p)
+                ++counts[p][(key >> (p * 8)) & 0xFF];
+        }
+    }
+
+    // stably relocates the n elements at src to dst ordered by digit p of their keys
+    template<class T, class KeyOf>
+    void radix_scatter (T *src, T *dst, size_t n, KeyOf &key_of, const size_t *count, size_t p) noexcept
+    {
+        // slots are pointers rather than offsets, a store through dst may alias a size_t but not a T *
+        T *slots[256];
+        T *slot = dst;
+        for (size_t b = 0; b < 256; ++b)
+        {
+            slots[b] = slot;
+            slot += count[b];
+        }
+
+        for (size_t i = 0; i < n; ++i)
+        {
+            T *target = slots[(key_of(src[i]) >> (p * 8)) & 0xFF]++;
+            if constexpr (is_trivially_copyable_v<T>)
+                std::memcpy(static_cast<void *>(target), static_cast<const void *>(src + i), sizeof(T));
+            else
+                ::new (static_cast<void *>(target)) T(std::move(src[i]));
+        }
+        dstl::destroy(src, src + n);
+    }
+
+    // sorts the n elements at src by digits [0, passes) of their keys, ping-ponging with the
+    // buffer at dst and skipping digits shared by every key. returns where the result lives
+    template<class T, class KeyOf>
+    T *radix_lsd (T *src, T *dst, size_t n, KeyOf &key_of, radix_histogram counts, size_t passes) noexcept
+    {
+        for (size_t p = 0; p < passes; ++p)
+        {
+            if (counts[p][(key_of(*src) >> (p * 8)) & 0xFF] == n)
+                continue;
+            radix_scatter(src, dst, n, key_of, counts[p], p);
+            std::swap(src, dst);
+        }
+        return src;
+    }
+
+    // sorts n elements at data by the unsigned keys key_of returns. stable, input that is
+    // already in order or strictly in reverse order takes a single pass
+    template<class T, class KeyOf>
+    void radix_sort_keys (T *data, size_t n, KeyOf key_of)
+    {
+        using U = decltype(key_of(*data));
+        if (n < 2)
+            return;
+
+        // the histograms of all digits in a single read of the input
+        size_t counts[sizeof(U)][256] = {};
+        bool ascending                = true;
+        bool descending               = true;
+        U prev                        = key_of(data[0]);
+        for (size_t i = 0; i < n; ++i)
+        {
+            const U key = key_of(data[i]);
+            ascending   = ascending && prev <= key;
+            descending  = descending && (i == 0 || prev > key);
+            prev        = key;
+            for (size_t p = 0; p < sizeof(U); ++p)
+                ++counts[p][(key >> (p * 8)) & 0xFF];
+        }
+        if (ascending)
+            return;
+        if (descending)
+        {
+            std::reverse(data, data + n);
+            return;
+        }
+
+        // the most significant digit that tells keys apart
+        size_t top = sizeof(U) - 1;
+        while (top > 0 && counts[top][(key_of(*data) >> (top * 8)) & 0xFF] == n)
+            --top;
+
+        T *buffer = allocate_n<T>(n);
+        if (n > radix_msd_threshold && top >= 2)
+        {
+            radix_scatter(data, buffer, n, key_of, counts[top], top);
+            size_t offset = 0;
+            for (size_t b = 0; b < 256; ++b)
+            {
+                const size_t count = counts[top][b];
+                T *bucket          = buffer + offset;
+                if (count > 1)
+                {
+                    radix_count(bucket, count, key_of, counts, top);
+                    bucket = radix_lsd(bucket, data + offset, count, key_of, counts, top);
+                }
+                if (bucket != data + offset)
+                    dstl::uninitialized_relocate(bucket, bucket + count, data + offset);
+                offset += count;
+            }
+        }
+        else
+        {
+            T *result = radix_lsd(data, buffer, n, key_of, counts, top + 1);
+            if (result != data)
+                dstl::uninitialized_relocate(result, result + n, data);
+        }
+        deallocate_n(buffer, n);
+    }
+
+    template<bool Descending, class T, class Proj>
+    void radix_sort_contiguous (T *data, size_t n, Proj &proj)
+    {
+        using K = remove_cvref_t<decltype(std::invoke(proj, *data))>;
+        static_assert(is_radix_key_v<K>, "radix_sort needs an integral or floating point key");
+        static_assert(is_trivially_copyable_v<T> || noexcept(T(declval<T>())),
+                      "radix_sort relocates the elements, their move constructor must not throw");
+
+        detail::radix_sort_keys(data, n, [&proj] (const T &elem) {
+            const auto key = radix_key(static_cast<K>(std::invoke(proj, elem)));
+            return Descending ? static_cast<decltype(key)>(~key) : key;
+        });
+    }
+
+    // sort hands ranges of radix keys above this size per byte of key to radix_sort,
+    // each byte costs radix_sort a pass over the range
+    inline constexpr ptrdiff_t radix_sort_threshold_per_byte = 512;
+
+    // whether sort may hand a range of T compared with Compare to radix_sort,
+    // and whether that is a descending sort
+    template<class T, class Compare>
+    inline constexpr bool is_radix_ascending_v = is_radix_key_v<T> && is_any_of_v<Compare, std::less<T>, std::less<>>;
+    template<class T, class Compare>
+    inline constexpr bool is_radix_descending_v = is_radix_key_v<T> && is_any_of_v<Compare, std::greater<T>, std::greater<>>;
+
+    template<bool Branchless, class It, class Compare>
+    void pdqsort_loop (It begin, It end, Compare &comp, int bad_allowed, bool leftmost)
+    {
+        while (true)
+        {
+            const ptrdiff_t size = end - begin;
+            if (size < insertion_sort_threshold)
+            {
+                if (leftmost)
+                    insertion_sort(begin, end, comp);
+                else
+                    unguarded_insertion_sort(begin, end, comp);
+                return;
+            }
+
+            // move the pivot to begin
+            const ptrdiff_t s2 = size / 2;
+            if (size > ninther_threshold)
+            {
+                sort3(begin, begin + s2, end - 1, comp);
+                sort3(begin + 1, begin + (s2 - 1), end - 2, comp);
+                sort3(begin + 2, begin + (s2 + 1), end - 3, comp);
+                sort3(begin + (s2 - 1), begin + s2, begin + (s2 + 1), comp);
+                std::iter_swap(begin, begin + s2);
+            }
+            else
+            {
+                sort3(begin + s2, begin, end - 1, comp);
+            }
+
+            // the element before begin is the pivot of an enclosing partition. if it equals
+            // the new pivot, every element equal to it goes left and needs no more sorting
+            if (!leftmost && !comp(*(begin - 1), *begin))
+            {
+                begin = partition_left(begin, end, comp) + 1;
+                continue;
+            }
+
+            const auto [pivot_pos, already_partitioned] =
+                Branchless ? partition_right_branchless(begin, end, comp) : partition_right(begin, end, comp);
+
+            const ptrdiff_t l_size = pivot_pos - begin;
+            const ptrdiff_t r_size = end - (pivot_pos + 1);
+            if (l_size < size / 8 || r_size < size / 8)
+            {
+                // too many bad partitions, switch to the guaranteed O(n log n) heapsort
+                if (--bad_allowed == 0)
+                {
+                    std::make_heap(begin, end, comp);
+                    std::sort_heap(begin, end, comp);
+                    return;
+                }
+
+                // break up patterns that may be causing the bad partition
+                if (l_size >= insertion_sort_threshold)
+                {
+                    std::iter_swap(begin, begin + l_size / 4);
+                    std::iter_swap(pivot_pos - 1, pivot_pos - l_size / 4);
+                    if (l_size > ninther_threshold)
+                    {
+                        std::iter_swap(begin + 1, begin + (l_size / 4 + 1));
+                        std::iter_swap(begin + 2, begin + (l_size / 4 + 2));
+                        std::iter_swap(pivot_pos - 2, pivot_pos - (l_size / 4 + 1));
+                        std::iter_swap(pivot_pos - 3, pivot_pos - (l_size / 4 + 2));
+                    }
+                }
+                if (r_size >= insertion_sort_threshold)
+                {
+                    std::iter_swap(pivot_pos + 1, pivot_pos + (1 + r_size / 4));
+                    std::iter_swap(end - 1, end - r_size / 4);
+                    if (r_size > ninther_threshold)
+                    {
+                        std::iter_swap(pivot_pos + 2, pivot_pos + (2 + r_size / 4));
+                        std::iter_swap(pivot_pos + 3, pivot_pos + (3 + r_size / 4));
+                        std::iter_swap(end - 2, end - (1 + r_size / 4));
+                        std::iter_swap(end - 3, end - (2 + r_size / 4));
+                    }
+                }
+            }
+            else if (already_partitioned && partial_insertion_sort(begin, pivot_pos, comp) &&
+                     partial_insertion_sort(pivot_pos + 1, end, comp))
+            {
+                // a well balanced, already partitioned range is likely sorted
+                return;
+            }
+
+            // recurse into the left part, loop on the right one
+            pdqsort_loop<Branchless>(begin, pivot_pos, comp, bad_allowed, leftmost);
+            begin    = pivot_pos + 1;
+            leftmost = false;
+        }
+    }
+}
+
+// sorts [first, last) by the key proj returns for each element, ascending, not stable.
+// the key must be an integral or floating point type, first must be a contiguous iterator
+template<class RandomIt, class Proj = std::identity>
+void radix_sort (RandomIt first, RandomIt last, Proj proj = {})
+{
+    static_assert(std::contiguous_iterator<RandomIt>, "radix_sort needs contiguous storage");
+    detail::radix_sort_contiguous<false>(std::to_address(first), static_cast<size_t>(last - first), proj);
+}
+
+// sorts [first, last) with comp, not stable. O(n log n) comparisons in the worst case
+template<class RandomIt, class Compare>
+void sort (RandomIt first, RandomIt last, Compare comp)
+{
+    using T = std::iter_value_t<RandomIt>;
+    if (last - first < 2)
+        return;
+
+    if constexpr (std::contiguous_iterator<RandomIt> && (detail::is_radix_ascending_v<T, Compare> || detail::is_radix_descending_v<T, Compare>))
+    {
+        if (last - first > detail::radix_sort_threshold_per_byte * static_cast<ptrdiff_t>(sizeof(T)))
+        {
+            std::identity proj;
+            detail::radix_sort_contiguous<detail::is_radix_descending_v<T, Compare>>(std::to_address(first), static_cast<size_t>(last - first), proj);
+            return;
+        }
+    }
+    const int bad_allowed = static_cast<int>(std::bit_width(static_cast<size_t>(last - first)));
+    detail::pdqsort_loop<detail::is_branchless_sort_v<T, Compare>>(first, last, comp, bad_allowed, true);
+}
+
+template<class RandomIt>
+void sort (RandomIt first, RandomIt last)
+{
+    dstl::sort(first, last, std::less<>());
+}
+
+namespace detail
+{
+    template<class Pred, class T>
+    inline constexpr bool is_default_equal_v = is_same_v<Pred, std::equal_to<T>> || is_same_v<Pred, std::equal_to<>>;
+
+    // whether [first1, first1 + n) and [first2, first2 + n) compare as their bytes
+    template<class It1, class It2, class Pred>
+    inline constexpr bool is_memcmp_equal_v = std::contiguous_iterator<It1> && std::contiguous_iterator<It2> &&
+                                              is_same_v<std::iter_value_t<It1>, std::iter_value_t<It2>> &&
+                                              is_bytewise_comparable_v<std::iter_value_t<It1>> &&
+                                              is_default_equal_v<Pred, std::iter_value_t<It1>>;
+
+    template<class It1, class It2>
+    bool memcmp_equal (It1 first1, It2 first2, size_t n) noexcept
+    {
+        return n == 0 || std::memcmp(std::to_address(first1), std::to_address(first2), n * sizeof(std::iter_value_t<It1>)) == 0;
+    }
+
+    // the element types the search kernels compare as vector lanes
+    template<class T>
+    inline constexpr bool is_simd_scalar_v = (is_integral_v<T> && (sizeof(T) == 1 || sizeof(T) == 2 || sizeof(T) == 4 || sizeof(T) == 8)) ||
+                                             is_same_v<T, float> || is_same_v<T, double>;
+
+    // whether searching [first, last) for a value of type T can run on the vector kernels. integral
+    // elements are only searched for integral values and floating point ones for floating point
+    // values, so that the needle equals every matching element as an element
+    template<class It, class T>
+    inline constexpr bool is_simd_find_v = std::contiguous_iterator<It> && is_simd_scalar_v<std::iter_value_t<It>> &&
+                                           is_arithmetic_v<T> && is_integral_v<std::iter_value_t<It>> == is_integral_v<T>;
+
+    template<class It1, class It2, class Pred>
+    inline constexpr bool is_simd_mismatch_v = std::contiguous_iterator<It1> && std::contiguous_iterator<It2> &&
+                                               is_same_v<std::iter_value_t<It1>, std::iter_value_t<It2>> &&
+                                               is_simd_scalar_v<std::iter_value_t<It1>> &&
+                                               is_default_equal_v<Pred, std::iter_value_t<It1>>;
+
+    // whether sorted arrays of T ordered by Compare can be searched by simd_rank
+    template<class T, class Compare>
+    inline constexpr bool is_simd_rank_v = is_simd_scalar_v<T> && !is_same_v<T, bool> && is_any_of_v<Compare, std::less<T>, std::less<>>;
+
+    // converts value to the element type T. false when no T compares equal to value,
+    // e.g. 300 for unsigned char or 0.1 for float
+    template<class T, class U>
+    bool simd_needle (const U &value, T &needle) noexcept
+    {
+        using common = common_type_t<T, U>;
+        needle       = static_cast<T>(static_cast<common>(value));
+        return static_cast<common>(needle) == static_cast<common>(value);
+    }
+
+#if defined(DSTL_AVX2)
+    using simd_vector = __m256i;
+
+    inline simd_vector simd_load (const void *p) noexcept { return _mm256_loadu_si256(static_cast<const __m256i *>(p)); }
+    inline simd_vector simd_or (simd_vector a, simd_vector b) noexcept { return _mm256_or_si256(a, b); }
+    inline simd_vector simd_and (simd_vector a, simd_vector b) noexcept { return _mm256_and_si256(a, b); }
+    inline uint32_t simd_byte_mask (simd_vector v) noexcept { return static_cast<uint32_t>(_mm256_movemask_epi8(v)); }
+    inline simd_vector simd_zero () noexcept { return _mm256_setzero_si256(); }
+    inline simd_vector simd_sub_bytes (simd_vector a, simd_vector b) noexcept { return _mm256_sub_epi8(a, b); }
+
+    // the sum of the bytes of v
+    inline size_t simd_sum_bytes (simd_vector v) noexcept
+    {
+        const __m256i sums = _mm256_sad_epu8(v, _mm256_setzero_si256());
+        const __m128i half = _mm_add_epi64(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+        return static_cast<size_t>(_mm_cvtsi128_si32(half)) + static_cast<size_t>(_mm_extract_epi16(half, 4));
+    }
+
+    template<class T>
+    simd_vector simd_splat (T value) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm256_castps_si256(_mm256_set1_ps(value));
+        else if constexpr (is_same_v<T, double>)
+            return _mm256_castpd_si256(_mm256_set1_pd(value));
+        else if constexpr (sizeof(T) == 1)
+            return _mm256_set1_epi8(static_cast<char>(value));
+        else if constexpr (sizeof(T) == 2)
+            return _mm256_set1_epi16(static_cast<short>(value));
+        else if constexpr (sizeof(T) == 4)
+            return _mm256_set1_epi32(static_cast<int>(value));
+        else
+            return _mm256_set1_epi64x(static_cast<long long>(value));
+    }
+
+    // all ones in the lanes where a and b compare equal as T
+    template<class T>
+    simd_vector simd_equal (simd_vector a, simd_vector b) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_EQ_OQ));
+        else if constexpr (is_same_v<T, double>)
+            return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_EQ_OQ));
+        else if constexpr (sizeof(T) == 1)
+            return _mm256_cmpeq_epi8(a, b);
+        else if constexpr (sizeof(T) == 2)
+            return _mm256_cmpeq_epi16(a, b);
+        else if constexpr (sizeof(T) == 4)
+            return _mm256_cmpeq_epi32(a, b);
+        else
+            return _mm256_cmpeq_epi64(a, b);
+    }
+
+    // all ones in the lanes where a is less than b as T. unsigned lanes are compared as signed
+    // ones after flipping their sign bits
+    template<class T>
+    simd_vector simd_less (simd_vector a, simd_vector b) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm256_castps_si256(_mm256_cmp_ps(_mm256_castsi256_ps(a), _mm256_castsi256_ps(b), _CMP_LT_OQ));
+        else if constexpr (is_same_v<T, double>)
+            return _mm256_castpd_si256(_mm256_cmp_pd(_mm256_castsi256_pd(a), _mm256_castsi256_pd(b), _CMP_LT_OQ));
+        else
+        {
+            if constexpr (is_unsigned_v<T>)
+            {
+                const simd_vector sign = simd_splat(static_cast<T>(T(1) << (sizeof(T) * 8 - 1)));
+                a                      = _mm256_xor_si256(a, sign);
+                b                      = _mm256_xor_si256(b, sign);
+            }
+            if constexpr (sizeof(T) == 1)
+                return _mm256_cmpgt_epi8(b, a);
+            else if constexpr (sizeof(T) == 2)
+                return _mm256_cmpgt_epi16(b, a);
+            else if constexpr (sizeof(T) == 4)
+                return _mm256_cmpgt_epi32(b, a);
+            else
+                return _mm256_cmpgt_epi64(b, a);
+        }
+    }
+#elif defined(DSTL_SSE2)
+    using simd_vector = __m128i;
+
+    inline simd_vector simd_load (const void *p) noexcept { return _mm_loadu_si128(static_cast<const __m128i *>(p)); }
+    inline simd_vector simd_or (simd_vector a, simd_vector b) noexcept { return _mm_or_si128(a, b); }
+    inline simd_vector simd_and (simd_vector a, simd_vector b) noexcept { return _mm_and_si128(a, b); }
+    inline uint32_t simd_byte_mask (simd_vector v) noexcept { return static_cast<uint32_t>(_mm_movemask_epi8(v)); }
+    inline simd_vector simd_zero () noexcept { return _mm_setzero_si128(); }
+    inline simd_vector simd_sub_bytes (simd_vector a, simd_vector b) noexcept { return _mm_sub_epi8(a, b); }
+
+    inline size_t simd_sum_bytes (simd_vector v) noexcept
+    {
+        const __m128i sums = _mm_sad_epu8(v, _mm_setzero_si128());
+        return static_cast<size_t>(_mm_cvtsi128_si32(sums)) + static_cast<size_t>(_mm_extract_epi16(sums, 4));
+    }
+
+    template<class T>
+    simd_vector simd_splat (T value) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm_castps_si128(_mm_set1_ps(value));
+        else if constexpr (is_same_v<T, double>)
+            return _mm_castpd_si128(_mm_set1_pd(value));
+        else if constexpr (sizeof(T) == 1)
+            return _mm_set1_epi8(static_cast<char>(value));
+        else if constexpr (sizeof(T) == 2)
+            return _mm_set1_epi16(static_cast<short>(value));
+        else if constexpr (sizeof(T) == 4)
+            return _mm_set1_epi32(static_cast<int>(value));
+        else
+            return _mm_set1_epi64x(static_cast<long long>(value));
+    }
+
+    template<class T>
+    simd_vector simd_equal (simd_vector a, simd_vector b) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+        else if constexpr (is_same_v<T, double>)
+            return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+        else if constexpr (sizeof(T) == 1)
+            return _mm_cmpeq_epi8(a, b);
+        else if constexpr (sizeof(T) == 2)
+            return _mm_cmpeq_epi16(a, b);
+        else if constexpr (sizeof(T) == 4)
+            return _mm_cmpeq_epi32(a, b);
+        else
+        {
+            // SSE2 has no 64 bit compare, both 32 bit halves must match
+            const __m128i halves = _mm_cmpeq_epi32(a, b);
+            return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+        }
+    }
+
+    template<class T>
+    simd_vector simd_less (simd_vector a, simd_vector b) noexcept
+    {
+        if constexpr (is_same_v<T, float>)
+            return _mm_castps_si128(_mm_cmplt_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+        else if constexpr (is_same_v<T, double>)
+            return _mm_castpd_si128(_mm_cmplt_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+        else
+        {
+            if constexpr (is_unsigned_v<T>)
+            {
+                const simd_vector sign = simd_splat(static_cast<T>(T(1) << (sizeof(T) * 8 - 1)));
+                a                      = _mm_xor_si128(a, sign);
+                b                      = _mm_xor_si128(b, sign);
+            }
+            if constexpr (sizeof(T) == 1)
+                return _mm_cmplt_epi8(a, b);
+            else if constexpr (sizeof(T) == 2)
+                return _mm_cmplt_epi16(a, b);
+            else if constexpr (sizeof(T) == 4)
+                return _mm_cmplt_epi32(a, b);
+            else
+            {
+                // SSE2 has no 64 bit compare: the high halves decide unless they are equal,
+                // then the low halves decide as unsigned numbers
+                const __m128i low_sign  = _mm_set1_epi64x(0x80000000);
+                const __m128i high_less = _mm_cmplt_epi32(a, b);
+                const __m128i equal     = _mm_cmpeq_epi32(a, b);
+                const __m128i low_less  = _mm_cmplt_epi32(_mm_xor_si128(a, low_sign), _mm_xor_si128(b, low_sign));
+                const __m128i less      = _mm_or_si128(high_less, _mm_and_si128(equal, _mm_shuffle_epi32(low_less, _MM_SHUFFLE(2, 2, 0, 0))));
+                return _mm_shuffle_epi32(less, _MM_SHUFFLE(3, 3, 1, 1));
+            }
+        }
+    }
+#endif
+
+#if defined(DSTL_SSE2)
+    inline constexpr size_t simd_width = sizeof(simd_vector);
+
+    // one bit per byte of a vector, the value of simd_byte_mask when every lane matched
+    inline constexpr uint32_t simd_full_mask = static_cast<uint32_t>((uint64_t(1) << simd_width) - 1);
+#endif
+
+    template<class T>
+    const T *simd_find (const T *first, const T *last, T value) noexcept
+    {
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes   = simd_width / sizeof(T);
+        const simd_vector needle = simd_splat(value);
+        // four vectors per branch until one of them holds the value, the loop below then finds which
+        while (static_cast<size_t>(last - first) >= 4 * lanes)
+        {
+            const simd_vector m0 = simd_equal<T>(simd_load(first), needle);
+            const simd_vector m1 = simd_equal<T>(simd_load(first + lanes), needle);
+            const simd_vector m2 = simd_equal<T>(simd_load(first + 2 * lanes), needle);
+            const simd_vector m3 = simd_equal<T>(simd_load(first + 3 * lanes), needle);
+            if (simd_byte_mask(simd_or(simd_or(m0, m1), simd_or(m2, m3))) != 0)
+                break;
+            first += 4 * lanes;
+        }
+        for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+            if (const uint32_t mask = simd_byte_mask(simd_equal<T>(simd_load(first), needle)))
+                return first + std::countr_zero(mask) / sizeof(T);
+#endif
+        for (; first != last; ++first)
+            if (*first == value)
+                return first;
+        return last;
+    }
+
+    // the most values simd_find_any looks for at once
+    inline constexpr size_t simd_find_any_limit = 8;
+
+    // the first element of [first, last) equal to one of the count values at set, count must
+    // be from 1 to simd_find_any_limit
+    template<class T>
+    const T *simd_find_any (const T *first, const T *last, const T *set, size_t count) noexcept
+    {
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes = simd_width / sizeof(T);
+        simd_vector needles[simd_find_any_limit];
+        for (size_t k = 0; k < count; ++k)
+            needles[k] = simd_splat(set[k]);
+        for (; static_cast<size_t>(last - first) >= lanes; first += lanes)
+        {
+            const simd_vector elements = simd_load(first);
+            simd_vector hits           = simd_equal<T>(elements, needles[0]);
+            for (size_t k = 1; k < count; ++k)
+                hits = simd_or(hits, simd_equal<T>(elements, needles[k]));
+            if (const uint32_t mask = simd_byte_mask(hits))
+                return first + std::countr_zero(mask) / sizeof(T);
+        }
+#endif
+        for (; first != last; ++first)
+            for (size_t k = 0; k < count; ++k)
+                if (*first == set[k])
+                    return first;
+        return last;
+    }
+
+    template<class T>
+    size_t simd_count (const T *first, const T *last, T value) noexcept
+    {
+        size_t n = 0;
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes   = simd_width / sizeof(T);
+        const simd_vector needle = simd_splat(value);
+        // a matching lane is all ones, i.e. -1 in each of its bytes, so subtracting the compare
+        // results counts every match sizeof(T) times in per byte counters, summed before they wrap
+        size_t bytes = 0;
+        while (static_cast<size_t>(last - first) >= lanes)
+        {
+            simd_vector counters = simd_zero();
+            for (size_t round = 0; round < 255 && static_cast<size_t>(last - first) >= lanes; ++round, first += lanes)
+                counters = simd_sub_bytes(counters, simd_equal<T>(simd_load(first), needle));
+            bytes += simd_sum_bytes(counters);
+        }
+        n = bytes / sizeof(T);
+#endif
+        for (; first != last; ++first)
+            n += *first == value;
+        return n;
+    }
+
+    // the index of the first position where a and b differ, n when they do not
+    template<class T>
+    size_t simd_mismatch (const T *a, const T *b, size_t n) noexcept
+    {
+        size_t i = 0;
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes = simd_width / sizeof(T);
+        for (; i + lanes <= n; i += lanes)
+        {
+            const uint32_t mask = simd_byte_mask(simd_equal<T>(simd_load(a + i), simd_load(b + i)));
+            if (mask != simd_full_mask)
+                return i + std::countr_one(mask) / sizeof(T);
+        }
+        // the last vector overlaps the ones compared equal, which spares the element loop
+        if (i != n && n >= lanes)
+        {
+            const size_t last   = n - lanes;
+            const uint32_t mask = simd_byte_mask(simd_equal<T>(simd_load(a + last), simd_load(b + last)));
+            return mask != simd_full_mask ? last + std::countr_one(mask) / sizeof(T) : n;
+        }
+#endif
+        while (i < n && a[i] == b[i])
+            ++i;
+        return i;
+    }
+
+    // the first position i below starts with first[i] == head and first[i + distance] == tail,
+    // starts when there is none. substring searches test a vector of positions against the
+    // first and the last character of the needle at once, which few positions pass even when
+    // the first character alone is common
+    template<class T>
+    size_t simd_find_pair (const T *first, size_t starts, T head, T tail, size_t distance) noexcept
+    {
+        size_t i = 0;
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes = simd_width / sizeof(T);
+        // the lowest bit of each lane in a byte mask
+        constexpr uint32_t lane_bits = sizeof(T) == 1 ? 0xFFFFFFFFu : sizeof(T) == 2 ? 0x55555555u : sizeof(T) == 4 ? 0x11111111u : 0x01010101u;
+        const simd_vector heads = simd_splat(head);
+        const simd_vector tails = simd_splat(tail);
+        for (; i + lanes <= starts; i += lanes)
+        {
+            const simd_vector hits = simd_and(simd_equal<T>(simd_load(first + i), heads), simd_equal<T>(simd_load(first + i + distance), tails));
+            if (const uint32_t mask = simd_byte_mask(hits) & lane_bits)
+                return i + std::countr_zero(mask) / sizeof(T);
+        }
+#endif
+        for (; i < starts; ++i)
+            if (first[i] == head && first[i + distance] == tail)
+                return i;
+        return starts;
+    }
+
+    // the number of elements of the sorted [first, first + n) that are less than value, or with
+    // Upper that are not greater than it: the index lower_bound (upper_bound) returns
+    template<bool Upper, class T>
+    size_t simd_rank (const T *first, size_t n, T value) noexcept
+    {
+        size_t i    = 0;
+        size_t rank = 0;
+#if defined(DSTL_SSE2)
+        constexpr size_t lanes   = simd_width / sizeof(T);
+        const simd_vector needle = simd_splat(value);
+        // counts the lanes on the near side of value in every vector instead of stopping at the
+        // first vector that crosses it, which takes no branch on the comparisons and lets all of
+        // the loads run at once. the per byte counters work as in simd_count
+        size_t bytes = 0;
+        while (i + lanes <= n)
+        {
+            simd_vector counters = simd_zero();
+            for (size_t round = 0; round < 255 && i + lanes <= n; ++round, i += lanes)
+            {
+                const simd_vector elements = simd_load(first + i);
+                counters = simd_sub_bytes(counters, Upper ? simd_less<T>(needle, elements) : simd_less<T>(elements, needle));
+            }
+            bytes += simd_sum_bytes(counters);
+        }
+        rank = Upper ? i - bytes / sizeof(T) : bytes / sizeof(T);
+#endif
+        for (; i < n; ++i)
+            rank += Upper ? !(value < first[i]) : first[i] < value;
+        return rank;
+    }
+}
+
+// finds the first element of [first, last) equal to value
+template<class InputIt, class T>
+InputIt find (InputIt first, InputIt last, const T &value)
+{
+    if constexpr (detail::is_simd_find_v<InputIt, T>)
+    {
+        std::iter_value_t<InputIt> needle;
+        if (!detail::simd_needle(value, needle))
+            return last;
+        const auto *begin = std::to_address(first);
+        return first + (detail::simd_find(begin, begin + (last - first), needle) - begin);
+    }
+    else
+    {
+        for (; first != last; ++first)
+            if (*first == value)
+                return first;
+        return last;
+    }
+}
+
+// checks if [first, last) holds an element equal to value
+template<class InputIt, class T>
+bool contains (InputIt first, InputIt last, const T &value)
+{
+    return dstl::find(first, last, value) != last;
+}
+
+// counts the elements of [first, last) equal to value
+template<class InputIt, class T>
+typename std::iterator_traits<InputIt>::difference_type count (InputIt first, InputIt last, const T &value)
+{
+    using difference_type = typename std::iterator_traits<InputIt>::difference_type;
+
+    if constexpr (detail::is_simd_find_v<InputIt, T>)
+    {
+        std::iter_value_t<InputIt> needle;
+        if (!detail::simd_needle(value, needle))
+            return 0;
+        const auto *begin = std::to_address(first);
+        return static_cast<difference_type>(detail::simd_count(begin, begin + (last - first), needle));
+    }
+    else
+    {
+        difference_type n = 0;
+        for (; first != last; ++first)
+            if (*first == value)
+                ++n;
+        return n;
+    }
+}
+
+// finds the first position where [first1, last1) and the range starting at first2 differ under pred
+template<class InputIt1, class InputIt2, class BinaryPred>
+std::pair<InputIt1, InputIt2> mismatch (InputIt1 first1, InputIt1 last1, InputIt2 first2, BinaryPred pred)
+{
+    if constexpr (detail::is_simd_mismatch_v<InputIt1, InputIt2, BinaryPred>)
+    {
+        const auto n = detail::simd_mismatch(std::to_address(first1), std::to_address(first2), static_cast<size_t>(last1 - first1));
+        return {first1 + static_cast<ptrdiff_t>(n), first2 + static_cast<ptrdiff_t>(n)};
+    }
+    else
+    {
+        while (first1 != last1 && pred(*first1, *first2))
+        {
+            ++first1;
+            ++first2;
+        }
+        return {first1, first2};
+    }
+}
+
+template<class InputIt1, class InputIt2>
+std::pair<InputIt1, InputIt2> mismatch (InputIt1 first1, InputIt1 last1, InputIt2 first2)
+{
+    return dstl::mismatch(first1, last1, first2, std::equal_to<>());
+}
+
+// finds the first position where [first1, last1) and [first2, last2) differ under pred, or the end of the shorter one
+template<class InputIt1, class InputIt2, class BinaryPred>
+std::pair<InputIt1, InputIt2> mismatch (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, BinaryPred pred)
+{
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>)
+    {
+        if (last2 - first2 < last1 - first1)
+            last1 = first1 + (last2 - first2);
+        return dstl::mismatch(first1, last1, first2, pred);
+    }
+    else
+    {
+        while (first1 != last1 && first2 != last2 && pred(*first1, *first2))
+        {
+            ++first1;
+            ++first2;
+        }
+        return {first1, first2};
+    }
+}
+
+template<class InputIt1, class InputIt2>
+std::pair<InputIt1, InputIt2> mismatch (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+{
+    return dstl::mismatch(first1, last1, first2, last2, std::equal_to<>());
+}
+
+// checks if [first1, last1) equals the range starting at first2 under pred
+template<class InputIt1, class InputIt2, class BinaryPred>
+bool equal (InputIt1 first1, InputIt1 last1, InputIt2 first2, BinaryPred pred)
+{
+    if constexpr (detail::is_memcmp_equal_v<InputIt1, InputIt2, BinaryPred>)
+        return detail::memcmp_equal(first1, first2, static_cast<size_t>(last1 - first1));
+    else if constexpr (detail::is_simd_mismatch_v<InputIt1, InputIt2, BinaryPred>)
+    {
+        // floating point ranges, equal values such as 0.0 and -0.0 may differ in their bytes
+        const auto n = static_cast<size_t>(last1 - first1);
+        return detail::simd_mismatch(std::to_address(first1), std::to_address(first2), n) == n;
+    }
+    else
+    {
+        for (; first1 != last1; ++first1, ++first2)
+            if (!pred(*first1, *first2))
+                return false;
+        return true;
+    }
+}
+
+template<class InputIt1, class InputIt2>
+bool equal (InputIt1 first1, InputIt1 last1, InputIt2 first2)
+{
+    return dstl::equal(first1, last1, first2, std::equal_to<>());
+}
+
+// checks if [first1, last1) equals [first2, last2) under pred, ranges of different length never do
+template<class InputIt1, class InputIt2, class BinaryPred>
+bool equal (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2, BinaryPred pred)
+{
+    if constexpr (std::random_access_iterator<InputIt1> && std::random_access_iterator<InputIt2>)
+    {
+        if (last1 - first1 != last2 - first2)
+            return false;
+        return dstl::equal(first1, last1, first2, pred);
+    }
+    else
+    {
+        for (; first1 != last1 && first2 != last2; ++first1, ++first2)
+            if (!pred(*first1, *first2))
+                return false;
+        return first1 == last1 && first2 == last2;
+    }
+}
+
+template<class InputIt1, class InputIt2>
+bool equal (InputIt1 first1, InputIt1 last1, InputIt2 first2, InputIt2 last2)
+{
+    return dstl::equal(first1, last1, first2, last2, std::equal_to<>());
+}
+
+// finds the first element of [first, last) that is not ordered before value
+template<class ForwardIt, class T, class Compare>
+ForwardIt lower_bound (ForwardIt first, ForwardIt last, const T &value, Compare comp)
+{
+    if constexpr (std::random_access_iterator<ForwardIt>)
+    {
+        auto n = last - first;
+        if (n == 0)
+            return first;
+        // the answer lies in [first, first + n]
+        while (n > 1)
+        {
+            const auto half = n / 2;
+            first += static_cast<decltype(n)>(comp(first[half - 1], value)) * half;
+            n -= half;
+        }
+        return first + static_cast<ptrdiff_t>(comp(*first, value));
+    }
+    else
+        return std::lower_bound(first, last, value, comp);
+}
+
+template<class ForwardIt, class T>
+ForwardIt lower_bound (ForwardIt first, ForwardIt last, const T &value)
+{
+    return dstl::lower_bound(first, last, value, std::less<>());
+}
+
+// finds the first element of [first, last) that value is ordered before
+template<class ForwardIt, class T, class Compare>
+ForwardIt upper_bound (ForwardIt first, ForwardIt last, const T &value, Compare comp)
+{
+    if constexpr (std::random_access_iterator<ForwardIt>)
+    {
+        auto n = last - first;
+        if (n == 0)
+            return first;
+        while (n > 1)
+        {
+            const auto half = n / 2;
+            first += static_cast<decltype(n)>(!comp(value, first[half - 1])) * half;
+            n -= half;
+        }
+        return first + static_cast<ptrdiff_t>(!comp(value, *first));
+    }
+    else
+        return std::upper_bound(first, last, value, comp);
+}
+
+template<class ForwardIt, class T>
+ForwardIt upper_bound (ForwardIt first, ForwardIt last, const T &value)
+{
+    return dstl::upper_bound(first, last, value, std::less<>());
+}
+
+#endif // DSTL_ALGORITHM_H
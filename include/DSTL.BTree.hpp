@@ -0,0 +1,1228 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.BTree.hpp
+
+Abstract:
+    B-Tree Map and Set.
+
+    btree_map and btree_set are B+ trees: the elements live in leaves that
+    are linked into a list, the inner nodes hold copies of the smallest key
+    of every child but the first. Each node is aligned to a cache line and
+    takes the most elements whose arrays, laid out by their sizes and
+    alignments, fit in four of them, so a lookup touches a few lines per
+    level instead of one node per key, and an element costs no pointers
+    beyond its share of the node.
+
+    Nodes of arithmetic keys under the default comparators are searched a
+    vector at a time; other keys run the branchless binary search. A split
+    at the end of the last leaf leaves the full node as it is, so keys
+    inserted in ascending order pack the leaves; bulk construction from
+    sorted input fills whole leaves and builds the inner levels on top of
+    them. Erasing merges a node that falls below half its capacity with a
+    sibling, or moves elements over from that sibling when both do not fit
+    into one node.
+
+    Keys and mapped values must be nothrow move constructible, as nodes
+    are rebuilt by relocating their elements. Inserting and erasing
+    invalidate iterators.
+
+--*/
+
+#ifndef DSTL_BTREE_H
+#define DSTL_BTREE_H
+
+namespace detail
+{
+    // the bytes of a node when its arrays take as many elements as fit
+    inline constexpr size_t btree_node_bytes = 4 * cache_line_size;
+
+    struct btree_node
+    {
+        uint32_t count_ = 0;
+    };
+
+    // uninitialized storage for N objects of T, nothing for void
+    template<class T, size_t N>
+    struct btree_slots
+    {
+        alignas(alignment_of_v<T>) unsigned char bytes_[N * sizeof(T)];
+
+        T *data () noexcept { return reinterpret_cast<T *>(bytes_); }
+        const T *data () const noexcept { return reinterpret_cast<const T *>(bytes_); }
+    };
+
+    template<size_t N>
+    struct btree_slots<void, N>
+    {
+    };
+
+    // count_ keys and as many mapped values, linked to the leaves before and after it
+    template<class Key, class T, size_t N>
+    struct alignas(cache_line_size) btree_leaf : btree_node
+    {
+        btree_leaf *prev_ = nullptr;
+        btree_leaf *next_ = nullptr;
+        btree_slots<Key, N> keys_;
+        [[no_unique_address]] btree_slots<T, N> values_;
+    };
+
+    // count_ keys separating count_ + 1 children, key i is the smallest key below child i + 1
+    template<class Key, size_t N>
+    struct alignas(cache_line_size) btree_inner : btree_node
+    {
+        btree_slots<Key, N> keys_;
+        btree_node *children_[N + 1];
+    };
+
+    // the largest capacity, at least 3, at which Node spans at most btree_node_bytes
+    template<template<size_t> class Node, size_t N = 3>
+    constexpr size_t btree_capacity () noexcept
+    {
+        if constexpr (sizeof(Node<N + 1>) > btree_node_bytes)
+            return N;
+        else
+            return btree_capacity<Node, N + 1>();
+    }
+
+    // B+ tree shared by btree_set (T is void) and btree_map
+    template<class Key, class T, class Compare>
+    class raw_btree
+    {
+        static_assert(is_nothrow_move_constructible_v<Key>, "btree keys must be nothrow move constructible");
+        static_assert(is_void_v<T> || is_nothrow_move_constructible_v<T>, "btree values must be nothrow move constructible");
+
+    protected:
+        static constexpr bool is_map = !is_void_v<T>;
+
+        template<size_t N>
+        using leaf_node = btree_leaf<Key, T, N>;
+        template<size_t N>
+        using inner_node = btree_inner<Key, N>;
+
+        static constexpr size_t leaf_capacity  = btree_capacity<leaf_node>();
+        static constexpr size_t inner_capacity = btree_capacity<inner_node>();
+
+        // below these counts a node is merged with or refilled from a sibling
+        static constexpr size_t leaf_minimum  = leaf_capacity / 2;
+        static constexpr size_t inner_minimum = inner_capacity / 2;
+
+        // every inner node but the last one of its level has two children or more, so a tree
+        // of height h has at least 2^(h - 2) leaves
+        static constexpr size_t max_height = 64;
+
+        static constexpr bool simd_search = is_simd_rank_v<Key, Compare>;
+
+        using leaf_type  = leaf_node<leaf_capacity>;
+        using inner_type = inner_node<inner_capacity>;
+
+        // the inner nodes on the way to a leaf and the child taken in each of them
+        struct path_entry
+        {
+            inner_type *node_;
+            size_t index_;
+        };
+
+    public:
+        using key_type        = Key;
+        using value_type      = conditional_t<is_map, std::pair<Key, T>, Key>;
+        using key_compare     = Compare;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using reference       = conditional_t<is_map, std::pair<const Key &, std::add_lvalue_reference_t<T>>, const Key &>;
+        using const_reference = conditional_t<is_map, std::pair<const Key &, std::add_lvalue_reference_t<const T>>, const Key &>;
+
+        // a position in a leaf, the past the end position is the one after the last element
+        template<bool Const>
+        class basic_iterator
+        {
+            friend class raw_btree;
+            template<bool> friend class basic_iterator;
+
+        public:
+            using iterator_concept  = std::bidirectional_iterator_tag;
+            using iterator_category = conditional_t<is_map, std::input_iterator_tag, std::bidirectional_iterator_tag>;
+            using value_type        = raw_btree::value_type;
+            using difference_type   = ptrdiff_t;
+            using reference         = conditional_t<Const, raw_btree::const_reference, raw_btree::reference>;
+
+            // operator-> of a map iterator returns the pair of references by value, wrapped so
+            // that -> reaches its members
+            class arrow
+            {
+            private:
+                reference ref_;
+
+            public:
+                explicit arrow (reference ref) noexcept : ref_(ref) {}
+
+                const reference *operator-> () const noexcept { return &ref_; }
+            };
+
+            using pointer = conditional_t<is_map, arrow, const Key *>;
+
+        private:
+            leaf_type *leaf_ = nullptr;
+            size_t pos_      = 0;
+
+            basic_iterator (leaf_type *leaf, size_t pos) noexcept : leaf_(leaf), pos_(pos) {}
+
+        public:
+            basic_iterator () noexcept = default;
+
+            template<bool C = Const, class = enable_if_t<C>>
+            basic_iterator (const basic_iterator<false> &other) noexcept : leaf_(other.leaf_), pos_(other.pos_) {}
+
+            reference operator* () const noexcept
+            {
+                if constexpr (is_map)
+                    return reference(leaf_->keys_.data()[pos_], leaf_->values_.data()[pos_]);
+                else
+                    return leaf_->keys_.data()[pos_];
+            }
+
+            pointer operator-> () const noexcept
+            {
+                if constexpr (is_map)
+                    return arrow(**this);
+                else
+                    return leaf_->keys_.data() + pos_;
+            }
+
+            basic_iterator &operator++ () noexcept
+            {
+                if (++pos_ == leaf_->count_ && leaf_->next_ != nullptr)
+                {
+                    leaf_ = leaf_->next_;
+                    pos_  = 0;
+                }
+                return *this;
+            }
+
+            basic_iterator operator++ (int) noexcept
+            {
+                basic_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            basic_iterator &operator-- () noexcept
+            {
+                if (pos_ == 0)
+                {
+                    leaf_ = leaf_->prev_;
+                    pos_  = leaf_->count_;
+                }
+                --pos_;
+                return *this;
+            }
+
+            basic_iterator operator-- (int) noexcept
+            {
+                basic_iterator tmp = *this;
+                --*this;
+                return tmp;
+            }
+
+            friend bool operator== (const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+            {
+                return lhs.leaf_ == rhs.leaf_ && lhs.pos_ == rhs.pos_;
+            }
+        };
+
+        using const_iterator         = basic_iterator<true>;
+        using iterator               = conditional_t<is_map, basic_iterator<false>, const_iterator>;
+        using reverse_iterator       = std::reverse_iterator<iterator>;
+        using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    private:
+        btree_node *root_     = nullptr;
+        leaf_type *leftmost_  = nullptr;
+        leaf_type *rightmost_ = nullptr;
+        size_t size_          = 0;
+        // the number of levels, 1 when the root is a leaf
+        size_t height_        = 0;
+        [[no_unique_address]] Compare comp_;
+
+    public:
+        raw_btree () = default;
+
+        explicit raw_btree (const Compare &comp) : comp_(comp) {}
+
+        raw_btree (const raw_btree &other) : comp_(other.comp_) { build(other.begin(), other.end()); }
+
+        raw_btree (raw_btree &&other) noexcept
+            : root_(std::exchange(other.root_, nullptr)),
+              leftmost_(std::exchange(other.leftmost_, nullptr)),
+              rightmost_(std::exchange(other.rightmost_, nullptr)),
+              size_(std::exchange(other.size_, 0)),
+              height_(std::exchange(other.height_, 0)),
+              comp_(other.comp_)
+        {
+        }
+
+        raw_btree &operator= (const raw_btree &other)
+        {
+            if (this != &other)
+            {
+                raw_btree tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        raw_btree &operator= (raw_btree &&other) noexcept
+        {
+            if (this != &other)
+            {
+                clear();
+                swap(other);
+            }
+            return *this;
+        }
+
+        ~raw_btree () { clear(); }
+
+        //
+        // iterators
+        //
+
+        iterator begin () noexcept { return iterator(leftmost_, 0); }
+        const_iterator begin () const noexcept { return const_iterator(leftmost_, 0); }
+        const_iterator cbegin () const noexcept { return begin(); }
+        iterator end () noexcept { return iterator(rightmost_, end_pos()); }
+        const_iterator end () const noexcept { return const_iterator(rightmost_, end_pos()); }
+        const_iterator cend () const noexcept { return end(); }
+
+        reverse_iterator rbegin () noexcept { return reverse_iterator(end()); }
+        const_reverse_iterator rbegin () const noexcept { return const_reverse_iterator(end()); }
+        reverse_iterator rend () noexcept { return reverse_iterator(begin()); }
+        const_reverse_iterator rend () const noexcept { return const_reverse_iterator(begin()); }
+
+        //
+        // capacity
+        //
+
+        [[nodiscard]] bool empty () const noexcept { return size_ == 0; }
+        [[nodiscard]] size_type size () const noexcept { return size_; }
+        [[nodiscard]] size_type height () const noexcept { return height_; }
+
+        //
+        // modifiers
+        //
+
+        std::pair<iterator, bool> insert (const value_type &value)
+        {
+            if constexpr (is_map)
+                return insert_unique(value.first, value.second);
+            else
+                return insert_unique(value);
+        }
+
+        std::pair<iterator, bool> insert (value_type &&value)
+        {
+            if constexpr (is_map)
+                return insert_unique(std::move(value.first), std::move(value.second));
+            else
+                return insert_unique(std::move(value));
+        }
+
+        template<class... Args>
+        std::pair<iterator, bool> emplace (Args &&...args)
+        {
+            value_type tmp(std::forward<Args>(args)...);
+            return insert(std::move(tmp));
+        }
+
+        template<class InputIt>
+        void insert (InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                insert(*first);
+        }
+
+        // inserts [first, last), which must be sorted and free of equivalent keys. an empty
+        // tree is built bottom up
+        template<class InputIt>
+        void insert (sorted_unique_t, InputIt first, InputIt last)
+        {
+            if (empty())
+                build(first, last);
+            else
+                insert(first, last);
+        }
+
+        void insert (std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+        iterator erase (const_iterator pos)
+        {
+            path_entry path[max_height];
+            leaf_type *leaf = descend(pos.leaf_->keys_.data()[pos.pos_], path);
+            return erase_at(path, leaf, pos.pos_);
+        }
+
+        iterator erase (const_iterator first, const_iterator last)
+        {
+            // erasing moves elements between leaves, so last is not stable, its distance is
+            size_t count = 0;
+            for (const_iterator it = first; it != last; ++it)
+                ++count;
+            iterator pos(first.leaf_, first.pos_);
+            for (; count != 0; --count)
+                pos = erase(pos);
+            return pos;
+        }
+
+        size_type erase (const Key &key)
+        {
+            if (root_ == nullptr)
+                return 0;
+            path_entry path[max_height];
+            leaf_type *leaf  = descend(key, path);
+            const size_t pos = rank<false>(leaf->keys_.data(), leaf->count_, key);
+            if (pos == leaf->count_ || comp_(key, leaf->keys_.data()[pos]))
+                return 0;
+            erase_at(path, leaf, pos);
+            return 1;
+        }
+
+        void clear () noexcept
+        {
+            if (height_ > 1)
+                destroy_inner(static_cast<inner_type *>(root_), height_ - 1);
+            for (leaf_type *leaf = leftmost_; leaf != nullptr;)
+            {
+                leaf_type *next = leaf->next_;
+                destroy_slots(leaf, 0, leaf->count_);
+                delete leaf;
+                leaf = next;
+            }
+            root_      = nullptr;
+            leftmost_  = nullptr;
+            rightmost_ = nullptr;
+            size_      = 0;
+            height_    = 0;
+        }
+
+        void swap (raw_btree &other) noexcept
+        {
+            std::swap(root_, other.root_);
+            std::swap(leftmost_, other.leftmost_);
+            std::swap(rightmost_, other.rightmost_);
+            std::swap(size_, other.size_);
+            std::swap(height_, other.height_);
+            std::swap(comp_, other.comp_);
+        }
+
+        //
+        // lookup
+        //
+
+        iterator find (const Key &key) { return find_position(key); }
+        const_iterator find (const Key &key) const { return find_position(key); }
+
+        [[nodiscard]] bool contains (const Key &key) const { return find_position(key) != end(); }
+        [[nodiscard]] size_type count (const Key &key) const { return contains(key) ? 1 : 0; }
+
+        iterator lower_bound (const Key &key) { return bound<false>(key); }
+        const_iterator lower_bound (const Key &key) const { return bound<false>(key); }
+        iterator upper_bound (const Key &key) { return bound<true>(key); }
+        const_iterator upper_bound (const Key &key) const { return bound<true>(key); }
+
+        std::pair<iterator, iterator> equal_range (const Key &key)
+        {
+            iterator first = lower_bound(key);
+            iterator last  = first;
+            if (first != end() && !comp_(key, first.leaf_->keys_.data()[first.pos_]))
+                ++last;
+            return {first, last};
+        }
+
+        std::pair<const_iterator, const_iterator> equal_range (const Key &key) const
+        {
+            auto range = const_cast<raw_btree *>(this)->equal_range(key);
+            return {range.first, range.second};
+        }
+
+        //
+        // observers
+        //
+
+        key_compare key_comp () const { return comp_; }
+
+        friend bool operator== (const raw_btree &lhs, const raw_btree &rhs)
+        {
+            return lhs.size_ == rhs.size_ && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+        }
+
+    protected:
+        template<class K, class... Args>
+        std::pair<iterator, bool> insert_unique (K &&key, Args &&...args)
+        {
+            if (root_ == nullptr)
+            {
+                leaf_type *leaf = new leaf_type;
+                try
+                {
+                    emplace_slot(leaf, 0, std::forward<K>(key), std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    delete leaf;
+                    throw;
+                }
+                root_      = leaf;
+                leftmost_  = leaf;
+                rightmost_ = leaf;
+                size_      = 1;
+                height_    = 1;
+                return {iterator(leaf, 0), true};
+            }
+
+            // keys past the largest one, as a growing series of timestamps inserts them, go to the
+            // end of the last leaf without searching the nodes on the way
+            path_entry path[max_height];
+            const bool past_end = comp_(keys_of(rightmost_)[rightmost_->count_ - 1], key);
+            leaf_type *leaf     = past_end ? descend_last(path) : descend(key, path);
+            const size_t pos    = past_end ? leaf->count_ : rank<false>(leaf->keys_.data(), leaf->count_, key);
+            if (pos != leaf->count_ && !comp_(key, leaf->keys_.data()[pos]))
+                return {iterator(leaf, pos), false};
+
+            if (leaf->count_ < leaf_capacity)
+            {
+                emplace_slot(leaf, pos, std::forward<K>(key), std::forward<Args>(args)...);
+                ++size_;
+                return {iterator(leaf, pos), true};
+            }
+
+            // the element is built before anything moves, the split then only relocates
+            Key new_key(std::forward<K>(key));
+            if constexpr (is_map)
+            {
+                T new_value(std::forward<Args>(args)...);
+                return {insert_split(path, leaf, pos, std::move(new_key), std::move(new_value)), true};
+            }
+            else
+                return {insert_split(path, leaf, pos, std::move(new_key)), true};
+        }
+
+    private:
+        size_t end_pos () const noexcept { return rightmost_ != nullptr ? rightmost_->count_ : 0; }
+
+        // the number of keys of [keys, keys + n) that are less than key, or with Upper that are
+        // not greater than it
+        template<bool Upper>
+        size_t rank (const Key *keys, size_t n, const Key &key) const
+        {
+            if constexpr (simd_search)
+                return simd_rank<Upper>(keys, n, key);
+            else if constexpr (Upper)
+                return static_cast<size_t>(dstl::upper_bound(keys, keys + n, key, comp_) - keys);
+            else
+                return static_cast<size_t>(dstl::lower_bound(keys, keys + n, key, comp_) - keys);
+        }
+
+        // the leaf that holds key if the tree does, the tree must not be empty
+        leaf_type *find_leaf (const Key &key) const
+        {
+            btree_node *node = root_;
+            for (size_t level = height_; level > 1; --level)
+            {
+                const inner_type *inner = static_cast<const inner_type *>(node);
+                node                    = inner->children_[rank<true>(inner->keys_.data(), inner->count_, key)];
+            }
+            return static_cast<leaf_type *>(node);
+        }
+
+        // find_leaf, recording the way down in path
+        leaf_type *descend (const Key &key, path_entry *path) const
+        {
+            btree_node *node = root_;
+            for (size_t level = 0; level + 1 < height_; ++level)
+            {
+                inner_type *inner  = static_cast<inner_type *>(node);
+                const size_t index = rank<true>(inner->keys_.data(), inner->count_, key);
+                path[level]        = {inner, index};
+                node               = inner->children_[index];
+            }
+            return static_cast<leaf_type *>(node);
+        }
+
+        // descend to the last leaf
+        leaf_type *descend_last (path_entry *path) const noexcept
+        {
+            btree_node *node = root_;
+            for (size_t level = 0; level + 1 < height_; ++level)
+            {
+                inner_type *inner = static_cast<inner_type *>(node);
+                path[level]       = {inner, inner->count_};
+                node              = inner->children_[inner->count_];
+            }
+            return static_cast<leaf_type *>(node);
+        }
+
+        // the iterator to position pos of leaf, moving past the end of a leaf to the next one.
+        // a null leaf is the end
+        iterator position (leaf_type *leaf, size_t pos) const noexcept
+        {
+            if (leaf == nullptr)
+                return iterator(rightmost_, end_pos());
+            if (pos == leaf->count_ && leaf->next_ != nullptr)
+                return iterator(leaf->next_, 0);
+            return iterator(leaf, pos);
+        }
+
+        iterator find_position (const Key &key) const
+        {
+            if (root_ == nullptr)
+                return position(nullptr, 0);
+            leaf_type *leaf  = find_leaf(key);
+            const size_t pos = rank<false>(leaf->keys_.data(), leaf->count_, key);
+            if (pos == leaf->count_ || comp_(key, leaf->keys_.data()[pos]))
+                return position(nullptr, 0);
+            return iterator(leaf, pos);
+        }
+
+        template<bool Upper>
+        iterator bound (const Key &key) const
+        {
+            if (root_ == nullptr)
+                return position(nullptr, 0);
+            leaf_type *leaf = find_leaf(key);
+            return position(leaf, rank<Upper>(leaf->keys_.data(), leaf->count_, key));
+        }
+
+        //
+        // element slots
+        //
+
+        static Key *keys_of (leaf_type *leaf) noexcept { return leaf->keys_.data(); }
+        static Key *keys_of (inner_type *inner) noexcept { return inner->keys_.data(); }
+
+        // relocates count elements from slot from of source to slot to of dest, the ranges may overlap
+        static void move_slots (leaf_type *source, size_t from, size_t count, leaf_type *dest, size_t to) noexcept
+        {
+            dstl::relocate(keys_of(source) + from, keys_of(source) + from + count, keys_of(dest) + to);
+            if constexpr (is_map)
+                dstl::relocate(source->values_.data() + from, source->values_.data() + from + count, dest->values_.data() + to);
+        }
+
+        static void destroy_slots (leaf_type *leaf, size_t from, size_t to) noexcept
+        {
+            dstl::destroy(keys_of(leaf) + from, keys_of(leaf) + to);
+            if constexpr (is_map)
+                dstl::destroy(leaf->values_.data() + from, leaf->values_.data() + to);
+        }
+
+        // constructs an element at pos of a leaf with room for it, shifting the ones from pos on
+        template<class K, class... Args>
+        static void emplace_slot (leaf_type *leaf, size_t pos, K &&key, Args &&...args)
+        {
+            const size_t count = leaf->count_;
+            move_slots(leaf, pos, count - pos, leaf, pos + 1);
+            Key *slot = keys_of(leaf) + pos;
+            try
+            {
+                ::new (static_cast<void *>(slot)) Key(std::forward<K>(key));
+            }
+            catch (...)
+            {
+                move_slots(leaf, pos + 1, count - pos, leaf, pos);
+                throw;
+            }
+            if constexpr (is_map)
+            {
+                try
+                {
+                    ::new (static_cast<void *>(leaf->values_.data() + pos)) T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    dstl::destroy_at(slot);
+                    move_slots(leaf, pos + 1, count - pos, leaf, pos);
+                    throw;
+                }
+            }
+            leaf->count_ = static_cast<uint32_t>(count + 1);
+        }
+
+        // relocates count keys and count children, the children shifted by one, between inner nodes
+        static void move_keys (inner_type *source, size_t from, size_t count, inner_type *dest, size_t to) noexcept
+        {
+            dstl::relocate(keys_of(source) + from, keys_of(source) + from + count, keys_of(dest) + to);
+        }
+
+        static void move_children (inner_type *source, size_t from, size_t count, inner_type *dest, size_t to) noexcept
+        {
+            std::memmove(dest->children_ + to, source->children_ + from, count * sizeof(btree_node *));
+        }
+
+        static void relocate_key (Key *source, Key *dest) noexcept { dstl::relocate_at(source, dest); }
+
+        //
+        // insertion
+        //
+
+        // inserts the element into the full leaf at pos, splitting it and the full inner nodes
+        // above it, and returns where the element went
+        template<class... V>
+        iterator insert_split (path_entry *path, leaf_type *leaf, size_t pos, Key &&key, V &&...value)
+        {
+            // the inner nodes that split, from the parent of the leaf up
+            size_t splits = 0;
+            while (splits + 1 < height_ && path[height_ - 2 - splits].node_->count_ == inner_capacity)
+                ++splits;
+            const bool new_root = splits + 1 == height_;
+
+            leaf_type *right = new leaf_type;
+            inner_type *spare[max_height];
+            size_t allocated = 0;
+            // the separator of the new leaf, its smallest key, lives in the parent as a copy
+            btree_slots<Key, 1> carry;
+            const bool append = leaf == rightmost_ && pos == leaf_capacity;
+            const size_t keep = append ? leaf_capacity : (leaf_capacity + 1) / 2;
+            try
+            {
+                for (; allocated < splits + new_root; ++allocated)
+                    spare[allocated] = new inner_type;
+                const Key &separator = keep == pos ? key : keys_of(leaf)[keep < pos ? keep : keep - 1];
+                ::new (static_cast<void *>(carry.data())) Key(separator);
+            }
+            catch (...)
+            {
+                while (allocated != 0)
+                    delete spare[--allocated];
+                delete right;
+                throw;
+            }
+
+            // from here on only relocations, which do not throw
+            iterator result;
+            if (pos < keep)
+            {
+                move_slots(leaf, keep - 1, leaf_capacity - keep + 1, right, 0);
+                leaf->count_ = static_cast<uint32_t>(keep - 1);
+                emplace_slot(leaf, pos, std::move(key), std::move(value)...);
+                result = iterator(leaf, pos);
+            }
+            else
+            {
+                move_slots(leaf, pos, leaf_capacity - pos, right, pos - keep + 1);
+                move_slots(leaf, keep, pos - keep, right, 0);
+                ::new (static_cast<void *>(keys_of(right) + pos - keep)) Key(std::move(key));
+                if constexpr (is_map)
+                    ::new (static_cast<void *>(right->values_.data() + pos - keep)) T(std::move(value)...);
+                leaf->count_ = static_cast<uint32_t>(keep);
+                result       = iterator(right, pos - keep);
+            }
+            right->count_ = static_cast<uint32_t>(leaf_capacity + 1 - keep);
+            right->prev_  = leaf;
+            right->next_  = leaf->next_;
+            if (leaf->next_ != nullptr)
+                leaf->next_->prev_ = right;
+            else
+                rightmost_ = right;
+            leaf->next_ = right;
+            ++size_;
+
+            // carries the separator and the new node up until a parent has room for them
+            btree_node *child = right;
+            for (size_t level = height_ - 1; level-- != 0;)
+            {
+                inner_type *node    = path[level].node_;
+                const size_t index  = path[level].index_;
+                const size_t count  = node->count_;
+                if (count < inner_capacity)
+                {
+                    move_keys(node, index, count - index, node, index + 1);
+                    move_children(node, index + 1, count - index, node, index + 2);
+                    relocate_key(carry.data(), keys_of(node) + index);
+                    node->children_[index + 1] = child;
+                    node->count_               = static_cast<uint32_t>(count + 1);
+                    return result;
+                }
+                child = split_inner(node, index, spare[--allocated], carry.data(), child, append);
+            }
+
+            inner_type *root = spare[--allocated];
+            relocate_key(carry.data(), keys_of(root));
+            root->children_[0] = root_;
+            root->children_[1] = child;
+            root->count_       = 1;
+            root_              = root;
+            ++height_;
+            return result;
+        }
+
+        // splits the full node, inserting the key at carry before child index + 1 of it, into node
+        // and right. the middle key moves to carry, right is returned
+        static inner_type *split_inner (inner_type *node, size_t index, inner_type *right, Key *carry, btree_node *child, bool append) noexcept
+        {
+            // of the inner_capacity + 1 keys, node keeps the first middle ones and key middle goes up.
+            // along the last path of an ascending load the right node gets a single key
+            const size_t capacity = inner_capacity;
+            const size_t middle   = append ? capacity - 1 : (capacity + 1) / 2;
+            btree_slots<Key, 1> promoted;
+            if (index < middle)
+            {
+                relocate_key(keys_of(node) + middle - 1, promoted.data());
+                move_keys(node, middle, capacity - middle, right, 0);
+                move_children(node, middle, capacity - middle + 1, right, 0);
+                move_keys(node, index, middle - 1 - index, node, index + 1);
+                move_children(node, index + 1, middle - 1 - index, node, index + 2);
+                relocate_key(carry, keys_of(node) + index);
+                node->children_[index + 1] = child;
+            }
+            else if (index == middle)
+            {
+                relocate_key(carry, promoted.data());
+                move_keys(node, middle, capacity - middle, right, 0);
+                right->children_[0] = child;
+                move_children(node, middle + 1, capacity - middle, right, 1);
+            }
+            else
+            {
+                relocate_key(keys_of(node) + middle, promoted.data());
+                const size_t before = index - middle - 1;
+                move_keys(node, middle + 1, before, right, 0);
+                relocate_key(carry, keys_of(right) + before);
+                move_keys(node, index, capacity - index, right, before + 1);
+                move_children(node, middle + 1, before + 1, right, 0);
+                right->children_[before + 1] = child;
+                move_children(node, index + 1, capacity - index, right, before + 2);
+            }
+            node->count_  = static_cast<uint32_t>(middle);
+            right->count_ = static_cast<uint32_t>(capacity - middle);
+            relocate_key(promoted.data(), carry);
+            return right;
+        }
+
+        //
+        // erasure
+        //
+
+        // erases the element at pos of leaf, reached through path, and returns its successor
+        iterator erase_at (path_entry *path, leaf_type *leaf, size_t pos)
+        {
+            const size_t count = leaf->count_ - 1u;
+            if (height_ == 1 || count >= leaf_minimum)
+            {
+                remove_slot(leaf, pos);
+                if (count == 0)
+                {
+                    // the last element of a tree that is a single leaf
+                    delete leaf;
+                    root_      = nullptr;
+                    leftmost_  = nullptr;
+                    rightmost_ = nullptr;
+                    height_    = 0;
+                    return end();
+                }
+                return position(leaf, pos);
+            }
+
+            inner_type *parent = path[height_ - 2].node_;
+            const size_t index = path[height_ - 2].index_;
+            const bool has_left = index != 0;
+            leaf_type *sibling  = static_cast<leaf_type *>(parent->children_[has_left ? index - 1 : index + 1]);
+            const size_t other  = sibling->count_;
+
+            if (count + other > leaf_capacity)
+            {
+                // both do not fit into one leaf, the sibling hands over half of its surplus.
+                // the new separator is copied before anything changes
+                const size_t moved   = (other - count) / 2;
+                const size_t key_pos = has_left ? index - 1 : index;
+                Key separator(keys_of(sibling)[has_left ? other - moved : moved]);
+                remove_slot(leaf, pos);
+                if (has_left)
+                {
+                    move_slots(leaf, 0, count, leaf, moved);
+                    move_slots(sibling, other - moved, moved, leaf, 0);
+                    pos += moved;
+                }
+                else
+                {
+                    move_slots(sibling, 0, moved, leaf, count);
+                    move_slots(sibling, moved, other - moved, sibling, 0);
+                }
+                leaf->count_    = static_cast<uint32_t>(count + moved);
+                sibling->count_ = static_cast<uint32_t>(other - moved);
+                dstl::destroy_at(keys_of(parent) + key_pos);
+                ::new (static_cast<void *>(keys_of(parent) + key_pos)) Key(std::move(separator));
+                return position(leaf, pos);
+            }
+
+            remove_slot(leaf, pos);
+            // the right leaf of the pair moves into the left one
+            leaf_type *left  = has_left ? sibling : leaf;
+            leaf_type *right = has_left ? leaf : sibling;
+            if (has_left)
+                pos += other;
+            move_slots(right, 0, right->count_, left, left->count_);
+            left->count_ += right->count_;
+            left->next_ = right->next_;
+            if (right->next_ != nullptr)
+                right->next_->prev_ = left;
+            else
+                rightmost_ = left;
+            delete right;
+            remove_child(parent, has_left ? index - 1 : index);
+            rebalance(path);
+            return position(left, pos);
+        }
+
+        void remove_slot (leaf_type *leaf, size_t pos) noexcept
+        {
+            destroy_slots(leaf, pos, pos + 1);
+            move_slots(leaf, pos + 1, leaf->count_ - pos - 1, leaf, pos);
+            --leaf->count_;
+            --size_;
+        }
+
+        // removes key index of node and the child after it
+        static void remove_child (inner_type *node, size_t index) noexcept
+        {
+            const size_t count = node->count_;
+            dstl::destroy_at(keys_of(node) + index);
+            move_keys(node, index + 1, count - index - 1, node, index);
+            move_children(node, index + 2, count - index - 1, node, index + 1);
+            node->count_ = static_cast<uint32_t>(count - 1);
+        }
+
+        // merges or refills the inner nodes along path that lost a child, from the parent of the
+        // leaves up, and drops a root that is left with a single child
+        void rebalance (path_entry *path) noexcept
+        {
+            for (size_t level = height_ - 1; level-- != 0;)
+            {
+                inner_type *node = path[level].node_;
+                if (level == 0)
+                {
+                    if (node->count_ == 0)
+                    {
+                        root_ = node->children_[0];
+                        delete node;
+                        --height_;
+                    }
+                    return;
+                }
+                if (node->count_ >= inner_minimum)
+                    return;
+
+                inner_type *parent  = path[level - 1].node_;
+                const size_t index  = path[level - 1].index_;
+                const bool has_left = index != 0;
+                const size_t key    = has_left ? index - 1 : index;
+                inner_type *left    = has_left ? static_cast<inner_type *>(parent->children_[index - 1]) : node;
+                inner_type *right   = has_left ? node : static_cast<inner_type *>(parent->children_[index + 1]);
+                const size_t nl     = left->count_;
+                const size_t nr     = right->count_;
+
+                if (nl + nr + 1 > inner_capacity)
+                {
+                    rotate(parent, key, left, right, has_left);
+                    return;
+                }
+
+                // the separator comes down between the keys of the two nodes
+                relocate_key(keys_of(parent) + key, keys_of(left) + nl);
+                move_keys(right, 0, nr, left, nl + 1);
+                move_children(right, 0, nr + 1, left, nl + 1);
+                left->count_ = static_cast<uint32_t>(nl + nr + 1);
+                delete right;
+                // remove_child without destroying the separator, which moved into left
+                const size_t count = parent->count_;
+                move_keys(parent, key + 1, count - key - 1, parent, key);
+                move_children(parent, key + 2, count - key - 1, parent, key + 1);
+                parent->count_ = static_cast<uint32_t>(count - 1);
+            }
+        }
+
+        // moves keys and children from the fuller of two neighbouring inner nodes to the other
+        // one through separator key of parent, to_right when right is the underfull one
+        static void rotate (inner_type *parent, size_t key, inner_type *left, inner_type *right, bool to_right) noexcept
+        {
+            const size_t nl = left->count_;
+            const size_t nr = right->count_;
+            Key *separator  = keys_of(parent) + key;
+            if (to_right)
+            {
+                const size_t moved = (nl - nr) / 2;
+                move_keys(right, 0, nr, right, moved);
+                move_children(right, 0, nr + 1, right, moved);
+                relocate_key(separator, keys_of(right) + moved - 1);
+                move_keys(left, nl - moved + 1, moved - 1, right, 0);
+                move_children(left, nl - moved + 1, moved, right, 0);
+                relocate_key(keys_of(left) + nl - moved, separator);
+                left->count_  = static_cast<uint32_t>(nl - moved);
+                right->count_ = static_cast<uint32_t>(nr + moved);
+            }
+            else
+            {
+                const size_t moved = (nr - nl) / 2;
+                relocate_key(separator, keys_of(left) + nl);
+                move_keys(right, 0, moved - 1, left, nl + 1);
+                move_children(right, 0, moved, left, nl + 1);
+                relocate_key(keys_of(right) + moved - 1, separator);
+                move_keys(right, moved, nr - moved, right, 0);
+                move_children(right, moved, nr - moved + 1, right, 0);
+                left->count_  = static_cast<uint32_t>(nl + moved);
+                right->count_ = static_cast<uint32_t>(nr - moved);
+            }
+        }
+
+        //
+        // bulk construction
+        //
+
+        // fills leaves with the sorted unique elements [first, last) and builds the inner levels
+        // over them, the tree must be empty
+        template<class InputIt>
+        void build (InputIt first, InputIt last)
+        {
+            try
+            {
+                for (; first != last; ++first)
+                {
+                    if (rightmost_ == nullptr || rightmost_->count_ == leaf_capacity)
+                    {
+                        leaf_type *leaf = new leaf_type;
+                        leaf->prev_     = rightmost_;
+                        if (rightmost_ != nullptr)
+                            rightmost_->next_ = leaf;
+                        else
+                            leftmost_ = leaf;
+                        rightmost_ = leaf;
+                    }
+                    auto &&value = *first;
+                    if constexpr (is_map)
+                        emplace_slot(rightmost_, rightmost_->count_, std::forward<decltype(value)>(value).first,
+                                     std::forward<decltype(value)>(value).second);
+                    else
+                        emplace_slot(rightmost_, rightmost_->count_, std::forward<decltype(value)>(value));
+                    ++size_;
+                }
+                if (leftmost_ != nullptr)
+                    build_inner();
+            }
+            catch (...)
+            {
+                clear();
+                throw;
+            }
+        }
+
+        // builds the inner levels over the linked leaves, spreading the children of each level
+        // evenly over its nodes
+        void build_inner ()
+        {
+            vector<btree_node *> level;
+            vector<const Key *> smallest;
+            for (leaf_type *leaf = leftmost_; leaf != nullptr; leaf = leaf->next_)
+            {
+                level.push_back(leaf);
+                smallest.push_back(keys_of(leaf));
+            }
+            height_ = 1;
+
+            vector<btree_node *> parents;
+            vector<const Key *> parent_smallest;
+            try
+            {
+                while (level.size() > 1)
+                {
+                    const size_t children = level.size();
+                    const size_t nodes    = (children + inner_capacity) / (inner_capacity + 1);
+                    parents.reserve(nodes);
+                    parent_smallest.reserve(nodes);
+                    for (size_t i = 0, child = 0; i < nodes; ++i)
+                    {
+                        const size_t take = children / nodes + (i < children % nodes);
+                        inner_type *node  = new inner_type;
+                        parents.push_back(node);
+                        parent_smallest.push_back(smallest[child]);
+                        node->children_[0] = level[child];
+                        for (size_t j = 1; j < take; ++j)
+                        {
+                            ::new (static_cast<void *>(keys_of(node) + j - 1)) Key(*smallest[child + j]);
+                            node->children_[j] = level[child + j];
+                            node->count_       = static_cast<uint32_t>(j);
+                        }
+                        child += take;
+                    }
+                    level.swap(parents);
+                    smallest.swap(parent_smallest);
+                    parents.clear();
+                    parent_smallest.clear();
+                    ++height_;
+                }
+            }
+            catch (...)
+            {
+                // the finished levels hang below the nodes of level, the leaves go with clear
+                if (height_ > 1)
+                    for (btree_node *node : level)
+                        destroy_inner(static_cast<inner_type *>(node), height_ - 1);
+                for (btree_node *node : parents)
+                {
+                    inner_type *inner = static_cast<inner_type *>(node);
+                    dstl::destroy(keys_of(inner), keys_of(inner) + inner->count_);
+                    delete inner;
+                }
+                height_ = 0;
+                throw;
+            }
+            root_ = level[0];
+        }
+
+        // frees node and the inner nodes below it, levels is the number of inner levels from it down
+        static void destroy_inner (inner_type *node, size_t levels) noexcept
+        {
+            if (levels > 1)
+                for (size_t i = 0; i <= node->count_; ++i)
+                    destroy_inner(static_cast<inner_type *>(node->children_[i]), levels - 1);
+            dstl::destroy(keys_of(node), keys_of(node) + node->count_);
+            delete node;
+        }
+    };
+}
+
+// B+ tree ordered set
+template<class Key, class Compare = std::less<Key>>
+class btree_set : public detail::raw_btree<Key, void, Compare>
+{
+private:
+    using base = detail::raw_btree<Key, void, Compare>;
+
+public:
+    using value_compare = Compare;
+
+    btree_set () = default;
+
+    explicit btree_set (const Compare &comp) : base(comp) {}
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    btree_set (InputIt first, InputIt last, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(first, last);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    btree_set (sorted_unique_t, InputIt first, InputIt last, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(sorted_unique, first, last);
+    }
+
+    btree_set (std::initializer_list<Key> init, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(init);
+    }
+
+    btree_set &operator= (std::initializer_list<Key> init)
+    {
+        base::clear();
+        base::insert(init);
+        return *this;
+    }
+
+    value_compare value_comp () const { return base::key_comp(); }
+
+    friend void swap (btree_set &lhs, btree_set &rhs) noexcept { lhs.swap(rhs); }
+};
+
+// B+ tree ordered map
+template<class Key, class T, class Compare = std::less<Key>>
+class btree_map : public detail::raw_btree<Key, T, Compare>
+{
+private:
+    using base = detail::raw_btree<Key, T, Compare>;
+
+public:
+    using mapped_type = T;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    btree_map () = default;
+
+    explicit btree_map (const Compare &comp) : base(comp) {}
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    btree_map (InputIt first, InputIt last, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(first, last);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    btree_map (sorted_unique_t, InputIt first, InputIt last, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(sorted_unique, first, last);
+    }
+
+    btree_map (std::initializer_list<value_type> init, const Compare &comp = Compare())
+        : base(comp)
+    {
+        base::insert(init);
+    }
+
+    btree_map &operator= (std::initializer_list<value_type> init)
+    {
+        base::clear();
+        base::insert(init);
+        return *this;
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (const Key &key, Args &&...args)
+    {
+        return base::insert_unique(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (Key &&key, Args &&...args)
+    {
+        return base::insert_unique(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign (const Key &key, M &&obj)
+    {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second)
+            result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    T &operator[] (const Key &key) { return try_emplace(key).first->second; }
+    T &operator[] (Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+    T &at (const Key &key)
+    {
+        auto it = base::find(key);
+        if (it == base::end())
+            throw std::out_of_range("dstl::btree_map::at");
+        return it->second;
+    }
+
+    const T &at (const Key &key) const
+    {
+        auto it = base::find(key);
+        if (it == base::end())
+            throw std::out_of_range("dstl::btree_map::at");
+        return it->second;
+    }
+
+    friend void swap (btree_map &lhs, btree_map &rhs) noexcept { lhs.swap(rhs); }
+};
+
+#endif // DSTL_BTREE_H
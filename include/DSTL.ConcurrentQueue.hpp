@@ -0,0 +1,586 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.ConcurrentQueue.hpp
+
+Abstract:
+    Bounded Lock Free Queues.
+
+    spsc_queue is a ring buffer for one producer and one consumer. The
+    producer owns the tail index and the consumer the head index, each on
+    its own cache line. Both sides keep a private copy of the index of the
+    other side and reload it only when the queue looks full or empty, so
+    in the steady state a cache line moves between the two cores once per
+    batch rather than once per element. Indices grow without bound and
+    are masked into the buffer, which holds a power of two elements.
+
+    mpmc_queue follows Vyukov's bounded queue: every slot carries a
+    sequence number that tells a producer whether the slot is free for
+    the current lap and a consumer whether it holds a value, so a push or
+    pop is one CAS on the shared index plus one store to the slot. The
+    slot layout follows the element type. A nothrow move constructible
+    value lives in the slot, anything else lives in a heap box the slot
+    points to, so that a claimed slot can always be completed even when
+    constructing the value throws. Slots are packed, but consecutive
+    indices are spread over different cache lines so that threads working
+    on neighbouring indices do not share a line.
+
+    blocking_mpmc_queue adds push and pop that wait, parking on an event
+    count built on atomic wait, i.e. a futex on Linux, once spinning has
+    not helped.
+
+--*/
+
+#ifndef DSTL_CONCURRENT_QUEUE_H
+#define DSTL_CONCURRENT_QUEUE_H
+
+// a bounded queue for exactly one producer thread and one consumer thread
+template<class T, size_t Capacity>
+class spsc_queue
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "spsc_queue capacity must be a power of two");
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    spsc_queue () noexcept = default;
+
+    spsc_queue (const spsc_queue &)            = delete;
+    spsc_queue &operator= (const spsc_queue &) = delete;
+
+    ~spsc_queue ()
+    {
+        if constexpr (!is_trivially_destructible_v<T>)
+        {
+            const size_t tail = tail_.load(std::memory_order_acquire);
+            for (size_t head = head_.load(std::memory_order_relaxed); head != tail; ++head)
+                dstl::destroy_at(slot(head));
+        }
+    }
+
+    static constexpr size_t capacity () noexcept { return Capacity; }
+
+    //
+    // producer
+    //
+
+    template<class... Args>
+    bool try_emplace (Args &&...args)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_cache_ == Capacity)
+        {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail - head_cache_ == Capacity)
+                return false;
+        }
+        ::new (static_cast<void *>(slot(tail))) T(std::forward<Args>(args)...);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_push (const T &value) { return try_emplace(value); }
+
+    bool try_push (T &&value) { return try_emplace(std::move(value)); }
+
+    // copies as many of the count elements at src as fit, returns how many
+    size_t push_n (const T *src, size_t count)
+    {
+        const size_t tail = tail_.load(std::memory_order_relaxed);
+        if (Capacity - (tail - head_cache_) < count)
+            head_cache_ = head_.load(std::memory_order_acquire);
+        const size_t free = Capacity - (tail - head_cache_);
+        const size_t n    = count < free ? count : free;
+        if (n == 0)
+            return 0;
+
+        if constexpr (is_trivially_copyable_v<T>)
+        {
+            // up to the end of the buffer, then the rest from its start
+            const size_t first = tail & (Capacity - 1);
+            const size_t split = Capacity - first < n ? Capacity - first : n;
+            std::memcpy(static_cast<void *>(slot(tail)), src, split * sizeof(T));
+            std::memcpy(static_cast<void *>(slot(0)), src + split, (n - split) * sizeof(T));
+        }
+        else
+        {
+            size_t i = 0;
+            try
+            {
+                for (; i < n; ++i)
+                    ::new (static_cast<void *>(slot(tail + i))) T(src[i]);
+            }
+            catch (...)
+            {
+                for (size_t j = 0; j < i; ++j)
+                    dstl::destroy_at(slot(tail + j));
+                throw;
+            }
+        }
+        tail_.store(tail + n, std::memory_order_release);
+        return n;
+    }
+
+    //
+    // consumer
+    //
+
+    bool try_pop (T &value)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_cache_)
+        {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head == tail_cache_)
+                return false;
+        }
+        T *elem = slot(head);
+        value   = std::move(*elem);
+        dstl::destroy_at(elem);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // moves up to count elements into the elements at dst, returns how many
+    size_t pop_n (T *dst, size_t count)
+    {
+        const size_t head = head_.load(std::memory_order_relaxed);
+        if (tail_cache_ - head < count)
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+        const size_t available = tail_cache_ - head;
+        const size_t n         = count < available ? count : available;
+        if (n == 0)
+            return 0;
+
+        if constexpr (is_trivially_copyable_v<T>)
+        {
+            const size_t first = head & (Capacity - 1);
+            const size_t split = Capacity - first < n ? Capacity - first : n;
+            std::memcpy(static_cast<void *>(dst), slot(head), split * sizeof(T));
+            std::memcpy(static_cast<void *>(dst + split), slot(0), (n - split) * sizeof(T));
+        }
+        else
+        {
+            size_t i = 0;
+            try
+            {
+                for (; i < n; ++i)
+                {
+                    T *elem = slot(head + i);
+                    dst[i]  = std::move(*elem);
+                    dstl::destroy_at(elem);
+                }
+            }
+            catch (...)
+            {
+                // the elements before i are destroyed, the one whose assignment threw stays queued
+                head_.store(head + i, std::memory_order_release);
+                throw;
+            }
+        }
+        head_.store(head + n, std::memory_order_release);
+        return n;
+    }
+
+    //
+    // either side, exact only when the other side is idle
+    //
+
+    size_t size () const noexcept
+    {
+        const size_t head = head_.load(std::memory_order_acquire);
+        return tail_.load(std::memory_order_acquire) - head;
+    }
+
+    bool empty () const noexcept { return size() == 0; }
+
+private:
+    T *slot (size_t index) noexcept { return std::launder(reinterpret_cast<T *>(buffer_) + (index & (Capacity - 1))); }
+
+    // written by the producer
+    alignas(detail::cache_line_size) std::atomic<size_t> tail_{0};
+    size_t head_cache_ = 0;
+
+    // written by the consumer
+    alignas(detail::cache_line_size) std::atomic<size_t> head_{0};
+    size_t tail_cache_ = 0;
+
+    alignas(detail::cache_line_size > alignof(T) ? detail::cache_line_size : alignof(T)) unsigned char buffer_[Capacity * sizeof(T)];
+};
+
+namespace detail
+{
+    // a value slot of mpmc_queue. when moving the value cannot throw it is stored in place
+    template<class T, bool Inline = is_nothrow_move_constructible_v<T>>
+    struct mpmc_slot_base
+    {
+        std::atomic<size_t> seq_;
+        alignas(T) unsigned char storage_[sizeof(T)];
+
+        T *value () noexcept { return std::launder(reinterpret_cast<T *>(storage_)); }
+    };
+
+    // otherwise the slot points to a boxed value, which is null when constructing it threw
+    template<class T>
+    struct mpmc_slot_base<T, false>
+    {
+        std::atomic<size_t> seq_;
+        T *box_;
+    };
+
+    // rounds the slot up to a power of two so that a whole number of slots fits a cache line
+    template<class T>
+    inline constexpr size_t mpmc_slot_align = sizeof(mpmc_slot_base<T>) < cache_line_size ? std::bit_ceil(sizeof(mpmc_slot_base<T>))
+                                                                                          : cache_line_size;
+
+    template<class T>
+    struct alignas(mpmc_slot_align<T>) mpmc_slot : mpmc_slot_base<T> {};
+}
+
+// a bounded queue for any number of producer and consumer threads
+template<class T>
+class mpmc_queue
+{
+    using slot = detail::mpmc_slot<T>;
+
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    // whether values live in the slots rather than in boxes on the heap
+    static constexpr bool stores_inline = is_nothrow_move_constructible_v<T>;
+
+    // the number of slots sharing a cache line
+    static constexpr size_t slots_per_line = sizeof(slot) < detail::cache_line_size ? detail::cache_line_size / sizeof(slot) : 1;
+
+    // holds at least capacity elements, rounded up to a power of two
+    explicit mpmc_queue (size_t capacity)
+    {
+        if (capacity > (size_t(1) << (std::numeric_limits<size_t>::digits - 2)) / sizeof(slot))
+            throw std::length_error("dstl::mpmc_queue");
+
+        capacity_ = std::bit_ceil(capacity < 2 * slots_per_line ? 2 * slots_per_line : capacity);
+        mask_       = capacity_ - 1;
+        lines_      = capacity_ / slots_per_line;
+        line_shift_ = static_cast<unsigned>(std::countr_zero(lines_));
+
+        slots_ = detail::allocate_n<slot>(capacity_);
+        for (size_t i = 0; i < capacity_; ++i)
+            ::new (static_cast<void *>(slots_ + i)) slot;
+        for (size_t i = 0; i < capacity_; ++i)
+            at(i).seq_.store(i, std::memory_order_relaxed);
+    }
+
+    mpmc_queue (const mpmc_queue &)            = delete;
+    mpmc_queue &operator= (const mpmc_queue &) = delete;
+
+    ~mpmc_queue ()
+    {
+        if constexpr (!is_trivially_destructible_v<T> || !stores_inline)
+        {
+            const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+            for (size_t head = dequeue_pos_.load(std::memory_order_relaxed); head != tail; ++head)
+            {
+                if constexpr (stores_inline)
+                    dstl::destroy_at(at(head).value());
+                else
+                    delete at(head).box_;
+            }
+        }
+        detail::deallocate_n(slots_, capacity_);
+    }
+
+    size_t capacity () const noexcept { return capacity_; }
+
+    // a failed push leaves its arguments untouched, unless T is stored in place and
+    // constructing it from the arguments may throw
+    template<class... Args>
+    bool try_emplace (Args &&...args)
+    {
+        if constexpr (stores_inline && !is_nothrow_constructible_v<T, Args...>)
+        {
+            // construct first, a claimed slot has to be filled
+            T value(std::forward<Args>(args)...);
+            return try_emplace(std::move(value));
+        }
+        else
+        {
+            size_t pos;
+            slot *s = claim_push(pos);
+            if (s == nullptr)
+                return false;
+
+            if constexpr (stores_inline)
+                ::new (static_cast<void *>(s->storage_)) T(std::forward<Args>(args)...);
+            else
+            {
+                try
+                {
+                    s->box_ = new T(std::forward<Args>(args)...);
+                }
+                catch (...)
+                {
+                    s->box_ = nullptr;
+                    s->seq_.store(pos + 1, std::memory_order_release);
+                    throw;
+                }
+            }
+            s->seq_.store(pos + 1, std::memory_order_release);
+            return true;
+        }
+    }
+
+    bool try_push (const T &value) { return try_emplace(value); }
+
+    bool try_push (T &&value) { return try_emplace(std::move(value)); }
+
+    bool try_pop (T &value)
+    {
+        for (;;)
+        {
+            size_t pos;
+            slot *s = claim_pop(pos);
+            if (s == nullptr)
+                return false;
+
+            if constexpr (is_trivially_copyable_v<T> && stores_inline)
+            {
+                value = *s->value();
+                release_pop(s, pos);
+                return true;
+            }
+            else if constexpr (stores_inline)
+            {
+                // free the slot before the assignment, which may throw
+                T moved(std::move(*s->value()));
+                dstl::destroy_at(s->value());
+                release_pop(s, pos);
+                value = std::move(moved);
+                return true;
+            }
+            else
+            {
+                T *box = s->box_;
+                release_pop(s, pos);
+                if (box == nullptr)
+                    continue;
+                try
+                {
+                    value = std::move(*box);
+                }
+                catch (...)
+                {
+                    delete box;
+                    throw;
+                }
+                delete box;
+                return true;
+            }
+        }
+    }
+
+    // exact only while no other thread uses the queue
+    size_t size () const noexcept
+    {
+        const size_t head = dequeue_pos_.load(std::memory_order_acquire);
+        const size_t tail = enqueue_pos_.load(std::memory_order_acquire);
+        return tail > head ? tail - head : 0;
+    }
+
+    bool empty () const noexcept { return size() == 0; }
+
+private:
+    // consecutive positions go to consecutive cache lines
+    slot &at (size_t pos) const noexcept
+    {
+        const size_t index = pos & mask_;
+        return slots_[(index & (lines_ - 1)) * slots_per_line + (index >> line_shift_)];
+    }
+
+    // a slot is free for the lap of pos when its sequence is pos, and full when it is pos + 1
+    slot *claim_push (size_t &pos) noexcept
+    {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot &s          = at(pos);
+            const size_t seq = s.seq_.load(std::memory_order_acquire);
+            const auto diff  = static_cast<ptrdiff_t>(seq - pos);
+            if (diff == 0)
+            {
+                if (enqueue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    return &s;
+            }
+            else if (diff < 0)
+                return nullptr;
+            else
+                pos = enqueue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    slot *claim_pop (size_t &pos) noexcept
+    {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            slot &s          = at(pos);
+            const size_t seq = s.seq_.load(std::memory_order_acquire);
+            const auto diff  = static_cast<ptrdiff_t>(seq - (pos + 1));
+            if (diff == 0)
+            {
+                if (dequeue_pos_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                    return &s;
+            }
+            else if (diff < 0)
+                return nullptr;
+            else
+                pos = dequeue_pos_.load(std::memory_order_relaxed);
+        }
+    }
+
+    // hands the slot to the producer of the next lap
+    void release_pop (slot *s, size_t pos) noexcept { s->seq_.store(pos + capacity_, std::memory_order_release); }
+
+    slot *slots_ = nullptr;
+    size_t capacity_;
+    size_t mask_;
+    size_t lines_;
+    unsigned line_shift_;
+
+    alignas(detail::cache_line_size) std::atomic<size_t> enqueue_pos_{0};
+    alignas(detail::cache_line_size) std::atomic<size_t> dequeue_pos_{0};
+};
+
+namespace detail
+{
+    // an event count: a waiter takes the epoch, registers and checks its condition once more
+    // before it sleeps, and notify only moves the epoch when somebody is registered
+    class wait_event
+    {
+    public:
+        void notify () noexcept
+        {
+            // a read-modify-write, so that it is ordered with the registration of a waiter
+            if (waiters_.fetch_add(0, std::memory_order_seq_cst) != 0)
+            {
+                epoch_.fetch_add(1, std::memory_order_release);
+                epoch_.notify_one();
+            }
+        }
+
+        // returns whether attempt succeeded, otherwise the caller has been woken and retries
+        template<class Attempt>
+        bool wait (Attempt &&attempt)
+        {
+            const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+            waiters_.fetch_add(1, std::memory_order_seq_cst);
+            bool done = false;
+            try
+            {
+                done = attempt();
+            }
+            catch (...)
+            {
+                waiters_.fetch_sub(1, std::memory_order_relaxed);
+                throw;
+            }
+            if (!done)
+                epoch_.wait(epoch, std::memory_order_acquire);
+            waiters_.fetch_sub(1, std::memory_order_relaxed);
+            return done;
+        }
+
+    private:
+        alignas(cache_line_size) std::atomic<uint32_t> epoch_{0};
+        std::atomic<uint32_t> waiters_{0};
+    };
+}
+
+// mpmc_queue with push and pop that wait for room and for values
+template<class T>
+class blocking_mpmc_queue
+{
+public:
+    using value_type = T;
+    using size_type  = size_t;
+
+    // the number of failed attempts before a waiting thread parks
+    static constexpr size_t spin_rounds = 64;
+
+    explicit blocking_mpmc_queue (size_t capacity) : queue_(capacity) {}
+
+    size_t capacity () const noexcept { return queue_.capacity(); }
+
+    size_t size () const noexcept { return queue_.size(); }
+
+    bool empty () const noexcept { return queue_.empty(); }
+
+    template<class... Args>
+    bool try_emplace (Args &&...args)
+    {
+        if (!queue_.try_emplace(std::forward<Args>(args)...))
+            return false;
+        not_empty_.notify();
+        return true;
+    }
+
+    bool try_push (const T &value) { return try_emplace(value); }
+
+    bool try_push (T &&value) { return try_emplace(std::move(value)); }
+
+    bool try_pop (T &value)
+    {
+        if (!queue_.try_pop(value))
+            return false;
+        not_full_.notify();
+        return true;
+    }
+
+    template<class... Args>
+    void emplace (Args &&...args)
+    {
+        if constexpr (mpmc_queue<T>::stores_inline && !is_nothrow_constructible_v<T, Args...>)
+        {
+            // retries must not construct from arguments that an earlier attempt moved from
+            T value(std::forward<Args>(args)...);
+            emplace(std::move(value));
+        }
+        else
+            wait_for(not_full_, [&] { return try_emplace(std::forward<Args>(args)...); });
+    }
+
+    void push (const T &value) { emplace(value); }
+
+    void push (T &&value) { emplace(std::move(value)); }
+
+    void pop (T &value)
+    {
+        wait_for(not_empty_, [&] { return try_pop(value); });
+    }
+
+private:
+    template<class Attempt>
+    static void wait_for (detail::wait_event &event, Attempt attempt)
+    {
+        for (size_t round = 0; round < spin_rounds; ++round)
+        {
+            if (attempt())
+                return;
+            if (round != 0)
+                std::this_thread::yield();
+        }
+        while (!event.wait(attempt))
+        {
+        }
+    }
+
+    mpmc_queue<T> queue_;
+    detail::wait_event not_empty_;
+    detail::wait_event not_full_;
+};
+
+#endif // DSTL_CONCURRENT_QUEUE_H
@@ -0,0 +1,478 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Execution.hpp
+
+Abstract:
+    Execution Policies and Parallel Algorithms.
+
+    The parallel policies split a range into chunks that run on the
+    default_thread_pool, one worker per hardware thread besides the calling
+    one. The jobs that fan a call out live on the stack of the calling
+    thread, and on the heap only past 16 of them, and that thread runs
+    pending jobs while it waits for them, so nested parallel calls cannot
+    deadlock the pool.
+
+    As with the standard policies, an exception escaping an element access
+    function under par or par_unseq calls std::terminate. par_unseq is
+    executed like par.
+
+--*/
+
+#ifndef DSTL_EXECUTION_H
+#define DSTL_EXECUTION_H
+
+namespace execution
+{
+    class sequenced_policy
+    {
+    };
+
+    class parallel_policy
+    {
+    };
+
+    class parallel_unsequenced_policy
+    {
+    };
+
+    inline constexpr sequenced_policy seq{};
+    inline constexpr parallel_policy par{};
+    inline constexpr parallel_unsequenced_policy par_unseq{};
+}
+
+// checks if a type is an execution policy
+template<class T>
+struct is_execution_policy : false_type {};
+template<>
+struct is_execution_policy<execution::sequenced_policy> : true_type {};
+template<>
+struct is_execution_policy<execution::parallel_policy> : true_type {};
+template<>
+struct is_execution_policy<execution::parallel_unsequenced_policy> : true_type {};
+
+template<class T> inline constexpr bool is_execution_policy_v = is_execution_policy<T>::value;
+
+namespace detail
+{
+    template<class Policy>
+    inline constexpr bool is_parallel_policy_v = is_any_of_v<remove_cvref_t<Policy>, execution::parallel_policy, execution::parallel_unsequenced_policy>;
+
+    // chunks per thread, so that uneven chunks even out across the pool
+    inline constexpr size_t chunks_per_thread = 4;
+
+    // helper jobs of a parallel call kept in its frame, more are allocated
+    inline constexpr size_t parallel_inline_jobs = 16;
+
+    // ranges of cheap element operations below this size per chunk are not worth a task
+    inline constexpr size_t parallel_min_chunk = 2048;
+
+    // the number of chunks to split n elements into, at least min_chunk elements each
+    inline size_t parallel_chunk_count (size_t n, size_t min_chunk) noexcept
+    {
+        const size_t limit = default_thread_pool().concurrency() * chunks_per_thread;
+        const size_t count = (n + min_chunk - 1) / min_chunk;
+        return count < limit ? count : limit;
+    }
+
+    // the first element of chunk index when n elements are split into count chunks
+    inline size_t chunk_begin (size_t n, size_t count, size_t index) noexcept
+    {
+        return n / count * index + (index < n % count ? index : n % count);
+    }
+
+    // runs body(index) for every index in [0, count) across the pool and the calling thread
+    template<class Body>
+    void parallel_invoke_n (size_t count, Body &body)
+    {
+        thread_pool &pool = default_thread_pool();
+        if (count == 0)
+            return;
+        if (count == 1 || pool.concurrency() == 1)
+        {
+            for (size_t i = 0; i < count; ++i)
+                body(i);
+            return;
+        }
+
+        std::atomic<size_t> next{0};
+        std::atomic<size_t> finished{0};
+        auto run = [&] () noexcept {
+            for (size_t i; (i = next.fetch_add(1, std::memory_order_relaxed)) < count;)
+                body(i);
+        };
+
+        // the helper jobs live in this frame, so it waits for all of them and not only for the indices
+        const size_t helpers = (count < pool.concurrency() ? count : pool.concurrency()) - 1;
+        alignas(pool_job) unsigned char inline_jobs[parallel_inline_jobs * sizeof(pool_job)];
+        pool_job *jobs = helpers <= parallel_inline_jobs ? reinterpret_cast<pool_job *>(inline_jobs) : allocate_n<pool_job>(helpers);
+        for (size_t i = 0; i < helpers; ++i)
+        {
+            ::new (static_cast<void *>(jobs + i)) pool_job{[&run, &finished] () noexcept {
+                run();
+                finished.fetch_add(1, std::memory_order_release);
+            }};
+            pool.enqueue(jobs[i]);
+        }
+        run();
+        while (finished.load(std::memory_order_acquire) != helpers)
+        {
+            if (!pool.run_pending_task())
+                std::this_thread::yield();
+        }
+        dstl::destroy(jobs, jobs + helpers);
+        if (helpers > parallel_inline_jobs)
+            deallocate_n(jobs, helpers);
+    }
+
+    // runs body(begin, end) over the index ranges of n elements split into chunks of at least min_chunk
+    template<class Body>
+    void parallel_for (size_t n, size_t min_chunk, Body body)
+    {
+        const size_t count = parallel_chunk_count(n, min_chunk);
+        auto chunk         = [&] (size_t index) { body(chunk_begin(n, count, index), chunk_begin(n, count, index + 1)); };
+        parallel_invoke_n(count, chunk);
+    }
+
+    // finds the split of the first d elements of the stable merge of a and b: i elements of a and d - i of b
+    template<class ItA, class ItB, class Compare>
+    size_t merge_path (ItA a, size_t na, ItB b, size_t nb, size_t d, Compare &comp)
+    {
+        size_t lo = d > nb ? d - nb : 0;
+        size_t hi = d < na ? d : na;
+        while (lo < hi)
+        {
+            const size_t i = lo + (hi - lo) / 2;
+            const size_t j = d - i;
+            if (j > 0 && i < na && !comp(b[j - 1], a[i]))
+                lo = i + 1;
+            else
+                hi = i;
+        }
+        return lo;
+    }
+
+    // merges the sorted runs of src pairwise into dst, every merge split along its merge path.
+    // run r is [runs[r], runs[r + 1]), and runs[run_count + 1] is n so that an odd run out meets an empty one
+    template<class Src, class Dst, class Compare>
+    void parallel_merge_runs (Src src, Dst dst, const size_t *runs, size_t run_count, size_t n, Compare &comp)
+    {
+        // the elements the first run of its pair contributes before every piece boundary. found up front,
+        // the searches would otherwise read elements that other pieces are moving
+        const size_t pieces = parallel_chunk_count(n, parallel_min_chunk);
+        vector<size_t> splits(pieces + 1);
+        for (size_t k = 0, r = 0; k < pieces; ++k)
+        {
+            const size_t d = chunk_begin(n, pieces, k);
+            while (runs[r + 2] <= d)
+                r += 2;
+            splits[k] = merge_path(src + runs[r], runs[r + 1] - runs[r], src + runs[r + 1], runs[r + 2] - runs[r + 1], d - runs[r], comp);
+        }
+
+        auto merge_piece = [&] (size_t piece) {
+            const size_t out_begin = chunk_begin(n, pieces, piece);
+            const size_t out_end   = chunk_begin(n, pieces, piece + 1);
+
+            // a piece may span several pairs of runs
+            for (size_t r = 0; r < run_count && runs[r] < out_end; r += 2)
+            {
+                const size_t a_begin = runs[r];
+                const size_t b_begin = runs[r + 1];
+                const size_t b_end   = runs[r + 2];
+                if (b_end <= out_begin)
+                    continue;
+
+                const bool starts_inside = out_begin > a_begin;
+                const bool ends_inside   = out_end < b_end;
+                const size_t lo          = starts_inside ? out_begin - a_begin : 0;
+                const size_t hi          = ends_inside ? out_end - a_begin : b_end - a_begin;
+                const size_t i0          = starts_inside ? splits[piece] : 0;
+                const size_t i1          = ends_inside ? splits[piece + 1] : b_begin - a_begin;
+                std::merge(std::make_move_iterator(src + a_begin + i0), std::make_move_iterator(src + a_begin + i1),
+                           std::make_move_iterator(src + b_begin + (lo - i0)), std::make_move_iterator(src + b_begin + (hi - i1)),
+                           dst + a_begin + lo, comp);
+            }
+        };
+        parallel_invoke_n(pieces, merge_piece);
+    }
+
+    // sorts runs in parallel, then merges them pairwise through a buffer
+    template<class RandomIt, class Compare>
+    void parallel_sort (RandomIt first, RandomIt last, Compare &comp)
+    {
+        using T        = std::iter_value_t<RandomIt>;
+        const size_t n = static_cast<size_t>(last - first);
+        const size_t k = parallel_chunk_count(n, parallel_min_chunk * 8);
+        if (k < 2)
+        {
+            dstl::sort(first, last, comp);
+            return;
+        }
+
+        // run r is [runs[r], runs[r + 1]), an odd run out is paired with an empty one
+        vector<size_t> runs(k + 2);
+        for (size_t r = 0; r <= k; ++r)
+            runs[r] = chunk_begin(n, k, r);
+        runs[k + 1] = n;
+
+        // every run is sorted in place and then moved into the buffer, whose elements the merges reuse
+        T *buffer = allocate_n<T>(n);
+        auto sort_run = [&] (size_t r) {
+            dstl::sort(first + runs[r], first + runs[r + 1], comp);
+            for (size_t i = runs[r]; i != runs[r + 1]; ++i)
+                ::new (static_cast<void *>(buffer + i)) T(std::move(first[i]));
+        };
+        parallel_invoke_n(k, sort_run);
+
+        bool in_buffer = true;
+        for (size_t run_count = k; run_count > 1; run_count = (run_count + 1) / 2)
+        {
+            if (in_buffer)
+                parallel_merge_runs(buffer, first, runs.data(), run_count, n, comp);
+            else
+                parallel_merge_runs(first, buffer, runs.data(), run_count, n, comp);
+            in_buffer = !in_buffer;
+
+            // the boundaries of the merged runs
+            size_t merged = 0;
+            for (size_t r = 0; r < run_count; r += 2)
+                runs[merged++] = runs[r];
+            runs[merged]     = n;
+            runs[merged + 1] = n;
+        }
+
+        if (in_buffer)
+            parallel_for(n, parallel_min_chunk, [&] (size_t begin, size_t end) { std::move(buffer + begin, buffer + end, first + begin); });
+        dstl::destroy(buffer, buffer + n);
+        deallocate_n(buffer, n);
+    }
+}
+
+// applies f to every element of [first, last)
+template<class ExecutionPolicy, class ForwardIt, class UnaryFunc,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> && is_invocable_v<UnaryFunc &, std::iter_reference_t<ForwardIt>>>>
+void for_each (ExecutionPolicy &&, ForwardIt first, ForwardIt last, UnaryFunc f)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt>)
+    {
+        detail::parallel_for(static_cast<size_t>(last - first), 1, [&] (size_t begin, size_t end) noexcept {
+            for (ForwardIt it = first + begin, stop = first + end; it != stop; ++it)
+                std::invoke(f, *it);
+        });
+    }
+    else
+    {
+        for (; first != last; ++first)
+            std::invoke(f, *first);
+    }
+}
+
+// stores op applied to every element of [first, last) in the range beginning at d_first
+template<class ExecutionPolicy, class ForwardIt, class OutputIt, class UnaryOp,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> && is_invocable_v<UnaryOp &, std::iter_reference_t<ForwardIt>>>>
+OutputIt transform (ExecutionPolicy &&, ForwardIt first, ForwardIt last, OutputIt d_first, UnaryOp op)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt> && std::random_access_iterator<OutputIt>)
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for(n, 1, [&] (size_t begin, size_t end) noexcept {
+            OutputIt out = d_first + begin;
+            for (ForwardIt it = first + begin, stop = first + end; it != stop; ++it, ++out)
+                *out = std::invoke(op, *it);
+        });
+        return d_first + n;
+    }
+    else
+    {
+        for (; first != last; ++first, ++d_first)
+            *d_first = std::invoke(op, *first);
+        return d_first;
+    }
+}
+
+// stores op applied to the elements of [first1, last1) and the range beginning at first2 in the range beginning at d_first
+template<class ExecutionPolicy, class ForwardIt1, class ForwardIt2, class OutputIt, class BinaryOp,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> &&
+                             is_invocable_v<BinaryOp &, std::iter_reference_t<ForwardIt1>, std::iter_reference_t<ForwardIt2>>>>
+OutputIt transform (ExecutionPolicy &&, ForwardIt1 first1, ForwardIt1 last1, ForwardIt2 first2, OutputIt d_first, BinaryOp op)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt1> &&
+                  std::random_access_iterator<ForwardIt2> && std::random_access_iterator<OutputIt>)
+    {
+        const size_t n = static_cast<size_t>(last1 - first1);
+        detail::parallel_for(n, 1, [&] (size_t begin, size_t end) noexcept {
+            ForwardIt2 in2 = first2 + begin;
+            OutputIt out   = d_first + begin;
+            for (ForwardIt1 it = first1 + begin, stop = first1 + end; it != stop; ++it, ++in2, ++out)
+                *out = std::invoke(op, *it, *in2);
+        });
+        return d_first + n;
+    }
+    else
+    {
+        for (; first1 != last1; ++first1, ++first2, ++d_first)
+            *d_first = std::invoke(op, *first1, *first2);
+        return d_first;
+    }
+}
+
+// copies [first, last) to the range beginning at d_first
+template<class ExecutionPolicy, class ForwardIt, class OutputIt, class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>>>
+OutputIt copy (ExecutionPolicy &&, ForwardIt first, ForwardIt last, OutputIt d_first)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt> && std::random_access_iterator<OutputIt>)
+    {
+        const size_t n = static_cast<size_t>(last - first);
+        detail::parallel_for(n, detail::parallel_min_chunk, [&] (size_t begin, size_t end) noexcept {
+            std::copy(first + begin, first + end, d_first + begin);
+        });
+        return d_first + n;
+    }
+    else
+    {
+        return std::copy(first, last, d_first);
+    }
+}
+
+// folds [first, last) into init with op, in an unspecified order and grouping
+template<class ExecutionPolicy, class ForwardIt, class T, class BinaryOp,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> && is_invocable_r_v<T, BinaryOp &, T, T>>>
+T reduce (ExecutionPolicy &&, ForwardIt first, ForwardIt last, T init, BinaryOp op)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt>)
+    {
+        const size_t n     = static_cast<size_t>(last - first);
+        const size_t count = detail::parallel_chunk_count(n, detail::parallel_min_chunk);
+        if (count > 1)
+        {
+            // every chunk folds into its first element, the partial sums are folded in chunk order
+            T *partials  = detail::allocate_n<T>(count);
+            auto partial = [&] (size_t index) noexcept {
+                ForwardIt it   = first + detail::chunk_begin(n, count, index);
+                ForwardIt stop = first + detail::chunk_begin(n, count, index + 1);
+                T sum          = *it;
+                while (++it != stop)
+                    sum = std::invoke(op, std::move(sum), *it);
+                ::new (static_cast<void *>(partials + index)) T(std::move(sum));
+            };
+            detail::parallel_invoke_n(count, partial);
+            for (size_t i = 0; i < count; ++i)
+                init = std::invoke(op, std::move(init), std::move(partials[i]));
+            dstl::destroy(partials, partials + count);
+            detail::deallocate_n(partials, count);
+            return init;
+        }
+    }
+
+    for (; first != last; ++first)
+        init = std::invoke(op, std::move(init), *first);
+    return init;
+}
+
+template<class ExecutionPolicy, class ForwardIt, class T, class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>>>
+T reduce (ExecutionPolicy &&policy, ForwardIt first, ForwardIt last, T init)
+{
+    return dstl::reduce(std::forward<ExecutionPolicy>(policy), first, last, std::move(init), std::plus<>());
+}
+
+template<class ExecutionPolicy, class ForwardIt, class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>>>
+std::iter_value_t<ForwardIt> reduce (ExecutionPolicy &&policy, ForwardIt first, ForwardIt last)
+{
+    return dstl::reduce(std::forward<ExecutionPolicy>(policy), first, last, std::iter_value_t<ForwardIt>(), std::plus<>());
+}
+
+// stores the prefix folds of init and [first, last) with op in the range beginning at d_first.
+// the parallel version folds every chunk, scans the chunk sums and then rescans every chunk
+template<class ExecutionPolicy, class ForwardIt, class OutputIt, class BinaryOp, class T,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> && is_invocable_r_v<T, BinaryOp &, T, T>>>
+OutputIt inclusive_scan (ExecutionPolicy &&, ForwardIt first, ForwardIt last, OutputIt d_first, BinaryOp op, T init)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy> && std::random_access_iterator<ForwardIt> && std::random_access_iterator<OutputIt>)
+    {
+        const size_t n     = static_cast<size_t>(last - first);
+        const size_t count = detail::parallel_chunk_count(n, detail::parallel_min_chunk);
+        if (count > 1)
+        {
+            // the fold of every chunk but the last, then the prefix that every chunk starts from
+            T *carries = detail::allocate_n<T>(count);
+            ::new (static_cast<void *>(carries)) T(std::move(init));
+            auto fold = [&] (size_t index) noexcept {
+                ForwardIt it   = first + detail::chunk_begin(n, count, index);
+                ForwardIt stop = first + detail::chunk_begin(n, count, index + 1);
+                T sum          = *it;
+                while (++it != stop)
+                    sum = std::invoke(op, std::move(sum), *it);
+                ::new (static_cast<void *>(carries + index + 1)) T(std::move(sum));
+            };
+            detail::parallel_invoke_n(count - 1, fold);
+            for (size_t i = 1; i < count; ++i)
+                carries[i] = std::invoke(op, carries[i - 1], std::move(carries[i]));
+
+            auto scan = [&] (size_t index) noexcept {
+                const size_t begin = detail::chunk_begin(n, count, index);
+                const size_t end   = detail::chunk_begin(n, count, index + 1);
+                OutputIt out       = d_first + begin;
+                T sum              = carries[index];
+                for (ForwardIt it = first + begin, stop = first + end; it != stop; ++it, ++out)
+                {
+                    sum  = std::invoke(op, std::move(sum), *it);
+                    *out = sum;
+                }
+            };
+            detail::parallel_invoke_n(count, scan);
+            dstl::destroy(carries, carries + count);
+            detail::deallocate_n(carries, count);
+            return d_first + n;
+        }
+    }
+
+    for (; first != last; ++first, ++d_first)
+    {
+        init     = std::invoke(op, std::move(init), *first);
+        *d_first = init;
+    }
+    return d_first;
+}
+
+template<class ExecutionPolicy, class ForwardIt, class OutputIt, class BinaryOp,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> &&
+                             is_invocable_v<BinaryOp &, std::iter_reference_t<ForwardIt>, std::iter_reference_t<ForwardIt>>>>
+OutputIt inclusive_scan (ExecutionPolicy &&policy, ForwardIt first, ForwardIt last, OutputIt d_first, BinaryOp op)
+{
+    if (first == last)
+        return d_first;
+
+    // the first element seeds the fold
+    std::iter_value_t<ForwardIt> init = *first;
+    *d_first                          = init;
+    return dstl::inclusive_scan(std::forward<ExecutionPolicy>(policy), std::next(first), last, std::next(d_first), op, std::move(init));
+}
+
+template<class ExecutionPolicy, class ForwardIt, class OutputIt, class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>>>
+OutputIt inclusive_scan (ExecutionPolicy &&policy, ForwardIt first, ForwardIt last, OutputIt d_first)
+{
+    return dstl::inclusive_scan(std::forward<ExecutionPolicy>(policy), first, last, d_first, std::plus<>());
+}
+
+// sorts [first, last) with comp, not stable. the parallel version sorts a run per chunk and merges the runs
+template<class ExecutionPolicy, class RandomIt, class Compare,
+         class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>> &&
+                             is_invocable_r_v<bool, Compare &, std::iter_reference_t<RandomIt>, std::iter_reference_t<RandomIt>>>>
+void sort (ExecutionPolicy &&, RandomIt first, RandomIt last, Compare comp)
+{
+    if constexpr (detail::is_parallel_policy_v<ExecutionPolicy>)
+        detail::parallel_sort(first, last, comp);
+    else
+        dstl::sort(first, last, comp);
+}
+
+template<class ExecutionPolicy, class RandomIt, class = enable_if_t<is_execution_policy_v<remove_cvref_t<ExecutionPolicy>>>>
+void sort (ExecutionPolicy &&policy, RandomIt first, RandomIt last)
+{
+    dstl::sort(std::forward<ExecutionPolicy>(policy), first, last, std::less<>());
+}
+
+#endif // DSTL_EXECUTION_H
@@ -0,0 +1,792 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.FlatMap.hpp
+
+Abstract:
+    Sorted Array Map and Set.
+
+    flat_set keeps its keys in one sorted vector, flat_map keeps its keys
+    and its mapped values in two parallel vectors, so a lookup touches only
+    the contiguous key array and runs the branchless lower_bound on it.
+    Inserting or erasing one element shifts the tail of each array, with
+    memmove for trivially relocatable types. Bulk inserts append the new
+    elements and merge them with the old ones in a single pass; input that
+    is tagged sorted_unique skips sorting, and input that only extends the
+    largest key skips the merge as well.
+
+--*/
+
+#ifndef DSTL_FLATMAP_H
+#define DSTL_FLATMAP_H
+
+// tells bulk constructors and inserts that their input is sorted and free of equivalent keys
+struct sorted_unique_t
+{
+    explicit sorted_unique_t () = default;
+};
+
+inline constexpr sorted_unique_t sorted_unique{};
+
+namespace detail
+{
+    // visits the indices of the sorted unique runs [0, mid) and [mid, size) of keys in merged
+    // order, skipping keys of the second run that the first one holds
+    template<class Key, class Compare, class Take>
+    void merge_sorted_runs (const Key *keys, size_t mid, size_t size, const Compare &comp, Take take)
+    {
+        size_t i = 0;
+        size_t j = mid;
+        while (i < mid && j < size)
+        {
+            if (comp(keys[j], keys[i]))
+                take(j++);
+            else
+            {
+                if (!comp(keys[i], keys[j]))
+                    ++j;
+                take(i++);
+            }
+        }
+        for (; i < mid; ++i)
+            take(i);
+        for (; j < size; ++j)
+            take(j);
+    }
+}
+
+// sorted array set
+template<class Key, class Compare = std::less<Key>>
+class flat_set
+{
+public:
+    using key_type               = Key;
+    using value_type             = Key;
+    using key_compare            = Compare;
+    using value_compare          = Compare;
+    using size_type              = size_t;
+    using difference_type        = ptrdiff_t;
+    using reference              = const Key &;
+    using const_reference        = const Key &;
+    using container_type         = vector<Key>;
+    using iterator               = const Key *;
+    using const_iterator         = const Key *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    container_type keys_;
+    [[no_unique_address]] Compare comp_;
+
+public:
+    flat_set () = default;
+
+    explicit flat_set (const Compare &comp) : comp_(comp) {}
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    flat_set (InputIt first, InputIt last, const Compare &comp = Compare())
+        : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    flat_set (sorted_unique_t, InputIt first, InputIt last, const Compare &comp = Compare())
+        : keys_(first, last), comp_(comp)
+    {
+    }
+
+    // adopts keys, which must be sorted and free of equivalent keys
+    flat_set (sorted_unique_t, container_type keys, const Compare &comp = Compare())
+        : keys_(std::move(keys)), comp_(comp)
+    {
+    }
+
+    flat_set (std::initializer_list<Key> init, const Compare &comp = Compare())
+        : comp_(comp)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    flat_set &operator= (std::initializer_list<Key> init)
+    {
+        clear();
+        insert(init.begin(), init.end());
+        return *this;
+    }
+
+    //
+    // iterators
+    //
+
+    iterator begin () const noexcept { return keys_.begin(); }
+    iterator end () const noexcept { return keys_.end(); }
+    const_iterator cbegin () const noexcept { return keys_.begin(); }
+    const_iterator cend () const noexcept { return keys_.end(); }
+    reverse_iterator rbegin () const noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend () const noexcept { return reverse_iterator(begin()); }
+
+    //
+    // capacity
+    //
+
+    [[nodiscard]] bool empty () const noexcept { return keys_.empty(); }
+    [[nodiscard]] size_type size () const noexcept { return keys_.size(); }
+
+    void reserve (size_type count) { keys_.reserve(count); }
+    void shrink_to_fit () { keys_.shrink_to_fit(); }
+
+    //
+    // modifiers
+    //
+
+    std::pair<iterator, bool> insert (const Key &key) { return insert_unique(key); }
+    std::pair<iterator, bool> insert (Key &&key) { return insert_unique(std::move(key)); }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace (Args &&...args)
+    {
+        Key tmp(std::forward<Args>(args)...);
+        return insert_unique(std::move(tmp));
+    }
+
+    template<class InputIt>
+    void insert (InputIt first, InputIt last)
+    {
+        const size_t mid = append(first, last);
+        // equivalent keys keep their input order, so unique keeps the first of them
+        std::stable_sort(keys_.begin() + mid, keys_.end(), comp_);
+        auto equivalent = [this] (const Key &a, const Key &b) { return !comp_(a, b); };
+        keys_.erase(std::unique(keys_.begin() + mid, keys_.end(), equivalent), keys_.end());
+        merge_back(mid);
+    }
+
+    // inserts [first, last), which must be sorted and free of equivalent keys
+    template<class InputIt>
+    void insert (sorted_unique_t, InputIt first, InputIt last)
+    {
+        merge_back(append(first, last));
+    }
+
+    void insert (std::initializer_list<Key> init) { insert(init.begin(), init.end()); }
+
+    // moves the keys out, leaving the set empty
+    container_type extract () &&
+    {
+        container_type keys = std::move(keys_);
+        keys_.clear();
+        return keys;
+    }
+
+    // adopts keys, which must be sorted and free of equivalent keys
+    void replace (container_type &&keys) { keys_ = std::move(keys); }
+
+    iterator erase (const_iterator pos) { return keys_.erase(pos); }
+    iterator erase (const_iterator first, const_iterator last) { return keys_.erase(first, last); }
+
+    size_type erase (const Key &key)
+    {
+        const_iterator pos = find(key);
+        if (pos == end())
+            return 0;
+        keys_.erase(pos);
+        return 1;
+    }
+
+    void clear () noexcept { keys_.clear(); }
+
+    void swap (flat_set &other) noexcept
+    {
+        keys_.swap(other.keys_);
+        std::swap(comp_, other.comp_);
+    }
+
+    friend void swap (flat_set &lhs, flat_set &rhs) noexcept { lhs.swap(rhs); }
+
+    //
+    // lookup
+    //
+
+    iterator find (const Key &key) const
+    {
+        const_iterator pos = lower_bound(key);
+        return pos != end() && !comp_(key, *pos) ? pos : end();
+    }
+
+    [[nodiscard]] bool contains (const Key &key) const { return find(key) != end(); }
+    [[nodiscard]] size_type count (const Key &key) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound (const Key &key) const { return dstl::lower_bound(begin(), end(), key, comp_); }
+    iterator upper_bound (const Key &key) const { return dstl::upper_bound(begin(), end(), key, comp_); }
+
+    std::pair<iterator, iterator> equal_range (const Key &key) const
+    {
+        const_iterator pos = lower_bound(key);
+        return {pos, pos != end() && !comp_(key, *pos) ? pos + 1 : pos};
+    }
+
+    //
+    // observers
+    //
+
+    key_compare key_comp () const { return comp_; }
+    value_compare value_comp () const { return comp_; }
+
+    const container_type &keys () const noexcept { return keys_; }
+
+    friend bool operator== (const flat_set &lhs, const flat_set &rhs) { return lhs.keys_ == rhs.keys_; }
+
+private:
+    template<class K>
+    std::pair<iterator, bool> insert_unique (K &&key)
+    {
+        const_iterator pos = lower_bound(key);
+        if (pos != end() && !comp_(key, *pos))
+            return {pos, false};
+        return {keys_.emplace(pos, std::forward<K>(key)), true};
+    }
+
+    // appends [first, last) and returns where the new keys start
+    template<class InputIt>
+    size_t append (InputIt first, InputIt last)
+    {
+        const size_t mid = keys_.size();
+        if constexpr (std::forward_iterator<InputIt>)
+            keys_.reserve(mid + static_cast<size_t>(std::distance(first, last)));
+        try
+        {
+            for (; first != last; ++first)
+                keys_.emplace_back(*first);
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + mid, keys_.end());
+            throw;
+        }
+        return mid;
+    }
+
+    // merges the sorted unique keys from mid on into the ones before them
+    void merge_back (size_t mid)
+    {
+        const size_t size = keys_.size();
+        // appending past the largest key, the usual way to build a set, needs no merge
+        if (mid == 0 || mid == size || comp_(keys_[mid - 1], keys_[mid]))
+            return;
+
+        try
+        {
+            container_type merged;
+            merged.reserve(size);
+            detail::merge_sorted_runs(keys_.data(), mid, size, comp_, [&] (size_t i) {
+                merged.push_back(std::move_if_noexcept(keys_[i]));
+            });
+            keys_.swap(merged);
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + mid, keys_.end());
+            throw;
+        }
+    }
+};
+
+// sorted array map, keys and mapped values in separate arrays
+template<class Key, class T, class Compare = std::less<Key>>
+class flat_map
+{
+public:
+    using key_type              = Key;
+    using mapped_type           = T;
+    using value_type            = std::pair<Key, T>;
+    using key_compare           = Compare;
+    using size_type             = size_t;
+    using difference_type       = ptrdiff_t;
+    using reference             = std::pair<const Key &, T &>;
+    using const_reference       = std::pair<const Key &, const T &>;
+    using key_container_type    = vector<Key>;
+    using mapped_container_type = vector<T>;
+
+    // the two arrays, as handed out by extract
+    struct containers
+    {
+        key_container_type keys_;
+        mapped_container_type values_;
+    };
+
+    // an element is a pair of references into the two arrays
+    template<bool Const>
+    class basic_iterator
+    {
+        friend class flat_map;
+        template<bool> friend class basic_iterator;
+
+    public:
+        using iterator_concept  = std::random_access_iterator_tag;
+        using iterator_category = std::input_iterator_tag;
+        using value_type        = std::pair<Key, T>;
+        using difference_type   = ptrdiff_t;
+        using reference         = conditional_t<Const, flat_map::const_reference, flat_map::reference>;
+
+        // operator-> returns the pair of references by value, wrapped so that -> reaches its members
+        class pointer
+        {
+        private:
+            reference ref_;
+
+        public:
+            explicit pointer (reference ref) noexcept : ref_(ref) {}
+
+            const reference *operator-> () const noexcept { return &ref_; }
+        };
+
+    private:
+        using mapped_pointer = conditional_t<Const, const T *, T *>;
+
+        const Key *key_       = nullptr;
+        mapped_pointer value_ = nullptr;
+
+        basic_iterator (const Key *key, mapped_pointer value) noexcept : key_(key), value_(value) {}
+
+    public:
+        basic_iterator () noexcept = default;
+
+        template<bool C = Const, class = enable_if_t<C>>
+        basic_iterator (const basic_iterator<false> &other) noexcept : key_(other.key_), value_(other.value_) {}
+
+        reference operator* () const noexcept { return reference(*key_, *value_); }
+        pointer operator-> () const noexcept { return pointer(**this); }
+        reference operator[] (difference_type n) const noexcept { return reference(key_[n], value_[n]); }
+
+        basic_iterator &operator++ () noexcept
+        {
+            ++key_;
+            ++value_;
+            return *this;
+        }
+
+        basic_iterator operator++ (int) noexcept
+        {
+            basic_iterator tmp = *this;
+            ++*this;
+            return tmp;
+        }
+
+        basic_iterator &operator-- () noexcept
+        {
+            --key_;
+            --value_;
+            return *this;
+        }
+
+        basic_iterator operator-- (int) noexcept
+        {
+            basic_iterator tmp = *this;
+            --*this;
+            return tmp;
+        }
+
+        basic_iterator &operator+= (difference_type n) noexcept
+        {
+            key_ += n;
+            value_ += n;
+            return *this;
+        }
+
+        basic_iterator &operator-= (difference_type n) noexcept { return *this += -n; }
+
+        friend basic_iterator operator+ (basic_iterator it, difference_type n) noexcept { return it += n; }
+        friend basic_iterator operator+ (difference_type n, basic_iterator it) noexcept { return it += n; }
+        friend basic_iterator operator- (basic_iterator it, difference_type n) noexcept { return it -= n; }
+
+        friend difference_type operator- (const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.key_ - rhs.key_;
+        }
+
+        friend bool operator== (const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.key_ == rhs.key_;
+        }
+
+        friend auto operator<=> (const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+        {
+            return lhs.key_ <=> rhs.key_;
+        }
+    };
+
+    using iterator               = basic_iterator<false>;
+    using const_iterator         = basic_iterator<true>;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    key_container_type keys_;
+    mapped_container_type values_;
+    [[no_unique_address]] Compare comp_;
+
+    // whether merges may move elements out of the arrays, and not only copy them, without
+    // giving up the strong guarantee
+    static constexpr bool nothrow_relocate = is_nothrow_move_constructible_v<Key> && is_nothrow_move_constructible_v<T>;
+
+public:
+    flat_map () = default;
+
+    explicit flat_map (const Compare &comp) : comp_(comp) {}
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    flat_map (InputIt first, InputIt last, const Compare &comp = Compare())
+        : comp_(comp)
+    {
+        insert(first, last);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    flat_map (sorted_unique_t, InputIt first, InputIt last, const Compare &comp = Compare())
+        : comp_(comp)
+    {
+        append(first, last);
+    }
+
+    // adopts keys and values, the keys must be sorted and free of equivalent keys
+    flat_map (sorted_unique_t, key_container_type keys, mapped_container_type values, const Compare &comp = Compare())
+        : keys_(std::move(keys)), values_(std::move(values)), comp_(comp)
+    {
+        if (keys_.size() != values_.size())
+            throw std::invalid_argument("dstl::flat_map");
+    }
+
+    flat_map (std::initializer_list<value_type> init, const Compare &comp = Compare())
+        : comp_(comp)
+    {
+        insert(init.begin(), init.end());
+    }
+
+    flat_map &operator= (std::initializer_list<value_type> init)
+    {
+        clear();
+        insert(init.begin(), init.end());
+        return *this;
+    }
+
+    //
+    // iterators
+    //
+
+    iterator begin () noexcept { return iterator(keys_.data(), values_.data()); }
+    const_iterator begin () const noexcept { return const_iterator(keys_.data(), values_.data()); }
+    const_iterator cbegin () const noexcept { return begin(); }
+    iterator end () noexcept { return begin() + static_cast<ptrdiff_t>(size()); }
+    const_iterator end () const noexcept { return begin() + static_cast<ptrdiff_t>(size()); }
+    const_iterator cend () const noexcept { return end(); }
+
+    reverse_iterator rbegin () noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin () const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend () noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend () const noexcept { return const_reverse_iterator(begin()); }
+
+    //
+    // capacity
+    //
+
+    [[nodiscard]] bool empty () const noexcept { return keys_.empty(); }
+    [[nodiscard]] size_type size () const noexcept { return keys_.size(); }
+
+    void reserve (size_type count)
+    {
+        keys_.reserve(count);
+        values_.reserve(count);
+    }
+
+    void shrink_to_fit ()
+    {
+        keys_.shrink_to_fit();
+        values_.shrink_to_fit();
+    }
+
+    //
+    // element access
+    //
+
+    T &operator[] (const Key &key) { return try_emplace(key).first->second; }
+    T &operator[] (Key &&key) { return try_emplace(std::move(key)).first->second; }
+
+    T &at (const Key &key)
+    {
+        const size_t index = index_of(key);
+        if (index == size())
+            throw std::out_of_range("dstl::flat_map::at");
+        return values_[index];
+    }
+
+    const T &at (const Key &key) const
+    {
+        const size_t index = index_of(key);
+        if (index == size())
+            throw std::out_of_range("dstl::flat_map::at");
+        return values_[index];
+    }
+
+    //
+    // modifiers
+    //
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (const Key &key, Args &&...args)
+    {
+        return insert_unique(key, std::forward<Args>(args)...);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (Key &&key, Args &&...args)
+    {
+        return insert_unique(std::move(key), std::forward<Args>(args)...);
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign (const Key &key, M &&obj)
+    {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second)
+            result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    std::pair<iterator, bool> insert (const value_type &value) { return insert_unique(value.first, value.second); }
+    std::pair<iterator, bool> insert (value_type &&value) { return insert_unique(std::move(value.first), std::move(value.second)); }
+
+    template<class... Args>
+    std::pair<iterator, bool> emplace (Args &&...args)
+    {
+        value_type tmp(std::forward<Args>(args)...);
+        return insert(std::move(tmp));
+    }
+
+    template<class InputIt>
+    void insert (InputIt first, InputIt last)
+    {
+        vector<value_type> sorted(first, last);
+        // equivalent keys keep their input order, the first of them is inserted
+        std::stable_sort(sorted.begin(), sorted.end(), [this] (const value_type &a, const value_type &b) {
+            return comp_(a.first, b.first);
+        });
+        auto equivalent = [this] (const value_type &a, const value_type &b) { return !comp_(a.first, b.first); };
+        sorted.erase(std::unique(sorted.begin(), sorted.end(), equivalent), sorted.end());
+        merge_back(append(std::make_move_iterator(sorted.begin()), std::make_move_iterator(sorted.end())));
+    }
+
+    // inserts [first, last), which must be sorted and free of equivalent keys
+    template<class InputIt>
+    void insert (sorted_unique_t, InputIt first, InputIt last)
+    {
+        merge_back(append(first, last));
+    }
+
+    void insert (std::initializer_list<value_type> init) { insert(init.begin(), init.end()); }
+
+    // moves the arrays out, leaving the map empty
+    containers extract () &&
+    {
+        containers result{std::move(keys_), std::move(values_)};
+        clear();
+        return result;
+    }
+
+    // adopts keys and values, the keys must be sorted and free of equivalent keys
+    void replace (key_container_type &&keys, mapped_container_type &&values)
+    {
+        if (keys.size() != values.size())
+            throw std::invalid_argument("dstl::flat_map");
+        keys_   = std::move(keys);
+        values_ = std::move(values);
+    }
+
+    iterator erase (const_iterator pos) { return erase(pos, pos + 1); }
+
+    iterator erase (const_iterator first, const_iterator last)
+    {
+        const ptrdiff_t from = first.key_ - keys_.data();
+        const ptrdiff_t to   = last.key_ - keys_.data();
+        keys_.erase(keys_.begin() + from, keys_.begin() + to);
+        values_.erase(values_.begin() + from, values_.begin() + to);
+        return begin() + from;
+    }
+
+    size_type erase (const Key &key)
+    {
+        const size_t index = index_of(key);
+        if (index == size())
+            return 0;
+        keys_.erase(keys_.begin() + index);
+        values_.erase(values_.begin() + index);
+        return 1;
+    }
+
+    void clear () noexcept
+    {
+        keys_.clear();
+        values_.clear();
+    }
+
+    void swap (flat_map &other) noexcept
+    {
+        keys_.swap(other.keys_);
+        values_.swap(other.values_);
+        std::swap(comp_, other.comp_);
+    }
+
+    friend void swap (flat_map &lhs, flat_map &rhs) noexcept { lhs.swap(rhs); }
+
+    //
+    // lookup
+    //
+
+    iterator find (const Key &key) { return begin() + static_cast<ptrdiff_t>(index_of(key)); }
+    const_iterator find (const Key &key) const { return begin() + static_cast<ptrdiff_t>(index_of(key)); }
+
+    [[nodiscard]] bool contains (const Key &key) const { return index_of(key) != size(); }
+    [[nodiscard]] size_type count (const Key &key) const { return contains(key) ? 1 : 0; }
+
+    iterator lower_bound (const Key &key) { return begin() + lower_index(key); }
+    const_iterator lower_bound (const Key &key) const { return begin() + lower_index(key); }
+    iterator upper_bound (const Key &key) { return begin() + upper_index(key); }
+    const_iterator upper_bound (const Key &key) const { return begin() + upper_index(key); }
+
+    std::pair<iterator, iterator> equal_range (const Key &key)
+    {
+        const ptrdiff_t index = lower_index(key);
+        const bool found      = static_cast<size_t>(index) != size() && !comp_(key, keys_[static_cast<size_t>(index)]);
+        return {begin() + index, begin() + index + found};
+    }
+
+    std::pair<const_iterator, const_iterator> equal_range (const Key &key) const
+    {
+        auto range = const_cast<flat_map *>(this)->equal_range(key);
+        return {range.first, range.second};
+    }
+
+    //
+    // observers
+    //
+
+    key_compare key_comp () const { return comp_; }
+
+    const key_container_type &keys () const noexcept { return keys_; }
+    const mapped_container_type &values () const noexcept { return values_; }
+
+    friend bool operator== (const flat_map &lhs, const flat_map &rhs)
+    {
+        return lhs.keys_ == rhs.keys_ && lhs.values_ == rhs.values_;
+    }
+
+private:
+    ptrdiff_t lower_index (const Key &key) const
+    {
+        return dstl::lower_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin();
+    }
+
+    ptrdiff_t upper_index (const Key &key) const
+    {
+        return dstl::upper_bound(keys_.begin(), keys_.end(), key, comp_) - keys_.begin();
+    }
+
+    // the index of key, size() when it is missing
+    size_t index_of (const Key &key) const
+    {
+        const auto index = static_cast<size_t>(lower_index(key));
+        return index != size() && !comp_(key, keys_[index]) ? index : size();
+    }
+
+    template<class K, class... Args>
+    std::pair<iterator, bool> insert_unique (K &&key, Args &&...args)
+    {
+        const ptrdiff_t index = lower_index(key);
+        if (static_cast<size_t>(index) != size() && !comp_(key, keys_[static_cast<size_t>(index)]))
+            return {begin() + index, false};
+
+        keys_.emplace(keys_.begin() + index, std::forward<K>(key));
+        try
+        {
+            values_.emplace(values_.begin() + index, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            keys_.erase(keys_.begin() + index);
+            throw;
+        }
+        return {begin() + index, true};
+    }
+
+    // drops everything from mid on, after a failed bulk insert
+    void truncate (size_t mid) noexcept
+    {
+        keys_.erase(keys_.begin() + mid, keys_.end());
+        if (values_.size() > mid)
+            values_.erase(values_.begin() + static_cast<ptrdiff_t>(mid), values_.end());
+    }
+
+    // appends the pairs [first, last) and returns where the new elements start
+    template<class InputIt>
+    size_t append (InputIt first, InputIt last)
+    {
+        const size_t mid = keys_.size();
+        if constexpr (std::forward_iterator<InputIt>)
+            reserve(mid + static_cast<size_t>(std::distance(first, last)));
+        try
+        {
+            for (; first != last; ++first)
+            {
+                auto &&value = *first;
+                keys_.emplace_back(std::forward<decltype(value)>(value).first);
+                values_.emplace_back(std::forward<decltype(value)>(value).second);
+            }
+        }
+        catch (...)
+        {
+            truncate(mid);
+            throw;
+        }
+        return mid;
+    }
+
+    // merges the sorted unique elements from mid on into the ones before them
+    void merge_back (size_t mid)
+    {
+        const size_t size = keys_.size();
+        // appending past the largest key, the usual way to build a table, needs no merge
+        if (mid == 0 || mid == size || comp_(keys_[mid - 1], keys_[mid]))
+            return;
+
+        try
+        {
+            key_container_type keys;
+            mapped_container_type values;
+            keys.reserve(size);
+            values.reserve(size);
+            detail::merge_sorted_runs(keys_.data(), mid, size, comp_, [&] (size_t i) {
+                if constexpr (nothrow_relocate)
+                {
+                    keys.push_back(std::move(keys_[i]));
+                    values.push_back(std::move(values_[i]));
+                }
+                else
+                {
+                    keys.push_back(static_cast<const Key &>(keys_[i]));
+                    values.push_back(static_cast<const T &>(values_[i]));
+                }
+            });
+            keys_.swap(keys);
+            values_.swap(values);
+        }
+        catch (...)
+        {
+            truncate(mid);
+            throw;
+        }
+    }
+};
+
+#endif // DSTL_FLATMAP_H
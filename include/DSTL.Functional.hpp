@@ -0,0 +1,343 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Functional.hpp
+
+Abstract:
+    Function Wrappers.
+
+    function and move_only_function keep a callable in an inline buffer
+    of four pointers (move_only_function takes its size as a parameter)
+    when it fits and cannot throw while moving, and on the heap
+    otherwise; a lambda capturing a few references never allocates.
+    Next to the buffer sit a pointer to the invoker of the callable, which
+    a call goes through directly, and a pointer to a static table of its
+    move, copy and destroy operations. The table leaves out the
+    operations a memcpy does: moving a heap callable or copying and
+    moving a trivially copyable one copies the buffer.
+
+    function_ref is the object pointer and the invoker only, it refers to
+    a callable that outlives it and is passed by value.
+
+--*/
+
+#ifndef DSTL_FUNCTIONAL_H
+#define DSTL_FUNCTIONAL_H
+
+namespace detail
+{
+    // inline buffer of function, and the default one of move_only_function
+    inline constexpr size_t function_inline_size = 4 * sizeof(void *);
+
+    // operations on a stored callable, a null entry copies the buffer, or does nothing for destroy_
+    struct function_manager
+    {
+        // move constructs the callable of the buffer at source into the one at dest and destroys it at source
+        void (*relocate_)(void *dest, void *source) noexcept;
+        // copy constructs the callable of the buffer at source into the one at dest
+        void (*copy_)(void *dest, const void *source);
+        void (*destroy_)(void *storage) noexcept;
+    };
+
+    inline constexpr function_manager empty_function_manager{nullptr, nullptr, nullptr};
+
+    template<class F, bool Inline, bool Copyable>
+    struct function_manager_for
+    {
+        static F *target (void *storage) noexcept
+        {
+            if constexpr (Inline)
+                return std::launder(static_cast<F *>(storage));
+            else
+                return *static_cast<F **>(storage);
+        }
+
+        static void relocate (void *dest, void *source) noexcept
+        {
+            F *f = target(source);
+            ::new (dest) F(std::move(*f));
+            f->~F();
+        }
+
+        static void copy (void *dest, const void *source)
+        {
+            const F &f = *target(const_cast<void *>(source));
+            if constexpr (Inline)
+                ::new (dest) F(f);
+            else
+                *static_cast<F **>(dest) = new F(f);
+        }
+
+        static void destroy (void *storage) noexcept
+        {
+            if constexpr (Inline)
+                target(storage)->~F();
+            else
+                delete target(storage);
+        }
+
+        static constexpr function_manager make () noexcept
+        {
+            constexpr bool trivial = Inline && is_trivially_copyable_v<F> && is_trivially_destructible_v<F>;
+            function_manager manager{nullptr, nullptr, nullptr};
+            if constexpr (Inline && !trivial)
+                manager.relocate_ = &relocate;
+            if constexpr (Copyable && !trivial)
+                manager.copy_ = &copy;
+            if constexpr (!trivial)
+                manager.destroy_ = &destroy;
+            return manager;
+        }
+
+        static constexpr function_manager table = make();
+    };
+
+    template<class R, class... Args>
+    struct function_invoker
+    {
+        template<class F, bool Inline>
+        static R call (void *storage, Args &&...args)
+        {
+            F &f = *function_manager_for<F, Inline, false>::target(storage);
+            if constexpr (is_void_v<R>)
+                std::invoke(f, static_cast<Args &&>(args)...);
+            else
+                return std::invoke(f, static_cast<Args &&>(args)...);
+        }
+
+        // the invoker of an empty wrapper, which saves the call a test
+        [[noreturn]] static R empty (void *, Args &&...) { throw std::bad_function_call(); }
+    };
+
+    // owning wrapper of a callable of R(Args...), copyable or move only
+    template<bool Copyable, size_t InlineSize, class R, class... Args>
+    class basic_function
+    {
+        static constexpr size_t buffer_size = InlineSize < sizeof(void *) ? sizeof(void *) : InlineSize;
+
+        using invoker_type = R (*)(void *, Args &&...);
+
+    public:
+        using result_type = R;
+
+        // whether a callable of type F is kept in the inline buffer
+        template<class F>
+        static constexpr bool stores_inline =
+            sizeof(F) <= buffer_size && alignof(F) <= alignof(std::max_align_t) && is_nothrow_move_constructible_v<F>;
+
+        basic_function () noexcept = default;
+        basic_function (std::nullptr_t) noexcept {}
+
+        template<class F, class D = decay_t<F>,
+                 class = enable_if_t<!is_base_of_v<basic_function, D> && is_invocable_r_v<R, D &, Args...> &&
+                                     (!Copyable || is_copy_constructible_v<D>)>>
+        basic_function (F &&f)
+        {
+            // a null function or member pointer makes an empty wrapper
+            if constexpr (is_pointer_v<remove_reference_t<F>> || is_member_pointer_v<D>)
+                if (f == nullptr)
+                    return;
+            emplace<D>(std::forward<F>(f));
+        }
+
+        template<class D, class... CArgs, class = enable_if_t<is_constructible_v<D, CArgs...> && is_invocable_r_v<R, D &, Args...>>>
+        explicit basic_function (std::in_place_type_t<D>, CArgs &&...args)
+        {
+            emplace<D>(std::forward<CArgs>(args)...);
+        }
+
+        // deleted by move_only_function, whose table has no copy_
+        basic_function (const basic_function &other) : invoker_(other.invoker_), manager_(other.manager_)
+        {
+            if (manager_->copy_ != nullptr)
+                manager_->copy_(storage_, other.storage_);
+            else
+                std::memcpy(storage_, other.storage_, buffer_size);
+        }
+
+        basic_function (basic_function &&other) noexcept { steal(other); }
+
+        ~basic_function () { reset(); }
+
+        basic_function &operator= (const basic_function &other)
+        {
+            if (this != &other)
+                basic_function(other).swap(*this);
+            return *this;
+        }
+
+        basic_function &operator= (basic_function &&other) noexcept
+        {
+            if (this != &other)
+            {
+                reset();
+                steal(other);
+            }
+            return *this;
+        }
+
+        basic_function &operator= (std::nullptr_t) noexcept
+        {
+            reset();
+            return *this;
+        }
+
+        void swap (basic_function &other) noexcept
+        {
+            basic_function tmp(std::move(other));
+            other.steal(*this);
+            steal(tmp);
+        }
+
+        explicit operator bool () const noexcept { return invoker_ != &function_invoker<R, Args...>::empty; }
+
+        friend bool operator== (const basic_function &f, std::nullptr_t) noexcept { return !f; }
+
+    protected:
+        R call (Args &&...args) const { return invoker_(storage_, static_cast<Args &&>(args)...); }
+
+    private:
+        template<class D, class... CArgs>
+        void emplace (CArgs &&...args)
+        {
+            constexpr bool is_inline = stores_inline<D>;
+            if constexpr (is_inline)
+                ::new (static_cast<void *>(storage_)) D(std::forward<CArgs>(args)...);
+            else
+                *reinterpret_cast<D **>(storage_) = new D(std::forward<CArgs>(args)...);
+            invoker_ = &function_invoker<R, Args...>::template call<D, is_inline>;
+            manager_ = &function_manager_for<D, is_inline, Copyable>::table;
+        }
+
+        // takes the callable of other, which is left empty
+        void steal (basic_function &other) noexcept
+        {
+            invoker_ = other.invoker_;
+            manager_ = other.manager_;
+            if (manager_->relocate_ != nullptr)
+                manager_->relocate_(storage_, other.storage_);
+            else
+                std::memcpy(storage_, other.storage_, buffer_size);
+            other.invoker_ = &function_invoker<R, Args...>::empty;
+            other.manager_ = &empty_function_manager;
+        }
+
+        void reset () noexcept
+        {
+            if (manager_->destroy_ != nullptr)
+                manager_->destroy_(storage_);
+            invoker_ = &function_invoker<R, Args...>::empty;
+            manager_ = &empty_function_manager;
+        }
+
+        alignas(std::max_align_t) mutable unsigned char storage_[buffer_size];
+        invoker_type invoker_            = &function_invoker<R, Args...>::empty;
+        const function_manager *manager_ = &empty_function_manager;
+    };
+}
+
+template<class Signature>
+class function;
+
+// copyable wrapper of a callable, std::function without allocations for small callables
+template<class R, class... Args>
+class function<R(Args...)> : public detail::basic_function<true, detail::function_inline_size, R, Args...>
+{
+    using base = detail::basic_function<true, detail::function_inline_size, R, Args...>;
+
+public:
+    using base::base;
+
+    // calls the callable as an lvalue, or throws std::bad_function_call when there is none
+    R operator() (Args... args) const { return this->call(std::forward<Args>(args)...); }
+
+    friend void swap (function &lhs, function &rhs) noexcept { lhs.swap(rhs); }
+};
+
+template<class Signature, size_t InlineSize = detail::function_inline_size>
+class move_only_function;
+
+// wrapper of a callable that may be move only, with an inline buffer of InlineSize bytes
+template<class R, class... Args, size_t InlineSize>
+class move_only_function<R(Args...), InlineSize> : public detail::basic_function<false, InlineSize, R, Args...>
+{
+    using base = detail::basic_function<false, InlineSize, R, Args...>;
+
+public:
+    using base::base;
+
+    move_only_function (move_only_function &&) noexcept            = default;
+    move_only_function &operator= (move_only_function &&) noexcept = default;
+    move_only_function (const move_only_function &)                = delete;
+    move_only_function &operator= (const move_only_function &)     = delete;
+
+    R operator() (Args... args) { return this->call(std::forward<Args>(args)...); }
+
+    friend void swap (move_only_function &lhs, move_only_function &rhs) noexcept { lhs.swap(rhs); }
+};
+
+template<class Signature>
+class function_ref;
+
+// non-owning reference to a callable, two pointers passed by value. the callable must outlive it
+template<class R, class... Args>
+class function_ref<R(Args...)>
+{
+    // the callable is an object or a function
+    union target
+    {
+        void *object_;
+        void (*function_)();
+    };
+
+    using invoker_type = R (*)(target, Args &&...);
+
+public:
+    template<class F, class = enable_if_t<is_function_v<F> && is_invocable_r_v<R, F &, Args...>>>
+    function_ref (F *f) noexcept : invoker_(&call_function<F>)
+    {
+        target_.function_ = reinterpret_cast<void (*)()>(f);
+    }
+
+    template<class F, class T = remove_reference_t<F>,
+             class = enable_if_t<!is_same_v<remove_cv_t<T>, function_ref> && !is_function_v<T> && !is_pointer_v<T> && !is_member_pointer_v<T> &&
+                                 is_invocable_r_v<R, T &, Args...>>>
+    function_ref (F &&f) noexcept : invoker_(&call_object<T>)
+    {
+        target_.object_ = const_cast<void *>(static_cast<const void *>(std::addressof(f)));
+    }
+
+    function_ref (const function_ref &) noexcept            = default;
+    function_ref &operator= (const function_ref &) noexcept = default;
+
+    R operator() (Args... args) const { return invoker_(target_, std::forward<Args>(args)...); }
+
+private:
+    template<class F>
+    static R call_function (target t, Args &&...args)
+    {
+        F *f = reinterpret_cast<F *>(t.function_);
+        if constexpr (is_void_v<R>)
+            std::invoke(f, static_cast<Args &&>(args)...);
+        else
+            return std::invoke(f, static_cast<Args &&>(args)...);
+    }
+
+    template<class T>
+    static R call_object (target t, Args &&...args)
+    {
+        T &f = *static_cast<T *>(t.object_);
+        if constexpr (is_void_v<R>)
+            std::invoke(f, static_cast<Args &&>(args)...);
+        else
+            return std::invoke(f, static_cast<Args &&>(args)...);
+    }
+
+    target target_;
+    invoker_type invoker_;
+};
+
+#endif // DSTL_FUNCTIONAL_H
@@ -0,0 +1,419 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Hash.hpp
+
+Abstract:
+    Hash Functions.
+
+    hash_bytes is a seeded 64 bit hash of a byte span in the wyhash family.
+    Up to 256 bytes it folds 16 bytes per step into its state with a
+    64x64->128 bit multiply whose halves are xored ("mum"), running three
+    independent lanes over 48 bytes at a time, and reads inputs of at most
+    16 bytes with a few overlapping loads instead of a byte loop. Longer
+    inputs go through eight 64 bit accumulator lanes fed by 64 byte stripes
+    (the xxh3 layout): each lane adds a 32x32->64 bit product of its keyed
+    input word, which maps onto the packed multiplies of SSE2 and AVX2, and
+    the lanes are scrambled after every 1 KiB block and folded with mums at
+    the end. The vector and scalar stripe loops compute the same values, so
+    hashes do not depend on the instruction set. hash_bytes128 extends the
+    result to 128 bits; its low half is hash_bytes.
+
+    hash<T> mixes integral keys with a single multiply-xorshift step, hashes
+    strings and string views with hash_bytes, hashes the bytes of bytewise
+    comparable types, i.e. ones whose objects are equal exactly when their
+    object representations are, when no std::hash<T> is enabled for them,
+    and defers to std::hash<T> for anything else. The first three kinds of
+    results are well mixed, so the hash tables skip their own mixing step
+    for them. hash_n hashes an array of keys, prefetching the bytes of keys
+    that keep them out of line (strings) a few keys ahead. It does not run
+    several keys through hash_bytes in lockstep: the hashes of different
+    keys share no state, so an out of order core already overlaps them in
+    a plain loop, and a four and an eight key kernel for keys of at most
+    16 bytes measured no faster than the loop.
+
+--*/
+
+#ifndef DSTL_HASH_H
+#define DSTL_HASH_H
+
+namespace detail
+{
+    inline constexpr uint64_t hash_secret[4] = {0x2d358dccaa6c78a5ULL, 0x8bb84b93962eacc9ULL,
+                                                0x4b33a62ed433d4a3ULL, 0x4d5a2da51de1aa47ULL};
+
+    // replaces a and b with the low and high halves of their 128 bit product
+    inline void hash_multiply (uint64_t &a, uint64_t &b) noexcept
+    {
+#if defined(__SIZEOF_INT128__)
+        __extension__ using uint128 = unsigned __int128;
+        const uint128 product = static_cast<uint128>(a) * b;
+        a = static_cast<uint64_t>(product);
+        b = static_cast<uint64_t>(product >> 64);
+#elif defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        const uint64_t a_lo = a & 0xffffffffULL, a_hi = a >> 32;
+        const uint64_t b_lo = b & 0xffffffffULL, b_hi = b >> 32;
+        const uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+        const uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+        const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xffffffffULL) + lo_hi;
+        a = (cross << 32) | (lo_lo & 0xffffffffULL);
+        b = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+#endif
+    }
+
+    // the 128 bit product of a and b, folded to 64 bits
+    inline uint64_t hash_mum (uint64_t a, uint64_t b) noexcept
+    {
+        hash_multiply(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t hash_read64 (const unsigned char *p) noexcept
+    {
+        uint64_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    inline uint64_t hash_read32 (const unsigned char *p) noexcept
+    {
+        uint32_t value;
+        std::memcpy(&value, p, sizeof(value));
+        return value;
+    }
+
+    // the multiply-xorshift finalizer of murmur3, spreads the entropy of
+    // weak hashes (e.g. identity hashes of integers) over all bits
+    inline uint64_t hash_mix (uint64_t x) noexcept
+    {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    inline uint64_t hash_seed (uint64_t seed) noexcept
+    {
+        return seed ^ hash_mum(seed ^ hash_secret[0], hash_secret[1]);
+    }
+
+    inline constexpr size_t hash_stripe_size   = 64;
+    inline constexpr size_t hash_block_stripes = 16;
+
+    // inputs longer than this go through the stripe lanes
+    inline constexpr size_t hash_long_threshold = 256;
+
+    struct hash_key_table
+    {
+        uint64_t key_[hash_block_stripes + 8];
+    };
+
+    // splitmix64 output, so that the stripe keys share no structure
+    constexpr hash_key_table make_hash_keys () noexcept
+    {
+        hash_key_table table{};
+        uint64_t x = hash_secret[0];
+        for (uint64_t &key : table.key_)
+        {
+            uint64_t z = x += 0x9e3779b97f4a7c15ULL;
+            z          = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+            z          = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+            key        = z ^ (z >> 31);
+        }
+        return table;
+    }
+
+    inline constexpr hash_key_table hash_keys = make_hash_keys();
+
+    // adds the stripes 64 byte stripes at p into the eight lanes of acc,
+    // stripe s keyed with key[s, s + 8)
+    inline void hash_accumulate_scalar (uint64_t *acc, const unsigned char *p, size_t stripes,
+                                        const uint64_t *key) noexcept
+    {
+        for (size_t s = 0; s < stripes; ++s, p += hash_stripe_size, ++key)
+            for (size_t i = 0; i < 8; ++i)
+            {
+                const uint64_t data  = hash_read64(p + 8 * i);
+                const uint64_t mixed = data ^ key[i];
+                acc[i ^ 1] += data;
+                acc[i] += (mixed & 0xffffffffULL) * (mixed >> 32);
+            }
+    }
+
+    // hash_accumulate_scalar with the lanes held in vector registers
+    inline void hash_accumulate (uint64_t *acc, const unsigned char *p, size_t stripes, const uint64_t *key) noexcept
+    {
+#if defined(DSTL_AVX2)
+        __m256i lanes[2] = {_mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc)),
+                            _mm256_loadu_si256(reinterpret_cast<const __m256i *>(acc + 4))};
+        for (size_t s = 0; s < stripes; ++s, p += hash_stripe_size, ++key)
+            for (size_t i = 0; i < 2; ++i)
+            {
+                const __m256i data    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p) + i);
+                const __m256i keys    = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(key + 4 * i));
+                const __m256i mixed   = _mm256_xor_si256(data, keys);
+                const __m256i product = _mm256_mul_epu32(mixed, _mm256_srli_epi64(mixed, 32));
+                // swaps the two 64 bit words of each 128 bit half, lane i takes the data of lane i ^ 1
+                const __m256i swapped = _mm256_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i]              = _mm256_add_epi64(lanes[i], _mm256_add_epi64(product, swapped));
+            }
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc), lanes[0]);
+        _mm256_storeu_si256(reinterpret_cast<__m256i *>(acc + 4), lanes[1]);
+#elif defined(DSTL_SSE2)
+        __m128i lanes[4];
+        for (size_t i = 0; i < 4; ++i)
+            lanes[i] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(acc) + i);
+        for (size_t s = 0; s < stripes; ++s, p += hash_stripe_size, ++key)
+            for (size_t i = 0; i < 4; ++i)
+            {
+                const __m128i data    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p) + i);
+                const __m128i keys    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(key + 2 * i));
+                const __m128i mixed   = _mm_xor_si128(data, keys);
+                const __m128i product = _mm_mul_epu32(mixed, _mm_srli_epi64(mixed, 32));
+                const __m128i swapped = _mm_shuffle_epi32(data, _MM_SHUFFLE(1, 0, 3, 2));
+                lanes[i]              = _mm_add_epi64(lanes[i], _mm_add_epi64(product, swapped));
+            }
+        for (size_t i = 0; i < 4; ++i)
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(acc) + i, lanes[i]);
+#else
+        hash_accumulate_scalar(acc, p, stripes, key);
+#endif
+    }
+
+    // keeps the lanes from saturating, once per block of stripes
+    inline void hash_scramble (uint64_t *acc, const uint64_t *key) noexcept
+    {
+        for (size_t i = 0; i < 8; ++i)
+            acc[i] = (acc[i] ^ (acc[i] >> 47) ^ key[i]) * 0x9e3779b1ULL;
+    }
+
+    // folds the lanes into 64 bits
+    inline uint64_t hash_merge (const uint64_t *acc, const uint64_t *key, uint64_t start) noexcept
+    {
+        for (size_t i = 0; i < 8; i += 2)
+            start += hash_mum(acc[i] ^ key[i], acc[i + 1] ^ key[i + 1]);
+        start ^= start >> 37;
+        start *= 0x165667919e3779f9ULL;
+        return start ^ (start >> 32);
+    }
+
+    // runs size > hash_long_threshold bytes at p through the stripe lanes
+    inline void hash_long (uint64_t *acc, const unsigned char *p, size_t size, uint64_t seed) noexcept
+    {
+        const uint64_t *key = hash_keys.key_;
+        for (size_t i = 0; i < 8; ++i)
+            acc[i] = key[i] ^ seed;
+
+        const unsigned char *last = p + size - hash_stripe_size;
+        size_t stripes            = (size - 1) / hash_stripe_size;
+        for (; stripes >= hash_block_stripes; stripes -= hash_block_stripes)
+        {
+            hash_accumulate(acc, p, hash_block_stripes, key);
+            hash_scramble(acc, key + hash_block_stripes);
+            p += hash_block_stripes * hash_stripe_size;
+        }
+        hash_accumulate(acc, p, stripes, key);
+        // the last stripe, overlapping the ones before
+        hash_accumulate(acc, last, 1, key + hash_block_stripes);
+    }
+}
+
+// the two halves of a 128 bit hash
+struct hash128
+{
+    uint64_t low_  = 0;
+    uint64_t high_ = 0;
+
+    bool operator== (const hash128 &) const = default;
+};
+
+// hashes size bytes at data
+inline uint64_t hash_bytes (const void *data, size_t size, uint64_t seed = 0) noexcept
+{
+    using detail::hash_mum;
+    using detail::hash_read32;
+    using detail::hash_read64;
+    using detail::hash_secret;
+
+    const auto *p = static_cast<const unsigned char *>(data);
+    seed          = detail::hash_seed(seed);
+    if (size > detail::hash_long_threshold)
+    {
+        uint64_t acc[8];
+        detail::hash_long(acc, p, size, seed);
+        return detail::hash_merge(acc, detail::hash_keys.key_ + 3, size * hash_secret[1]);
+    }
+
+    uint64_t a = 0;
+    uint64_t b = 0;
+    if (size <= 16)
+    {
+        if (size >= 4)
+        {
+            // two pairs of overlapping 4 byte reads cover 4 to 16 bytes
+            const size_t shift = (size >> 3) << 2;
+            a = (hash_read32(p) << 32) | hash_read32(p + shift);
+            b = (hash_read32(p + size - 4) << 32) | hash_read32(p + size - 4 - shift);
+        }
+        else if (size > 0)
+            a = (uint64_t(p[0]) << 16) | (uint64_t(p[size >> 1]) << 8) | p[size - 1];
+    }
+    else
+    {
+        size_t left = size;
+        if (left > 48)
+        {
+            uint64_t lane1 = seed;
+            uint64_t lane2 = seed;
+            do
+            {
+                seed  = hash_mum(hash_read64(p) ^ hash_secret[1], hash_read64(p + 8) ^ seed);
+                lane1 = hash_mum(hash_read64(p + 16) ^ hash_secret[2], hash_read64(p + 24) ^ lane1);
+                lane2 = hash_mum(hash_read64(p + 32) ^ hash_secret[3], hash_read64(p + 40) ^ lane2);
+                p += 48;
+                left -= 48;
+            } while (left > 48);
+            seed ^= lane1 ^ lane2;
+        }
+        while (left > 16)
+        {
+            seed = hash_mum(hash_read64(p) ^ hash_secret[1], hash_read64(p + 8) ^ seed);
+            p += 16;
+            left -= 16;
+        }
+        // the last 16 bytes, overlapping what came before
+        a = hash_read64(p + left - 16);
+        b = hash_read64(p + left - 8);
+    }
+    a ^= hash_secret[1];
+    b ^= seed;
+    detail::hash_multiply(a, b);
+    return hash_mum(a ^ hash_secret[0] ^ size, b ^ hash_secret[1]);
+}
+
+// 128 bit hash of size bytes at data, the low half is hash_bytes(data, size, seed)
+inline hash128 hash_bytes128 (const void *data, size_t size, uint64_t seed = 0) noexcept
+{
+    if (size > detail::hash_long_threshold)
+    {
+        uint64_t acc[8];
+        detail::hash_long(acc, static_cast<const unsigned char *>(data), size, detail::hash_seed(seed));
+        return {detail::hash_merge(acc, detail::hash_keys.key_ + 3, size * detail::hash_secret[1]),
+                detail::hash_merge(acc, detail::hash_keys.key_ + 11, ~(size * detail::hash_secret[2]))};
+    }
+    // shorter inputs are cheap enough to hash twice
+    return {hash_bytes(data, size, seed), hash_bytes(data, size, seed ^ detail::hash_secret[2])};
+}
+
+namespace detail
+{
+    template<class T, class = void>
+    inline constexpr bool has_std_hash_v = false;
+
+    template<class T>
+    inline constexpr bool has_std_hash_v<T, void_t<decltype(std::hash<T>()(declval<const T &>()))>> = true;
+
+    enum class hash_kind
+    {
+        mix,      // integral keys, through hash_mix
+        bytes,    // bytewise comparable keys without a std::hash, through hash_bytes
+        standard, // std::hash<T>
+    };
+
+    // a std::hash the user enabled wins over hashing the bytes, its operator== may look at fewer of them
+    template<class T>
+    inline constexpr hash_kind hash_kind_v = is_integral_v<T> && sizeof(T) <= sizeof(uint64_t) ? hash_kind::mix
+                                           : !has_std_hash_v<T> && is_bytewise_comparable_v<T> ? hash_kind::bytes
+                                                                                                : hash_kind::standard;
+
+    template<class T, hash_kind = hash_kind_v<T>>
+    struct hash_base : std::hash<T> {};
+
+    template<class T>
+    struct hash_base<T, hash_kind::mix>
+    {
+        // tells the hash tables that every bit of the result depends on every bit of the key
+        using is_avalanching = void;
+
+        size_t operator() (T value) const noexcept { return static_cast<size_t>(hash_mix(static_cast<uint64_t>(value))); }
+    };
+
+    template<class T>
+    struct hash_base<T, hash_kind::bytes>
+    {
+        using is_avalanching = void;
+
+        size_t operator() (const T &value) const noexcept
+        {
+            return static_cast<size_t>(hash_bytes(__builtin_addressof(value), sizeof(T)));
+        }
+    };
+
+    template<class CharT, class Traits>
+    struct string_hash
+    {
+        using is_avalanching = void;
+
+        size_t operator() (std::basic_string_view<CharT, Traits> s) const noexcept
+        {
+            return static_cast<size_t>(hash_bytes(s.data(), s.size() * sizeof(CharT)));
+        }
+    };
+
+    template<class Hash, class = void>
+    inline constexpr bool is_avalanching_v = false;
+
+    template<class Hash>
+    inline constexpr bool is_avalanching_v<Hash, void_t<typename Hash::is_avalanching>> = true;
+
+    template<class T, class = void>
+    inline constexpr bool has_data_v = false;
+
+    template<class T>
+    inline constexpr bool has_data_v<T, void_t<decltype(declval<const T &>().data())>> = true;
+
+    inline void prefetch (const void *p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(p);
+#elif defined(DSTL_SSE2)
+        _mm_prefetch(static_cast<const char *>(p), _MM_HINT_T0);
+#else
+        (void)p;
+#endif
+    }
+}
+
+// mixes integral keys, hashes strings and bytewise comparable types as bytes, anything else with std::hash
+template<class T>
+struct hash : detail::hash_base<T> {};
+
+template<class CharT, class Traits, class Allocator>
+struct hash<std::basic_string<CharT, Traits, Allocator>> : detail::string_hash<CharT, Traits> {};
+
+template<class CharT, class Traits>
+struct hash<std::basic_string_view<CharT, Traits>> : detail::string_hash<CharT, Traits> {};
+
+// hashes keys[0, n) into hashes. the bytes of keys that keep them out of line
+// (strings) are prefetched a few keys ahead, so that their cache misses overlap.
+// the hashing itself is a plain loop, see the header comment
+template<class T, class Hash = hash<T>>
+void hash_n (const T *keys, size_t n, size_t *hashes, const Hash &hasher = Hash())
+{
+    constexpr size_t distance = 8;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        if constexpr (detail::has_data_v<T>)
+            if (i + distance < n)
+                detail::prefetch(keys[i + distance].data());
+        hashes[i] = static_cast<size_t>(hasher(keys[i]));
+    }
+}
+
+#endif // DSTL_HASH_H
@@ -0,0 +1,757 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.HashTable.hpp
+
+Abstract:
+    Open Addressing Hash Table.
+
+    Swiss table layout: one control byte per slot, stored apart from the
+    slots, holding either the low 7 bits of the hash (H2) of a full slot or
+    an empty/deleted marker. Probing compares 16 control bytes at once and
+    only touches slots whose H2 matches. Groups are 16-byte aligned, so a
+    probe is one aligned SSE2 load. Keys are hashed with dstl::hash unless
+    another hasher is given; results of hashers that do not declare
+    is_avalanching are mixed first.
+
+--*/
+
+#ifndef DSTL_HASHTABLE_H
+#define DSTL_HASHTABLE_H
+
+namespace detail
+{
+    using ctrl_t = signed char;
+
+    inline constexpr ctrl_t ctrl_empty    = -128;
+    inline constexpr ctrl_t ctrl_deleted  = -2;
+    inline constexpr ctrl_t ctrl_sentinel = -1;
+
+    inline constexpr size_t group_width = 16;
+
+    // bit mask of the slots of a group that matched, one bit per slot
+    class group_mask
+    {
+    private:
+        uint32_t mask_;
+
+    public:
+        explicit group_mask (uint32_t mask) noexcept : mask_(mask) {}
+
+        explicit operator bool () const noexcept { return mask_ != 0; }
+
+        [[nodiscard]] unsigned lowest () const noexcept { return static_cast<unsigned>(std::countr_zero(mask_)); }
+
+        // visits the matching slots in ascending order
+        group_mask &operator++ () noexcept
+        {
+            mask_ &= mask_ - 1;
+            return *this;
+        }
+    };
+
+    // the control bytes of group_width consecutive slots
+    class hash_group
+    {
+    private:
+#ifdef DSTL_SSE2
+        __m128i ctrl_;
+
+    public:
+        explicit hash_group (const ctrl_t *pos) noexcept
+            : ctrl_(_mm_load_si128(reinterpret_cast<const __m128i *>(pos))) {}
+
+        [[nodiscard]] group_mask match (ctrl_t h2) const noexcept
+        {
+            return group_mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl_))));
+        }
+
+        [[nodiscard]] group_mask match_empty () const noexcept
+        {
+            return match(ctrl_empty);
+        }
+
+        [[nodiscard]] group_mask match_empty_or_deleted () const noexcept
+        {
+            return group_mask(static_cast<uint32_t>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(ctrl_sentinel), ctrl_))));
+        }
+#else
+        ctrl_t ctrl_[group_width];
+
+        template<class Pred>
+        [[nodiscard]] group_mask match_if (Pred pred) const noexcept
+        {
+            uint32_t mask = 0;
+            for (size_t i = 0; i < group_width; ++i)
+                mask |= static_cast<uint32_t>(pred(ctrl_[i])) << i;
+            return group_mask(mask);
+        }
+
+    public:
+        explicit hash_group (const ctrl_t *pos) noexcept
+        {
+            std::memcpy(ctrl_, pos, group_width);
+        }
+
+        [[nodiscard]] group_mask match (ctrl_t h2) const noexcept
+        {
+            return match_if([h2] (ctrl_t c) { return c == h2; });
+        }
+
+        [[nodiscard]] group_mask match_empty () const noexcept
+        {
+            return match(ctrl_empty);
+        }
+
+        [[nodiscard]] group_mask match_empty_or_deleted () const noexcept
+        {
+            return match_if([] (ctrl_t c) { return c < ctrl_sentinel; });
+        }
+#endif
+    };
+
+    template<class Key>
+    struct flat_set_policy
+    {
+        using key_type   = Key;
+        using value_type = Key;
+
+        static constexpr bool constant_iterators = true;
+        static constexpr bool trivially_copyable = is_trivially_copyable_v<Key>;
+
+        static const key_type &key (const value_type &value) noexcept { return value; }
+    };
+
+    template<class Key, class T>
+    struct flat_map_policy
+    {
+        using key_type   = Key;
+        using value_type = std::pair<const Key, T>;
+
+        static constexpr bool constant_iterators = false;
+        static constexpr bool trivially_copyable = is_trivially_copyable_v<Key> && is_trivially_copyable_v<T>;
+
+        static const key_type &key (const value_type &value) noexcept { return value.first; }
+    };
+
+    // open addressing hash table shared by flat_hash_set and flat_hash_map
+    template<class Policy, class Hash, class KeyEqual>
+    class raw_hash_table
+    {
+    public:
+        using key_type        = typename Policy::key_type;
+        using value_type      = typename Policy::value_type;
+        using size_type       = size_t;
+        using difference_type = ptrdiff_t;
+        using hasher          = Hash;
+        using key_equal       = KeyEqual;
+        using reference       = value_type &;
+        using const_reference = const value_type &;
+        using pointer         = value_type *;
+        using const_pointer   = const value_type *;
+
+        template<bool Const>
+        class basic_iterator
+        {
+            friend class raw_hash_table;
+            template<bool> friend class basic_iterator;
+
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = typename Policy::value_type;
+            using difference_type   = ptrdiff_t;
+            using pointer           = conditional_t<Const, const value_type *, value_type *>;
+            using reference         = conditional_t<Const, const value_type &, value_type &>;
+
+        private:
+            const ctrl_t *ctrl_ = nullptr;
+            value_type *slot_   = nullptr;
+
+            basic_iterator (const ctrl_t *ctrl, value_type *slot) noexcept : ctrl_(ctrl), slot_(slot) {}
+
+            void skip_free () noexcept
+            {
+                while (*ctrl_ < ctrl_sentinel)
+                {
+                    ++ctrl_;
+                    ++slot_;
+                }
+            }
+
+        public:
+            basic_iterator () noexcept = default;
+
+            template<bool C = Const, class = enable_if_t<C>>
+            basic_iterator (const basic_iterator<false> &other) noexcept : ctrl_(other.ctrl_), slot_(other.slot_) {}
+
+            reference operator* () const noexcept { return *slot_; }
+            pointer operator-> () const noexcept { return slot_; }
+
+            basic_iterator &operator++ () noexcept
+            {
+                ++ctrl_;
+                ++slot_;
+                skip_free();
+                return *this;
+            }
+
+            basic_iterator operator++ (int) noexcept
+            {
+                basic_iterator tmp = *this;
+                ++*this;
+                return tmp;
+            }
+
+            friend bool operator== (const basic_iterator &lhs, const basic_iterator &rhs) noexcept
+            {
+                return lhs.slot_ == rhs.slot_;
+            }
+        };
+
+        using const_iterator = basic_iterator<true>;
+        using iterator       = conditional_t<Policy::constant_iterators, const_iterator, basic_iterator<false>>;
+
+    private:
+        static constexpr size_t npos = static_cast<size_t>(-1);
+
+        ctrl_t *ctrl_       = nullptr;
+        value_type *slots_  = nullptr;
+        size_t capacity_    = 0;
+        size_t size_        = 0;
+        size_t growth_left_ = 0;
+        [[no_unique_address]] Hash hash_;
+        [[no_unique_address]] KeyEqual eq_;
+
+    public:
+        raw_hash_table () = default;
+
+        explicit raw_hash_table (size_type bucket_count, const Hash &hash = Hash(), const KeyEqual &eq = KeyEqual())
+            : hash_(hash), eq_(eq)
+        {
+            reserve(bucket_count);
+        }
+
+        raw_hash_table (const raw_hash_table &other)
+            : hash_(other.hash_), eq_(other.eq_)
+        {
+            if (other.size_ == 0)
+                return;
+
+            // same capacity and hash function, so every element keeps its slot
+            allocate(other.capacity_);
+            std::memcpy(ctrl_, other.ctrl_, capacity_ + 1);
+            if constexpr (Policy::trivially_copyable)
+            {
+                std::memcpy(static_cast<void *>(slots_), static_cast<const void *>(other.slots_), capacity_ * sizeof(value_type));
+            }
+            else
+            {
+                size_t i = 0;
+                try
+                {
+                    for (; i != capacity_; ++i)
+                    {
+                        if (ctrl_[i] >= 0)
+                            ::new (static_cast<void *>(slots_ + i)) value_type(other.slots_[i]);
+                    }
+                }
+                catch (...)
+                {
+                    destroy_slots(i);
+                    deallocate();
+                    throw;
+                }
+            }
+            size_        = other.size_;
+            growth_left_ = other.growth_left_;
+        }
+
+        raw_hash_table (raw_hash_table &&other) noexcept
+            : ctrl_(other.ctrl_), slots_(other.slots_), capacity_(other.capacity_), size_(other.size_),
+              growth_left_(other.growth_left_), hash_(std::move(other.hash_)), eq_(std::move(other.eq_))
+        {
+            other.ctrl_        = nullptr;
+            other.slots_       = nullptr;
+            other.capacity_    = 0;
+            other.size_        = 0;
+            other.growth_left_ = 0;
+        }
+
+        ~raw_hash_table ()
+        {
+            destroy_slots(capacity_);
+            deallocate();
+        }
+
+        raw_hash_table &operator= (const raw_hash_table &other)
+        {
+            if (this != &other)
+            {
+                raw_hash_table tmp(other);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        raw_hash_table &operator= (raw_hash_table &&other) noexcept
+        {
+            if (this != &other)
+            {
+                raw_hash_table tmp(std::move(other));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        //
+        // iterators
+        //
+
+        iterator begin () noexcept
+        {
+            if (size_ == 0)
+                return end();
+            iterator it(ctrl_, slots_);
+            it.skip_free();
+            return it;
+        }
+
+        const_iterator begin () const noexcept { return const_cast<raw_hash_table *>(this)->begin(); }
+        const_iterator cbegin () const noexcept { return begin(); }
+        iterator end () noexcept { return iterator(ctrl_ + capacity_, slots_ + capacity_); }
+        const_iterator end () const noexcept { return const_cast<raw_hash_table *>(this)->end(); }
+        const_iterator cend () const noexcept { return end(); }
+
+        //
+        // capacity
+        //
+
+        [[nodiscard]] bool empty () const noexcept { return size_ == 0; }
+        [[nodiscard]] size_type size () const noexcept { return size_; }
+        [[nodiscard]] size_type capacity () const noexcept { return capacity_; }
+        [[nodiscard]] float load_factor () const noexcept { return capacity_ == 0 ? 0.0f : static_cast<float>(size_) / static_cast<float>(capacity_); }
+        [[nodiscard]] static constexpr float max_load_factor () noexcept { return 7.0f / 8.0f; }
+
+        hasher hash_function () const { return hash_; }
+        key_equal key_eq () const { return eq_; }
+
+        //
+        // modifiers
+        //
+
+        void clear () noexcept
+        {
+            if (capacity_ == 0)
+                return;
+            destroy_slots(capacity_);
+            reset_ctrl();
+            size_ = 0;
+        }
+
+        std::pair<iterator, bool> insert (const value_type &value)
+        {
+            return insert_unique(Policy::key(value), [&value] (value_type *slot) {
+                ::new (static_cast<void *>(slot)) value_type(value);
+            });
+        }
+
+        std::pair<iterator, bool> insert (value_type &&value)
+        {
+            return insert_unique(Policy::key(value), [&value] (value_type *slot) {
+                ::new (static_cast<void *>(slot)) value_type(std::move(value));
+            });
+        }
+
+        template<class InputIt>
+        void insert (InputIt first, InputIt last)
+        {
+            for (; first != last; ++first)
+                emplace(*first);
+        }
+
+        void insert (std::initializer_list<value_type> init)
+        {
+            insert(init.begin(), init.end());
+        }
+
+        template<class... Args>
+        std::pair<iterator, bool> emplace (Args &&...args)
+        {
+            value_type tmp(std::forward<Args>(args)...);
+            return insert(std::move(tmp));
+        }
+
+        iterator erase (const_iterator pos)
+        {
+            const auto index = static_cast<size_t>(pos.slot_ - slots_);
+            erase_at(index);
+            iterator next(ctrl_ + index, slots_ + index);
+            next.skip_free();
+            return next;
+        }
+
+        size_type erase (const key_type &key)
+        {
+            const size_t index = find_index(key, hash_of(key));
+            if (index == npos)
+                return 0;
+            erase_at(index);
+            return 1;
+        }
+
+        void swap (raw_hash_table &other) noexcept
+        {
+            std::swap(ctrl_, other.ctrl_);
+            std::swap(slots_, other.slots_);
+            std::swap(capacity_, other.capacity_);
+            std::swap(size_, other.size_);
+            std::swap(growth_left_, other.growth_left_);
+            std::swap(hash_, other.hash_);
+            std::swap(eq_, other.eq_);
+        }
+
+        //
+        // lookup
+        //
+
+        iterator find (const key_type &key)
+        {
+            const size_t index = find_index(key, hash_of(key));
+            return index == npos ? end() : iterator_at(index);
+        }
+
+        const_iterator find (const key_type &key) const { return const_cast<raw_hash_table *>(this)->find(key); }
+
+        [[nodiscard]] bool contains (const key_type &key) const { return find_index(key, hash_of(key)) != npos; }
+        [[nodiscard]] size_type count (const key_type &key) const { return contains(key) ? 1 : 0; }
+
+        //
+        // hash policy
+        //
+
+        // makes room for count elements without rehashing
+        void reserve (size_type count)
+        {
+            if (count > size_ + growth_left_)
+                resize(capacity_for(count));
+        }
+
+        // rebuilds the table with room for at least count elements, dropping deleted slots
+        void rehash (size_type count)
+        {
+            const size_t target = capacity_for(count > size_ ? count : size_);
+            if (target != 0)
+                resize(target);
+        }
+
+    protected:
+        [[nodiscard]] size_t hash_of (const key_type &key) const
+        {
+            if constexpr (is_avalanching_v<Hash>)
+                return static_cast<size_t>(hash_(key));
+            else
+                return static_cast<size_t>(hash_mix(static_cast<size_t>(hash_(key))));
+        }
+
+        [[nodiscard]] static ctrl_t h2_of (size_t hash) noexcept { return static_cast<ctrl_t>(hash & 0x7F); }
+        [[nodiscard]] static size_t h1_of (size_t hash) noexcept { return hash >> 7; }
+
+        iterator iterator_at (size_t index) noexcept { return iterator(ctrl_ + index, slots_ + index); }
+
+        [[nodiscard]] size_t find_index (const key_type &key, size_t hash) const
+        {
+            if (capacity_ == 0)
+                return npos;
+
+            const size_t group_mask_bits = capacity_ / group_width - 1;
+            const ctrl_t h2              = h2_of(hash);
+            size_t group                 = h1_of(hash) & group_mask_bits;
+            for (size_t step = 1;; ++step)
+            {
+                const size_t offset = group * group_width;
+                const hash_group g(ctrl_ + offset);
+                for (group_mask m = g.match(h2); m; ++m)
+                {
+                    const size_t index = offset + m.lowest();
+                    if (eq_(Policy::key(slots_[index]), key))
+                        return index;
+                }
+                if (g.match_empty())
+                    return npos;
+                group = (group + step) & group_mask_bits;
+            }
+        }
+
+        // inserts the element built by construct(slot) unless key is already present
+        template<class Construct>
+        std::pair<iterator, bool> insert_unique (const key_type &key, Construct &&construct)
+        {
+            const size_t hash = hash_of(key);
+            size_t index      = find_index(key, hash);
+            if (index != npos)
+                return {iterator_at(index), false};
+
+            if (growth_left_ == 0)
+                grow();
+            index = find_first_non_full(hash);
+            construct(slots_ + index);
+
+            if (ctrl_[index] == ctrl_empty)
+                --growth_left_;
+            ctrl_[index] = h2_of(hash);
+            ++size_;
+            return {iterator_at(index), true};
+        }
+
+    private:
+        // the smallest power-of-two capacity holding count elements under the maximum load factor
+        [[nodiscard]] static size_t capacity_for (size_t count) noexcept
+        {
+            if (count == 0)
+                return 0;
+            const size_t min_slots = count + (count + 6) / 7;
+            return std::bit_ceil(min_slots < group_width ? group_width : min_slots);
+        }
+
+        [[nodiscard]] static constexpr size_t block_align () noexcept
+        {
+            return alignof(value_type) > group_width ? alignof(value_type) : group_width;
+        }
+
+        // control bytes (including the sentinel, padded to whole groups) precede the slots
+        [[nodiscard]] static constexpr size_t slots_offset (size_t capacity) noexcept
+        {
+            const size_t ctrl_bytes = capacity + group_width;
+            return (ctrl_bytes + alignof(value_type) - 1) / alignof(value_type) * alignof(value_type);
+        }
+
+        [[nodiscard]] static constexpr size_t block_size (size_t capacity) noexcept
+        {
+            return slots_offset(capacity) + capacity * sizeof(value_type);
+        }
+
+        void allocate (size_t capacity)
+        {
+            auto *block = static_cast<unsigned char *>(::operator new(block_size(capacity), std::align_val_t{block_align()}));
+            ctrl_       = reinterpret_cast<ctrl_t *>(block);
+            slots_      = reinterpret_cast<value_type *>(block + slots_offset(capacity));
+            capacity_   = capacity;
+            reset_ctrl();
+        }
+
+        void deallocate () noexcept
+        {
+            if (ctrl_ != nullptr)
+                ::operator delete(ctrl_, block_size(capacity_), std::align_val_t{block_align()});
+            ctrl_        = nullptr;
+            slots_       = nullptr;
+            capacity_    = 0;
+            growth_left_ = 0;
+        }
+
+        void reset_ctrl () noexcept
+        {
+            std::memset(ctrl_, ctrl_empty, capacity_);
+            std::memset(ctrl_ + capacity_, ctrl_sentinel, group_width);
+            growth_left_ = capacity_ * 7 / 8;
+        }
+
+        // destroys the elements of the full slots in [0, count)
+        void destroy_slots (size_t count) noexcept
+        {
+            if constexpr (!is_trivially_destructible_v<value_type>)
+            {
+                for (size_t i = 0; i != count; ++i)
+                {
+                    if (ctrl_[i] >= 0)
+                        slots_[i].~value_type();
+                }
+            }
+        }
+
+        [[nodiscard]] size_t find_first_non_full (size_t hash) const noexcept
+        {
+            const size_t group_mask_bits = capacity_ / group_width - 1;
+            size_t group                 = h1_of(hash) & group_mask_bits;
+            for (size_t step = 1;; ++step)
+            {
+                const size_t offset = group * group_width;
+                if (const group_mask m = hash_group(ctrl_ + offset).match_empty_or_deleted())
+                    return offset + m.lowest();
+                group = (group + step) & group_mask_bits;
+            }
+        }
+
+        void erase_at (size_t index) noexcept
+        {
+            slots_[index].~value_type();
+            --size_;
+
+            // a probe only continues past a group without empty slots, so the slot can
+            // become empty again if its group already has one
+            const size_t offset = index & ~(group_width - 1);
+            if (hash_group(ctrl_ + offset).match_empty())
+            {
+                ctrl_[index] = ctrl_empty;
+                ++growth_left_;
+            }
+            else
+            {
+                ctrl_[index] = ctrl_deleted;
+            }
+        }
+
+        void grow ()
+        {
+            if (capacity_ == 0)
+                resize(group_width);
+            else if (size_ <= capacity_ * 7 / 16)
+                resize(capacity_); // mostly tombstones, rehash in place
+            else
+                resize(capacity_ * 2);
+        }
+
+        // moves every element into a new table of the given capacity.
+        // the move constructor of a non-trivially-copyable value type should not throw
+        void resize (size_t new_capacity)
+        {
+            ctrl_t *old_ctrl        = ctrl_;
+            value_type *old_slots   = slots_;
+            const size_t old_cap    = capacity_;
+            const size_t old_growth = growth_left_;
+
+            ctrl_ = nullptr;
+            try
+            {
+                allocate(new_capacity);
+            }
+            catch (...)
+            {
+                ctrl_        = old_ctrl;
+                slots_       = old_slots;
+                capacity_    = old_cap;
+                growth_left_ = old_growth;
+                throw;
+            }
+
+            for (size_t i = 0; i != old_cap; ++i)
+            {
+                if (old_ctrl[i] < 0)
+                    continue;
+
+                const size_t hash  = hash_of(Policy::key(old_slots[i]));
+                const size_t index = find_first_non_full(hash);
+                ctrl_[index]       = h2_of(hash);
+                if constexpr (Policy::trivially_copyable)
+                    std::memcpy(static_cast<void *>(slots_ + index), static_cast<const void *>(old_slots + i), sizeof(value_type));
+                else
+                    dstl::relocate_at(old_slots + i, slots_ + index);
+            }
+            growth_left_ -= size_;
+
+            if (old_ctrl != nullptr)
+                ::operator delete(old_ctrl, block_size(old_cap), std::align_val_t{block_align()});
+        }
+    };
+}
+
+// open addressing hash set
+template<class Key, class Hash = hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_set : public detail::raw_hash_table<detail::flat_set_policy<Key>, Hash, KeyEqual>
+{
+private:
+    using base = detail::raw_hash_table<detail::flat_set_policy<Key>, Hash, KeyEqual>;
+
+public:
+    using base::base;
+
+    flat_hash_set () = default;
+
+    flat_hash_set (std::initializer_list<Key> init)
+    {
+        base::reserve(init.size());
+        base::insert(init);
+    }
+
+    friend void swap (flat_hash_set &lhs, flat_hash_set &rhs) noexcept { lhs.swap(rhs); }
+};
+
+// open addressing hash map
+template<class Key, class T, class Hash = hash<Key>, class KeyEqual = std::equal_to<Key>>
+class flat_hash_map : public detail::raw_hash_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual>
+{
+private:
+    using base = detail::raw_hash_table<detail::flat_map_policy<Key, T>, Hash, KeyEqual>;
+
+public:
+    using mapped_type = T;
+    using typename base::key_type;
+    using typename base::value_type;
+    using typename base::iterator;
+    using typename base::const_iterator;
+
+    using base::base;
+
+    flat_hash_map () = default;
+
+    flat_hash_map (std::initializer_list<value_type> init)
+    {
+        base::reserve(init.size());
+        base::insert(init);
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (const key_type &key, Args &&...args)
+    {
+        return base::insert_unique(key, [&] (value_type *slot) {
+            ::new (static_cast<void *>(slot)) value_type(std::piecewise_construct,
+                                                         std::forward_as_tuple(key),
+                                                         std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    template<class... Args>
+    std::pair<iterator, bool> try_emplace (key_type &&key, Args &&...args)
+    {
+        return base::insert_unique(key, [&] (value_type *slot) {
+            ::new (static_cast<void *>(slot)) value_type(std::piecewise_construct,
+                                                         std::forward_as_tuple(std::move(key)),
+                                                         std::forward_as_tuple(std::forward<Args>(args)...));
+        });
+    }
+
+    template<class M>
+    std::pair<iterator, bool> insert_or_assign (const key_type &key, M &&obj)
+    {
+        auto result = try_emplace(key, std::forward<M>(obj));
+        if (!result.second)
+            result.first->second = std::forward<M>(obj);
+        return result;
+    }
+
+    T &operator[] (const key_type &key) { return try_emplace(key).first->second; }
+    T &operator[] (key_type &&key) { return try_emplace(std::move(key)).first->second; }
+
+    T &at (const key_type &key)
+    {
+        auto it = base::find(key);
+        if (it == base::end())
+            throw std::out_of_range("dstl::flat_hash_map::at");
+        return it->second;
+    }
+
+    const T &at (const key_type &key) const
+    {
+        auto it = base::find(key);
+        if (it == base::end())
+            throw std::out_of_range("dstl::flat_hash_map::at");
+        return it->second;
+    }
+
+    friend void swap (flat_hash_map &lhs, flat_hash_map &rhs) noexcept { lhs.swap(rhs); }
+};
+
+#endif //DSTL_HASHTABLE_H
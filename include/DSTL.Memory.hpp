@@ -0,0 +1,225 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Memory.hpp
+
+Abstract:
+    Uninitialized Memory Algorithms.
+
+    Relocation moves an object to a new address and ends its lifetime at
+    the old one. For trivially relocatable types it is a single memcpy or
+    memmove of the whole range.
+
+--*/
+
+#ifndef DSTL_MEMORY_H
+#define DSTL_MEMORY_H
+
+namespace detail
+{
+    // the unit node based containers are laid out in, and that keeps atomics written by
+    // different threads apart
+    inline constexpr size_t cache_line_size = 64;
+
+    // allocates uninitialized storage for count objects of T
+    template<class T>
+    T *allocate_n (size_t count)
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            return static_cast<T *>(::operator new(count * sizeof(T), std::align_val_t{alignof(T)}));
+        else
+            return static_cast<T *>(::operator new(count * sizeof(T)));
+    }
+
+    // releases storage obtained from allocate_n
+    template<class T>
+    void deallocate_n (T *ptr, size_t count) noexcept
+    {
+        if constexpr (alignof(T) > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+            ::operator delete(ptr, count * sizeof(T), std::align_val_t{alignof(T)});
+        else
+            ::operator delete(ptr, count * sizeof(T));
+    }
+
+    // moves [first, last) into the uninitialized, non-overlapping storage at dest, or copies
+    // them when T is copyable and its move constructor may throw, as std::move_if_noexcept,
+    // so that a constructor that throws leaves the source range as it was
+    template<class T>
+    T *move_if_noexcept_construct_range (T *first, T *last, T *dest)
+    {
+        if constexpr (is_trivially_copyable_v<T>)
+        {
+            const size_t count = static_cast<size_t>(last - first);
+            if (count != 0)
+                std::memcpy(dest, first, count * sizeof(T));
+            return dest + count;
+        }
+        else
+        {
+            T *cur = dest;
+            try
+            {
+                for (; first != last; ++first, ++cur)
+                    ::new (static_cast<void *>(cur)) T(std::move_if_noexcept(*first));
+            }
+            catch (...)
+            {
+                for (; dest != cur; ++dest)
+                    dest->~T();
+                throw;
+            }
+            return cur;
+        }
+    }
+
+    // copies [first, last) into the uninitialized, non-overlapping storage at dest
+    template<class T>
+    T *copy_construct_range (const T *first, const T *last, T *dest)
+    {
+        if constexpr (is_trivially_copyable_v<T>)
+        {
+            const size_t count = static_cast<size_t>(last - first);
+            if (count != 0)
+                std::memcpy(dest, first, count * sizeof(T));
+            return dest + count;
+        }
+        else
+        {
+            T *cur = dest;
+            try
+            {
+                for (; first != last; ++first, ++cur)
+                    ::new (static_cast<void *>(cur)) T(*first);
+            }
+            catch (...)
+            {
+                for (; dest != cur; ++dest)
+                    dest->~T();
+                throw;
+            }
+            return cur;
+        }
+    }
+}
+
+// destroys an object at a given address
+template<class T>
+void destroy_at (T *ptr) noexcept
+{
+    if constexpr (is_array_v<T>)
+    {
+        for (auto &elem : *ptr)
+            dstl::destroy_at(&elem);
+    }
+    else if constexpr (!is_trivially_destructible_v<T>)
+    {
+        ptr->~T();
+    }
+}
+
+// destroys the objects in [first, last)
+template<class T>
+void destroy (T *first, T *last) noexcept
+{
+    if constexpr (!is_trivially_destructible_v<T>)
+    {
+        for (; first != last; ++first)
+            dstl::destroy_at(first);
+    }
+}
+
+// relocates the object at source into the uninitialized storage at dest
+template<class T>
+T *relocate_at (T *source, T *dest) noexcept(is_trivially_relocatable_v<T> || noexcept(T(std::move(*source))))
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        std::memmove(static_cast<void *>(dest), static_cast<const void *>(source), sizeof(T));
+        return std::launder(dest);
+    }
+    else
+    {
+        T *result = ::new (static_cast<void *>(dest)) T(std::move(*source));
+        dstl::destroy_at(source);
+        return result;
+    }
+}
+
+// relocates [first, last) into the uninitialized, non-overlapping storage at dest.
+// if a constructor throws, the objects constructed at dest are destroyed and the
+// source range keeps its objects, which are only moved from when T is not copyable
+// and its move constructor may throw
+template<class T>
+T *uninitialized_relocate (T *first, T *last, T *dest)
+{
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        const size_t count = static_cast<size_t>(last - first);
+        if (count != 0)
+            std::memcpy(static_cast<void *>(dest), static_cast<const void *>(first), count * sizeof(T));
+        return dest + count;
+    }
+    else
+    {
+        T *result = detail::move_if_noexcept_construct_range(first, last, dest);
+        dstl::destroy(first, last);
+        return result;
+    }
+}
+
+// relocates count objects starting at first into the uninitialized, non-overlapping storage at dest
+template<class T>
+T *uninitialized_relocate_n (T *first, size_t count, T *dest)
+{
+    return dstl::uninitialized_relocate(first, first + count, dest);
+}
+
+// relocates [first, last) to dest, the ranges may overlap and the part of the
+// destination outside of the source range must be uninitialized.
+// if a move constructor throws, every object of both ranges is destroyed
+template<class T>
+T *relocate (T *first, T *last, T *dest)
+{
+    const size_t count = static_cast<size_t>(last - first);
+    if constexpr (is_trivially_relocatable_v<T>)
+    {
+        if (count != 0)
+            std::memmove(static_cast<void *>(dest), static_cast<const void *>(first), count * sizeof(T));
+    }
+    else if (dest < first)
+    {
+        size_t i = 0;
+        try
+        {
+            for (; i != count; ++i)
+                dstl::relocate_at(first + i, dest + i);
+        }
+        catch (...)
+        {
+            dstl::destroy(dest, dest + i);
+            dstl::destroy(first + i, last);
+            throw;
+        }
+    }
+    else if (dest > first)
+    {
+        size_t i = count;
+        try
+        {
+            for (; i != 0; --i)
+                dstl::relocate_at(first + i - 1, dest + i - 1);
+        }
+        catch (...)
+        {
+            dstl::destroy(first, first + i);
+            dstl::destroy(dest + i, dest + count);
+            throw;
+        }
+    }
+    return dest + count;
+}
+
+#endif //DSTL_MEMORY_H
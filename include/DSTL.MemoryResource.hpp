@@ -0,0 +1,355 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.MemoryResource.hpp
+
+Abstract:
+    Polymorphic Memory Resources.
+
+    monotonic_buffer_resource hands out memory by bumping a pointer through
+    a chain of blocks obtained from an upstream resource and gives it all
+    back at once on release. Objects made with its create member have
+    their destructors run on release, trivially destructible ones are
+    simply dropped.
+
+--*/
+
+#ifndef DSTL_MEMORY_RESOURCE_H
+#define DSTL_MEMORY_RESOURCE_H
+
+class memory_resource
+{
+public:
+    static constexpr size_t max_align = alignof(std::max_align_t);
+
+    virtual ~memory_resource () = default;
+
+    [[nodiscard]] void *allocate (size_t bytes, size_t alignment = max_align)
+    {
+        return do_allocate(bytes, alignment);
+    }
+
+    void deallocate (void *ptr, size_t bytes, size_t alignment = max_align)
+    {
+        do_deallocate(ptr, bytes, alignment);
+    }
+
+    bool is_equal (const memory_resource &other) const noexcept { return do_is_equal(other); }
+
+    friend bool operator== (const memory_resource &lhs, const memory_resource &rhs) noexcept
+    {
+        return &lhs == &rhs || lhs.is_equal(rhs);
+    }
+
+private:
+    virtual void *do_allocate (size_t bytes, size_t alignment)             = 0;
+    virtual void do_deallocate (void *ptr, size_t bytes, size_t alignment) = 0;
+    virtual bool do_is_equal (const memory_resource &other) const noexcept = 0;
+};
+
+namespace detail
+{
+    class new_delete_resource_impl final : public memory_resource
+    {
+        void *do_allocate (size_t bytes, size_t alignment) override
+        {
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                return ::operator new(bytes, std::align_val_t{alignment});
+            return ::operator new(bytes);
+        }
+
+        void do_deallocate (void *ptr, size_t bytes, size_t alignment) override
+        {
+            if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+                ::operator delete(ptr, bytes, std::align_val_t{alignment});
+            else
+                ::operator delete(ptr, bytes);
+        }
+
+        bool do_is_equal (const memory_resource &other) const noexcept override { return this == &other; }
+    };
+
+    class null_memory_resource_impl final : public memory_resource
+    {
+        void *do_allocate (size_t, size_t) override { throw std::bad_alloc(); }
+
+        void do_deallocate (void *, size_t, size_t) override {}
+
+        bool do_is_equal (const memory_resource &other) const noexcept override { return this == &other; }
+    };
+}
+
+// a resource that forwards to the global operator new and operator delete
+inline memory_resource *new_delete_resource () noexcept
+{
+    static detail::new_delete_resource_impl resource;
+    return &resource;
+}
+
+// a resource whose allocations always throw std::bad_alloc
+inline memory_resource *null_memory_resource () noexcept
+{
+    static detail::null_memory_resource_impl resource;
+    return &resource;
+}
+
+namespace detail
+{
+    inline std::atomic<memory_resource *> &default_resource () noexcept
+    {
+        static std::atomic<memory_resource *> resource{new_delete_resource()};
+        return resource;
+    }
+}
+
+inline memory_resource *get_default_resource () noexcept
+{
+    return detail::default_resource().load(std::memory_order_acquire);
+}
+
+// replaces the default resource, nullptr restores new_delete_resource. returns the previous one
+inline memory_resource *set_default_resource (memory_resource *resource) noexcept
+{
+    if (resource == nullptr)
+        resource = new_delete_resource();
+    return detail::default_resource().exchange(resource, std::memory_order_acq_rel);
+}
+
+class monotonic_buffer_resource : public memory_resource
+{
+public:
+    monotonic_buffer_resource () : monotonic_buffer_resource(get_default_resource()) {}
+
+    explicit monotonic_buffer_resource (memory_resource *upstream) : upstream_(upstream) {}
+
+    monotonic_buffer_resource (size_t initial_size, memory_resource *upstream = get_default_resource())
+        : upstream_(upstream), next_size_(initial_size != 0 ? initial_size : 1)
+    {
+    }
+
+    // serves allocations from buffer before going upstream, buffer must outlive the resource
+    monotonic_buffer_resource (void *buffer, size_t buffer_size, memory_resource *upstream = get_default_resource())
+        : upstream_(upstream),
+          initial_buffer_(buffer),
+          initial_size_(buffer_size),
+          cur_(static_cast<unsigned char *>(buffer)),
+          end_(static_cast<unsigned char *>(buffer) + buffer_size),
+          next_size_(buffer_size != 0 ? buffer_size * growth_factor : min_block_size)
+    {
+    }
+
+    monotonic_buffer_resource (const monotonic_buffer_resource &)            = delete;
+    monotonic_buffer_resource &operator= (const monotonic_buffer_resource &) = delete;
+
+    ~monotonic_buffer_resource () override { release(); }
+
+    // destroys the objects made by create and returns every block to the upstream resource.
+    // the initial buffer is reused by the next allocations
+    void release () noexcept
+    {
+        for (destructor_node *node = destructors_; node != nullptr; node = node->next_)
+            node->destroy_(node->object_);
+        destructors_ = nullptr;
+
+        while (blocks_ != nullptr)
+        {
+            block_header *prev = blocks_->prev_;
+            upstream_->deallocate(blocks_, blocks_->size_, alignof(block_header));
+            blocks_ = prev;
+        }
+
+        cur_ = static_cast<unsigned char *>(initial_buffer_);
+        end_ = cur_ + initial_size_;
+    }
+
+    memory_resource *upstream_resource () const noexcept { return upstream_; }
+
+    // constructs a T in the arena that lives until release. only non-trivially
+    // destructible types pay for a destructor record
+    template<class T, class... Args>
+    T *create (Args &&...args)
+    {
+        void *storage = allocate(sizeof(T), alignof(T));
+        if constexpr (is_trivially_destructible_v<T>)
+        {
+            return ::new (storage) T(std::forward<Args>(args)...);
+        }
+        else
+        {
+            // allocated first so that a throwing constructor leaves no record behind
+            void *record = allocate(sizeof(destructor_node), alignof(destructor_node));
+            T *object    = ::new (storage) T(std::forward<Args>(args)...);
+            destructors_ = ::new (record) destructor_node{destructors_, object, [] (void *ptr) noexcept {
+                                                              static_cast<T *>(ptr)->~T();
+                                                          }};
+            return object;
+        }
+    }
+
+protected:
+    void *do_allocate (size_t bytes, size_t alignment) override
+    {
+        if (void *ptr = bump(bytes, alignment))
+            return ptr;
+
+        // the first bytes of every block hold its header
+        size_t size = next_size_;
+        if (size < bytes + alignment + sizeof(block_header))
+            size = bytes + alignment + sizeof(block_header);
+
+        void *raw  = upstream_->allocate(size, alignof(block_header));
+        blocks_    = ::new (raw) block_header{blocks_, size};
+        cur_       = static_cast<unsigned char *>(raw) + sizeof(block_header);
+        end_       = static_cast<unsigned char *>(raw) + size;
+        next_size_ = size * growth_factor;
+        return bump(bytes, alignment);
+    }
+
+    // individual deallocation is a no-op, memory comes back on release
+    void do_deallocate (void *, size_t, size_t) override {}
+
+    bool do_is_equal (const memory_resource &other) const noexcept override { return this == &other; }
+
+private:
+    static constexpr size_t min_block_size = 1024;
+    static constexpr size_t growth_factor  = 2;
+
+    struct block_header
+    {
+        block_header *prev_;
+        size_t size_;
+    };
+
+    struct destructor_node
+    {
+        destructor_node *next_;
+        void *object_;
+        void (*destroy_) (void *) noexcept;
+    };
+
+    void *bump (size_t bytes, size_t alignment) noexcept
+    {
+        const uintptr_t addr    = reinterpret_cast<uintptr_t>(cur_);
+        const uintptr_t aligned = (addr + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1);
+        if (cur_ == nullptr || aligned - addr > static_cast<size_t>(end_ - cur_) || bytes > static_cast<size_t>(end_ - cur_) - (aligned - addr))
+            return nullptr;
+        cur_ = reinterpret_cast<unsigned char *>(aligned) + bytes;
+        return reinterpret_cast<void *>(aligned);
+    }
+
+    memory_resource *upstream_;
+    void *initial_buffer_         = nullptr;
+    size_t initial_size_          = 0;
+    unsigned char *cur_           = nullptr;
+    unsigned char *end_           = nullptr;
+    size_t next_size_             = min_block_size;
+    block_header *blocks_         = nullptr;
+    destructor_node *destructors_ = nullptr;
+};
+
+template<class T = std::byte>
+class polymorphic_allocator
+{
+public:
+    using value_type = T;
+
+    polymorphic_allocator () noexcept : resource_(get_default_resource()) {}
+
+    polymorphic_allocator (memory_resource *resource) noexcept : resource_(resource) {}
+
+    polymorphic_allocator (const polymorphic_allocator &other) = default;
+
+    template<class U>
+    polymorphic_allocator (const polymorphic_allocator<U> &other) noexcept : resource_(other.resource())
+    {
+    }
+
+    polymorphic_allocator &operator= (const polymorphic_allocator &) = delete;
+
+    [[nodiscard]] T *allocate (size_t count)
+    {
+        if (count > static_cast<size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return static_cast<T *>(resource_->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    void deallocate (T *ptr, size_t count) { resource_->deallocate(ptr, count * sizeof(T), alignof(T)); }
+
+    [[nodiscard]] void *allocate_bytes (size_t bytes, size_t alignment = memory_resource::max_align)
+    {
+        return resource_->allocate(bytes, alignment);
+    }
+
+    void deallocate_bytes (void *ptr, size_t bytes, size_t alignment = memory_resource::max_align)
+    {
+        resource_->deallocate(ptr, bytes, alignment);
+    }
+
+    template<class U>
+    [[nodiscard]] U *allocate_object (size_t count = 1)
+    {
+        if (count > static_cast<size_t>(-1) / sizeof(U))
+            throw std::bad_array_new_length();
+        return static_cast<U *>(allocate_bytes(count * sizeof(U), alignof(U)));
+    }
+
+    template<class U>
+    void deallocate_object (U *ptr, size_t count = 1)
+    {
+        deallocate_bytes(ptr, count * sizeof(U), alignof(U));
+    }
+
+    template<class U, class... Args>
+    [[nodiscard]] U *new_object (Args &&...args)
+    {
+        U *ptr = allocate_object<U>();
+        try
+        {
+            construct(ptr, std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            deallocate_object(ptr);
+            throw;
+        }
+        return ptr;
+    }
+
+    template<class U>
+    void delete_object (U *ptr)
+    {
+        destroy(ptr);
+        deallocate_object(ptr);
+    }
+
+    template<class U, class... Args>
+    void construct (U *ptr, Args &&...args)
+    {
+        ::new (static_cast<void *>(ptr)) U(std::forward<Args>(args)...);
+    }
+
+    // no-op for trivially destructible types
+    template<class U>
+    void destroy (U *ptr)
+    {
+        dstl::destroy_at(ptr);
+    }
+
+    polymorphic_allocator select_on_container_copy_construction () const { return polymorphic_allocator(); }
+
+    memory_resource *resource () const noexcept { return resource_; }
+
+    template<class U>
+    friend bool operator== (const polymorphic_allocator &lhs, const polymorphic_allocator<U> &rhs) noexcept
+    {
+        return *lhs.resource() == *rhs.resource();
+    }
+
+private:
+    memory_resource *resource_;
+};
+
+#endif // DSTL_MEMORY_RESOURCE_H
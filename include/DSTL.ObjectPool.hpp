@@ -0,0 +1,259 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.ObjectPool.hpp
+
+Abstract:
+    Object Pool and Slab Allocator.
+
+    Objects are grouped into size classes derived from their size and
+    alignment. Each class carves fixed size slots out of large slabs and
+    links free slots through their own storage. Every thread caches free
+    slots in two magazines of batch_size slots, so allocation and
+    deallocation touch only thread local state. A full magazine is handed
+    to the global depot of its class, and an empty one is refilled from
+    there, under a lock taken once per batch.
+
+    Slabs are never returned to the system, freed slots stay in the class
+    for reuse.
+
+--*/
+
+#ifndef DSTL_OBJECT_POOL_H
+#define DSTL_OBJECT_POOL_H
+
+namespace detail
+{
+    // a free slot, the second link chains whole magazines in the depot
+    struct slab_node
+    {
+        slab_node *next_;
+        slab_node *next_magazine_;
+    };
+
+    // the size class of T, slots are a multiple of both its alignment and the node size
+    template<class T>
+    struct slab_class
+    {
+        static constexpr size_t align   = alignment_of_v<T> > alignof(slab_node) ? alignment_of_v<T> : alignof(slab_node);
+        static constexpr size_t granule = align > sizeof(slab_node) ? align : sizeof(slab_node);
+        static constexpr size_t size    = (sizeof(T) + granule - 1) / granule * granule;
+    };
+
+    template<size_t Size, size_t Align>
+    class slab_pool
+    {
+    public:
+        static constexpr size_t batch_size = 64;
+        static constexpr size_t slab_bytes = Size * batch_size * 4 > (64u << 10) ? Size * batch_size * 4 : (64u << 10) / Size * Size;
+
+        [[nodiscard]] static void *allocate ()
+        {
+            thread_cache &cache = local_cache();
+            if (cache.loaded_.count_ == 0)
+            {
+                if (cache.previous_.count_ != 0)
+                    std::swap(cache.loaded_, cache.previous_);
+                else
+                    cache.loaded_ = instance().take_magazine();
+            }
+
+            slab_node *node     = cache.loaded_.head_;
+            cache.loaded_.head_ = node->next_;
+            --cache.loaded_.count_;
+            return node;
+        }
+
+        static void deallocate (void *ptr) noexcept
+        {
+            thread_cache &cache = local_cache();
+            if (cache.loaded_.count_ == batch_size)
+            {
+                // previous is either empty or full
+                if (cache.previous_.count_ != 0)
+                    instance().give_magazine(cache.previous_.head_);
+                cache.previous_ = cache.loaded_;
+                cache.loaded_   = {};
+            }
+
+            auto *node          = static_cast<slab_node *>(ptr);
+            node->next_         = cache.loaded_.head_;
+            cache.loaded_.head_ = node;
+            ++cache.loaded_.count_;
+        }
+
+    private:
+        struct magazine
+        {
+            slab_node *head_ = nullptr;
+            size_t count_    = 0;
+        };
+
+        struct thread_cache
+        {
+            magazine loaded_;
+            magazine previous_;
+
+            ~thread_cache ()
+            {
+                instance().give_loose(loaded_.head_);
+                instance().give_loose(previous_.head_);
+            }
+        };
+
+        // never destroyed, so objects may be freed from static destructors and exiting threads
+        static slab_pool &instance () noexcept
+        {
+            static slab_pool *pool = new slab_pool;
+            return *pool;
+        }
+
+        static thread_cache &local_cache () noexcept
+        {
+            thread_local thread_cache cache;
+            return cache;
+        }
+
+        magazine take_magazine ()
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            magazine result;
+            if (full_ != nullptr)
+            {
+                result.head_  = full_;
+                result.count_ = batch_size;
+                full_         = full_->next_magazine_;
+            }
+            else if (loose_ != nullptr)
+            {
+                result.head_ = loose_;
+                slab_node *last = loose_;
+                for (result.count_ = 1; result.count_ < batch_size && last->next_ != nullptr; ++result.count_)
+                    last = last->next_;
+                loose_      = last->next_;
+                last->next_ = nullptr;
+            }
+            else
+            {
+                if (static_cast<size_t>(end_ - cur_) < Size * batch_size)
+                {
+                    cur_ = static_cast<unsigned char *>(::operator new(slab_bytes, std::align_val_t{Align}));
+                    end_ = cur_ + slab_bytes;
+                }
+                for (; result.count_ < batch_size && cur_ != end_; ++result.count_, cur_ += Size)
+                {
+                    auto *node   = reinterpret_cast<slab_node *>(cur_);
+                    node->next_  = result.head_;
+                    result.head_ = node;
+                }
+            }
+            return result;
+        }
+
+        void give_magazine (slab_node *head) noexcept
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            head->next_magazine_ = full_;
+            full_                = head;
+        }
+
+        void give_loose (slab_node *head) noexcept
+        {
+            if (head == nullptr)
+                return;
+            slab_node *last = head;
+            while (last->next_ != nullptr)
+                last = last->next_;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            last->next_ = loose_;
+            loose_      = head;
+        }
+
+        std::mutex mutex_;
+        slab_node *full_    = nullptr;
+        slab_node *loose_   = nullptr;
+        unsigned char *cur_ = nullptr;
+        unsigned char *end_ = nullptr;
+    };
+
+    template<class T>
+    using slab_pool_for = slab_pool<slab_class<T>::size, slab_class<T>::align>;
+}
+
+// creates and destroys objects of T in slots of the slab size class of T.
+// an object may be destroyed on any thread, not only the one that created it
+template<class T>
+class object_pool
+{
+public:
+    using value_type = T;
+
+    template<class... Args>
+    [[nodiscard]] T *create (Args &&...args)
+    {
+        void *ptr = detail::slab_pool_for<T>::allocate();
+        try
+        {
+            return ::new (ptr) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            detail::slab_pool_for<T>::deallocate(ptr);
+            throw;
+        }
+    }
+
+    void destroy (T *ptr) noexcept
+    {
+        if (ptr == nullptr)
+            return;
+        dstl::destroy_at(ptr);
+        detail::slab_pool_for<T>::deallocate(ptr);
+    }
+};
+
+// an allocator serving single objects from the slab size class of T, arrays come from operator new.
+// node based containers allocate one node at a time and get the slab path throughout
+template<class T>
+class slab_allocator
+{
+public:
+    using value_type      = T;
+    using is_always_equal = true_type;
+
+    slab_allocator () noexcept = default;
+
+    template<class U>
+    slab_allocator (const slab_allocator<U> &) noexcept
+    {
+    }
+
+    [[nodiscard]] T *allocate (size_t count)
+    {
+        if (count == 1)
+            return static_cast<T *>(detail::slab_pool_for<T>::allocate());
+        if (count > static_cast<size_t>(-1) / sizeof(T))
+            throw std::bad_array_new_length();
+        return detail::allocate_n<T>(count);
+    }
+
+    void deallocate (T *ptr, size_t count) noexcept
+    {
+        if (count == 1)
+            detail::slab_pool_for<T>::deallocate(ptr);
+        else
+            detail::deallocate_n(ptr, count);
+    }
+
+    template<class U>
+    friend bool operator== (const slab_allocator &, const slab_allocator<U> &) noexcept
+    {
+        return true;
+    }
+};
+
+#endif // DSTL_OBJECT_POOL_H
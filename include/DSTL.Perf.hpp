@@ -0,0 +1,261 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Perf.hpp
+
+Abstract:
+    Hardware Performance Counters.
+
+    perf_counter counts user space cycles, instructions, cache misses and
+    branch misses of the calling thread through Linux perf_event_open.
+    Where that is unavailable (other systems, containers, a restrictive
+    perf_event_paranoid, or a cpu without a cycles event) it falls back to
+    the time stamp counter for cycles and reports the other events and the
+    instructions per cycle as unavailable. When the kernel multiplexes the
+    counters among more events than the cpu has, the counts are scaled by
+    the share of time the group was counting; a group that was never
+    scheduled is reported as unavailable for that sample.
+
+--*/
+
+#ifndef DSTL_PERF_H
+#define DSTL_PERF_H
+
+// counts accumulated between start and stop
+struct perf_sample
+{
+    uint64_t cycles_        = 0;
+    uint64_t instructions_  = 0;
+    uint64_t cache_misses_  = 0;
+    uint64_t branch_misses_ = 0;
+    uint64_t nanoseconds_   = 0;
+
+    // false when cycles_ is read from the time stamp counter and the other events were not counted
+    bool hardware_ = false;
+
+    // instructions per cycle, 0 unless cycles_ counts hardware cycles
+    double ipc () const noexcept
+    {
+        return hardware_ && cycles_ != 0 ? static_cast<double>(instructions_) / static_cast<double>(cycles_) : 0.0;
+    }
+
+    perf_sample &operator+= (const perf_sample &other) noexcept
+    {
+        cycles_ += other.cycles_;
+        instructions_ += other.instructions_;
+        cache_misses_ += other.cache_misses_;
+        branch_misses_ += other.branch_misses_;
+        nanoseconds_ += other.nanoseconds_;
+        hardware_ = hardware_ || other.hardware_;
+        return *this;
+    }
+};
+
+namespace detail
+{
+    inline uint64_t read_cycle_counter () noexcept
+    {
+#if defined(DSTL_RDTSC)
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+}
+
+class perf_counter
+{
+public:
+    enum event : unsigned
+    {
+        cycles,
+        instructions,
+        cache_misses,
+        branch_misses,
+        event_count
+    };
+
+    perf_counter () noexcept { open(); }
+
+    perf_counter (const perf_counter &)            = delete;
+    perf_counter &operator= (const perf_counter &) = delete;
+
+    ~perf_counter () { close(); }
+
+    // whether the hardware events are counted, otherwise cycles come from the time stamp counter
+    bool hardware () const noexcept { return leader_ != -1; }
+
+    // whether a single event is counted, not every cpu exposes all of them
+    bool available (event e) const noexcept { return slot_[e] != -1; }
+
+    void start () noexcept
+    {
+#if defined(DSTL_PERF_EVENT)
+        if (leader_ != -1)
+            ::ioctl(leader_, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        start_ns_  = now_ns();
+        start_tsc_ = detail::read_cycle_counter();
+    }
+
+    void stop () noexcept
+    {
+        const uint64_t tsc = detail::read_cycle_counter();
+        const uint64_t ns  = now_ns();
+#if defined(DSTL_PERF_EVENT)
+        if (leader_ != -1)
+            ::ioctl(leader_, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+#endif
+        tsc_ += tsc - start_tsc_;
+        ns_ += ns - start_ns_;
+    }
+
+    // zeroes the counts, must not be called between start and stop
+    void reset () noexcept
+    {
+#if defined(DSTL_PERF_EVENT)
+        if (leader_ != -1)
+        {
+            ::ioctl(leader_, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            // the reset leaves the enabled and running times alone, they count from here
+            group_read group{};
+            if (::read(leader_, &group, sizeof(group)) > 0)
+            {
+                enabled_base_ = group.enabled_;
+                running_base_ = group.running_;
+            }
+        }
+#endif
+        tsc_ = 0;
+        ns_  = 0;
+    }
+
+    // counts accumulated since construction or the last reset
+    perf_sample read () const noexcept
+    {
+        perf_sample sample;
+        sample.nanoseconds_ = ns_;
+        sample.cycles_      = tsc_;
+
+#if defined(DSTL_PERF_EVENT)
+        group_read group{};
+        if (leader_ != -1 && ::read(leader_, &group, sizeof(group)) > 0)
+        {
+            // with more events than counter registers the kernel multiplexes them, and the group
+            // counts only while it is scheduled. its counts are scaled up to the time it was
+            // enabled, and a group that never ran reports no hardware events
+            const uint64_t enabled = group.enabled_ - enabled_base_;
+            const uint64_t running = group.running_ - running_base_;
+            if (running != 0)
+            {
+                const double scale = running < enabled ? static_cast<double>(enabled) / static_cast<double>(running) : 1.0;
+                uint64_t *counts[event_count] = {&sample.cycles_, &sample.instructions_, &sample.cache_misses_, &sample.branch_misses_};
+                for (unsigned e = 0; e < event_count; ++e)
+                {
+                    if (slot_[e] != -1 && static_cast<uint64_t>(slot_[e]) < group.count_)
+                        *counts[e] = static_cast<uint64_t>(static_cast<double>(group.values_[slot_[e]]) * scale);
+                }
+                sample.hardware_ = true;
+            }
+        }
+#endif
+        return sample;
+    }
+
+private:
+#if defined(DSTL_PERF_EVENT)
+    // what a read of the group leader returns: the number of events, the nanoseconds the
+    // group was enabled and running, then one value per event in open order
+    struct group_read
+    {
+        uint64_t count_;
+        uint64_t enabled_;
+        uint64_t running_;
+        uint64_t values_[event_count];
+    };
+#endif
+
+    static uint64_t now_ns () noexcept
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void open () noexcept
+    {
+#if defined(DSTL_PERF_EVENT)
+        constexpr uint64_t configs[event_count] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES,
+        };
+
+        int opened = 0;
+        for (unsigned e = 0; e < event_count; ++e)
+        {
+            perf_event_attr attr{};
+            attr.size           = sizeof(attr);
+            attr.type           = PERF_TYPE_HARDWARE;
+            attr.config         = configs[e];
+            attr.disabled       = leader_ == -1;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv     = 1;
+            attr.read_format    = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+
+            const int fd = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, leader_, 0));
+            // without hardware cycles the instructions per cycle would divide by time stamp
+            // counter ticks, so the group is only opened with the cycles event as its leader
+            if (fd == -1 && e == cycles)
+                break;
+            if (fd == -1)
+                continue;
+            if (leader_ == -1)
+                leader_ = fd;
+            fds_[opened] = fd;
+            slot_[e]     = opened++;
+        }
+#endif
+    }
+
+    void close () noexcept
+    {
+#if defined(DSTL_PERF_EVENT)
+        // members first, the leader owns the group
+        for (int i = event_count; i-- > 0;)
+        {
+            if (fds_[i] != -1)
+                ::close(fds_[i]);
+        }
+#endif
+    }
+
+    int leader_                = -1;
+    int fds_[event_count]      = {-1, -1, -1, -1};
+    int slot_[event_count]     = {-1, -1, -1, -1};
+    uint64_t start_ns_         = 0;
+    uint64_t start_tsc_        = 0;
+    uint64_t ns_               = 0;
+    uint64_t tsc_              = 0;
+    uint64_t enabled_base_     = 0;
+    uint64_t running_base_     = 0;
+};
+
+// counts the enclosing scope on a perf_counter
+class perf_scope
+{
+public:
+    explicit perf_scope (perf_counter &counter) noexcept : counter_(counter) { counter_.start(); }
+
+    perf_scope (const perf_scope &)            = delete;
+    perf_scope &operator= (const perf_scope &) = delete;
+
+    ~perf_scope () { counter_.stop(); }
+
+private:
+    perf_counter &counter_;
+};
+
+#endif // DSTL_PERF_H
@@ -0,0 +1,509 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.SmallVector.hpp
+
+Abstract:
+    Small Vector.
+
+    Dynamic contiguous array that keeps up to N elements inline and spills
+    to the heap beyond that. Size and capacity are 32 bits wide, so the
+    header is a pointer and two counters: small_vector<int, 8> takes 48
+    bytes and fits one cache line. Inline elements of trivially copyable
+    types are copied, moved and swapped as one fixed size memcpy of the
+    inline buffer.
+
+--*/
+
+#ifndef DSTL_SMALL_VECTOR_H
+#define DSTL_SMALL_VECTOR_H
+
+// dynamic contiguous array with inline storage for N elements
+template<class T, size_t N>
+class small_vector
+{
+    static_assert(N > 0, "small_vector needs room for at least one inline element");
+
+public:
+    using value_type             = T;
+    using size_type              = size_t;
+    using difference_type        = ptrdiff_t;
+    using reference              = T &;
+    using const_reference        = const T &;
+    using pointer                = T *;
+    using const_pointer          = const T *;
+    using iterator               = T *;
+    using const_iterator         = const T *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+    static constexpr size_type inline_capacity = N;
+
+private:
+    static_assert(N <= static_cast<uint32_t>(-1), "small_vector inline capacity exceeds the 32 bit size");
+
+    T *data_           = inline_data();
+    uint32_t size_     = 0;
+    uint32_t capacity_ = static_cast<uint32_t>(N);
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+
+    // a whole inline buffer of trivially copyable elements is copied at once up to this size
+    static constexpr bool copy_whole_buffer = is_trivially_copyable_v<T> && N * sizeof(T) <= 256;
+
+    // moving inline elements relocates them
+    static constexpr bool nothrow_move = is_trivially_relocatable_v<T> || noexcept(T(declval<T>()));
+
+public:
+    small_vector () noexcept {}
+
+    explicit small_vector (size_type count)
+    {
+        resize(count);
+    }
+
+    small_vector (size_type count, const T &value)
+    {
+        insert(end(), count, value);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    small_vector (InputIt first, InputIt last)
+    {
+        insert(end(), first, last);
+    }
+
+    small_vector (std::initializer_list<T> init)
+    {
+        insert(end(), init.begin(), init.end());
+    }
+
+    small_vector (const small_vector &other)
+    {
+        copy_from(other);
+    }
+
+    small_vector (small_vector &&other) noexcept(nothrow_move)
+    {
+        steal(other);
+    }
+
+    ~small_vector ()
+    {
+        release();
+    }
+
+    small_vector &operator= (const small_vector &other)
+    {
+        if (this != &other)
+        {
+            clear();
+            copy_from(other);
+        }
+        return *this;
+    }
+
+    small_vector &operator= (small_vector &&other) noexcept(nothrow_move)
+    {
+        if (this != &other)
+        {
+            release();
+            steal(other);
+        }
+        return *this;
+    }
+
+    small_vector &operator= (std::initializer_list<T> init)
+    {
+        clear();
+        insert(end(), init.begin(), init.end());
+        return *this;
+    }
+
+    //
+    // element access
+    //
+
+    reference at (size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::small_vector::at");
+        return data_[pos];
+    }
+
+    const_reference at (size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::small_vector::at");
+        return data_[pos];
+    }
+
+    reference operator[] (size_type pos) noexcept { return data_[pos]; }
+    const_reference operator[] (size_type pos) const noexcept { return data_[pos]; }
+
+    reference front () noexcept { return *data_; }
+    const_reference front () const noexcept { return *data_; }
+    reference back () noexcept { return data_[size_ - 1]; }
+    const_reference back () const noexcept { return data_[size_ - 1]; }
+
+    T *data () noexcept { return data_; }
+    const T *data () const noexcept { return data_; }
+
+    //
+    // iterators
+    //
+
+    iterator begin () noexcept { return data_; }
+    const_iterator begin () const noexcept { return data_; }
+    const_iterator cbegin () const noexcept { return data_; }
+    iterator end () noexcept { return data_ + size_; }
+    const_iterator end () const noexcept { return data_ + size_; }
+    const_iterator cend () const noexcept { return data_ + size_; }
+
+    reverse_iterator rbegin () noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin () const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend () noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend () const noexcept { return const_reverse_iterator(begin()); }
+
+    //
+    // capacity
+    //
+
+    [[nodiscard]] bool empty () const noexcept { return size_ == 0; }
+    [[nodiscard]] size_type size () const noexcept { return size_; }
+    [[nodiscard]] size_type capacity () const noexcept { return capacity_; }
+    [[nodiscard]] bool is_inline () const noexcept { return data_ == inline_data(); }
+
+    [[nodiscard]] static constexpr size_type max_size () noexcept
+    {
+        return static_cast<size_type>(-1) / sizeof(T) < static_cast<uint32_t>(-1) ? static_cast<size_type>(-1) / sizeof(T)
+                                                                                     : static_cast<uint32_t>(-1);
+    }
+
+    void reserve (size_type new_cap)
+    {
+        // the capacity is kept in 32 bits
+        if (new_cap > max_size())
+            throw std::length_error("dstl::small_vector");
+        if (new_cap > capacity())
+            reallocate(new_cap);
+    }
+
+    // moves the elements back inline when they fit, otherwise trims the heap storage
+    void shrink_to_fit ()
+    {
+        if (!is_inline() && size_ != capacity_)
+            reallocate(size_);
+    }
+
+    //
+    // modifiers
+    //
+
+    void clear () noexcept
+    {
+        dstl::destroy(data_, data_ + size_);
+        size_ = 0;
+    }
+
+    template<class... Args>
+    reference emplace_back (Args &&...args)
+    {
+        if (size_ == capacity_)
+        {
+            // constructed first, args may refer to an element
+            T tmp(std::forward<Args>(args)...);
+            reallocate(recommend(size() + 1));
+            ::new (static_cast<void *>(data_ + size_)) T(std::move(tmp));
+        }
+        else
+        {
+            ::new (static_cast<void *>(data_ + size_)) T(std::forward<Args>(args)...);
+        }
+        return data_[size_++];
+    }
+
+    void push_back (const T &value) { emplace_back(value); }
+    void push_back (T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back () noexcept
+    {
+        --size_;
+        dstl::destroy_at(data_ + size_);
+    }
+
+    template<class... Args>
+    iterator emplace (const_iterator pos, Args &&...args)
+    {
+        const size_type offset = static_cast<size_type>(pos - data_);
+        if (offset == size_)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return data_ + offset;
+        }
+
+        T tmp(std::forward<Args>(args)...);
+        return insert_n(offset, 1, [&tmp] (T *dest) { ::new (static_cast<void *>(dest)) T(std::move(tmp)); });
+    }
+
+    iterator insert (const_iterator pos, const T &value) { return emplace(pos, value); }
+    iterator insert (const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+    iterator insert (const_iterator pos, size_type count, const T &value)
+    {
+        const T tmp(value);
+        return insert_n(static_cast<size_type>(pos - data_), count, [&tmp] (T *dest) { ::new (static_cast<void *>(dest)) T(tmp); });
+    }
+
+    // the range must not refer to elements of this small_vector
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    iterator insert (const_iterator pos, InputIt first, InputIt last)
+    {
+        const size_type offset = static_cast<size_type>(pos - data_);
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            return insert_n(offset, count, [&first] (T *dest) { ::new (static_cast<void *>(dest)) T(*first++); });
+        }
+        else
+        {
+            for (size_type cur = offset; first != last; ++first, ++cur)
+                emplace(data_ + cur, *first);
+            return data_ + offset;
+        }
+    }
+
+    iterator insert (const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase (const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase (const_iterator first, const_iterator last)
+    {
+        T *f = const_cast<T *>(first);
+        T *l = const_cast<T *>(last);
+        if (f == l)
+            return f;
+
+        T *old_end = data_ + size_;
+        T *new_end;
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::destroy(f, l);
+            new_end = dstl::relocate(l, old_end, f);
+        }
+        else
+        {
+            new_end = std::move(l, old_end, f);
+            dstl::destroy(new_end, old_end);
+        }
+        size_ = static_cast<uint32_t>(new_end - data_);
+        return f;
+    }
+
+    void resize (size_type count)
+    {
+        if (count <= size())
+        {
+            erase(data_ + count, end());
+            return;
+        }
+        if (count > capacity())
+            reallocate(recommend(count));
+        for (; size_ != count; ++size_)
+            ::new (static_cast<void *>(data_ + size_)) T();
+    }
+
+    void resize (size_type count, const T &value)
+    {
+        if (count <= size())
+            erase(data_ + count, end());
+        else
+            insert(end(), count - size(), value);
+    }
+
+    void swap (small_vector &other) noexcept(nothrow_move)
+    {
+        if (this == &other)
+            return;
+
+        if (!is_inline() && !other.is_inline())
+        {
+            std::swap(data_, other.data_);
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+        }
+        else if constexpr (copy_whole_buffer)
+        {
+            unsigned char tmp[sizeof(storage_)];
+            std::memcpy(tmp, storage_, sizeof(storage_));
+            std::memcpy(storage_, other.storage_, sizeof(storage_));
+            std::memcpy(other.storage_, tmp, sizeof(storage_));
+
+            T *heap       = is_inline() ? nullptr : data_;
+            T *other_heap = other.is_inline() ? nullptr : other.data_;
+            data_         = other_heap != nullptr ? other_heap : inline_data();
+            other.data_   = heap != nullptr ? heap : other.inline_data();
+            std::swap(size_, other.size_);
+            std::swap(capacity_, other.capacity_);
+        }
+        else
+        {
+            small_vector tmp(std::move(other));
+            other = std::move(*this);
+            *this = std::move(tmp);
+        }
+    }
+
+    friend void swap (small_vector &lhs, small_vector &rhs) noexcept(noexcept(lhs.swap(rhs))) { lhs.swap(rhs); }
+
+    friend bool operator== (const small_vector &lhs, const small_vector &rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin(), lhs.end(), rhs.begin());
+    }
+
+private:
+    T *inline_data () noexcept { return reinterpret_cast<T *>(storage_); }
+    const T *inline_data () const noexcept { return reinterpret_cast<const T *>(storage_); }
+
+    // growth policy: at least double the current capacity
+    [[nodiscard]] size_type recommend (size_type new_size) const
+    {
+        if (new_size > max_size())
+            throw std::length_error("dstl::small_vector");
+        const size_type cap = capacity();
+        if (cap >= max_size() / 2)
+            return max_size();
+        return cap * 2 > new_size ? cap * 2 : new_size;
+    }
+
+    // destroys the elements and returns to the empty inline state
+    void release () noexcept
+    {
+        dstl::destroy(data_, data_ + size_);
+        if (!is_inline())
+            detail::deallocate_n(data_, capacity_);
+        data_     = inline_data();
+        size_     = 0;
+        capacity_ = static_cast<uint32_t>(N);
+    }
+
+    // copies into an empty small_vector
+    void copy_from (const small_vector &other)
+    {
+        if (other.size_ > capacity_)
+            reallocate(other.size_);
+        if constexpr (copy_whole_buffer)
+        {
+            if (is_inline())
+            {
+                std::memcpy(storage_, other.data_, other.is_inline() ? sizeof(storage_) : other.size_ * sizeof(T));
+                size_ = other.size_;
+                return;
+            }
+        }
+        detail::copy_construct_range(other.data_, other.data_ + other.size_, data_);
+        size_ = other.size_;
+    }
+
+    // moves from other into an empty inline small_vector, leaving other empty
+    void steal (small_vector &other) noexcept(nothrow_move)
+    {
+        if (!other.is_inline())
+        {
+            data_           = other.data_;
+            size_           = other.size_;
+            capacity_       = other.capacity_;
+            other.data_     = other.inline_data();
+            other.size_     = 0;
+            other.capacity_ = static_cast<uint32_t>(N);
+            return;
+        }
+
+        if constexpr (copy_whole_buffer)
+            std::memcpy(storage_, other.storage_, sizeof(storage_));
+        else
+            dstl::uninitialized_relocate(other.data_, other.data_ + other.size_, data_);
+        size_       = other.size_;
+        other.size_ = 0;
+    }
+
+    // moves the elements into storage for new_cap elements, inline when they fit
+    void reallocate (size_type new_cap)
+    {
+        if (new_cap <= N)
+        {
+            if (is_inline())
+                return;
+            T *heap = data_;
+            dstl::uninitialized_relocate(heap, heap + size_, inline_data());
+            detail::deallocate_n(heap, capacity_);
+            data_     = inline_data();
+            capacity_ = static_cast<uint32_t>(N);
+            return;
+        }
+
+        T *new_data = detail::allocate_n<T>(new_cap);
+        try
+        {
+            dstl::uninitialized_relocate(data_, data_ + size_, new_data);
+        }
+        catch (...)
+        {
+            detail::deallocate_n(new_data, new_cap);
+            throw;
+        }
+        if (!is_inline())
+            detail::deallocate_n(data_, capacity_);
+        data_     = new_data;
+        capacity_ = static_cast<uint32_t>(new_cap);
+    }
+
+    // opens a gap of count elements at offset and fills it through construct(dest)
+    template<class Construct>
+    T *insert_n (size_type offset, size_type count, Construct construct)
+    {
+        if (count == 0)
+            return data_ + offset;
+        if (count > capacity() - size())
+            reallocate(recommend(size() + count));
+
+        T *pos = data_ + offset;
+        T *end = data_ + size_;
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::relocate(pos, end, pos + count);
+            T *cur = pos;
+            try
+            {
+                for (; cur != pos + count; ++cur)
+                    construct(cur);
+            }
+            catch (...)
+            {
+                // close the gap again
+                dstl::destroy(pos, cur);
+                dstl::relocate(pos + count, end + count, pos);
+                throw;
+            }
+            size_ += static_cast<uint32_t>(count);
+        }
+        else
+        {
+            // append then rotate into place to keep the sequence valid if a constructor throws
+            for (size_type i = 0; i < count; ++i, ++size_)
+                construct(data_ + size_);
+            std::rotate(pos, end, data_ + size_);
+        }
+        return pos;
+    }
+};
+
+#endif // DSTL_SMALL_VECTOR_H
@@ -0,0 +1,963 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.String.hpp
+
+Abstract:
+    String.
+
+    basic_string takes three words. A short string keeps its characters
+    in those words, up to 23 chars (11 char16_t, 5 char32_t), and stores
+    the room it has left in their last character, which makes that
+    character the terminator of a full inline string. A long string
+    points to its characters and marks the highest bit of the last byte,
+    which the count of a short string never sets. Copying a short string
+    copies the three words.
+
+    Growing never fills the new characters, resize_and_overwrite hands
+    them to the caller to write. With the standard character traits find,
+    find_first_of and compare of wide characters run on the vector kernels
+    of DSTL.Algorithm.hpp; the SSE4.2 string instructions are slower than
+    comparing a vector and taking its mask on current processors. Single
+    byte characters are compared with memcmp, which is faster still.
+
+    basic_string_view is std::basic_string_view with a substring find that
+    takes linear time. Needles up to 32 characters are compared in full
+    only where both their first and their last character occur, which a
+    vector of positions is tested for at once. Longer needles, and every
+    needle under other traits, run the two-way algorithm of Crochemore
+    and Perrin, which shifts by the period of the needle after a match of
+    its right part and so never compares a character of the text more
+    than twice; the same filter skips the positions it cannot match at.
+    basic_searcher factors a needle once for many searches.
+
+--*/
+
+#ifndef DSTL_STRING_H
+#define DSTL_STRING_H
+
+namespace detail
+{
+    // the standard traits compare characters as the numbers they are, which the vector kernels do
+    template<class CharT, class Traits>
+    inline constexpr bool is_simd_traits_v = is_same_v<Traits, std::char_traits<CharT>>;
+
+    // needles up to this length are compared in full wherever their first and last characters
+    // occur, which bounds the work per position of the text; longer ones run the two-way algorithm
+    inline constexpr size_t two_way_threshold = 32;
+
+    template<class Traits, class CharT>
+    const CharT *find_char (const CharT *first, const CharT *last, CharT ch) noexcept
+    {
+        if constexpr (is_simd_traits_v<CharT, Traits>)
+            return simd_find(first, last, ch);
+        else
+        {
+            const CharT *found = Traits::find(first, static_cast<size_t>(last - first), ch);
+            return found != nullptr ? found : last;
+        }
+    }
+
+    // critical factorization of a needle into needle[0, suffix_) and needle[suffix_, m). the
+    // needle is periodic_ when its left part recurs period_ characters later, after a match the
+    // search then shifts by period_ and remembers the characters known to match. otherwise
+    // period_ is a shift that cannot skip an occurrence
+    struct two_way_factorization
+    {
+        size_t suffix_ = 0;
+        size_t period_ = 0;
+        bool periodic_ = false;
+    };
+
+    // start and period of the lexicographically greatest suffix of x, under Traits::lt or under
+    // its reverse
+    template<class Traits, bool Reverse, class CharT>
+    std::pair<size_t, size_t> maximal_suffix (const CharT *x, size_t m) noexcept
+    {
+        // start is one before the suffix, starting at -1 as an empty prefix
+        size_t start  = static_cast<size_t>(-1);
+        size_t j      = 0;
+        size_t k      = 1;
+        size_t period = 1;
+        while (j + k < m)
+        {
+            const CharT a = x[j + k];
+            const CharT b = x[start + k];
+            if (Traits::eq(a, b))
+            {
+                if (k != period)
+                    ++k;
+                else
+                {
+                    j += period;
+                    k = 1;
+                }
+            }
+            else if (Reverse ? Traits::lt(b, a) : Traits::lt(a, b))
+            {
+                j += k;
+                k      = 1;
+                period = j - start;
+            }
+            else
+            {
+                start = j++;
+                k = period = 1;
+            }
+        }
+        return {start + 1, period};
+    }
+
+    template<class Traits, class CharT>
+    two_way_factorization factorize (const CharT *x, size_t m) noexcept
+    {
+        // the later of the two maximal suffixes is a critical position
+        const auto forward  = maximal_suffix<Traits, false>(x, m);
+        const auto backward = maximal_suffix<Traits, true>(x, m);
+        const auto critical = backward.first < forward.first ? forward : backward;
+
+        two_way_factorization f;
+        f.suffix_   = critical.first;
+        f.period_   = critical.second;
+        f.periodic_ = Traits::compare(x, x + f.period_, f.suffix_) == 0;
+        if (!f.periodic_)
+            f.period_ = (f.suffix_ > m - f.suffix_ ? f.suffix_ : m - f.suffix_) + 1;
+        return f;
+    }
+
+    // the first position of the m characters at x in the n at text, n when they do not occur.
+    // 0 < m <= n
+    template<class Traits, class CharT>
+    size_t two_way_search (const CharT *text, size_t n, const CharT *x, size_t m, const two_way_factorization &f) noexcept
+    {
+        const size_t last = n - m;
+        size_t j          = 0;
+        // the characters of the left part known to match at j
+        size_t memory = 0;
+        while (j <= last)
+        {
+            if constexpr (is_simd_traits_v<CharT, Traits>)
+            {
+                if (memory == 0)
+                {
+                    j += simd_find_pair(text + j, last - j + 1, x[0], x[m - 1], m - 1);
+                    if (j > last)
+                        break;
+                }
+            }
+
+            // the right part from its start, then the left part from its end
+            size_t i = f.suffix_ > memory ? f.suffix_ : memory;
+            while (i < m && Traits::eq(x[i], text[i + j]))
+                ++i;
+            if (i < m)
+            {
+                j += i - f.suffix_ + 1;
+                memory = 0;
+                continue;
+            }
+            i = f.suffix_;
+            while (i > memory && Traits::eq(x[i - 1], text[i - 1 + j]))
+                --i;
+            if (i <= memory)
+                return j;
+            j += f.period_;
+            memory = f.periodic_ ? m - f.period_ : 0;
+        }
+        return n;
+    }
+
+    // the first position of the m characters at x in the n at text, n when they do not occur
+    template<class Traits, class CharT>
+    size_t string_search (const CharT *text, size_t n, const CharT *x, size_t m, const two_way_factorization *f = nullptr) noexcept
+    {
+        if (m > n)
+            return n;
+        if (m == 0)
+            return 0;
+        if constexpr (is_simd_traits_v<CharT, Traits>)
+        {
+            if (m <= two_way_threshold)
+            {
+                const size_t starts = n - m + 1;
+                for (size_t j = 0;; ++j)
+                {
+                    j += simd_find_pair(text + j, starts - j, x[0], x[m - 1], m - 1);
+                    if (j == starts)
+                        return n;
+                    if (m <= 2 || simd_mismatch(text + j + 1, x + 1, m - 2) == m - 2)
+                        return j;
+                }
+            }
+        }
+        return f != nullptr ? two_way_search<Traits>(text, n, x, m, *f) : two_way_search<Traits>(text, n, x, m, factorize<Traits>(x, m));
+    }
+}
+
+// std::basic_string_view with a substring find in linear time
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_string_view : public std::basic_string_view<CharT, Traits>
+{
+    using base = std::basic_string_view<CharT, Traits>;
+
+public:
+    using typename base::size_type;
+    using base::npos;
+
+    using base::base;
+
+    constexpr basic_string_view (base s) noexcept : base(s) {}
+
+    size_type find (base s, size_type pos = 0) const noexcept
+    {
+        const size_type n = this->size();
+        if (pos > n)
+            return npos;
+        const size_type found = detail::string_search<Traits>(this->data() + pos, n - pos, s.data(), s.size());
+        return found != n - pos || s.empty() ? pos + found : npos;
+    }
+
+    size_type find (CharT ch, size_type pos = 0) const noexcept
+    {
+        const size_type n = this->size();
+        if (pos >= n)
+            return npos;
+        const CharT *p     = this->data();
+        const CharT *found = detail::find_char<Traits>(p + pos, p + n, ch);
+        return found != p + n ? static_cast<size_type>(found - p) : npos;
+    }
+
+    size_type find (const CharT *s, size_type pos, size_type count) const noexcept { return find(base(s, count), pos); }
+    size_type find (const CharT *s, size_type pos = 0) const noexcept { return find(base(s), pos); }
+
+    [[nodiscard]] bool contains (base s) const noexcept { return find(s) != npos; }
+    [[nodiscard]] bool contains (CharT ch) const noexcept { return find(ch) != npos; }
+    [[nodiscard]] bool contains (const CharT *s) const noexcept { return find(base(s)) != npos; }
+
+    constexpr basic_string_view substr (size_type pos = 0, size_type count = npos) const { return base::substr(pos, count); }
+};
+
+using string_view    = basic_string_view<char>;
+using wstring_view   = basic_string_view<wchar_t>;
+using u8string_view  = basic_string_view<char8_t>;
+using u16string_view = basic_string_view<char16_t>;
+using u32string_view = basic_string_view<char32_t>;
+
+// a needle factored once for any number of searches. like std::boyer_moore_searcher it refers
+// to the characters of the needle, which must outlive it
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_searcher
+{
+public:
+    using view_type = std::basic_string_view<CharT, Traits>;
+
+    static constexpr size_t npos = view_type::npos;
+
+    explicit basic_searcher (view_type needle) noexcept : needle_(needle)
+    {
+        if (!needle.empty())
+            factorization_ = detail::factorize<Traits>(needle.data(), needle.size());
+    }
+
+    // the first position of the needle in text from pos on, npos when it does not occur
+    size_t find (view_type text, size_t pos = 0) const noexcept
+    {
+        const size_t n = text.size();
+        if (pos > n)
+            return npos;
+        const size_t found = detail::string_search<Traits>(text.data() + pos, n - pos, needle_.data(), needle_.size(), &factorization_);
+        return found != n - pos || needle_.empty() ? pos + found : npos;
+    }
+
+    // the range of the first occurrence in [first, last), [last, last) when there is none, for std::search
+    template<class It, class = enable_if_t<std::contiguous_iterator<It>>>
+    std::pair<It, It> operator() (It first, It last) const noexcept
+    {
+        const size_t n     = static_cast<size_t>(last - first);
+        const size_t found = detail::string_search<Traits>(std::to_address(first), n, needle_.data(), needle_.size(), &factorization_);
+        if (found == n && !needle_.empty())
+            return {last, last};
+        return {first + found, first + found + needle_.size()};
+    }
+
+    view_type needle () const noexcept { return needle_; }
+
+private:
+    view_type needle_;
+    detail::two_way_factorization factorization_;
+};
+
+using searcher = basic_searcher<char>;
+
+// string of a character type with a 24 byte footprint (on 64 bit targets) and inline storage
+template<class CharT, class Traits = std::char_traits<CharT>>
+class basic_string
+{
+    static_assert(is_any_of_v<CharT, char, char8_t, char16_t, char32_t, wchar_t>, "basic_string holds character types");
+
+public:
+    using traits_type            = Traits;
+    using value_type             = CharT;
+    using size_type              = size_t;
+    using difference_type        = ptrdiff_t;
+    using reference              = CharT &;
+    using const_reference        = const CharT &;
+    using pointer                = CharT *;
+    using const_pointer          = const CharT *;
+    using iterator               = CharT *;
+    using const_iterator         = const CharT *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+    using view_type              = std::basic_string_view<CharT, Traits>;
+
+    static constexpr size_type npos = static_cast<size_type>(-1);
+
+private:
+    struct heap
+    {
+        CharT *data_;
+        size_t size_;
+        // the capacity with the heap mark, see encode
+        size_t capacity_;
+    };
+
+    union storage
+    {
+        heap heap_;
+        CharT inline_[sizeof(heap) / sizeof(CharT)];
+    };
+
+    static constexpr size_type inline_capacity = sizeof(heap) / sizeof(CharT) - 1;
+
+    // the bit of the last byte that tells a long string from a short one
+    static constexpr unsigned char heap_bit = 0x80;
+    static constexpr size_t heap_mark = std::endian::native == std::endian::little ? size_t(heap_bit) << (8 * (sizeof(size_t) - 1)) : heap_bit;
+
+    static constexpr bool simd_traits = detail::is_simd_traits_v<CharT, Traits>;
+
+    // memcmp, which the standard traits compare single byte characters with, is faster than the
+    // mismatch kernel; wider characters are compared one at a time by the standard traits
+    static constexpr bool simd_compare = simd_traits && sizeof(CharT) > 1;
+
+    storage storage_;
+
+public:
+    basic_string () noexcept { set_inline_size(0); }
+
+    basic_string (const CharT *s, size_type count)
+    {
+        set_inline_size(0);
+        assign(s, count);
+    }
+
+    basic_string (const CharT *s) : basic_string(s, Traits::length(s)) {}
+
+    basic_string (size_type count, CharT ch)
+    {
+        set_inline_size(0);
+        append(count, ch);
+    }
+
+    explicit basic_string (view_type s) : basic_string(s.data(), s.size()) {}
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    basic_string (InputIt first, InputIt last)
+    {
+        set_inline_size(0);
+        append(first, last);
+    }
+
+    basic_string (std::initializer_list<CharT> init) : basic_string(init.begin(), init.size()) {}
+
+    basic_string (const basic_string &other)
+    {
+        if (!other.is_heap())
+            storage_ = other.storage_;
+        else
+        {
+            set_inline_size(0);
+            assign(other.data(), other.size());
+        }
+    }
+
+    basic_string (basic_string &&other) noexcept : storage_(other.storage_) { other.set_inline_size(0); }
+
+    ~basic_string () { release(); }
+
+    basic_string &operator= (const basic_string &other)
+    {
+        if (this != &other)
+        {
+            if (!is_heap() && !other.is_heap())
+                storage_ = other.storage_;
+            else
+                assign(other.data(), other.size());
+        }
+        return *this;
+    }
+
+    basic_string &operator= (basic_string &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            storage_ = other.storage_;
+            other.set_inline_size(0);
+        }
+        return *this;
+    }
+
+    basic_string &operator= (view_type s) { return assign(s.data(), s.size()); }
+    basic_string &operator= (const CharT *s) { return assign(s, Traits::length(s)); }
+
+    basic_string &operator= (CharT ch)
+    {
+        clear();
+        push_back(ch);
+        return *this;
+    }
+
+    basic_string &assign (const CharT *s, size_type count)
+    {
+        if (count > capacity())
+        {
+            // s may point into the old characters, which stay until the new ones are copied
+            const size_type new_cap = recommend(count);
+            CharT *p                = allocate(new_cap);
+            Traits::copy(p, s, count);
+            adopt(p, count, new_cap);
+        }
+        else
+        {
+            Traits::move(data(), s, count);
+            set_size(count);
+        }
+        return *this;
+    }
+
+    basic_string &assign (view_type s) { return assign(s.data(), s.size()); }
+
+    basic_string &assign (size_type count, CharT ch)
+    {
+        clear();
+        return append(count, ch);
+    }
+
+    operator view_type () const noexcept { return view_type(data(), size()); }
+    operator basic_string_view<CharT, Traits> () const noexcept { return basic_string_view<CharT, Traits>(data(), size()); }
+
+    //
+    // element access
+    //
+
+    reference at (size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::basic_string::at");
+        return data()[pos];
+    }
+
+    const_reference at (size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::basic_string::at");
+        return data()[pos];
+    }
+
+    reference operator[] (size_type pos) noexcept { return data()[pos]; }
+    const_reference operator[] (size_type pos) const noexcept { return data()[pos]; }
+
+    reference front () noexcept { return data()[0]; }
+    const_reference front () const noexcept { return data()[0]; }
+    reference back () noexcept { return data()[size() - 1]; }
+    const_reference back () const noexcept { return data()[size() - 1]; }
+
+    CharT *data () noexcept { return is_heap() ? storage_.heap_.data_ : storage_.inline_; }
+    const CharT *data () const noexcept { return is_heap() ? storage_.heap_.data_ : storage_.inline_; }
+    const CharT *c_str () const noexcept { return data(); }
+
+    //
+    // iterators
+    //
+
+    iterator begin () noexcept { return data(); }
+    const_iterator begin () const noexcept { return data(); }
+    const_iterator cbegin () const noexcept { return data(); }
+    iterator end () noexcept { return data() + size(); }
+    const_iterator end () const noexcept { return data() + size(); }
+    const_iterator cend () const noexcept { return end(); }
+
+    reverse_iterator rbegin () noexcept { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin () const noexcept { return const_reverse_iterator(end()); }
+    reverse_iterator rend () noexcept { return reverse_iterator(begin()); }
+    const_reverse_iterator rend () const noexcept { return const_reverse_iterator(begin()); }
+
+    //
+    // capacity
+    //
+
+    [[nodiscard]] bool empty () const noexcept { return size() == 0; }
+
+    [[nodiscard]] size_type size () const noexcept
+    {
+        return is_heap() ? storage_.heap_.size_ : inline_capacity - static_cast<size_type>(storage_.inline_[inline_capacity]);
+    }
+
+    [[nodiscard]] size_type length () const noexcept { return size(); }
+
+    [[nodiscard]] size_type capacity () const noexcept
+    {
+        return is_heap() ? decode(storage_.heap_.capacity_) : inline_capacity;
+    }
+
+    // capacities are kept below the heap mark
+    [[nodiscard]] static constexpr size_type max_size () noexcept { return (static_cast<size_type>(-1) >> 8) / sizeof(CharT) - 1; }
+
+    void reserve (size_type new_cap)
+    {
+        if (new_cap > max_size())
+            throw std::length_error("dstl::basic_string");
+        if (new_cap > capacity())
+            reallocate(new_cap);
+    }
+
+    void shrink_to_fit ()
+    {
+        if (!is_heap())
+            return;
+        const size_type n = size();
+        if (n <= inline_capacity)
+        {
+            CharT *p           = storage_.heap_.data_;
+            const size_type cap = capacity();
+            Traits::copy(storage_.inline_, p, n);
+            set_inline_size(n);
+            detail::deallocate_n(p, cap + 1);
+        }
+        else if (n < capacity())
+            reallocate(n);
+    }
+
+    //
+    // modifiers
+    //
+
+    void clear () noexcept { set_size(0); }
+
+    void push_back (CharT ch)
+    {
+        const size_type n = size();
+        if (n == capacity())
+            reallocate(recommend(n + 1));
+        Traits::assign(data()[n], ch);
+        set_size(n + 1);
+    }
+
+    void pop_back () noexcept { set_size(size() - 1); }
+
+    basic_string &append (const CharT *s, size_type count)
+    {
+        const size_type n = size();
+        if (count > capacity() - n)
+        {
+            if (count > max_size() - n)
+                throw std::length_error("dstl::basic_string");
+            // s may point into the old characters, which stay until the new ones are copied
+            const size_type new_cap = recommend(n + count);
+            CharT *p                = allocate(new_cap);
+            Traits::copy(p, data(), n);
+            Traits::copy(p + n, s, count);
+            adopt(p, n + count, new_cap);
+        }
+        else
+        {
+            Traits::copy(data() + n, s, count);
+            set_size(n + count);
+        }
+        return *this;
+    }
+
+    basic_string &append (view_type s) { return append(s.data(), s.size()); }
+    basic_string &append (const CharT *s) { return append(s, Traits::length(s)); }
+
+    basic_string &append (size_type count, CharT ch)
+    {
+        const size_type n = size();
+        if (count > capacity() - n)
+        {
+            if (count > max_size() - n)
+                throw std::length_error("dstl::basic_string");
+            reallocate(recommend(n + count));
+        }
+        Traits::assign(data() + n, count, ch);
+        set_size(n + count);
+        return *this;
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    basic_string &append (InputIt first, InputIt last)
+    {
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            const size_type n = size();
+            if (count > capacity() - n)
+            {
+                if (count > max_size() - n)
+                    throw std::length_error("dstl::basic_string");
+                reallocate(recommend(n + count));
+            }
+            CharT *p = data() + n;
+            for (; first != last; ++first, ++p)
+                Traits::assign(*p, static_cast<CharT>(*first));
+            set_size(n + count);
+        }
+        else
+            for (; first != last; ++first)
+                push_back(static_cast<CharT>(*first));
+        return *this;
+    }
+
+    basic_string &operator+= (view_type s) { return append(s.data(), s.size()); }
+    basic_string &operator+= (const CharT *s) { return append(s, Traits::length(s)); }
+
+    basic_string &operator+= (CharT ch)
+    {
+        push_back(ch);
+        return *this;
+    }
+
+    basic_string &insert (size_type pos, const CharT *s, size_type count)
+    {
+        const size_type n = size();
+        if (pos > n)
+            throw std::out_of_range("dstl::basic_string::insert");
+        if (count > capacity() - n)
+        {
+            if (count > max_size() - n)
+                throw std::length_error("dstl::basic_string");
+            const size_type new_cap = recommend(n + count);
+            CharT *p                = allocate(new_cap);
+            const CharT *old        = data();
+            Traits::copy(p, old, pos);
+            Traits::copy(p + pos, s, count);
+            Traits::copy(p + pos + count, old + pos, n - pos);
+            adopt(p, n + count, new_cap);
+            return *this;
+        }
+
+        CharT *p = data();
+        // s may point into the characters that move
+        if (s >= p + pos && s < p + n)
+            s += count;
+        else if (s < p + pos && s + count > p + pos)
+        {
+            // straddles the insertion point: copy it out of the way first
+            const basic_string tmp(s, count);
+            return insert(pos, tmp.data(), count);
+        }
+        Traits::move(p + pos + count, p + pos, n - pos);
+        Traits::copy(p + pos, s, count);
+        set_size(n + count);
+        return *this;
+    }
+
+    basic_string &insert (size_type pos, view_type s) { return insert(pos, s.data(), s.size()); }
+    basic_string &insert (size_type pos, const CharT *s) { return insert(pos, s, Traits::length(s)); }
+
+    basic_string &erase (size_type pos = 0, size_type count = npos)
+    {
+        const size_type n = size();
+        if (pos > n)
+            throw std::out_of_range("dstl::basic_string::erase");
+        count = count < n - pos ? count : n - pos;
+        CharT *p = data();
+        Traits::move(p + pos, p + pos + count, n - pos - count);
+        set_size(n - count);
+        return *this;
+    }
+
+    iterator erase (const_iterator pos) noexcept { return erase(pos, pos + 1); }
+
+    iterator erase (const_iterator first, const_iterator last) noexcept
+    {
+        CharT *p                = data();
+        const size_type from    = static_cast<size_type>(first - p);
+        const size_type count   = static_cast<size_type>(last - first);
+        const size_type n       = size();
+        Traits::move(p + from, p + from + count, n - from - count);
+        set_size(n - count);
+        return p + from;
+    }
+
+    void resize (size_type count) { resize(count, CharT()); }
+
+    void resize (size_type count, CharT ch)
+    {
+        const size_type n = size();
+        if (count <= n)
+            set_size(count);
+        else
+            append(count - n, ch);
+    }
+
+    // grows the string to count characters without filling them and lets op(data(), count)
+    // write them, its result is the new size
+    template<class Operation>
+    void resize_and_overwrite (size_type count, Operation op)
+    {
+        if (count > capacity())
+            reallocate(recommend(count));
+        const auto new_size = std::move(op)(data(), count);
+        set_size(static_cast<size_type>(new_size));
+    }
+
+    void swap (basic_string &other) noexcept { std::swap(storage_, other.storage_); }
+
+    friend void swap (basic_string &lhs, basic_string &rhs) noexcept { lhs.swap(rhs); }
+
+    //
+    // search
+    //
+
+    size_type find (CharT ch, size_type pos = 0) const noexcept
+    {
+        const size_type n = size();
+        if (pos >= n)
+            return npos;
+        const CharT *p     = data();
+        const CharT *found = detail::find_char<Traits>(p + pos, p + n, ch);
+        return found != p + n ? static_cast<size_type>(found - p) : npos;
+    }
+
+    size_type find (view_type s, size_type pos = 0) const noexcept
+    {
+        const size_type n = size();
+        const size_type m = s.size();
+        if (pos > n || m > n - pos)
+            return npos;
+        if (m == 0)
+            return pos;
+        const size_type found = detail::string_search<Traits>(data() + pos, n - pos, s.data(), m);
+        return found != n - pos ? pos + found : npos;
+    }
+
+    size_type find (const CharT *s, size_type pos = 0) const noexcept { return find(view_type(s), pos); }
+
+    size_type rfind (view_type s, size_type pos = npos) const noexcept { return view_type(*this).rfind(s, pos); }
+    size_type rfind (CharT ch, size_type pos = npos) const noexcept { return view_type(*this).rfind(ch, pos); }
+
+    size_type find_first_of (view_type s, size_type pos = 0) const noexcept
+    {
+        const size_type n = size();
+        if (pos >= n || s.empty())
+            return npos;
+        const CharT *p = data();
+        if constexpr (simd_traits)
+        {
+            const CharT *found = nullptr;
+            if (s.size() <= detail::simd_find_any_limit)
+                found = detail::simd_find_any(p + pos, p + n, s.data(), s.size());
+            else if constexpr (sizeof(CharT) == 1)
+            {
+                // a table of the characters of s
+                bool in_set[256] = {};
+                for (CharT ch : s)
+                    in_set[static_cast<unsigned char>(ch)] = true;
+                found = p + pos;
+                while (found != p + n && !in_set[static_cast<unsigned char>(*found)])
+                    ++found;
+            }
+            else
+                return view_type(*this).find_first_of(s, pos);
+            return found != p + n ? static_cast<size_type>(found - p) : npos;
+        }
+        else
+            return view_type(*this).find_first_of(s, pos);
+    }
+
+    size_type find_first_of (CharT ch, size_type pos = 0) const noexcept { return find(ch, pos); }
+
+    size_type find_first_not_of (view_type s, size_type pos = 0) const noexcept { return view_type(*this).find_first_not_of(s, pos); }
+    size_type find_last_of (view_type s, size_type pos = npos) const noexcept { return view_type(*this).find_last_of(s, pos); }
+    size_type find_last_not_of (view_type s, size_type pos = npos) const noexcept { return view_type(*this).find_last_not_of(s, pos); }
+
+    [[nodiscard]] bool contains (view_type s) const noexcept { return find(s) != npos; }
+    [[nodiscard]] bool contains (CharT ch) const noexcept { return find(ch) != npos; }
+
+    [[nodiscard]] bool starts_with (view_type s) const noexcept
+    {
+        return s.size() <= size() && Traits::compare(data(), s.data(), s.size()) == 0;
+    }
+
+    [[nodiscard]] bool ends_with (view_type s) const noexcept
+    {
+        return s.size() <= size() && Traits::compare(data() + size() - s.size(), s.data(), s.size()) == 0;
+    }
+
+    basic_string substr (size_type pos = 0, size_type count = npos) const
+    {
+        const size_type n = size();
+        if (pos > n)
+            throw std::out_of_range("dstl::basic_string::substr");
+        return basic_string(data() + pos, count < n - pos ? count : n - pos);
+    }
+
+    //
+    // comparison
+    //
+
+    int compare (view_type s) const noexcept
+    {
+        const size_type n = size();
+        const size_type m = s.size();
+        const size_type common = n < m ? n : m;
+        if constexpr (simd_compare)
+        {
+            const size_type i = detail::simd_mismatch(data(), s.data(), common);
+            if (i != common)
+                return Traits::lt(data()[i], s[i]) ? -1 : 1;
+        }
+        else if (const int result = Traits::compare(data(), s.data(), common))
+            return result;
+        return n < m ? -1 : n > m ? 1 : 0;
+    }
+
+    friend bool operator== (const basic_string &lhs, const basic_string &rhs) noexcept { return lhs.equals(rhs); }
+    friend bool operator== (const basic_string &lhs, view_type rhs) noexcept { return lhs.equals(rhs); }
+    friend bool operator== (const basic_string &lhs, const CharT *rhs) noexcept { return lhs.equals(rhs); }
+
+    friend std::strong_ordering operator<=> (const basic_string &lhs, const basic_string &rhs) noexcept { return lhs.compare(rhs) <=> 0; }
+    friend std::strong_ordering operator<=> (const basic_string &lhs, view_type rhs) noexcept { return lhs.compare(rhs) <=> 0; }
+    friend std::strong_ordering operator<=> (const basic_string &lhs, const CharT *rhs) noexcept { return lhs.compare(rhs) <=> 0; }
+
+    friend basic_string operator+ (const basic_string &lhs, const basic_string &rhs) { return concat(lhs, rhs); }
+    friend basic_string operator+ (const basic_string &lhs, view_type rhs) { return concat(lhs, rhs); }
+    friend basic_string operator+ (view_type lhs, const basic_string &rhs) { return concat(lhs, rhs); }
+
+    friend basic_string operator+ (basic_string &&lhs, view_type rhs)
+    {
+        lhs.append(rhs.data(), rhs.size());
+        return std::move(lhs);
+    }
+
+private:
+    bool is_heap () const noexcept
+    {
+        return (reinterpret_cast<const unsigned char *>(&storage_)[sizeof(heap) - 1] & heap_bit) != 0;
+    }
+
+    static constexpr size_t encode (size_type capacity) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+            return capacity | heap_mark;
+        else
+            return capacity << 8 | heap_mark;
+    }
+
+    static constexpr size_type decode (size_t field) noexcept
+    {
+        if constexpr (std::endian::native == std::endian::little)
+            return field & ~heap_mark;
+        else
+            return field >> 8;
+    }
+
+    void set_inline_size (size_type n) noexcept
+    {
+        Traits::assign(storage_.inline_[n], CharT());
+        storage_.inline_[inline_capacity] = static_cast<CharT>(inline_capacity - n);
+    }
+
+    // sets the size of a string whose capacity holds n characters, and terminates it
+    void set_size (size_type n) noexcept
+    {
+        if (is_heap())
+        {
+            storage_.heap_.size_ = n;
+            Traits::assign(storage_.heap_.data_[n], CharT());
+        }
+        else
+            set_inline_size(n);
+    }
+
+    // growth policy: at least double the current capacity
+    [[nodiscard]] size_type recommend (size_type new_size) const
+    {
+        if (new_size > max_size())
+            throw std::length_error("dstl::basic_string");
+        const size_type cap = capacity();
+        if (cap >= max_size() / 2)
+            return max_size();
+        return cap * 2 > new_size ? cap * 2 : new_size;
+    }
+
+    // room for capacity characters and the terminator
+    static CharT *allocate (size_type capacity) { return detail::allocate_n<CharT>(capacity + 1); }
+
+    void release () noexcept
+    {
+        if (is_heap())
+            detail::deallocate_n(storage_.heap_.data_, capacity() + 1);
+    }
+
+    // takes over p, which holds size characters and has room for capacity of them
+    void adopt (CharT *p, size_type size, size_type capacity) noexcept
+    {
+        release();
+        storage_.heap_ = heap{p, size, encode(capacity)};
+        Traits::assign(p[size], CharT());
+    }
+
+    void reallocate (size_type new_cap)
+    {
+        const size_type n = size();
+        CharT *p          = allocate(new_cap);
+        Traits::copy(p, data(), n);
+        adopt(p, n, new_cap);
+    }
+
+    bool equals (view_type s) const noexcept
+    {
+        const size_type n = size();
+        if (n != s.size())
+            return false;
+        if constexpr (simd_compare)
+            return detail::simd_mismatch(data(), s.data(), n) == n;
+        else
+            return Traits::compare(data(), s.data(), n) == 0;
+    }
+
+    static basic_string concat (view_type lhs, view_type rhs)
+    {
+        basic_string result;
+        result.resize_and_overwrite(lhs.size() + rhs.size(), [&] (CharT *p, size_type count) {
+            Traits::copy(p, lhs.data(), lhs.size());
+            Traits::copy(p + lhs.size(), rhs.data(), rhs.size());
+            return count;
+        });
+        return result;
+    }
+};
+
+using string    = basic_string<char>;
+using wstring   = basic_string<wchar_t>;
+using u8string  = basic_string<char8_t>;
+using u16string = basic_string<char16_t>;
+using u32string = basic_string<char32_t>;
+
+template<class CharT, class Traits>
+struct hash<basic_string<CharT, Traits>> : detail::string_hash<CharT, Traits> {};
+
+template<class CharT, class Traits>
+struct hash<basic_string_view<CharT, Traits>> : detail::string_hash<CharT, Traits> {};
+
+// neither the inline chars nor the heap pointer refer to the string itself, so a vector of
+// strings grows with a memcpy instead of moving them one by one
+template<class CharT, class Traits>
+struct is_trivially_relocatable<basic_string<CharT, Traits>> : true_type {};
+
+#endif // DSTL_STRING_H
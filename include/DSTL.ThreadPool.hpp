@@ -0,0 +1,524 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.ThreadPool.hpp
+
+Abstract:
+    Work Stealing Thread Pool.
+
+    Every worker owns a Chase-Lev deque: it pushes and pops jobs at the
+    bottom without locking, while other threads steal from the top with a
+    single compare and swap. Threads outside the pool submit through a
+    shared injection queue. A worker that runs dry steals from victims
+    picked at random, spins for a few rounds and then parks on an event
+    count, which submitters only signal when some worker is parked.
+
+    Jobs hold their callable in a small buffer, and submit takes the job
+    and the state shared with its future from the slab pools, so small
+    callables reach a worker without touching the heap. A thread that
+    waits for a future runs pending jobs in the meantime.
+
+--*/
+
+#ifndef DSTL_THREAD_POOL_H
+#define DSTL_THREAD_POOL_H
+
+class thread_pool;
+
+namespace detail
+{
+    // the callable of a job. submit wraps a callable with a pointer to its future state, so one
+    // of up to five pointers stays in place
+    using task = move_only_function<void(), 6 * sizeof(void *)>;
+
+    // a job in a deque or the injection queue, which must not throw
+    struct pool_job
+    {
+        task fn_;
+        pool_job *next_ = nullptr;
+
+        // returned to the slab pool after it ran, otherwise its owner keeps it alive until then
+        bool pooled_ = false;
+    };
+
+    // the Chase-Lev work stealing deque of one worker. only the owner pushes and pops, any thread steals
+    class work_deque
+    {
+    public:
+        static constexpr int64_t initial_capacity = 256;
+
+        work_deque () : ring_(new ring(initial_capacity, nullptr)) {}
+
+        work_deque (const work_deque &)            = delete;
+        work_deque &operator= (const work_deque &) = delete;
+
+        ~work_deque ()
+        {
+            for (ring *r = ring_.load(std::memory_order_relaxed); r != nullptr;)
+            {
+                ring *retired = r->retired_;
+                delete r;
+                r = retired;
+            }
+        }
+
+        void push (pool_job *job)
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed);
+            const int64_t t = top_.load(std::memory_order_acquire);
+            ring *r         = ring_.load(std::memory_order_relaxed);
+            if (b - t > r->mask_)
+                r = grow(r, t, b);
+            r->at(b).store(job, std::memory_order_relaxed);
+
+            // seq_cst rather than release, so that a worker about to park either sees the job or is seen by wake
+            bottom_.store(b + 1, std::memory_order_seq_cst);
+        }
+
+        pool_job *pop () noexcept
+        {
+            const int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+            ring *r         = ring_.load(std::memory_order_relaxed);
+            bottom_.store(b, std::memory_order_seq_cst);
+            int64_t t = top_.load(std::memory_order_seq_cst);
+            if (t > b)
+            {
+                bottom_.store(b + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            pool_job *job = r->at(b).load(std::memory_order_relaxed);
+            if (t == b)
+            {
+                // the last job, which a thief may be taking as well
+                if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                    job = nullptr;
+                bottom_.store(b + 1, std::memory_order_relaxed);
+            }
+            return job;
+        }
+
+        // takes the oldest job. contended is set when another thread took it first and the deque may still hold more
+        pool_job *steal (bool &contended) noexcept
+        {
+            int64_t t       = top_.load(std::memory_order_seq_cst);
+            const int64_t b = bottom_.load(std::memory_order_seq_cst);
+            if (t >= b)
+                return nullptr;
+
+            pool_job *job = ring_.load(std::memory_order_acquire)->at(t).load(std::memory_order_relaxed);
+            if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                contended = true;
+                return nullptr;
+            }
+            return job;
+        }
+
+        bool empty () const noexcept
+        {
+            return top_.load(std::memory_order_seq_cst) >= bottom_.load(std::memory_order_seq_cst);
+        }
+
+    private:
+        struct ring
+        {
+            ring (int64_t capacity, ring *retired) : mask_(capacity - 1), slots_(new std::atomic<pool_job *>[capacity]), retired_(retired) {}
+
+            ~ring () { delete[] slots_; }
+
+            std::atomic<pool_job *> &at (int64_t index) noexcept { return slots_[index & mask_]; }
+
+            int64_t mask_;
+            std::atomic<pool_job *> *slots_;
+
+            // the smaller rings this one replaced. thieves may still read them, so they live as long as the deque
+            ring *retired_;
+        };
+
+        ring *grow (ring *r, int64_t t, int64_t b)
+        {
+            ring *bigger = new ring((r->mask_ + 1) * 2, r);
+            for (int64_t i = t; i != b; ++i)
+                bigger->at(i).store(r->at(i).load(std::memory_order_relaxed), std::memory_order_relaxed);
+            ring_.store(bigger, std::memory_order_release);
+            return bigger;
+        }
+
+        alignas(cache_line_size) std::atomic<int64_t> top_{0};
+        alignas(cache_line_size) std::atomic<int64_t> bottom_{0};
+        alignas(cache_line_size) std::atomic<ring *> ring_;
+    };
+
+    // the result of a submitted job, shared by the job and its future
+    template<class R>
+    class future_state
+    {
+    public:
+        using value_type = conditional_t<is_void_v<R>, bool, R>;
+
+        explicit future_state (thread_pool *pool) noexcept : pool_(pool) {}
+
+        template<class Fn>
+        void run (Fn &fn) noexcept
+        {
+            try
+            {
+                if constexpr (is_void_v<R>)
+                    std::invoke(fn);
+                else
+                    ::new (static_cast<void *>(value_)) R(std::invoke(fn));
+            }
+            catch (...)
+            {
+                error_ = std::current_exception();
+            }
+            ready_.store(true, std::memory_order_release);
+            ready_.notify_all();
+            release();
+        }
+
+        bool ready () const noexcept { return ready_.load(std::memory_order_acquire); }
+
+        // runs pending jobs of the pool until the result is ready, blocks once there are none
+        void wait () const;
+
+        R get ()
+        {
+            wait();
+            if (error_)
+                std::rethrow_exception(error_);
+            if constexpr (!is_void_v<R>)
+                return std::move(*std::launder(reinterpret_cast<R *>(value_)));
+        }
+
+        void release () noexcept
+        {
+            if (refs_.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                return;
+            if constexpr (!is_void_v<R>)
+            {
+                if (!error_)
+                    dstl::destroy_at(std::launder(reinterpret_cast<R *>(value_)));
+            }
+            object_pool<future_state>().destroy(this);
+        }
+
+    private:
+        thread_pool *pool_;
+        std::atomic<uint32_t> refs_{2};
+        std::atomic<bool> ready_{false};
+        std::exception_ptr error_;
+        alignas(value_type) unsigned char value_[sizeof(value_type)];
+    };
+}
+
+// the result of a job submitted to a thread_pool
+template<class R>
+class future
+{
+public:
+    static_assert(!is_reference_v<R>, "future holds results by value");
+
+    future () noexcept = default;
+
+    explicit future (detail::future_state<R> *state) noexcept : state_(state) {}
+
+    future (future &&other) noexcept : state_(other.state_) { other.state_ = nullptr; }
+
+    future &operator= (future &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (state_ != nullptr)
+                state_->release();
+            state_       = other.state_;
+            other.state_ = nullptr;
+        }
+        return *this;
+    }
+
+    ~future ()
+    {
+        if (state_ != nullptr)
+            state_->release();
+    }
+
+    bool valid () const noexcept { return state_ != nullptr; }
+
+    bool ready () const noexcept { return state_->ready(); }
+
+    void wait () const { state_->wait(); }
+
+    // waits for the result and moves it out, rethrowing the exception of the job. the future is invalid afterwards
+    R get ()
+    {
+        detail::future_state<R> *state = state_;
+        state_                         = nullptr;
+        struct releaser
+        {
+            detail::future_state<R> *state_;
+            ~releaser () { state_->release(); }
+        } guard{state};
+        return state->get();
+    }
+
+private:
+    detail::future_state<R> *state_ = nullptr;
+};
+
+class thread_pool
+{
+public:
+    // the number of rounds a worker looks for jobs before it parks
+    static constexpr size_t spin_rounds = 64;
+
+    thread_pool () : thread_pool(std::thread::hardware_concurrency()) {}
+
+    // starts the given number of workers. a pool without workers runs its jobs on threads waiting for them
+    explicit thread_pool (size_t threads) : workers_(threads != 0 ? new worker[threads] : nullptr), worker_count_(threads)
+    {
+        for (size_t i = 0; i < worker_count_; ++i)
+        {
+            workers_[i].rng_    = 0x9E3779B97F4A7C15ULL * (i + 1);
+            workers_[i].thread_ = std::thread([this, i] { work(workers_[i]); });
+        }
+    }
+
+    thread_pool (const thread_pool &)            = delete;
+    thread_pool &operator= (const thread_pool &) = delete;
+
+    // runs the jobs still pending and joins the workers
+    ~thread_pool ()
+    {
+        stop_.store(true, std::memory_order_seq_cst);
+        epoch_.fetch_add(1, std::memory_order_release);
+        epoch_.notify_all();
+        for (size_t i = 0; i < worker_count_; ++i)
+            workers_[i].thread_.join();
+        while (run_pending_task())
+            ;
+        delete[] workers_;
+    }
+
+    size_t size () const noexcept { return worker_count_; }
+
+    // the number of threads that run jobs, counting one that waits for them
+    size_t concurrency () const noexcept { return worker_count_ + 1; }
+
+    // runs fn on a worker and returns the future of its result
+    template<class F, class = enable_if_t<is_invocable_v<decay_t<F> &>>>
+    future<invoke_result_t<decay_t<F> &>> submit (F &&fn)
+    {
+        using R    = invoke_result_t<decay_t<F> &>;
+        auto state = object_pool<detail::future_state<R>>().create(this);
+        future<R> result(state);
+        try
+        {
+            detail::task fn_task([state, fn = decay_t<F>(std::forward<F>(fn))] () mutable noexcept { state->run(fn); });
+            detail::pool_job *job = object_pool<detail::pool_job>().create();
+            job->fn_              = std::move(fn_task);
+            job->pooled_          = true;
+            enqueue(*job);
+        }
+        catch (...)
+        {
+            // the reference the job would have dropped
+            state->release();
+            throw;
+        }
+        return result;
+    }
+
+    // queues a job that the caller keeps alive until it ran, e.g. on the stack of a thread waiting for it
+    void enqueue (detail::pool_job &job)
+    {
+        if (local_pool_ == this)
+        {
+            local_worker_->deque_.push(&job);
+        }
+        else
+        {
+            std::lock_guard<std::mutex> lock(inject_mutex_);
+            job.next_ = nullptr;
+            if (inject_tail_ != nullptr)
+                inject_tail_->next_ = &job;
+            else
+                inject_head_ = &job;
+            inject_tail_ = &job;
+            injected_.fetch_add(1, std::memory_order_seq_cst);
+        }
+        wake();
+    }
+
+    // runs one pending job on the calling thread, returns false when none was found
+    bool run_pending_task ()
+    {
+        detail::pool_job *job = find_job(local_pool_ == this ? local_worker_ : nullptr);
+        if (job == nullptr)
+            return false;
+        run(job);
+        return true;
+    }
+
+private:
+    struct worker
+    {
+        detail::work_deque deque_;
+        std::thread thread_;
+        uint64_t rng_ = 0;
+    };
+
+    static void run (detail::pool_job *job) noexcept
+    {
+        // a job the caller owns may be gone as soon as it finished
+        const bool pooled = job->pooled_;
+        job->fn_();
+        if (pooled)
+            object_pool<detail::pool_job>().destroy(job);
+    }
+
+    detail::pool_job *take_injected () noexcept
+    {
+        if (injected_.load(std::memory_order_seq_cst) == 0)
+            return nullptr;
+        std::lock_guard<std::mutex> lock(inject_mutex_);
+        detail::pool_job *job = inject_head_;
+        if (job != nullptr)
+        {
+            inject_head_ = job->next_;
+            if (inject_head_ == nullptr)
+                inject_tail_ = nullptr;
+            injected_.fetch_sub(1, std::memory_order_relaxed);
+        }
+        return job;
+    }
+
+    // the own deque first, then the injection queue, then victims in random order
+    detail::pool_job *find_job (worker *self) noexcept
+    {
+        if (self != nullptr)
+        {
+            if (detail::pool_job *job = self->deque_.pop())
+                return job;
+        }
+        if (detail::pool_job *job = take_injected())
+            return job;
+        if (worker_count_ == 0)
+            return nullptr;
+
+        static thread_local uint64_t outside_rng = reinterpret_cast<uintptr_t>(&outside_rng) | 1;
+        uint64_t &rng = self != nullptr ? self->rng_ : outside_rng;
+        rng ^= rng << 13;
+        rng ^= rng >> 7;
+        rng ^= rng << 17;
+
+        const size_t start = static_cast<size_t>(rng % worker_count_);
+        for (size_t i = 0; i < worker_count_; ++i)
+        {
+            worker &victim = workers_[(start + i) % worker_count_];
+            if (&victim == self)
+                continue;
+            bool contended;
+            do
+            {
+                contended = false;
+                if (detail::pool_job *job = victim.deque_.steal(contended))
+                    return job;
+            } while (contended);
+        }
+        return nullptr;
+    }
+
+    bool has_work () const noexcept
+    {
+        if (injected_.load(std::memory_order_seq_cst) != 0)
+            return true;
+        for (size_t i = 0; i < worker_count_; ++i)
+        {
+            if (!workers_[i].deque_.empty())
+                return true;
+        }
+        return false;
+    }
+
+    // an event count: a parked worker waits for the epoch to move on, and submitters only
+    // move it when some worker is parked
+    void wake () noexcept
+    {
+        if (sleepers_.load(std::memory_order_seq_cst) != 0)
+        {
+            epoch_.fetch_add(1, std::memory_order_release);
+            epoch_.notify_one();
+        }
+    }
+
+    void park () noexcept
+    {
+        const uint32_t epoch = epoch_.load(std::memory_order_acquire);
+        sleepers_.fetch_add(1, std::memory_order_seq_cst);
+        if (!has_work() && !stop_.load(std::memory_order_seq_cst))
+            epoch_.wait(epoch, std::memory_order_acquire);
+        sleepers_.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void work (worker &self)
+    {
+        local_pool_   = this;
+        local_worker_ = &self;
+        for (;;)
+        {
+            detail::pool_job *job = nullptr;
+            for (size_t round = 0; round < spin_rounds && job == nullptr; ++round)
+            {
+                job = find_job(&self);
+                if (job == nullptr && round != 0)
+                    std::this_thread::yield();
+            }
+
+            if (job != nullptr)
+                run(job);
+            else if (stop_.load(std::memory_order_acquire))
+                return;
+            else
+                park();
+        }
+    }
+
+    static inline thread_local thread_pool *local_pool_ = nullptr;
+    static inline thread_local worker *local_worker_    = nullptr;
+
+    worker *workers_;
+    size_t worker_count_;
+
+    std::mutex inject_mutex_;
+    detail::pool_job *inject_head_ = nullptr;
+    detail::pool_job *inject_tail_ = nullptr;
+    alignas(detail::cache_line_size) std::atomic<size_t> injected_{0};
+
+    alignas(detail::cache_line_size) std::atomic<uint32_t> epoch_{0};
+    std::atomic<uint32_t> sleepers_{0};
+    std::atomic<bool> stop_{false};
+};
+
+template<class R>
+void detail::future_state<R>::wait () const
+{
+    while (!ready())
+    {
+        if (!pool_->run_pending_task())
+            ready_.wait(false, std::memory_order_acquire);
+    }
+}
+
+// the pool behind the parallel algorithms, one worker per hardware thread besides the calling one
+inline thread_pool &default_thread_pool ()
+{
+    static thread_pool *pool = new thread_pool(std::thread::hardware_concurrency() > 1 ? std::thread::hardware_concurrency() - 1 : 0);
+    return *pool;
+}
+
+#endif // DSTL_THREAD_POOL_H
@@ -14,6 +14,20 @@ Abstract:
 #ifndef DSTL_TYPETRAITS_H
 #define DSTL_TYPETRAITS_H
 
+//
+// compiler builtins
+//
+// traits use the GCC/Clang builtins when the compiler reports them and keep the
+// library implementation as the fallback. define DSTL_NO_TRAIT_BUILTINS to force
+// the fallback, e.g. to compare compile times.
+//
+
+#if defined(__has_builtin) && !defined(DSTL_NO_TRAIT_BUILTINS)
+#define DSTL_HAS_BUILTIN(x) __has_builtin(x)
+#else
+#define DSTL_HAS_BUILTIN(x) 0
+#endif
+
 template<class T, T Val>
 struct integral_constant
 {
@@ -112,6 +126,8 @@ template<class T> struct has_virtual_destructor;
 template<class T> struct has_unique_object_representations;
 template<class T, class U> struct reference_constructs_from_temporary;
 template<class T, class U> struct reference_converts_from_temporary;
+template<class T> struct is_trivially_relocatable;
+template<class T> struct is_bytewise_comparable;
 
 //
 // type property queries
@@ -119,7 +135,7 @@ template<class T, class U> struct reference_converts_from_temporary;
 
 template<class T> struct alignment_of;
 template<class T> struct rank;
-template<class T, unsigned I = 0> struct extent : integral_constant<size_t, 0> {};
+template<class T, unsigned I = 0> struct extent;
 
 //
 // type relations
@@ -148,9 +164,21 @@ template<class T> struct add_const;
 template<class T> struct add_volatile;
 template<class T> struct add_cv;
 
-template<class T> using remove_const_t    = typename remove_const<T>::type;
+#if DSTL_HAS_BUILTIN(__remove_const)
+template<class T> using remove_const_t = __remove_const(T);
+#else
+template<class T> using remove_const_t = typename remove_const<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__remove_volatile)
+template<class T> using remove_volatile_t = __remove_volatile(T);
+#else
 template<class T> using remove_volatile_t = typename remove_volatile<T>::type;
-template<class T> using remove_cv_t       = typename remove_cv<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__remove_cv)
+template<class T> using remove_cv_t = __remove_cv(T);
+#else
+template<class T> using remove_cv_t = typename remove_cv<T>::type;
+#endif
 template<class T> using add_const_t       = typename add_const<T>::type;
 template<class T> using add_volatile_t    = typename add_volatile<T>::type;
 template<class T> using add_cv_t          = typename add_cv<T>::type;
@@ -162,9 +190,23 @@ template<class T> struct remove_reference;
 template<class T> struct add_lvalue_reference;
 template<class T> struct add_rvalue_reference;
 
-template<class T> using remove_reference_t     = typename remove_reference<T>::type;
+#if DSTL_HAS_BUILTIN(__remove_reference_t)
+template<class T> using remove_reference_t = __remove_reference_t(T);
+#elif DSTL_HAS_BUILTIN(__remove_reference)
+template<class T> using remove_reference_t = __remove_reference(T);
+#else
+template<class T> using remove_reference_t = typename remove_reference<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__add_lvalue_reference)
+template<class T> using add_lvalue_reference_t = __add_lvalue_reference(T);
+#else
 template<class T> using add_lvalue_reference_t = typename add_lvalue_reference<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__add_rvalue_reference)
+template<class T> using add_rvalue_reference_t = __add_rvalue_reference(T);
+#else
 template<class T> using add_rvalue_reference_t = typename add_rvalue_reference<T>::type;
+#endif
 
 //
 // sign modifications
@@ -183,8 +225,16 @@ template<class T> using make_unsigned_t = typename make_unsigned<T>::type;
 template<class T> struct remove_extent;
 template<class T> struct remove_all_extents;
 
-template<class T> using remove_extent_t      = typename remove_extent<T>::type;
+#if DSTL_HAS_BUILTIN(__remove_extent)
+template<class T> using remove_extent_t = __remove_extent(T);
+#else
+template<class T> using remove_extent_t = typename remove_extent<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__remove_all_extents)
+template<class T> using remove_all_extents_t = __remove_all_extents(T);
+#else
 template<class T> using remove_all_extents_t = typename remove_all_extents<T>::type;
+#endif
 
 //
 // pointer modifications
@@ -193,8 +243,16 @@ template<class T> using remove_all_extents_t = typename remove_all_extents<T>::t
 template<class T> struct remove_pointer;
 template<class T> struct add_pointer;
 
+#if DSTL_HAS_BUILTIN(__remove_pointer)
+template<class T> using remove_pointer_t = __remove_pointer(T);
+#else
 template<class T> using remove_pointer_t = typename remove_pointer<T>::type;
-template<class T> using add_pointer_t    = typename add_pointer<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__add_pointer)
+template<class T> using add_pointer_t = __add_pointer(T);
+#else
+template<class T> using add_pointer_t = typename add_pointer<T>::type;
+#endif
 
 //
 // other transformations
@@ -214,10 +272,7 @@ template<class T> struct unwrap_reference;
 template<class T> struct unwrap_ref_decay;
 
 template<class T> using type_identity_t                     = typename type_identity<T>::type;
-template<class T> using remove_cvref_t                      = typename remove_cvref<T>::type;
-template<class T> using decay_t                             = typename decay<T>::type;
 template<bool B, class T = void> using enable_if_t          = typename enable_if<B, T>::type;
-template<bool B, class T, class F> using conditional_t      = typename conditional<B, T, F>::type;
 template<class... T> using common_type_t                    = typename common_type<T...>::type;
 template<class... T> using common_reference_t               = typename common_reference<T...>::type;
 template<class T> using underlying_type_t                   = typename underlying_type<T>::type;
@@ -226,6 +281,35 @@ template<class T> using unwrap_reference_t                  = typename unwrap_re
 template<class T> using unwrap_ref_decay_t                  = typename unwrap_ref_decay<T>::type;
 template<class...> using void_t                             = void;
 
+#if DSTL_HAS_BUILTIN(__remove_cvref)
+template<class T> using remove_cvref_t = __remove_cvref(T);
+#else
+template<class T> using remove_cvref_t = typename remove_cvref<T>::type;
+#endif
+#if DSTL_HAS_BUILTIN(__decay)
+template<class T> using decay_t = __decay(T);
+#else
+template<class T> using decay_t = typename decay<T>::type;
+#endif
+
+// selects through a member alias template, so every use shares one of two class instantiations
+namespace detail
+{
+    template<bool>
+    struct select
+    {
+        template<class T, class F> using type = T;
+    };
+
+    template<>
+    struct select<false>
+    {
+        template<class T, class F> using type = F;
+    };
+}
+
+template<bool B, class T, class F> using conditional_t = typename detail::select<B>::template type<T, F>;
+
 //
 // logical operator traits
 //
@@ -238,51 +322,139 @@ template<class B> struct negation;
 // primary type categories
 //
 
-template<class T> inline constexpr bool is_void_v                    = is_void<T>::value;
-template<class T> inline constexpr bool is_null_pointer_v            = is_null_pointer<T>::value;
-template<class T> inline constexpr bool is_integral_v                = is_integral<T>::value;
-template<class T> inline constexpr bool is_floating_point_v          = is_floating_point<T>::value;
-template<class T> inline constexpr bool is_array_v                   = is_array<T>::value;
-template<class T> inline constexpr bool is_pointer_v                 = is_pointer<T>::value;
-template<class T> inline constexpr bool is_lvalue_reference_v        = is_lvalue_reference<T>::value;
-template<class T> inline constexpr bool is_rvalue_reference_v        = is_rvalue_reference<T>::value;
-template<class T> inline constexpr bool is_member_object_pointer_v   = is_member_object_pointer<T>::value;
+#if DSTL_HAS_BUILTIN(__is_void)
+template<class T> inline constexpr bool is_void_v = __is_void(T);
+#else
+template<class T> inline constexpr bool is_void_v = is_void<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_nullptr)
+template<class T> inline constexpr bool is_null_pointer_v = __is_nullptr(T);
+#else
+template<class T> inline constexpr bool is_null_pointer_v = is_null_pointer<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_integral)
+template<class T> inline constexpr bool is_integral_v = __is_integral(T);
+#else
+template<class T> inline constexpr bool is_integral_v = is_integral<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_floating_point)
+template<class T> inline constexpr bool is_floating_point_v = __is_floating_point(T);
+#else
+template<class T> inline constexpr bool is_floating_point_v = is_floating_point<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_array)
+template<class T> inline constexpr bool is_array_v = __is_array(T);
+#else
+template<class T> inline constexpr bool is_array_v = is_array<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_pointer)
+template<class T> inline constexpr bool is_pointer_v = __is_pointer(T);
+#else
+template<class T> inline constexpr bool is_pointer_v = is_pointer<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_lvalue_reference)
+template<class T> inline constexpr bool is_lvalue_reference_v = __is_lvalue_reference(T);
+#else
+template<class T> inline constexpr bool is_lvalue_reference_v = is_lvalue_reference<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_rvalue_reference)
+template<class T> inline constexpr bool is_rvalue_reference_v = __is_rvalue_reference(T);
+#else
+template<class T> inline constexpr bool is_rvalue_reference_v = is_rvalue_reference<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_member_object_pointer)
+template<class T> inline constexpr bool is_member_object_pointer_v = __is_member_object_pointer(T);
+#else
+template<class T> inline constexpr bool is_member_object_pointer_v = is_member_object_pointer<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_member_function_pointer)
+template<class T> inline constexpr bool is_member_function_pointer_v = __is_member_function_pointer(T);
+#else
 template<class T> inline constexpr bool is_member_function_pointer_v = is_member_function_pointer<T>::value;
-template<class T> inline constexpr bool is_enum_v                    = is_enum<T>::value;
-template<class T> inline constexpr bool is_union_v                   = is_union<T>::value;
-template<class T> inline constexpr bool is_class_v                   = is_class<T>::value;
-template<class T> inline constexpr bool is_function_v                = is_function<T>::value;
+#endif
+template<class T> inline constexpr bool is_enum_v                    = __is_enum(T);
+template<class T> inline constexpr bool is_union_v                   = __is_union(T);
+template<class T> inline constexpr bool is_class_v                   = __is_class(T);
+#if DSTL_HAS_BUILTIN(__is_function)
+template<class T> inline constexpr bool is_function_v = __is_function(T);
+#else
+template<class T> inline constexpr bool is_function_v = is_function<T>::value;
+#endif
 
 //
 // composite type categories
 //
 
-template<class T> inline constexpr bool is_reference_v      = is_reference<T>::value;
-template<class T> inline constexpr bool is_arithmetic_v     = is_arithmetic<T>::value;
-template<class T> inline constexpr bool is_fundamental_v    = is_fundamental<T>::value;
-template<class T> inline constexpr bool is_scalar_v         = is_scalar<T>::value;
-template<class T> inline constexpr bool is_object_v         = is_object<T>::value;
-template<class T> inline constexpr bool is_compound_v       = is_compound<T>::value;
+#if DSTL_HAS_BUILTIN(__is_reference)
+template<class T> inline constexpr bool is_reference_v = __is_reference(T);
+#else
+template<class T> inline constexpr bool is_reference_v = is_reference<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_arithmetic)
+template<class T> inline constexpr bool is_arithmetic_v = __is_arithmetic(T);
+#else
+template<class T> inline constexpr bool is_arithmetic_v = is_arithmetic<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_fundamental)
+template<class T> inline constexpr bool is_fundamental_v = __is_fundamental(T);
+#else
+template<class T> inline constexpr bool is_fundamental_v = is_fundamental<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_scalar)
+template<class T> inline constexpr bool is_scalar_v = __is_scalar(T);
+#else
+template<class T> inline constexpr bool is_scalar_v = is_scalar<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_object)
+template<class T> inline constexpr bool is_object_v = __is_object(T);
+#else
+template<class T> inline constexpr bool is_object_v = is_object<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_compound)
+template<class T> inline constexpr bool is_compound_v = __is_compound(T);
+#else
+template<class T> inline constexpr bool is_compound_v = is_compound<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_member_pointer)
+template<class T> inline constexpr bool is_member_pointer_v = __is_member_pointer(T);
+#else
 template<class T> inline constexpr bool is_member_pointer_v = is_member_pointer<T>::value;
+#endif
 
 //
 // type properties
 //
 
-template<class T> inline constexpr bool is_const_v                                     = is_const<T>::value;
-template<class T> inline constexpr bool is_volatile_v                                  = is_volatile<T>::value;
-template<class T> inline constexpr bool is_trivial_v                                   = is_trivial<T>::value;
-template<class T> inline constexpr bool is_trivially_copyable_v                        = is_trivially_copyable<T>::value;
-template<class T> inline constexpr bool is_standard_layout_v                           = is_standard_layout<T>::value;
-template<class T> inline constexpr bool is_empty_v                                     = is_empty<T>::value;
-template<class T> inline constexpr bool is_polymorphic_v                               = is_polymorphic<T>::value;
-template<class T> inline constexpr bool is_abstract_v                                  = is_abstract<T>::value;
-template<class T> inline constexpr bool is_final_v                                     = is_final<T>::value;
-template<class T> inline constexpr bool is_aggregate_v                                 = is_aggregate<T>::value;
+#if DSTL_HAS_BUILTIN(__is_const)
+template<class T> inline constexpr bool is_const_v = __is_const(T);
+#else
+template<class T> inline constexpr bool is_const_v = is_const<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_volatile)
+template<class T> inline constexpr bool is_volatile_v = __is_volatile(T);
+#else
+template<class T> inline constexpr bool is_volatile_v = is_volatile<T>::value;
+#endif
+template<class T> inline constexpr bool is_trivial_v                                   = __is_trivial(T);
+template<class T> inline constexpr bool is_trivially_copyable_v                        = __is_trivially_copyable(T);
+template<class T> inline constexpr bool is_standard_layout_v                           = __is_standard_layout(T);
+template<class T> inline constexpr bool is_empty_v                                     = __is_empty(T);
+template<class T> inline constexpr bool is_polymorphic_v                               = __is_polymorphic(T);
+template<class T> inline constexpr bool is_abstract_v                                  = __is_abstract(T);
+template<class T> inline constexpr bool is_final_v                                     = __is_final(T);
+template<class T> inline constexpr bool is_aggregate_v                                 = __is_aggregate(T);
 template<class T> inline constexpr bool is_signed_v                                    = is_signed<T>::value;
 template<class T> inline constexpr bool is_unsigned_v                                  = is_unsigned<T>::value;
-template<class T> inline constexpr bool is_bounded_array_v                             = is_bounded_array<T>::value;
-template<class T> inline constexpr bool is_unbounded_array_v                           = is_unbounded_array<T>::value;
+#if DSTL_HAS_BUILTIN(__is_bounded_array)
+template<class T> inline constexpr bool is_bounded_array_v = __is_bounded_array(T);
+#else
+template<class T> inline constexpr bool is_bounded_array_v = is_bounded_array<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__is_unbounded_array)
+template<class T> inline constexpr bool is_unbounded_array_v = __is_unbounded_array(T);
+#else
+template<class T> inline constexpr bool is_unbounded_array_v = is_unbounded_array<T>::value;
+#endif
 template<class T> inline constexpr bool is_scoped_enum_v                               = is_scoped_enum<T>::value;
 template<class T, class... Args> inline constexpr bool is_constructible_v              = is_constructible<T, Args...>::value;
 template<class T> inline constexpr bool is_default_constructible_v                     = is_default_constructible<T>::value;
@@ -293,7 +465,11 @@ template<class T> inline constexpr bool is_copy_assignable_v
 template<class T> inline constexpr bool is_move_assignable_v                           = is_move_assignable<T>::value;
 template<class T, class U> inline constexpr bool is_swappable_with_v                   = is_swappable_with<T, U>::value;
 template<class T> inline constexpr bool is_swappable_v                                 = is_swappable<T>::value;
-template<class T> inline constexpr bool is_destructible_v                              = is_destructible<T>::value;
+#if DSTL_HAS_BUILTIN(__is_destructible)
+template<class T> inline constexpr bool is_destructible_v = __is_destructible(T);
+#else
+template<class T> inline constexpr bool is_destructible_v = is_destructible<T>::value;
+#endif
 template<class T, class... Args> inline constexpr bool is_trivially_constructible_v    = is_trivially_constructible<T, Args...>::value;
 template<class T> inline constexpr bool is_trivially_default_constructible_v           = is_trivially_default_constructible<T>::value;
 template<class T> inline constexpr bool is_trivially_copy_constructible_v              = is_trivially_copy_constructible<T>::value;
@@ -301,7 +477,11 @@ template<class T> inline constexpr bool is_trivially_move_constructible_v
 template<class T, class U> inline constexpr bool is_trivially_assignable_v             = is_trivially_assignable<T, U>::value;
 template<class T> inline constexpr bool is_trivially_copy_assignable_v                 = is_trivially_copy_assignable<T>::value;
 template<class T> inline constexpr bool is_trivially_move_assignable_v                 = is_trivially_move_assignable<T>::value;
-template<class T> inline constexpr bool is_trivially_destructible_v                    = is_trivially_destructible<T>::value;
+#if DSTL_HAS_BUILTIN(__is_trivially_destructible)
+template<class T> inline constexpr bool is_trivially_destructible_v = __is_trivially_destructible(T);
+#else
+template<class T> inline constexpr bool is_trivially_destructible_v = is_trivially_destructible<T>::value;
+#endif
 template<class T, class... Args> inline constexpr bool is_nothrow_constructible_v      = is_nothrow_constructible<T, Args...>::value;
 template<class T> inline constexpr bool is_nothrow_default_constructible_v             = is_nothrow_default_constructible<T>::value;
 template<class T> inline constexpr bool is_nothrow_copy_constructible_v                = is_nothrow_copy_constructible<T>::value;
@@ -316,21 +496,35 @@ template<class T> inline constexpr bool has_virtual_destructor_v
 template<class T> inline constexpr bool has_unique_object_representations_v            = has_unique_object_representations<T>::value;
 template<class T, class U> inline constexpr bool reference_constructs_from_temporary_v = reference_constructs_from_temporary<T, U>::value;
 template<class T, class U> inline constexpr bool reference_converts_from_temporary_v   = reference_converts_from_temporary<T, U>::value;
+template<class T> inline constexpr bool is_trivially_relocatable_v                     = is_trivially_relocatable<T>::value;
+template<class T> inline constexpr bool is_bytewise_comparable_v                       = is_bytewise_comparable<T>::value;
 
 //
 // type property queries
 //
 
 template<class T> inline constexpr size_t alignment_of_v           = alignment_of<T>::value;
-template<class T> inline constexpr size_t rank_v                   = rank<T>::value;
+#if DSTL_HAS_BUILTIN(__array_rank)
+template<class T> inline constexpr size_t rank_v = __array_rank(T);
+#else
+template<class T> inline constexpr size_t rank_v = rank<T>::value;
+#endif
+#if DSTL_HAS_BUILTIN(__array_extent)
+template<class T, unsigned I = 0> inline constexpr size_t extent_v = __array_extent(T, I);
+#else
 template<class T, unsigned I = 0> inline constexpr size_t extent_v = extent<T, I>::value;
+#endif
 
 //
 // type relations
 //
 
-template<class T, class U> inline constexpr bool is_same_v                                      = is_same<T, U>::value;
-template<class Base, class Derived> inline constexpr bool is_base_of_v                          = is_base_of<Base, Derived>::value;
+#if DSTL_HAS_BUILTIN(__is_same)
+template<class T, class U> inline constexpr bool is_same_v = __is_same(T, U);
+#else
+template<class T, class U> inline constexpr bool is_same_v = is_same<T, U>::value;
+#endif
+template<class Base, class Derived> inline constexpr bool is_base_of_v                          = __is_base_of(Base, Derived);
 template<class Base, class Derived> inline constexpr bool is_virtual_base_of_v                  = is_virtual_base_of<Base, Derived>::value;
 template<class From, class To> inline constexpr bool is_convertible_v                           = is_convertible<From, To>::value;
 template<class From, class To> inline constexpr bool is_nothrow_convertible_v                   = is_nothrow_convertible<From, To>::value;
@@ -342,7 +536,14 @@ template<class Fn, class... ArgTypes> inline constexpr bool is_nothrow_invocable
 template<class R, class Fn, class... ArgTypes> inline constexpr bool is_nothrow_invocable_r_v   = is_nothrow_invocable_r<R, Fn, ArgTypes...>::value;
 
 // check if T is in Types
+#if DSTL_HAS_BUILTIN(__is_same)
+template<class T, class... Types> constexpr bool is_any_of_v = (__is_same(T, Types) || ...);
+#else
 template<class T, class... Types> constexpr bool is_any_of_v = (is_same_v<T, Types> || ...);
+#endif
+
+// obtains a reference to its argument for use in unevaluated context
+template<class T> add_rvalue_reference_t<T> declval () noexcept;
 
 //
 // logical operator traits
@@ -355,20 +556,34 @@ template<class B> inline constexpr bool negation_v       = negation<B>::value;
 //
 // traits_type implement.
 //
+#if DSTL_HAS_BUILTIN(__is_void)
+template<class T>
+struct is_void : bool_constant<__is_void(T)> {};
+#else
 
 // checks if a type is void
 template<class T>
 struct is_void : is_same<void, remove_cv_t<T>> {};
+#endif
 
 // checks if a type is a base of the other type
 template<class B, class D>
 struct is_base_of : bool_constant<__is_base_of(B, D)> {};
 
 // checks if a type is nullptr_t
+#if DSTL_HAS_BUILTIN(__is_nullptr)
+template<class T>
+struct is_null_pointer : bool_constant<__is_nullptr(T)> {};
+#else
 template<class T>
 struct is_null_pointer : is_same<decltype(nullptr), remove_cv_t<T>> {};
+#endif
 
 // checks if a type is an integral type
+#if DSTL_HAS_BUILTIN(__is_integral)
+template<class T>
+struct is_integral : bool_constant<__is_integral(T)> {};
+#else
 template<class T>
 struct is_integral : bool_constant<
             is_any_of_v<remove_cv_t<T>, bool, char, signed char, unsigned char, wchar_t,
@@ -377,21 +592,58 @@ struct is_integral : bool_constant<
 #endif
                         char16_t, char32_t, short, unsigned short,
                         int, unsigned int, long, unsigned long, long long, unsigned long long>> {};
+#endif
 
 // checks if a type is a floating-point type
+#if DSTL_HAS_BUILTIN(__is_floating_point)
+template<class T>
+struct is_floating_point : bool_constant<__is_floating_point(T)> {};
+#else
 template<class T>
 struct is_floating_point : bool_constant<
             is_any_of_v<remove_cv_t<T>, float, double, long double>> {};
+#endif
 
 // checks if a type is an array type
+#if DSTL_HAS_BUILTIN(__is_array)
+template<class T>
+struct is_array : bool_constant<__is_array(T)> {};
+#else
 template<class T>
 struct is_array : false_type {};
 template<class T>
 struct is_array<T[]> : true_type {};
 template<class T, size_t N>
 struct is_array<T[N]> : true_type {};
+#endif
+
+// checks if a type is an array type of known bound
+#if DSTL_HAS_BUILTIN(__is_bounded_array)
+template<class T>
+struct is_bounded_array : bool_constant<__is_bounded_array(T)> {};
+#else
+template<class T>
+struct is_bounded_array : false_type {};
+template<class T, size_t N>
+struct is_bounded_array<T[N]> : true_type {};
+#endif
+
+// checks if a type is an array type of unknown bound
+#if DSTL_HAS_BUILTIN(__is_unbounded_array)
+template<class T>
+struct is_unbounded_array : bool_constant<__is_unbounded_array(T)> {};
+#else
+template<class T>
+struct is_unbounded_array : false_type {};
+template<class T>
+struct is_unbounded_array<T[]> : true_type {};
+#endif
 
 // checks if a type is a pointer type
+#if DSTL_HAS_BUILTIN(__is_pointer)
+template<class T>
+struct is_pointer : bool_constant<__is_pointer(T)> {};
+#else
 template<class T>
 struct is_pointer : false_type {};
 template<class T>
@@ -402,20 +654,36 @@ template<class T>
 struct is_pointer<T * volatile> : true_type {};
 template<class T>
 struct is_pointer<T * const volatile> : true_type {};
+#endif
 
 // checks if a type is a lvalue reference
+#if DSTL_HAS_BUILTIN(__is_lvalue_reference)
+template<class T>
+struct is_lvalue_reference : bool_constant<__is_lvalue_reference(T)> {};
+#else
 template<class T> struct is_lvalue_reference : false_type {};
 template<class T> struct is_lvalue_reference<T &> : true_type {};
+#endif
 
 // checks if a type is a rvalue reference
+#if DSTL_HAS_BUILTIN(__is_rvalue_reference)
+template<class T>
+struct is_rvalue_reference : bool_constant<__is_rvalue_reference(T)> {};
+#else
 template<class T> struct is_rvalue_reference : false_type {};
 template<class T> struct is_rvalue_reference<T &&> : true_type {};
+#endif
 
 // checks if a type is a pointer to a non-static member object
+#if DSTL_HAS_BUILTIN(__is_member_object_pointer)
+template<class T>
+struct is_member_object_pointer : bool_constant<__is_member_object_pointer(T)> {};
+#else
 template<class T>
 struct is_member_object_pointer : integral_constant<bool,
                                                     is_member_pointer_v<T> &&
                                                     !is_member_function_pointer_v<T>> {};
+#endif
 
 // checks if a type is an enumeration type
 template<class T>
@@ -430,12 +698,17 @@ template<class T>
 struct is_class : bool_constant<__is_class(T)> {};
 
 // checks if a type is a function type
+#if DSTL_HAS_BUILTIN(__is_function)
+template<class T>
+struct is_function : bool_constant<__is_function(T)> {};
+#else
 template<class T>
 struct is_function :
 #pragma warning(push)
 #pragma warning(disable : 4180)
         bool_constant<!is_const_v<const T> && !is_reference_v<T>> {};
 #pragma warning(pop)
+#endif
 
 // checks if a type is a pointer to a non-static member function
 namespace detail
@@ -446,46 +719,81 @@ namespace detail
     struct is_member_function_pointer_helper<T U::*> : is_function<T> {};
 }
 
+#if DSTL_HAS_BUILTIN(__is_member_function_pointer)
+template<class T>
+struct is_member_function_pointer : bool_constant<__is_member_function_pointer(T)> {};
+#else
 template<class T>
 struct is_member_function_pointer : detail::is_member_function_pointer_helper<typename remove_cv<T>::type> {};
+#endif
 
 // checks if a type is either a lvalue reference or rvalue reference
+#if DSTL_HAS_BUILTIN(__is_reference)
+template<class T>
+struct is_reference : bool_constant<__is_reference(T)> {};
+#else
 template<class T> struct is_reference : false_type {};
 template<class T> struct is_reference<T &> : true_type {};
 template<class T> struct is_reference<T &&> : true_type {};
+#endif
 
 // checks if a type is an arithmetic type
+#if DSTL_HAS_BUILTIN(__is_arithmetic)
+template<class T>
+struct is_arithmetic : bool_constant<__is_arithmetic(T)> {};
+#else
 template<class T>
 struct is_arithmetic : integral_constant<bool,
                                          is_integral_v<T> ||
                                          is_floating_point_v<T>> {};
+#endif
 
 // checks if a type is a fundamental type
+#if DSTL_HAS_BUILTIN(__is_fundamental)
+template<class T>
+struct is_fundamental : bool_constant<__is_fundamental(T)> {};
+#else
 template<class T>
 struct is_fundamental : integral_constant<bool,
                                           is_arithmetic_v<T> ||
                                           is_void_v<T> ||
                                           is_same<decltype(nullptr), remove_cv_t<T>>::value> {};
+#endif
 
 // checks if a type is a scalar type
+#if DSTL_HAS_BUILTIN(__is_scalar)
+template<class T>
+struct is_scalar : bool_constant<__is_scalar(T)> {};
+#else
 template<class T>
 struct is_scalar : integral_constant<bool, is_arithmetic<T>::value
                                            || is_enum<T>::value
                                            || is_pointer<T>::value
                                            || is_member_pointer<T>::value
                                            || is_null_pointer<T>::value> {};
+#endif
 
 // checks if a type is an object type
+#if DSTL_HAS_BUILTIN(__is_object)
+template<class T>
+struct is_object : bool_constant<__is_object(T)> {};
+#else
 template<class T>
 struct is_object : integral_constant<bool,
                                      is_scalar<T>::value ||
                                      is_array<T>::value ||
                                      is_union<T>::value ||
                                      is_class<T>::value> {};
+#endif
 
 // checks if a type is a compound type
+#if DSTL_HAS_BUILTIN(__is_compound)
+template<class T>
+struct is_compound : bool_constant<__is_compound(T)> {};
+#else
 template<class T>
 struct is_compound : integral_constant<bool, !is_fundamental<T>::value> {};
+#endif
 
 // checks if a type is a pointer to a non-static member function or object
 namespace detail
@@ -496,15 +804,30 @@ namespace detail
     struct is_member_pointer_helper<T U::*> : true_type {};
 }
 
+#if DSTL_HAS_BUILTIN(__is_member_pointer)
+template<class T>
+struct is_member_pointer : bool_constant<__is_member_pointer(T)> {};
+#else
 template<class T> struct is_member_pointer : detail::is_member_pointer_helper<remove_cv_t<T>> {};
+#endif
 
 // checks if a type is const-qualified
+#if DSTL_HAS_BUILTIN(__is_const)
+template<class T>
+struct is_const : bool_constant<__is_const(T)> {};
+#else
 template<class T> struct is_const : false_type {};
 template<class T> struct is_const<const T> : true_type {};
+#endif
 
 // checks if a type is volatile-qualified
+#if DSTL_HAS_BUILTIN(__is_volatile)
+template<class T>
+struct is_volatile : bool_constant<__is_volatile(T)> {};
+#else
 template<class T> struct is_volatile : false_type {};
 template<class T> struct is_volatile<volatile T> : true_type {};
+#endif
 
 // checks if a type is trivial
 template<class T>
@@ -538,16 +861,358 @@ struct is_final : bool_constant<__is_final(T)> {};
 template<class T>
 struct is_aggregate : bool_constant<__is_aggregate(T)> {};
 
+// checks if a type is a signed or an unsigned arithmetic type
+namespace detail
+{
+    template<class T, bool = is_arithmetic_v<T>>
+    struct is_signed_helper
+    {
+        static constexpr bool is_signed   = false;
+        static constexpr bool is_unsigned = false;
+    };
+
+    template<class T>
+    struct is_signed_helper<T, true>
+    {
+        static constexpr bool is_signed   = T(-1) < T(0);
+        static constexpr bool is_unsigned = !is_signed;
+    };
+}
+
+template<class T>
+struct is_signed : bool_constant<detail::is_signed_helper<T>::is_signed> {};
+
+template<class T>
+struct is_unsigned : bool_constant<detail::is_signed_helper<T>::is_unsigned> {};
+
+// checks if a type is a scoped enumeration type
+namespace detail
+{
+    template<class T, bool = is_enum_v<T>>
+    struct is_scoped_enum_helper : false_type {};
+
+    template<class T>
+    struct is_scoped_enum_helper<T, true> : bool_constant<!is_convertible_v<T, __underlying_type(T)>> {};
+}
+
+#if DSTL_HAS_BUILTIN(__is_scoped_enum)
+template<class T>
+struct is_scoped_enum : bool_constant<__is_scoped_enum(T)> {};
+#else
+template<class T>
+struct is_scoped_enum : detail::is_scoped_enum_helper<T> {};
+#endif
+
+// checks if a type has a constructor for specific arguments
+namespace detail
+{
+    template<class Void, class T, class... Args>
+    struct is_constructible_helper : false_type {};
+
+    template<class T, class... Args>
+    struct is_constructible_helper<void_t<decltype(::new (static_cast<void *>(nullptr)) T(declval<Args>()...))>, T, Args...> : true_type {};
+
+    // a reference binds like an implicit conversion from exactly one argument
+    template<class T, class... Args>
+    struct is_reference_constructible_helper : false_type {};
+
+    template<class T, class Arg>
+    struct is_reference_constructible_helper<T, Arg> : bool_constant<is_convertible_v<Arg, T>> {};
+
+    template<bool Constructible, class T, class... Args>
+    struct is_nothrow_constructible_helper : false_type {};
+
+    template<class T, class... Args>
+    struct is_nothrow_constructible_helper<true, T, Args...> : bool_constant<noexcept(::new (static_cast<void *>(nullptr)) T(declval<Args>()...))> {};
+
+    template<class T, class Arg>
+    struct is_nothrow_constructible_helper<true, T &, Arg> : bool_constant<is_nothrow_convertible_v<Arg, T &>> {};
+
+    template<class T, class Arg>
+    struct is_nothrow_constructible_helper<true, T &&, Arg> : bool_constant<is_nothrow_convertible_v<Arg, T &&>> {};
+}
+
+#if DSTL_HAS_BUILTIN(__is_constructible)
+template<class T, class... Args>
+struct is_constructible : bool_constant<__is_constructible(T, Args...)> {};
+#else
+template<class T, class... Args>
+struct is_constructible : bool_constant<is_reference_v<T> ? detail::is_reference_constructible_helper<T, Args...>::value
+                                                          : !is_unbounded_array_v<T> && detail::is_constructible_helper<void, T, Args...>::value> {};
+#endif
+
+template<class T>
+struct is_default_constructible : is_constructible<T> {};
+
+template<class T>
+struct is_copy_constructible : is_constructible<T, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_move_constructible : is_constructible<T, add_rvalue_reference_t<T>> {};
+
+// checks if a type has a non-throwing constructor for specific arguments
+#if DSTL_HAS_BUILTIN(__is_nothrow_constructible)
+template<class T, class... Args>
+struct is_nothrow_constructible : bool_constant<__is_nothrow_constructible(T, Args...)> {};
+#else
+template<class T, class... Args>
+struct is_nothrow_constructible : detail::is_nothrow_constructible_helper<is_constructible_v<T, Args...>, T, Args...> {};
+#endif
+
+template<class T>
+struct is_nothrow_default_constructible : is_nothrow_constructible<T> {};
+
+template<class T>
+struct is_nothrow_copy_constructible : is_nothrow_constructible<T, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_nothrow_move_constructible : is_nothrow_constructible<T, add_rvalue_reference_t<T>> {};
+
+// checks if a type has a trivial constructor for specific arguments
+template<class T, class... Args>
+struct is_trivially_constructible : bool_constant<__is_trivially_constructible(T, Args...)> {};
+
+template<class T>
+struct is_trivially_default_constructible : is_trivially_constructible<T> {};
+
+template<class T>
+struct is_trivially_copy_constructible : is_trivially_constructible<T, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_trivially_move_constructible : is_trivially_constructible<T, add_rvalue_reference_t<T>> {};
+
+// checks if a type has an assignment operator for a specific argument
+namespace detail
+{
+    template<class T, class U, class = void>
+    struct is_assignable_helper : false_type {};
+
+    template<class T, class U>
+    struct is_assignable_helper<T, U, void_t<decltype(declval<T>() = declval<U>())>> : true_type {};
+
+    template<class T, class U, bool = is_assignable_helper<T, U>::value>
+    struct is_nothrow_assignable_helper : false_type {};
+
+    template<class T, class U>
+    struct is_nothrow_assignable_helper<T, U, true> : bool_constant<noexcept(declval<T>() = declval<U>())> {};
+}
+
+#if DSTL_HAS_BUILTIN(__is_assignable)
+template<class T, class U>
+struct is_assignable : bool_constant<__is_assignable(T, U)> {};
+#else
+template<class T, class U>
+struct is_assignable : detail::is_assignable_helper<T, U> {};
+#endif
+
+template<class T>
+struct is_copy_assignable : is_assignable<add_lvalue_reference_t<T>, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_move_assignable : is_assignable<add_lvalue_reference_t<T>, add_rvalue_reference_t<T>> {};
+
+// checks if a type has a trivial assignment operator for a specific argument
+template<class T, class U>
+struct is_trivially_assignable : bool_constant<__is_trivially_assignable(T, U)> {};
+
+template<class T>
+struct is_trivially_copy_assignable : is_trivially_assignable<add_lvalue_reference_t<T>, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_trivially_move_assignable : is_trivially_assignable<add_lvalue_reference_t<T>, add_rvalue_reference_t<T>> {};
+
+// checks if a type has a non-throwing assignment operator for a specific argument
+#if DSTL_HAS_BUILTIN(__is_nothrow_assignable)
+template<class T, class U>
+struct is_nothrow_assignable : bool_constant<__is_nothrow_assignable(T, U)> {};
+#else
+template<class T, class U>
+struct is_nothrow_assignable : detail::is_nothrow_assignable_helper<T, U> {};
+#endif
+
+template<class T>
+struct is_nothrow_copy_assignable : is_nothrow_assignable<add_lvalue_reference_t<T>, add_lvalue_reference_t<const T>> {};
+
+template<class T>
+struct is_nothrow_move_assignable : is_nothrow_assignable<add_lvalue_reference_t<T>, add_rvalue_reference_t<T>> {};
+
+// checks if objects of a type can be swapped with objects of same or different type
+namespace detail
+{
+    // swap is looked up as after a using std::swap, i.e. std::swap and whatever ADL finds
+    namespace swap_lookup
+    {
+        using std::swap;
+
+        template<class T, class U, class = void>
+        struct is_swappable_with_helper
+        {
+            static constexpr bool swappable = false;
+            static constexpr bool nothrow   = false;
+        };
+
+        template<class T, class U>
+        struct is_swappable_with_helper<T, U, void_t<decltype(swap(declval<T>(), declval<U>())), decltype(swap(declval<U>(), declval<T>()))>>
+        {
+            static constexpr bool swappable = true;
+            static constexpr bool nothrow   = noexcept(swap(declval<T>(), declval<U>())) && noexcept(swap(declval<U>(), declval<T>()));
+        };
+    }
+}
+
+template<class T, class U>
+struct is_swappable_with : bool_constant<detail::swap_lookup::is_swappable_with_helper<T, U>::swappable> {};
+
+template<class T>
+struct is_swappable : is_swappable_with<add_lvalue_reference_t<T>, add_lvalue_reference_t<T>> {};
+
+template<class T, class U>
+struct is_nothrow_swappable_with : bool_constant<detail::swap_lookup::is_swappable_with_helper<T, U>::nothrow> {};
+
+template<class T>
+struct is_nothrow_swappable : is_nothrow_swappable_with<add_lvalue_reference_t<T>, add_lvalue_reference_t<T>> {};
+
+// checks if a type has a non-deleted destructor
+namespace detail
+{
+    template<class T, class = void>
+    struct is_destructible_helper : false_type {};
+
+    template<class T>
+    struct is_destructible_helper<T, void_t<decltype(declval<T &>().~T())>> : true_type {};
+
+    // only object types reach the destructor call, a reference there is a hard error
+    template<class T, bool = is_reference_v<T> || is_void_v<T> || is_function_v<T> || is_unbounded_array_v<T>>
+    struct is_destructible_fallback : bool_constant<is_reference_v<T>> {};
+
+    template<class T>
+    struct is_destructible_fallback<T, false> : is_destructible_helper<remove_all_extents_t<T>> {};
+}
+
+#if DSTL_HAS_BUILTIN(__is_destructible)
+template<class T>
+struct is_destructible : bool_constant<__is_destructible(T)> {};
+#else
+template<class T>
+struct is_destructible : bool_constant<detail::is_destructible_fallback<T>::value> {};
+#endif
+
+// checks if a type has a trivial non-deleted destructor
+#if DSTL_HAS_BUILTIN(__is_trivially_destructible) || defined(_MSC_VER)
+template<class T>
+struct is_trivially_destructible : bool_constant<__is_trivially_destructible(T)> {};
+#else
+template<class T>
+struct is_trivially_destructible : bool_constant<is_destructible_v<T> && __has_trivial_destructor(T)> {};
+#endif
+
+// checks if a type has a non-throwing non-deleted destructor
+namespace detail
+{
+    template<class T, bool = !is_reference_v<T> && is_destructible_v<T>>
+    struct is_nothrow_destructible_helper : bool_constant<is_reference_v<T>> {};
+
+    template<class T>
+    struct is_nothrow_destructible_helper<T, true>
+    {
+    private:
+        using U = remove_all_extents_t<T>;
+
+    public:
+        static constexpr bool value = noexcept(declval<U &>().~U());
+    };
+}
+
+#if DSTL_HAS_BUILTIN(__is_nothrow_destructible)
+template<class T>
+struct is_nothrow_destructible : bool_constant<__is_nothrow_destructible(T)> {};
+#else
+template<class T>
+struct is_nothrow_destructible : bool_constant<detail::is_nothrow_destructible_helper<T>::value> {};
+#endif
+
+// checks if a type has a virtual destructor
+template<class T>
+struct has_virtual_destructor : bool_constant<__has_virtual_destructor(T)> {};
+
+// checks if every bit in the object representation of a type contributes to its value,
+// i.e. equal objects have equal bytes
+template<class T>
+struct has_unique_object_representations : bool_constant<__has_unique_object_representations(T)> {};
+
+// checks if a reference is bound to a temporary in direct-initialization or copy-initialization
+namespace detail
+{
+    // without the builtin, binding to anything but a reference-compatible glvalue counts as
+    // a temporary, including a conversion function that returns a reference
+    template<class T, class U>
+    inline constexpr bool binds_to_temporary_v = !is_reference_v<U> ||
+                                                 !is_convertible_v<remove_reference_t<U> *, remove_reference_t<T> *>;
+}
+
+#if DSTL_HAS_BUILTIN(__reference_constructs_from_temporary)
+template<class T, class U>
+struct reference_constructs_from_temporary : bool_constant<__reference_constructs_from_temporary(T, U)> {};
+#else
+template<class T, class U>
+struct reference_constructs_from_temporary : bool_constant<is_reference_v<T> && is_constructible_v<T, U> &&
+                                                           detail::binds_to_temporary_v<T, U>> {};
+#endif
+
+#if DSTL_HAS_BUILTIN(__reference_converts_from_temporary)
+template<class T, class U>
+struct reference_converts_from_temporary : bool_constant<__reference_converts_from_temporary(T, U)> {};
+#else
+template<class T, class U>
+struct reference_converts_from_temporary : bool_constant<is_reference_v<T> && is_convertible_v<U, T> &&
+                                                         detail::binds_to_temporary_v<T, U>> {};
+#endif
+
+// checks if a type can be relocated, i.e. moved to a new address and destroyed at the old one,
+// with a bitwise copy. a type that is not trivially copyable, e.g. one that owns a pointer,
+// opts in by specializing this trait
+template<class T>
+struct is_trivially_relocatable : bool_constant<is_trivially_copyable_v<T> && is_trivially_destructible_v<T>> {};
+template<class T>
+struct is_trivially_relocatable<const T> : is_trivially_relocatable<T> {};
+template<class T, size_t N>
+struct is_trivially_relocatable<T[N]> : is_trivially_relocatable<T> {};
+
+// checks if objects of a type are equal exactly when their bytes are, so that comparing and
+// hashing them may look at the object representation. holds for types without padding or
+// multiple representations of a value; a type whose operator== skips members opts out by
+// specializing this trait
+template<class T>
+struct is_bytewise_comparable : bool_constant<has_unique_object_representations_v<T>> {};
+template<class T>
+struct is_bytewise_comparable<const T> : is_bytewise_comparable<T> {};
+template<class T, size_t N>
+struct is_bytewise_comparable<T[N]> : is_bytewise_comparable<T> {};
+
+// obtains the alignment requirement of a type
+template<class T>
+struct alignment_of : integral_constant<size_t, alignof(T)> {};
+
 // obtains the number of dimensions of an array type
+#if DSTL_HAS_BUILTIN(__array_rank)
+template<class T>
+struct rank : public integral_constant<size_t, __array_rank(T)> {};
+#else
 template<class T>
 struct rank : public integral_constant<size_t, 0> {};
 template<class T>
 struct rank<T[]> : public integral_constant<size_t, rank<T>::value + 1> {};
 template<class T, size_t N>
 struct rank<T[N]> : public integral_constant<size_t, rank<T>::value + 1> {};
+#endif
 
 // obtains the size of an array type along a specified dimension
-
+#if DSTL_HAS_BUILTIN(__array_extent)
+template<class T, unsigned I>
+struct extent : integral_constant<size_t, __array_extent(T, I)> {};
+#else
+template<class T, unsigned I>
+struct extent : integral_constant<size_t, 0> {};
 template<class T>
 struct extent<T[], 0> : integral_constant<size_t, 0> {};
 template<class T, unsigned N>
@@ -556,14 +1221,109 @@ template<class T, size_t I>
 struct extent<T[I], 0> : integral_constant<size_t, I> {};
 template<class T, size_t I, unsigned N>
 struct extent<T[I], N> : extent<T, N - 1> {};
+#endif
 
 // checks if two types are the same
+#if DSTL_HAS_BUILTIN(__is_same)
+template<class T, class U>
+struct is_same : bool_constant<__is_same(T, U)> {};
+#else
 template<class T, class U>
 struct is_same : false_type {};
 template<class T>
 struct is_same<T, T> : true_type {};
+#endif
+
+// checks if a type can be implicitly converted to another type
+namespace detail
+{
+    template<class To>
+    void convert_to (To) noexcept;
+
+    template<class From, class To, class = void>
+    struct is_convertible_helper : false_type {};
+
+    template<class From, class To>
+    struct is_convertible_helper<From, To, void_t<decltype(convert_to<To>(declval<From>()))>> : true_type {};
+
+    template<class From, class To, bool = is_convertible_helper<From, To>::value>
+    struct is_nothrow_convertible_helper : false_type {};
+
+    template<class From, class To>
+    struct is_nothrow_convertible_helper<From, To, true> : bool_constant<noexcept(convert_to<To>(declval<From>()))> {};
+}
+
+#if DSTL_HAS_BUILTIN(__is_convertible)
+template<class From, class To>
+struct is_convertible : bool_constant<__is_convertible(From, To)> {};
+#else
+template<class From, class To>
+struct is_convertible : bool_constant<(is_void_v<From> && is_void_v<To>) ||
+                                      (!is_void_v<To> && !is_array_v<To> && !is_function_v<To> &&
+                                       detail::is_convertible_helper<From, To>::value)> {};
+#endif
+
+#if DSTL_HAS_BUILTIN(__is_nothrow_convertible)
+template<class From, class To>
+struct is_nothrow_convertible : bool_constant<__is_nothrow_convertible(From, To)> {};
+#else
+template<class From, class To>
+struct is_nothrow_convertible : bool_constant<(is_void_v<From> && is_void_v<To>) ||
+                                              (!is_void_v<To> && !is_array_v<To> && !is_function_v<To> &&
+                                               detail::is_nothrow_convertible_helper<From, To>::value)> {};
+#endif
+
+// checks if a type is a virtual base of the other type
+namespace detail
+{
+    template<class Base, class Derived, class = void>
+    struct is_downcastable : false_type {};
+
+    template<class Base, class Derived>
+    struct is_downcastable<Base, Derived, void_t<decltype(static_cast<Derived *>(declval<Base *>()))>> : true_type {};
+}
+
+#if DSTL_HAS_BUILTIN(__builtin_is_virtual_base_of)
+template<class Base, class Derived>
+struct is_virtual_base_of : bool_constant<__builtin_is_virtual_base_of(Base, Derived)> {};
+#else
+// a pointer to a virtual base cannot be cast down. without the builtin an inaccessible or
+// ambiguous base counts as virtual as well
+template<class Base, class Derived>
+struct is_virtual_base_of : bool_constant<is_base_of_v<Base, Derived> && !is_same_v<remove_cv_t<Base>, remove_cv_t<Derived>> &&
+                                          !detail::is_downcastable<remove_cv_t<Base>, remove_cv_t<Derived>>::value> {};
+#endif
+
+// checks if two types are layout-compatible
+#if DSTL_HAS_BUILTIN(__is_layout_compatible)
+template<class T, class U>
+struct is_layout_compatible : bool_constant<__is_layout_compatible(T, U)> {};
+#else
+// without the builtin only a type and itself are known to be layout-compatible
+template<class T, class U>
+struct is_layout_compatible : is_same<remove_cv_t<T>, remove_cv_t<U>> {};
+#endif
+
+// checks if a type is a pointer-interconvertible (initial) base of another type
+#if DSTL_HAS_BUILTIN(__is_pointer_interconvertible_base_of)
+template<class Base, class Derived>
+struct is_pointer_interconvertible_base_of : bool_constant<__is_pointer_interconvertible_base_of(Base, Derived)> {};
+#else
+// every base of a standard-layout class shares its address
+template<class Base, class Derived>
+struct is_pointer_interconvertible_base_of : bool_constant<is_class_v<Base> && is_class_v<Derived> &&
+                                                           (is_same_v<remove_cv_t<Base>, remove_cv_t<Derived>> ||
+                                                            (is_base_of_v<Base, Derived> && is_standard_layout_v<Derived>))> {};
+#endif
 
 // removes const specifiers from the given type
+#if DSTL_HAS_BUILTIN(__remove_const)
+template<class T>
+struct remove_const
+{
+    using type = __remove_const(T);
+};
+#else
 template<class T>
 struct remove_const
 {
@@ -574,8 +1334,16 @@ struct remove_const<const T>
 {
     using type = T;
 };
+#endif
 
 // removes volatile specifiers from the given type
+#if DSTL_HAS_BUILTIN(__remove_volatile)
+template<class T>
+struct remove_volatile
+{
+    using type = __remove_volatile(T);
+};
+#else
 template<class T>
 struct remove_volatile
 {
@@ -586,8 +1354,16 @@ struct remove_volatile<volatile T>
 {
     using type = T;
 };
+#endif
 
 // removes const and volatile specifiers from the given type
+#if DSTL_HAS_BUILTIN(__remove_cv)
+template<class T>
+struct remove_cv
+{
+    using type = __remove_cv(T);
+};
+#else
 template<class T>
 struct remove_cv
 {
@@ -608,6 +1384,7 @@ struct remove_cv<const volatile T>
 {
     using type = T;
 };
+#endif
 
 // adds const specifiers to the given type
 template<class T>
@@ -631,6 +1408,17 @@ struct add_cv
 };
 
 // removes a reference from the given type
+#if DSTL_HAS_BUILTIN(__remove_reference_t)
+template<class T> struct remove_reference
+{
+    typedef __remove_reference_t(T) type;
+};
+#elif DSTL_HAS_BUILTIN(__remove_reference)
+template<class T> struct remove_reference
+{
+    typedef __remove_reference(T) type;
+};
+#else
 template<class T> struct remove_reference
 {
     typedef T type;
@@ -643,6 +1431,7 @@ template<class T> struct remove_reference<T &&>
 {
     typedef T type;
 };
+#endif
 
 // adds a lvalue or rvalue reference to the given type
 namespace detail
@@ -662,18 +1451,133 @@ namespace detail
     };
 }
 
+#if DSTL_HAS_BUILTIN(__add_lvalue_reference)
+template<class T>
+struct add_lvalue_reference
+{
+    using type = __add_lvalue_reference(T);
+};
+#else
 template<class T>
 struct add_lvalue_reference
 {
     using type = typename detail::add_reference_helper<T>::_Lvalue;
 };
+#endif
+#if DSTL_HAS_BUILTIN(__add_rvalue_reference)
+template<class T>
+struct add_rvalue_reference
+{
+    using type = __add_rvalue_reference(T);
+};
+#else
 template<class T>
 struct add_rvalue_reference
 {
     using type = typename detail::add_reference_helper<T>::_Rvalue;
 };
+#endif
+
+// obtains the corresponding signed or unsigned integral type for the given integral or enumeration type
+namespace detail
+{
+    template<class From, class To>
+    using copy_cv_t = conditional_t<is_const_v<From>,
+                                    conditional_t<is_volatile_v<From>, const volatile To, const To>,
+                                    conditional_t<is_volatile_v<From>, volatile To, To>>;
+
+    // the standard integer types of a size. the types of the same size as long or long long
+    // keep their own rank below, everything else maps to the smallest type of its size
+    template<size_t Size>
+    struct integer_of_size;
+    template<>
+    struct integer_of_size<1>
+    {
+        using signed_type   = signed char;
+        using unsigned_type = unsigned char;
+    };
+    template<>
+    struct integer_of_size<2>
+    {
+        using signed_type   = short;
+        using unsigned_type = unsigned short;
+    };
+    template<>
+    struct integer_of_size<4>
+    {
+        using signed_type   = int;
+        using unsigned_type = unsigned int;
+    };
+    template<>
+    struct integer_of_size<8>
+    {
+        using signed_type   = conditional_t<sizeof(long) == 8, long, long long>;
+        using unsigned_type = conditional_t<sizeof(long) == 8, unsigned long, unsigned long long>;
+    };
+
+    template<class T>
+    struct integer_pair : integer_of_size<sizeof(T)> {};
+    template<>
+    struct integer_pair<long>
+    {
+        using signed_type   = long;
+        using unsigned_type = unsigned long;
+    };
+    template<>
+    struct integer_pair<unsigned long> : integer_pair<long> {};
+    template<>
+    struct integer_pair<long long>
+    {
+        using signed_type   = long long;
+        using unsigned_type = unsigned long long;
+    };
+    template<>
+    struct integer_pair<unsigned long long> : integer_pair<long long> {};
+
+    template<class T>
+    struct checked_integer_pair : integer_pair<remove_cv_t<T>>
+    {
+        static_assert((is_integral_v<T> || is_enum_v<T>) && !is_same_v<remove_cv_t<T>, bool>,
+                      "make_signed and make_unsigned require a non-bool integral or an enumeration type");
+    };
+}
+
+#if DSTL_HAS_BUILTIN(__make_signed)
+template<class T>
+struct make_signed
+{
+    using type = __make_signed(T);
+};
+#else
+template<class T>
+struct make_signed
+{
+    using type = detail::copy_cv_t<T, typename detail::checked_integer_pair<T>::signed_type>;
+};
+#endif
+
+#if DSTL_HAS_BUILTIN(__make_unsigned)
+template<class T>
+struct make_unsigned
+{
+    using type = __make_unsigned(T);
+};
+#else
+template<class T>
+struct make_unsigned
+{
+    using type = detail::copy_cv_t<T, typename detail::checked_integer_pair<T>::unsigned_type>;
+};
+#endif
 
 // removes one extent from the given array type
+#if DSTL_HAS_BUILTIN(__remove_extent)
+template<class T>
+struct remove_extent
+{
+    using type = __remove_extent(T);
+};
+#else
 template<class T>
 struct remove_extent
 {
@@ -689,8 +1593,16 @@ struct remove_extent<T[N]>
 {
     using type = T;
 };
+#endif
 
 // removes all extents from the given array type
+#if DSTL_HAS_BUILTIN(__remove_all_extents)
+template<class T>
+struct remove_all_extents
+{
+    using type = __remove_all_extents(T);
+};
+#else
 template<class T>
 struct remove_all_extents
 {
@@ -706,8 +1618,16 @@ struct remove_all_extents<T[N]>
 {
     using type = typename remove_all_extents<T>::type;
 };
+#endif
 
 // 	removes a pointer from the given type
+#if DSTL_HAS_BUILTIN(__remove_pointer)
+template<class T>
+struct remove_pointer
+{
+    using type = __remove_pointer(T);
+};
+#else
 template<class T>
 struct remove_pointer
 {
@@ -733,6 +1653,7 @@ struct remove_pointer<T * const volatile>
 {
     using type = T;
 };
+#endif
 
 // adds a pointer to the given type
 namespace detail
@@ -750,11 +1671,19 @@ namespace detail
     };
 }
 
+#if DSTL_HAS_BUILTIN(__add_pointer)
+template<class T>
+struct add_pointer
+{
+    using type = __add_pointer(T);
+};
+#else
 template<class T>
 struct add_pointer
 {
     using type = typename detail::add_pointer_helper<T>::type;
 };
+#endif
 
 // returns the type argument unchanged
 template<class T>
@@ -764,13 +1693,28 @@ struct type_identity
 };
 
 // combines remove_cv and remove_reference
+#if DSTL_HAS_BUILTIN(__remove_cvref)
+template<class T>
+struct remove_cvref
+{
+    using type = __remove_cvref(T);
+};
+#else
 template<class T>
 struct remove_cvref
 {
     using type = remove_cv_t<remove_reference_t<T>>;
 };
+#endif
 
 // applies type transformations as when passing a function argument by value
+#if DSTL_HAS_BUILTIN(__decay)
+template<class T>
+struct decay
+{
+    using type = __decay(T);
+};
+#else
 template<class T>
 struct decay
 {
@@ -784,6 +1728,283 @@ public:
                                              add_pointer_t<U>,
                                              remove_cv_t<U>>>;
 };
+#endif
+
+// determines the common type of a group of types
+namespace detail
+{
+    template<class T1, class T2>
+    using conditional_result_t = decltype(false ? declval<T1>() : declval<T2>());
+
+    template<class T1, class T2, class = void>
+    struct common_type_of_const_refs {};
+
+    template<class T1, class T2>
+    struct common_type_of_const_refs<T1, T2, void_t<conditional_result_t<const T1 &, const T2 &>>>
+    {
+        using type = remove_cvref_t<conditional_result_t<const T1 &, const T2 &>>;
+    };
+
+    template<class T1, class T2, class = void>
+    struct common_type_of_decayed : common_type_of_const_refs<T1, T2> {};
+
+    template<class T1, class T2>
+    struct common_type_of_decayed<T1, T2, void_t<conditional_result_t<T1, T2>>>
+    {
+        using type = decay_t<conditional_result_t<T1, T2>>;
+    };
+
+    // types that decay go through common_type of the decayed types, which sees user specializations
+    template<class T1, class T2, class D1 = decay_t<T1>, class D2 = decay_t<T2>>
+    struct common_type_pair : common_type<D1, D2> {};
+
+    template<class T1, class T2>
+    struct common_type_pair<T1, T2, T1, T2> : common_type_of_decayed<T1, T2> {};
+
+    template<class Void, class T1, class T2, class... Rest>
+    struct common_type_fold {};
+
+    template<class T1, class T2, class... Rest>
+    struct common_type_fold<void_t<typename common_type<T1, T2>::type>, T1, T2, Rest...>
+            : common_type<typename common_type<T1, T2>::type, Rest...> {};
+}
+
+template<>
+struct common_type<> {};
+template<class T>
+struct common_type<T> : common_type<T, T> {};
+template<class T1, class T2>
+struct common_type<T1, T2> : detail::common_type_pair<T1, T2> {};
+template<class T1, class T2, class T3, class... Rest>
+struct common_type<T1, T2, T3, Rest...> : detail::common_type_fold<void, T1, T2, T3, Rest...> {};
+
+// determines the common reference type of a group of types
+namespace detail
+{
+    template<class From, class To>
+    using copy_cvref_t = conditional_t<is_lvalue_reference_v<From>,
+                                       add_lvalue_reference_t<copy_cv_t<remove_reference_t<From>, To>>,
+                                       conditional_t<is_rvalue_reference_v<From>,
+                                                     add_rvalue_reference_t<copy_cv_t<remove_reference_t<From>, To>>,
+                                                     copy_cv_t<From, To>>>;
+
+    template<class From>
+    struct copy_cvref_from
+    {
+        template<class To> using type = copy_cvref_t<From, To>;
+    };
+
+    // the type of a conditional expression on calls returning X and Y, which keeps references
+    template<class X, class Y>
+    using call_conditional_result_t = decltype(false ? declval<X (&)()>()() : declval<Y (&)()>()());
+
+    template<class A, class B, class = void>
+    struct common_ref {};
+
+    template<class X, class Y>
+    struct common_ref<X &, Y &, enable_if_t<is_reference_v<call_conditional_result_t<copy_cv_t<X, Y> &, copy_cv_t<Y, X> &>>>>
+    {
+        using type = call_conditional_result_t<copy_cv_t<X, Y> &, copy_cv_t<Y, X> &>;
+    };
+
+    template<class X, class Y>
+    using common_rvalue_ref_t = remove_reference_t<typename common_ref<X &, Y &>::type> &&;
+
+    template<class X, class Y>
+    struct common_ref<X &&, Y &&, enable_if_t<is_convertible_v<X &&, common_rvalue_ref_t<X, Y>> &&
+                                              is_convertible_v<Y &&, common_rvalue_ref_t<X, Y>>>>
+    {
+        using type = common_rvalue_ref_t<X, Y>;
+    };
+
+    template<class X, class Y>
+    struct common_ref<X &, Y &&, enable_if_t<is_convertible_v<Y &&, typename common_ref<const X &, Y &>::type>>>
+    {
+        using type = typename common_ref<const X &, Y &>::type;
+    };
+
+    template<class X, class Y>
+    struct common_ref<X &&, Y &, void> : common_ref<Y &, X &&> {};
+
+    template<class T1, class T2>
+    using basic_common_reference_t = typename basic_common_reference<remove_cvref_t<T1>, remove_cvref_t<T2>,
+                                                                     copy_cvref_from<T1>::template type,
+                                                                     copy_cvref_from<T2>::template type>::type;
+
+    // tried in order: the common reference of two references, basic_common_reference, the
+    // conditional operator, common_type
+    template<class T1, class T2, class = void>
+    struct common_reference_of_conditional : common_type<T1, T2> {};
+
+    template<class T1, class T2>
+    struct common_reference_of_conditional<T1, T2, void_t<call_conditional_result_t<T1, T2>>>
+    {
+        using type = call_conditional_result_t<T1, T2>;
+    };
+
+    template<class T1, class T2, class = void>
+    struct common_reference_of_basic : common_reference_of_conditional<T1, T2> {};
+
+    template<class T1, class T2>
+    struct common_reference_of_basic<T1, T2, void_t<basic_common_reference_t<T1, T2>>>
+    {
+        using type = basic_common_reference_t<T1, T2>;
+    };
+
+    template<class T1, class T2, class = void>
+    struct common_reference_pair : common_reference_of_basic<T1, T2> {};
+
+    template<class T1, class T2>
+    struct common_reference_pair<T1, T2, void_t<typename common_ref<T1, T2>::type>> : common_ref<T1, T2> {};
+
+    template<class Void, class T1, class T2, class... Rest>
+    struct common_reference_fold {};
+
+    template<class T1, class T2, class... Rest>
+    struct common_reference_fold<void_t<typename common_reference<T1, T2>::type>, T1, T2, Rest...>
+            : common_reference<typename common_reference<T1, T2>::type, Rest...> {};
+}
+
+template<>
+struct common_reference<> {};
+template<class T>
+struct common_reference<T>
+{
+    using type = T;
+};
+template<class T1, class T2>
+struct common_reference<T1, T2> : detail::common_reference_pair<T1, T2> {};
+template<class T1, class T2, class T3, class... Rest>
+struct common_reference<T1, T2, T3, Rest...> : detail::common_reference_fold<void, T1, T2, T3, Rest...> {};
+
+// obtains the underlying integer type for a given enumeration type
+namespace detail
+{
+    template<class T, bool = is_enum_v<T>>
+    struct underlying_type_helper {};
+
+    template<class T>
+    struct underlying_type_helper<T, true>
+    {
+        using type = __underlying_type(T);
+    };
+}
+
+template<class T>
+struct underlying_type : detail::underlying_type_helper<T> {};
+
+// deduces the result type of invoking a callable object with a set of arguments
+namespace detail
+{
+    template<class T>
+    struct is_reference_wrapper : false_type {};
+    template<class U>
+    struct is_reference_wrapper<std::reference_wrapper<U>> : true_type {};
+
+    // the INVOKE expression, for unevaluated operands only
+    template<class Fn>
+    struct invoke_impl
+    {
+        template<class F, class... Args>
+        static auto call (F &&f, Args &&...args) noexcept(noexcept(static_cast<F &&>(f)(static_cast<Args &&>(args)...)))
+            -> decltype(static_cast<F &&>(f)(static_cast<Args &&>(args)...));
+    };
+
+    template<class M, class C>
+    struct invoke_impl<M C::*>
+    {
+        // the object a pointer to member of C applies to: an object of C or a class derived
+        // from it, a reference_wrapper of one, or anything that dereferences to one
+        template<class T, enable_if_t<is_base_of_v<C, remove_cvref_t<T>>, int> = 0>
+        static T &&get (T &&t) noexcept;
+        template<class T, enable_if_t<is_reference_wrapper<remove_cvref_t<T>>::value, int> = 0>
+        static auto get (T &&t) noexcept -> decltype(t.get());
+        template<class T, enable_if_t<!is_base_of_v<C, remove_cvref_t<T>> && !is_reference_wrapper<remove_cvref_t<T>>::value, int> = 0>
+        static auto get (T &&t) noexcept(noexcept(*static_cast<T &&>(t))) -> decltype(*static_cast<T &&>(t));
+
+        template<class F, class T, class... Args, class N = M, enable_if_t<is_function_v<N>, int> = 0>
+        static auto call (F pm, T &&t, Args &&...args) noexcept(noexcept((get(static_cast<T &&>(t)).*pm)(static_cast<Args &&>(args)...)))
+            -> decltype((get(static_cast<T &&>(t)).*pm)(static_cast<Args &&>(args)...));
+        template<class F, class T, class N = M, enable_if_t<!is_function_v<N>, int> = 0>
+        static auto call (F pm, T &&t) noexcept(noexcept(get(static_cast<T &&>(t)).*pm))
+            -> decltype(get(static_cast<T &&>(t)).*pm);
+    };
+
+    template<class Void, class Fn, class... Args>
+    struct invoke_result_helper
+    {
+        static constexpr bool invocable = false;
+        static constexpr bool nothrow   = false;
+    };
+
+    template<class Fn, class... Args>
+    struct invoke_result_helper<void_t<decltype(invoke_impl<decay_t<Fn>>::call(declval<Fn>(), declval<Args>()...))>, Fn, Args...>
+    {
+        using type                      = decltype(invoke_impl<decay_t<Fn>>::call(declval<Fn>(), declval<Args>()...));
+        static constexpr bool invocable = true;
+        static constexpr bool nothrow   = noexcept(invoke_impl<decay_t<Fn>>::call(declval<Fn>(), declval<Args>()...));
+    };
+
+    // exposes type only when the call is well-formed, so invoke_result stays SFINAE friendly
+    template<class Helper, bool = Helper::invocable>
+    struct invoke_result_base {};
+    template<class Helper>
+    struct invoke_result_base<Helper, true>
+    {
+        using type = typename Helper::type;
+    };
+
+    template<class R, class Fn, class... Args>
+    constexpr bool is_invocable_r_helper () noexcept
+    {
+        using helper = invoke_result_helper<void, Fn, Args...>;
+        if constexpr (!helper::invocable)
+            return false;
+        else
+            return is_void_v<R> || is_convertible_v<typename helper::type, R>;
+    }
+
+    template<class R, class Fn, class... Args>
+    constexpr bool is_nothrow_invocable_r_helper () noexcept
+    {
+        using helper = invoke_result_helper<void, Fn, Args...>;
+        if constexpr (!helper::nothrow)
+            return false;
+        else
+            return is_void_v<R> || is_nothrow_convertible_v<typename helper::type, R>;
+    }
+}
+
+template<class Fn, class... ArgTypes>
+struct invoke_result : detail::invoke_result_base<detail::invoke_result_helper<void, Fn, ArgTypes...>> {};
+
+// checks if a type can be invoked with the given argument types, optionally yielding a result convertible to R
+template<class Fn, class... ArgTypes>
+struct is_invocable : bool_constant<detail::invoke_result_helper<void, Fn, ArgTypes...>::invocable> {};
+
+template<class R, class Fn, class... ArgTypes>
+struct is_invocable_r : bool_constant<detail::is_invocable_r_helper<R, Fn, ArgTypes...>()> {};
+
+template<class Fn, class... ArgTypes>
+struct is_nothrow_invocable : bool_constant<detail::invoke_result_helper<void, Fn, ArgTypes...>::nothrow> {};
+
+template<class R, class Fn, class... ArgTypes>
+struct is_nothrow_invocable_r : bool_constant<detail::is_nothrow_invocable_r_helper<R, Fn, ArgTypes...>()> {};
+
+// gets the referenced type wrapped in reference_wrapper, optionally after decaying
+template<class T>
+struct unwrap_reference
+{
+    using type = T;
+};
+template<class U>
+struct unwrap_reference<std::reference_wrapper<U>>
+{
+    using type = U &;
+};
+
+template<class T>
+struct unwrap_ref_decay : unwrap_reference<decay_t<T>> {};
 
 // conditionally removes a function overload or template specialization from overload resolution
 template<class T> struct enable_if<true, T>
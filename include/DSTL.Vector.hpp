@@ -0,0 +1,531 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    DSTL.Vector.hpp
+
+Abstract:
+    Vector.
+
+    Dynamic contiguous array. Elements of trivially relocatable types are
+    moved with memcpy/memmove on growth, insert and erase, and destructor
+    loops are skipped for trivially destructible types. A vector is three
+    pointers into its heap block and is trivially relocatable itself, so a
+    vector of vectors grows with memcpy as well.
+
+--*/
+
+#ifndef DSTL_VECTOR_H
+#define DSTL_VECTOR_H
+
+namespace detail
+{
+    // the capacity a buffer of cap elements grows to for new_size <= max_size elements:
+    // double the current one, at least new_size and at most max_size
+    constexpr size_t recommend_capacity (size_t cap, size_t new_size, size_t max_size) noexcept
+    {
+        if (cap >= max_size / 2)
+            return max_size;
+        return cap * 2 > new_size ? cap * 2 : new_size;
+    }
+}
+
+// dynamic contiguous array
+template<class T>
+class vector
+{
+public:
+    using value_type             = T;
+    using size_type              = size_t;
+    using difference_type        = ptrdiff_t;
+    using reference              = T &;
+    using const_reference        = const T &;
+    using pointer                = T *;
+    using const_pointer          = const T *;
+    using iterator               = T *;
+    using const_iterator         = const T *;
+    using reverse_iterator       = std::reverse_iterator<iterator>;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
+private:
+    T *begin_ = nullptr;
+    T *end_   = nullptr;
+    T *cap_   = nullptr;
+
+public:
+    vector () noexcept = default;
+
+    explicit vector (size_type count)
+    {
+        resize(count);
+    }
+
+    vector (size_type count, const T &value)
+    {
+        insert(end(), count, value);
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    vector (InputIt first, InputIt last)
+    {
+        insert(end(), first, last);
+    }
+
+    vector (std::initializer_list<T> init)
+    {
+        insert(end(), init.begin(), init.end());
+    }
+
+    vector (const vector &other)
+    {
+        if (!other.empty())
+        {
+            begin_ = detail::allocate_n<T>(other.size());
+            cap_   = begin_ + other.size();
+            try
+            {
+                end_ = detail::copy_construct_range(other.begin_, other.end_, begin_);
+            }
+            catch (...)
+            {
+                detail::deallocate_n(begin_, other.size());
+                begin_ = end_ = cap_ = nullptr;
+                throw;
+            }
+        }
+    }
+
+    vector (vector &&other) noexcept
+        : begin_(other.begin_), end_(other.end_), cap_(other.cap_)
+    {
+        other.begin_ = other.end_ = other.cap_ = nullptr;
+    }
+
+    ~vector ()
+    {
+        release();
+    }
+
+    vector &operator= (const vector &other)
+    {
+        if (this != &other)
+        {
+            vector tmp(other);
+            swap(tmp);
+        }
+        return *this;
+    }
+
+    vector &operator= (vector &&other) noexcept
+    {
+        if (this != &other)
+        {
+            release();
+            begin_       = other.begin_;
+            end_         = other.end_;
+            cap_         = other.cap_;
+            other.begin_ = other.end_ = other.cap_ = nullptr;
+        }
+        return *this;
+    }
+
+    vector &operator= (std::initializer_list<T> init)
+    {
+        clear();
+        insert(end(), init.begin(), init.end());
+        return *this;
+    }
+
+    //
+    // element access
+    //
+
+    reference at (size_type pos)
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::vector::at");
+        return begin_[pos];
+    }
+
+    const_reference at (size_type pos) const
+    {
+        if (pos >= size())
+            throw std::out_of_range("dstl::vector::at");
+        return begin_[pos];
+    }
+
+    reference operator[] (size_type pos) noexcept { return begin_[pos]; }
+    const_reference operator[] (size_type pos) const noexcept { return begin_[pos]; }
+
+    reference front () noexcept { return *begin_; }
+    const_reference front () const noexcept { return *begin_; }
+    reference back () noexcept { return *(end_ - 1); }
+    const_reference back () const noexcept { return *(end_ - 1); }
+
+    T *data () noexcept { return begin_; }
+    const T *data () const noexcept { return begin_; }
+
+    //
+    // iterators
+    //
+
+    iterator begin () noexcept { return begin_; }
+    const_iterator begin () const noexcept { return begin_; }
+    const_iterator cbegin () const noexcept { return begin_; }
+    iterator end () noexcept { return end_; }
+    const_iterator end () const noexcept { return end_; }
+    const_iterator cend () const noexcept { return end_; }
+
+    reverse_iterator rbegin () noexcept { return reverse_iterator(end_); }
+    const_reverse_iterator rbegin () const noexcept { return const_reverse_iterator(end_); }
+    reverse_iterator rend () noexcept { return reverse_iterator(begin_); }
+    const_reverse_iterator rend () const noexcept { return const_reverse_iterator(begin_); }
+
+    //
+    // capacity
+    //
+
+    [[nodiscard]] bool empty () const noexcept { return begin_ == end_; }
+    [[nodiscard]] size_type size () const noexcept { return static_cast<size_type>(end_ - begin_); }
+    [[nodiscard]] size_type capacity () const noexcept { return static_cast<size_type>(cap_ - begin_); }
+    // no object may be larger than PTRDIFF_MAX bytes, pointer differences across it would overflow
+    [[nodiscard]] static constexpr size_type max_size () noexcept
+    {
+        return static_cast<size_type>(std::numeric_limits<difference_type>::max()) / sizeof(T);
+    }
+
+    void reserve (size_type new_cap)
+    {
+        if (new_cap > max_size())
+            throw std::length_error("dstl::vector");
+        if (new_cap > capacity())
+            reallocate(new_cap);
+    }
+
+    void shrink_to_fit ()
+    {
+        if (end_ == begin_)
+            release();
+        else if (end_ != cap_)
+            reallocate(size());
+    }
+
+    //
+    // modifiers
+    //
+
+    void clear () noexcept
+    {
+        dstl::destroy(begin_, end_);
+        end_ = begin_;
+    }
+
+    template<class... Args>
+    reference emplace_back (Args &&...args)
+    {
+        if (end_ == cap_)
+            return *realloc_emplace(end_, std::forward<Args>(args)...);
+
+        ::new (static_cast<void *>(end_)) T(std::forward<Args>(args)...);
+        return *end_++;
+    }
+
+    void push_back (const T &value) { emplace_back(value); }
+    void push_back (T &&value) { emplace_back(std::move(value)); }
+
+    void pop_back () noexcept
+    {
+        --end_;
+        dstl::destroy_at(end_);
+    }
+
+    template<class... Args>
+    iterator emplace (const_iterator pos, Args &&...args)
+    {
+        T *p = const_cast<T *>(pos);
+        if (p == end_)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return end_ - 1;
+        }
+        if (end_ == cap_)
+            return realloc_emplace(p, std::forward<Args>(args)...);
+
+        T tmp(std::forward<Args>(args)...);
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::relocate(p, end_, p + 1);
+            try
+            {
+                ::new (static_cast<void *>(p)) T(std::move(tmp));
+            }
+            catch (...)
+            {
+                dstl::relocate(p + 1, end_ + 1, p);
+                throw;
+            }
+            ++end_;
+        }
+        else
+        {
+            ::new (static_cast<void *>(end_)) T(std::move(*(end_ - 1)));
+            ++end_;
+            std::move_backward(p, end_ - 2, end_ - 1);
+            *p = std::move(tmp);
+        }
+        return p;
+    }
+
+    iterator insert (const_iterator pos, const T &value) { return emplace(pos, value); }
+    iterator insert (const_iterator pos, T &&value) { return emplace(pos, std::move(value)); }
+
+    iterator insert (const_iterator pos, size_type count, const T &value)
+    {
+        const T tmp(value);
+        return insert_n(const_cast<T *>(pos), count, [&tmp] (T *dest) { ::new (static_cast<void *>(dest)) T(tmp); });
+    }
+
+    template<class InputIt, class = enable_if_t<!is_integral_v<InputIt>>>
+    iterator insert (const_iterator pos, InputIt first, InputIt last)
+    {
+        T *p = const_cast<T *>(pos);
+        if constexpr (std::forward_iterator<InputIt>)
+        {
+            const auto count = static_cast<size_type>(std::distance(first, last));
+            return insert_n(p, count, [&first] (T *dest) { ::new (static_cast<void *>(dest)) T(*first++); });
+        }
+        else
+        {
+            const auto offset = p - begin_;
+            for (T *cur = p; first != last; ++first, ++cur)
+                cur = emplace(cur, *first);
+            return begin_ + offset;
+        }
+    }
+
+    iterator insert (const_iterator pos, std::initializer_list<T> init)
+    {
+        return insert(pos, init.begin(), init.end());
+    }
+
+    iterator erase (const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase (const_iterator first, const_iterator last)
+    {
+        T *f = const_cast<T *>(first);
+        T *l = const_cast<T *>(last);
+        if (f == l)
+            return f;
+
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::destroy(f, l);
+            end_ = dstl::relocate(l, end_, f);
+        }
+        else
+        {
+            T *new_end = std::move(l, end_, f);
+            dstl::destroy(new_end, end_);
+            end_ = new_end;
+        }
+        return f;
+    }
+
+    void resize (size_type count)
+    {
+        if (count <= size())
+        {
+            erase(begin_ + count, end_);
+            return;
+        }
+        if (count > capacity())
+            reallocate(recommend(count));
+        for (; end_ != begin_ + count; ++end_)
+            ::new (static_cast<void *>(end_)) T();
+    }
+
+    void resize (size_type count, const T &value)
+    {
+        if (count <= size())
+            erase(begin_ + count, end_);
+        else
+            insert(end_, count - size(), value);
+    }
+
+    void swap (vector &other) noexcept
+    {
+        std::swap(begin_, other.begin_);
+        std::swap(end_, other.end_);
+        std::swap(cap_, other.cap_);
+    }
+
+    friend void swap (vector &lhs, vector &rhs) noexcept { lhs.swap(rhs); }
+
+    friend bool operator== (const vector &lhs, const vector &rhs)
+    {
+        return lhs.size() == rhs.size() && std::equal(lhs.begin_, lhs.end_, rhs.begin_);
+    }
+
+private:
+    // growth policy: at least double the current capacity
+    [[nodiscard]] size_type recommend (size_type new_size) const
+    {
+        if (new_size > max_size())
+            throw std::length_error("dstl::vector");
+        return detail::recommend_capacity(capacity(), new_size, max_size());
+    }
+
+    void release () noexcept
+    {
+        if (begin_ != nullptr)
+        {
+            dstl::destroy(begin_, end_);
+            detail::deallocate_n(begin_, capacity());
+            begin_ = end_ = cap_ = nullptr;
+        }
+    }
+
+    void reallocate (size_type new_cap)
+    {
+        T *new_begin = detail::allocate_n<T>(new_cap);
+        T *new_end;
+        try
+        {
+            new_end = dstl::uninitialized_relocate(begin_, end_, new_begin);
+        }
+        catch (...)
+        {
+            detail::deallocate_n(new_begin, new_cap);
+            throw;
+        }
+        if (begin_ != nullptr)
+            detail::deallocate_n(begin_, capacity());
+        begin_ = new_begin;
+        end_   = new_end;
+        cap_   = new_begin + new_cap;
+    }
+
+    // grows the storage and constructs one element at pos in the same pass
+    template<class... Args>
+    T *realloc_emplace (T *pos, Args &&...args)
+    {
+        const size_type new_cap = recommend(size() + 1);
+        const auto offset       = pos - begin_;
+        T *new_begin            = detail::allocate_n<T>(new_cap);
+        T *slot                 = new_begin + offset;
+        try
+        {
+            ::new (static_cast<void *>(slot)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            detail::deallocate_n(new_begin, new_cap);
+            throw;
+        }
+        return relocate_around(new_begin, new_cap, pos, 1, slot);
+    }
+
+    // opens a gap of count elements at pos and fills it through construct(dest)
+    template<class Construct>
+    T *insert_n (T *pos, size_type count, Construct construct)
+    {
+        if (count == 0)
+            return pos;
+
+        if (count > static_cast<size_type>(cap_ - end_))
+        {
+            const size_type new_cap = recommend(size() + count);
+            const auto offset       = pos - begin_;
+            T *new_begin            = detail::allocate_n<T>(new_cap);
+            T *gap                  = new_begin + offset;
+            T *cur                  = gap;
+            try
+            {
+                for (; cur != gap + count; ++cur)
+                    construct(cur);
+            }
+            catch (...)
+            {
+                dstl::destroy(gap, cur);
+                detail::deallocate_n(new_begin, new_cap);
+                throw;
+            }
+            return relocate_around(new_begin, new_cap, pos, count, gap);
+        }
+
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::relocate(pos, end_, pos + count);
+            T *cur = pos;
+            try
+            {
+                for (; cur != pos + count; ++cur)
+                    construct(cur);
+            }
+            catch (...)
+            {
+                // close the gap again
+                dstl::destroy(pos, cur);
+                dstl::relocate(pos + count, end_ + count, pos);
+                throw;
+            }
+            end_ += count;
+        }
+        else
+        {
+            // append then rotate into place to keep the sequence valid if a constructor throws
+            T *old_end = end_;
+            for (size_type i = 0; i < count; ++i, ++end_)
+                construct(end_);
+            std::rotate(pos, old_end, end_);
+        }
+        return pos;
+    }
+
+    // moves the current elements into new storage around an already constructed gap. elements
+    // whose move may throw are copied, so that a throw leaves the vector as it was
+    T *relocate_around (T *new_begin, size_type new_cap, T *pos, size_type count, T *gap)
+    {
+        if constexpr (is_trivially_relocatable_v<T>)
+        {
+            dstl::uninitialized_relocate(begin_, pos, new_begin);
+            dstl::uninitialized_relocate(pos, end_, gap + count);
+        }
+        else
+        {
+            T *prefix_end = nullptr;
+            try
+            {
+                prefix_end = detail::move_if_noexcept_construct_range(begin_, pos, new_begin);
+                detail::move_if_noexcept_construct_range(pos, end_, gap + count);
+            }
+            catch (...)
+            {
+                if (prefix_end != nullptr)
+                    dstl::destroy(new_begin, prefix_end);
+                dstl::destroy(gap, gap + count);
+                detail::deallocate_n(new_begin, new_cap);
+                throw;
+            }
+            dstl::destroy(begin_, end_);
+        }
+
+        const size_type old_size = size();
+        if (begin_ != nullptr)
+            detail::deallocate_n(begin_, capacity());
+        begin_ = new_begin;
+        end_   = new_begin + old_size + count;
+        cap_   = new_begin + new_cap;
+        return gap;
+    }
+};
+
+template<class T>
+struct is_trivially_relocatable<vector<T>> : true_type {};
+
+#endif //DSTL_VECTOR_H
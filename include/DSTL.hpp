@@ -14,9 +14,80 @@ Abstract:
 #ifndef DSTL_HPP
 #define DSTL_HPP
 
+// C/C++ runtime headers must stay outside of the dstl namespace.
+#include <bit>
+#include <compare>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <new>
+#include <utility>
+#include <iterator>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <stdexcept>
+#include <initializer_list>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define DSTL_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#if defined(__AVX2__)
+#define DSTL_AVX2 1
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+#define DSTL_RDTSC 1
+#include <x86intrin.h>
+#elif defined(_M_X64) || defined(_M_IX86)
+#define DSTL_RDTSC 1
+#include <intrin.h>
+#endif
+
+#if defined(__linux__) && __has_include(<linux/perf_event.h>)
+#define DSTL_PERF_EVENT 1
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
 namespace dstl // global namespace.
 {
+using std::size_t;
+using std::ptrdiff_t;
+using std::uint32_t;
+using std::uint64_t;
+using std::uintptr_t;
+
 #include "DSTL.TypeTraits.hpp"
+#include "DSTL.Memory.hpp"
+#include "DSTL.Functional.hpp"
+#include "DSTL.Algorithm.hpp"
+#include "DSTL.MemoryResource.hpp"
+#include "DSTL.ObjectPool.hpp"
+#include "DSTL.Vector.hpp"
+#include "DSTL.SmallVector.hpp"
+#include "DSTL.Hash.hpp"
+#include "DSTL.String.hpp"
+#include "DSTL.HashTable.hpp"
+#include "DSTL.FlatMap.hpp"
+#include "DSTL.BTree.hpp"
+#include "DSTL.Perf.hpp"
+#include "DSTL.ThreadPool.hpp"
+#include "DSTL.Execution.hpp"
+#include "DSTL.ConcurrentQueue.hpp"
 }
 
 #endif // DSTL_HPP
@@ -0,0 +1,409 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Algorithm.cpp
+
+Abstract:
+    Test Algorithms.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <cmath>
+#include <limits>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("Algorithm");
+
+// the input patterns that commonly degrade quicksort
+static std::vector<std::vector<uint64_t>> test_sort_inputs (size_t n)
+{
+    std::vector<std::vector<uint64_t>> inputs;
+    uint64_t state = 0x2545F4914F6CDD1DULL;
+    auto next      = [&state] {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        return state;
+    };
+
+    std::vector<uint64_t> v(n);
+    for (auto &x : v)
+        x = next();
+    inputs.push_back(v);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i;
+    inputs.push_back(v);
+
+    for (size_t i = 0; i < n; ++i)
+        v[i] = n - i;
+    inputs.push_back(v);
+
+    // organ pipe
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i < n / 2 ? i : n - i;
+    inputs.push_back(v);
+
+    // few unique values
+    for (auto &x : v)
+        x = next() % 4;
+    inputs.push_back(v);
+
+    // sorted with a few swaps
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i;
+    for (size_t i = 0; n != 0 && i < n / 100 + 1; ++i)
+        std::swap(v[next() % n], v[next() % n]);
+    inputs.push_back(v);
+
+    // sawtooth
+    for (size_t i = 0; i < n; ++i)
+        v[i] = i % 97;
+    inputs.push_back(v);
+
+    return inputs;
+}
+
+TEST_CASE("selects the branchless partition for arithmetic keys with default comparators")
+{
+    CHECK(detail::is_branchless_sort_v<int, std::less<>>);
+    CHECK(detail::is_branchless_sort_v<double, std::less<double>>);
+    CHECK(detail::is_branchless_sort_v<uint64_t, std::greater<>>);
+    CHECK(!detail::is_branchless_sort_v<std::string, std::less<>>);
+    CHECK(!detail::is_branchless_sort_v<int, bool (*) (int, int)>);
+}
+
+TEST_CASE("sorts the patterns that degrade quicksort")
+{
+    for (size_t n : {0, 1, 2, 3, 10, 24, 25, 100, 129, 1000, 100000})
+    {
+        for (auto input : test_sort_inputs(n))
+        {
+            auto expected = input;
+            std::sort(expected.begin(), expected.end());
+
+            auto branchless = input;
+            dstl::sort(branchless.begin(), branchless.end());
+            CHECK(branchless == expected);
+
+            // a comparator that is not a plain less takes the branchy partition
+            auto branchy = input;
+            dstl::sort(branchy.begin(), branchy.end(), [] (uint64_t a, uint64_t b) { return a < b; });
+            CHECK(branchy == expected);
+
+            auto descending = input;
+            dstl::sort(descending.begin(), descending.end(), std::greater<>());
+            CHECK(std::equal(descending.begin(), descending.end(), expected.rbegin()));
+        }
+    }
+}
+
+TEST_CASE("sorts move-only and non-trivial elements")
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; ++i)
+        words.push_back(std::to_string((i * 7919) % 5000));
+    auto expected = words;
+    std::sort(expected.begin(), expected.end());
+    dstl::sort(words.begin(), words.end());
+    CHECK(words == expected);
+
+    vector<std::unique_ptr<int>> owners;
+    for (int i = 0; i < 1000; ++i)
+        owners.push_back(std::make_unique<int>((i * 31) % 1000));
+    dstl::sort(owners.begin(), owners.end(), [] (const auto &a, const auto &b) { return *a < *b; });
+    bool sorted = true;
+    for (int i = 0; i < 1000; ++i)
+        sorted = sorted && *owners[i] == i;
+    CHECK(sorted);
+}
+
+TEST_CASE("keeps the comparison count in O(n log n)")
+{
+    constexpr size_t n = 1u << 16;
+    for (auto input : test_sort_inputs(n))
+    {
+        size_t comparisons = 0;
+        dstl::sort(input.begin(), input.end(), [&comparisons] (uint64_t a, uint64_t b) {
+            ++comparisons;
+            return a < b;
+        });
+        CHECK(std::is_sorted(input.begin(), input.end()));
+        CHECK(comparisons < 4 * n * 16);
+    }
+}
+
+TEST_CASE("orders radix keys like the built in comparisons")
+{
+    using dstl::detail::radix_key;
+    CHECK(radix_key(-1) < radix_key(0));
+    CHECK(radix_key(INT32_MIN) < radix_key(INT32_MAX));
+    CHECK(radix_key(static_cast<int64_t>(-5)) < radix_key(static_cast<int64_t>(3)));
+    CHECK(radix_key(-2.5) < radix_key(-1.0));
+    CHECK(radix_key(-1.0f) < radix_key(-0.0f));
+    CHECK(radix_key(-0.0) < radix_key(0.0));
+    CHECK(radix_key(0.0) < radix_key(1e-300));
+    CHECK(radix_key(-std::numeric_limits<double>::infinity()) < radix_key(std::numeric_limits<double>::lowest()));
+
+    CHECK(dstl::detail::is_radix_key_v<char>);
+    CHECK(dstl::detail::is_radix_key_v<uint64_t>);
+    CHECK(dstl::detail::is_radix_key_v<float>);
+    CHECK(!dstl::detail::is_radix_key_v<long double>);
+    CHECK(!dstl::detail::is_radix_key_v<std::string>);
+}
+
+TEST_CASE("radix sorts signed, unsigned and floating point keys")
+{
+    for (size_t n : {0u, 1u, 2u, 100u, 5000u, 70000u})
+    {
+        for (auto input : test_sort_inputs(n))
+        {
+            std::vector<int64_t> s64(input.begin(), input.end());
+            std::vector<int32_t> s32;
+            std::vector<uint16_t> u16;
+            std::vector<double> f64;
+            std::vector<float> f32;
+            for (uint64_t x : input)
+            {
+                s32.push_back(static_cast<int32_t>(x));
+                u16.push_back(static_cast<uint16_t>(x));
+                f64.push_back(static_cast<double>(static_cast<int64_t>(x)) / 3);
+                f32.push_back(static_cast<float>(static_cast<int32_t>(x)) * -0.5f);
+            }
+
+            dstl::radix_sort(input.begin(), input.end());
+            dstl::radix_sort(s64.begin(), s64.end());
+            dstl::radix_sort(s32.begin(), s32.end());
+            dstl::radix_sort(u16.begin(), u16.end());
+            dstl::radix_sort(f64.begin(), f64.end());
+            dstl::radix_sort(f32.begin(), f32.end());
+            CHECK(std::is_sorted(input.begin(), input.end()));
+            CHECK(std::is_sorted(s64.begin(), s64.end()));
+            CHECK(std::is_sorted(s32.begin(), s32.end()));
+            CHECK(std::is_sorted(u16.begin(), u16.end()));
+            CHECK(std::is_sorted(f64.begin(), f64.end()));
+            CHECK(std::is_sorted(f32.begin(), f32.end()));
+        }
+    }
+
+    std::vector<double> zeros = {0.0, -0.0, 1.0, -0.0, 0.0, -1.0};
+    dstl::radix_sort(zeros.begin(), zeros.end());
+    CHECK(zeros[0] == -1.0);
+    CHECK(std::signbit(zeros[1]));
+    CHECK(std::signbit(zeros[2]));
+    CHECK(!std::signbit(zeros[3]));
+    CHECK(zeros[5] == 1.0);
+}
+
+TEST_CASE("radix sorts by a projected key and keeps equal keys in order")
+{
+    struct test_keyed
+    {
+        int32_t key_;
+        std::string name_;
+    };
+
+    std::vector<test_keyed> v;
+    for (int i = 0; i < 3000; ++i)
+        v.push_back({(i * 7919) % 101 - 50, std::to_string(i)});
+    dstl::radix_sort(v.begin(), v.end(), &test_keyed::key_);
+
+    bool ordered = true;
+    for (size_t i = 1; i < v.size(); ++i)
+    {
+        ordered = ordered && v[i - 1].key_ <= v[i].key_;
+        if (v[i - 1].key_ == v[i].key_)
+            ordered = ordered && std::stoi(v[i - 1].name_) < std::stoi(v[i].name_);
+    }
+    CHECK(ordered);
+
+    std::vector<uint32_t> by_low_byte = {0x1FF, 0x200, 0x0FE, 0x301};
+    dstl::radix_sort(by_low_byte.begin(), by_low_byte.end(), [] (uint32_t x) { return static_cast<unsigned char>(x); });
+    CHECK(by_low_byte == std::vector<uint32_t>{0x200, 0x301, 0x0FE, 0x1FF});
+}
+
+TEST_CASE("sort switches to radix sort for large ranges of keys in either direction")
+{
+    std::vector<int32_t> v(20000);
+    for (size_t i = 0; i < v.size(); ++i)
+        v[i] = static_cast<int32_t>((i * 2654435761u) % 40000) - 20000;
+    auto expected = v;
+    std::sort(expected.begin(), expected.end(), std::greater<>());
+    dstl::sort(v.begin(), v.end(), std::greater<int32_t>());
+    CHECK(v == expected);
+
+    std::sort(expected.begin(), expected.end());
+    dstl::sort(v.begin(), v.end());
+    CHECK(v == expected);
+}
+
+struct test_packed_record
+{
+    uint32_t id_;
+    uint32_t kind_;
+    uint64_t stamp_;
+
+    bool operator== (const test_packed_record &) const = default;
+};
+
+// equal ids are equal records, whatever the rest holds
+struct test_keyed_record
+{
+    uint64_t id_;
+    uint64_t payload_;
+
+    bool operator== (const test_keyed_record &other) const { return id_ == other.id_; }
+};
+
+namespace dstl
+{
+template<>
+struct is_bytewise_comparable<test_keyed_record> : false_type {};
+}
+
+TEST_CASE("equal compares ranges element by element or as bytes")
+{
+    CHECK(detail::is_memcmp_equal_v<int *, const int *, std::equal_to<>>);
+    CHECK(detail::is_memcmp_equal_v<std::vector<test_packed_record>::iterator, test_packed_record *, std::equal_to<test_packed_record>>);
+    CHECK(!detail::is_memcmp_equal_v<double *, double *, std::equal_to<>>);
+    CHECK(!detail::is_memcmp_equal_v<int *, long *, std::equal_to<>>);
+    CHECK(!detail::is_memcmp_equal_v<std::list<int>::iterator, int *, std::equal_to<>>);
+    CHECK(!detail::is_memcmp_equal_v<test_keyed_record *, test_keyed_record *, std::equal_to<>>);
+
+    std::vector<int> a{1, 2, 3, 4};
+    std::vector<int> b{1, 2, 3, 5};
+    CHECK(dstl::equal(a.begin(), a.end(), a.begin()));
+    CHECK(!dstl::equal(a.begin(), a.end(), b.begin()));
+    CHECK(dstl::equal(a.begin(), a.begin() + 3, b.begin()));
+    CHECK(dstl::equal(a.begin(), a.begin(), b.begin()));
+    CHECK(!dstl::equal(a.begin(), a.end(), b.begin(), b.begin() + 3));
+    CHECK(dstl::equal(a.begin(), a.end(), b.begin(), [] (int x, int y) { return x / 2 == y / 2; }));
+
+    std::list<int> list{1, 2, 3, 4};
+    CHECK(dstl::equal(list.begin(), list.end(), a.begin(), a.end()));
+    CHECK(!dstl::equal(list.begin(), list.end(), a.begin(), a.begin() + 2));
+
+    // -0.0 and 0.0 are equal but differ in their bytes
+    std::vector<double> zeros{0.0, 1.0};
+    std::vector<double> negative_zeros{-0.0, 1.0};
+    CHECK(dstl::equal(zeros.begin(), zeros.end(), negative_zeros.begin()));
+
+    std::vector<test_packed_record> records(100, test_packed_record{7, 1, 99});
+    std::vector<test_packed_record> copy = records;
+    CHECK(dstl::equal(records.begin(), records.end(), copy.begin(), copy.end()));
+    copy[63].stamp_ = 100;
+    CHECK(!dstl::equal(records.begin(), records.end(), copy.begin(), copy.end()));
+
+    test_keyed_record keyed[2]  = {{1, 10}, {2, 20}};
+    test_keyed_record other[2]  = {{1, 11}, {2, 21}};
+    CHECK(dstl::equal(keyed, keyed + 2, other));
+}
+
+// runs dstl::find, count, contains and mismatch over every length and match position and compares with std
+template<class T>
+void check_search_kernels ()
+{
+    for (size_t n = 0; n <= 140; n += (n < 70 ? 1 : 7))
+    {
+        std::vector<T> values(n, T(1));
+        std::vector<T> other(values);
+        bool all_match = true;
+        for (size_t hit = 0; hit <= n; ++hit)
+        {
+            if (hit < n)
+            {
+                values[hit] = T(2);
+                other[hit]  = T(3);
+            }
+            all_match &= dstl::find(values.begin(), values.end(), T(2)) == std::find(values.begin(), values.end(), T(2));
+            all_match &= dstl::contains(values.begin(), values.end(), T(2)) == (hit < n);
+            all_match &= dstl::count(values.begin(), values.end(), T(1)) == std::count(values.begin(), values.end(), T(1));
+            all_match &= dstl::mismatch(values.begin(), values.end(), other.begin()) == std::mismatch(values.begin(), values.end(), other.begin());
+            all_match &= dstl::equal(values.begin(), values.end(), other.begin()) == (hit == n);
+            if (hit < n)
+            {
+                values[hit] = T(1);
+                other[hit]  = T(1);
+            }
+        }
+        CHECK(all_match);
+    }
+}
+
+TEST_CASE_TEMPLATE("find, count and mismatch agree with std for arithmetic ranges", T, int8_t, uint16_t, int32_t, int64_t, float, double)
+{
+    CHECK(detail::is_simd_find_v<typename std::vector<T>::iterator, T>);
+    check_search_kernels<T>();
+}
+
+TEST_CASE("count does not overflow its per byte counters")
+{
+    std::vector<uint8_t> bytes(100000, 7);
+    bytes[99999] = 8;
+    CHECK(dstl::count(bytes.begin(), bytes.end(), 7) == 99999);
+    std::vector<int64_t> words(20000, -1);
+    CHECK(dstl::count(words.begin(), words.end(), -1) == 20000);
+}
+
+TEST_CASE("find and count compare values of another arithmetic type like ==")
+{
+    std::vector<unsigned char> bytes{1, 255, 44, 255};
+    CHECK(dstl::find(bytes.begin(), bytes.end(), 255) == bytes.begin() + 1);
+    CHECK(dstl::find(bytes.begin(), bytes.end(), 300 + 44) == bytes.end());
+    CHECK(dstl::find(bytes.begin(), bytes.end(), -1) == bytes.end());
+    CHECK(dstl::count(bytes.begin(), bytes.end(), 255LL) == 2);
+
+    std::vector<unsigned> words{0, 7, 0xFFFFFFFFu};
+    // -1 converts to 0xFFFFFFFF, as in words[2] == -1
+    CHECK(dstl::find(words.begin(), words.end(), -1) == words.begin() + 2);
+    CHECK(dstl::find(words.begin(), words.end(), -1LL) == words.end());
+
+    std::vector<float> floats{0.5f, 0.1f, -0.0f, std::numeric_limits<float>::quiet_NaN()};
+    CHECK(dstl::find(floats.begin(), floats.end(), 0.1) == floats.end());
+    CHECK(dstl::find(floats.begin(), floats.end(), 0.5) == floats.begin());
+    CHECK(dstl::find(floats.begin(), floats.end(), 0.0f) == floats.begin() + 2);
+    CHECK(!dstl::contains(floats.begin(), floats.end(), std::numeric_limits<float>::quiet_NaN()));
+    CHECK(dstl::count(floats.begin(), floats.end(), std::numeric_limits<double>::quiet_NaN()) == 0);
+
+    // integral elements searched for a floating point value take the scalar loop
+    CHECK(!detail::is_simd_find_v<std::vector<int>::iterator, double>);
+    std::vector<int> ints{1, 2, 3};
+    CHECK(dstl::find(ints.begin(), ints.end(), 2.0) == ints.begin() + 1);
+    CHECK(dstl::find(ints.begin(), ints.end(), 2.5) == ints.end());
+
+    std::vector<bool> flags{false, true};
+    CHECK(dstl::find(flags.begin(), flags.end(), true) == flags.begin() + 1);
+}
+
+TEST_CASE("mismatch and equal handle signed zeros, NaNs and other ranges")
+{
+    std::vector<double> a{1.0, 0.0, std::numeric_limits<double>::quiet_NaN(), 4.0};
+    std::vector<double> b{1.0, -0.0, std::numeric_limits<double>::quiet_NaN(), 4.0};
+    CHECK(dstl::mismatch(a.begin(), a.end(), b.begin()).first == a.begin() + 2);
+    CHECK(!dstl::equal(a.begin(), a.end(), b.begin()));
+    CHECK(dstl::equal(a.begin(), a.begin() + 2, b.begin(), b.begin() + 2));
+
+    std::vector<int> longer{1, 2, 3, 4, 5};
+    std::vector<int> shorter{1, 2, 3};
+    CHECK(dstl::mismatch(longer.begin(), longer.end(), shorter.begin(), shorter.end()).first == longer.begin() + 3);
+    CHECK(dstl::mismatch(shorter.begin(), shorter.end(), longer.begin(), longer.end()).second == longer.begin() + 3);
+
+    std::list<int> list{1, 2, 9};
+    CHECK(dstl::mismatch(list.begin(), list.end(), shorter.begin()).second == shorter.begin() + 2);
+    CHECK(dstl::mismatch(list.begin(), list.end(), longer.begin(), longer.end(), [] (int x, int y) { return x >= y; }).first == list.end());
+    CHECK(dstl::count(list.begin(), list.end(), 2) == 1);
+    CHECK(dstl::find(list.begin(), list.end(), 9) == std::prev(list.end()));
+}
+
+TEST_SUITE_END();
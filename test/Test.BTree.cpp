@@ -0,0 +1,413 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.BTree.cpp
+
+Abstract:
+    Test B-Tree Map and Set.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("BTree");
+
+// large enough that every node holds the minimum of three elements, which makes trees deep
+struct test_wide_key
+{
+    int value_ = 0;
+    char padding_[92]{};
+
+    test_wide_key (int value) : value_(value) {}
+
+    friend bool operator< (const test_wide_key &lhs, const test_wide_key &rhs) { return lhs.value_ < rhs.value_; }
+    friend bool operator== (const test_wide_key &lhs, const test_wide_key &rhs) { return lhs.value_ == rhs.value_; }
+};
+
+// throws from its constructor from int once armed
+struct test_throwing_value
+{
+    static inline int constructions_left = -1;
+
+    int value_ = 0;
+
+    test_throwing_value () = default;
+
+    test_throwing_value (int value) : value_(value)
+    {
+        if (constructions_left == 0)
+            throw std::runtime_error("construct");
+        if (constructions_left > 0)
+            --constructions_left;
+    }
+};
+
+static uint64_t test_next (uint64_t &state)
+{
+    state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+    return state >> 33;
+}
+
+// inserts and erases random keys in both containers and checks that they hold the same elements
+template<class Map, class MakeKey>
+static bool test_against_std (uint64_t seed, int rounds, int range, MakeKey make_key)
+{
+    Map m;
+    std::map<typename Map::key_type, int> expected;
+    uint64_t state = seed;
+    bool same      = true;
+    for (int round = 0; round < rounds; ++round)
+    {
+        const auto key = make_key(static_cast<int>(test_next(state) % static_cast<uint64_t>(range)));
+        if (test_next(state) % 3 != 0)
+        {
+            const bool inserted = m.try_emplace(key, round).second;
+            same &= inserted == expected.emplace(key, round).second;
+        }
+        else
+            same &= m.erase(key) == expected.erase(key);
+    }
+    same &= m.size() == expected.size();
+    auto it = expected.begin();
+    for (auto [key, value] : m)
+    {
+        same &= it != expected.end() && it->first == key && it->second == value;
+        ++it;
+    }
+    // walking back from the end meets the same elements
+    auto rit = expected.rbegin();
+    for (auto pos = m.end(); pos != m.begin();)
+    {
+        --pos;
+        same &= rit->first == pos->first;
+        ++rit;
+    }
+    return same;
+}
+
+TEST_CASE("nodes span whole cache lines")
+{
+    using leaf = detail::btree_leaf<int64_t, int64_t, 14>;
+    CHECK(alignof(leaf) == detail::cache_line_size);
+    CHECK(sizeof(leaf) % detail::cache_line_size == 0);
+    CHECK(sizeof(detail::btree_inner<std::string, 5>) % detail::cache_line_size == 0);
+    // a set leaf has no room for values
+    CHECK(sizeof(detail::btree_leaf<int64_t, void, 29>) == 256);
+}
+
+TEST_CASE("inserts, finds and erases keys of a btree_set")
+{
+    btree_set<int> s{5, 1, 3, 1, 9};
+    CHECK(s.size() == 4);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 3, 5, 9});
+
+    CHECK(s.insert(4).second);
+    CHECK(!s.insert(4).second);
+    CHECK(*s.insert(7).first == 7);
+    CHECK(s.emplace(0).second);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{0, 1, 3, 4, 5, 7, 9});
+
+    CHECK(s.contains(3));
+    CHECK(!s.contains(2));
+    CHECK(s.count(9) == 1);
+    CHECK(s.find(2) == s.end());
+    CHECK(*s.lower_bound(6) == 7);
+    CHECK(*s.upper_bound(7) == 9);
+    CHECK(s.upper_bound(9) == s.end());
+    CHECK(std::distance(s.equal_range(5).first, s.equal_range(5).second) == 1);
+    CHECK(s.equal_range(6).first == s.equal_range(6).second);
+
+    CHECK(s.erase(3) == 1);
+    CHECK(s.erase(3) == 0);
+    CHECK(*s.erase(s.begin()) == 1);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 4, 5, 7, 9});
+    CHECK(*s.rbegin() == 9);
+
+    btree_set<int, std::greater<int>> descending{1, 2, 3};
+    CHECK(*descending.begin() == 3);
+    CHECK(*descending.lower_bound(2) == 2);
+
+    btree_set<int> empty;
+    CHECK(empty.begin() == empty.end());
+    CHECK(empty.find(1) == empty.end());
+    CHECK(empty.lower_bound(1) == empty.end());
+    CHECK(empty.erase(1) == 0);
+    CHECK(std::bidirectional_iterator<btree_set<int>::iterator>);
+}
+
+TEST_CASE("accesses mapped values of a btree_map")
+{
+    btree_map<std::string, int> m{{"beta", 2}, {"alpha", 1}, {"beta", 3}};
+    CHECK(m.size() == 2);
+    CHECK(m.at("beta") == 2);
+
+    m["gamma"] = 3;
+    ++m["alpha"];
+    CHECK(m.at("alpha") == 2);
+    CHECK_THROWS_AS(m.at("delta"), std::out_of_range);
+
+    CHECK(!m.try_emplace("gamma", 9).second);
+    CHECK(m.insert_or_assign("gamma", 9).first->second == 9);
+    CHECK(m.emplace("delta", 4).second);
+    CHECK(m.insert({"epsilon", 5}).second);
+    CHECK(m.size() == 5);
+
+    auto it = m.find("delta");
+    CHECK(it->first == "delta");
+    it->second = 40;
+    CHECK((*it).second == 40);
+    CHECK(m.find("zeta") == m.end());
+    CHECK(m.lower_bound("c")->first == "delta");
+    CHECK(m.upper_bound("delta")->first == "epsilon");
+
+    std::vector<std::string> order;
+    for (auto [key, value] : m)
+        order.push_back(key);
+    CHECK(order == std::vector<std::string>{"alpha", "beta", "delta", "epsilon", "gamma"});
+    CHECK(m.rbegin()->first == "gamma");
+
+    CHECK(m.erase("beta") == 1);
+    CHECK(m.erase(m.begin())->first == "delta");
+    CHECK(m.erase(m.begin(), std::next(m.begin(), 2))->first == "gamma");
+    CHECK(m.size() == 1);
+
+    const btree_map<std::string, int> &cm = m;
+    CHECK(cm.find("gamma")->second == 9);
+    CHECK(cm.at("gamma") == 9);
+    btree_map<std::string, int>::const_iterator cit = m.begin();
+    CHECK(cit == cm.begin());
+    CHECK(std::bidirectional_iterator<btree_map<std::string, int>::iterator>);
+}
+
+TEST_CASE("random inserts and erases agree with std::map")
+{
+    auto same_int  = [] (int key) { return key; };
+    auto to_string = [] (int key) { return std::to_string(key); };
+    auto to_wide   = [] (int key) { return test_wide_key(key); };
+    CHECK(test_against_std<btree_map<int, int>>(1, 20000, 3000, same_int));
+    CHECK(test_against_std<btree_map<int, int>>(2, 20000, 100, same_int));
+    CHECK(test_against_std<btree_map<std::string, int>>(3, 20000, 1000, to_string));
+    CHECK(test_against_std<btree_map<test_wide_key, int>>(4, 20000, 2000, to_wide));
+    CHECK(test_against_std<btree_map<test_wide_key, int>>(5, 20000, 50, to_wide));
+}
+
+TEST_CASE("string keys agree with std::set")
+{
+    btree_set<std::string> s;
+    std::set<std::string> expected;
+    uint64_t state = 6;
+    bool same      = true;
+    for (int round = 0; round < 20000; ++round)
+    {
+        const std::string key = "key" + std::to_string(test_next(state) % 2000);
+        if (test_next(state) % 3 != 0)
+            same &= s.insert(key).second == expected.insert(key).second;
+        else
+            same &= s.erase(key) == expected.erase(key);
+    }
+    CHECK(same);
+    CHECK(std::vector<std::string>(s.begin(), s.end()) == std::vector<std::string>(expected.begin(), expected.end()));
+}
+
+TEST_CASE("ascending inserts pack the leaves")
+{
+    btree_set<int64_t> s;
+    for (int64_t i = 0; i < 100000; ++i)
+        s.insert(i);
+    CHECK(s.size() == 100000);
+    bool ordered = true;
+    int64_t next = 0;
+    for (int64_t key : s)
+        ordered &= key == next++;
+    CHECK(ordered);
+
+    // a packed tree is no taller than one built in bulk
+    std::vector<int64_t> keys(100000);
+    for (size_t i = 0; i < keys.size(); ++i)
+        keys[i] = static_cast<int64_t>(i);
+    btree_set<int64_t> bulk(sorted_unique, keys.begin(), keys.end());
+    CHECK(s.height() <= bulk.height());
+    CHECK(s == bulk);
+
+    // descending inserts and erasing everything in either direction
+    btree_set<int64_t> down;
+    for (int64_t i = 50000; i-- != 0;)
+        down.insert(i);
+    CHECK(*down.begin() == 0);
+    for (int64_t i = 0; i < 50000; i += 2)
+        down.erase(i);
+    for (int64_t i = 49999; i > 0; i -= 2)
+        down.erase(i);
+    CHECK(down.empty());
+    CHECK(down.height() == 0);
+}
+
+TEST_CASE("erasing by iterator returns the successor")
+{
+    btree_map<test_wide_key, int> m;
+    for (int i = 0; i < 500; ++i)
+        m.try_emplace(test_wide_key(i), i);
+    auto it    = m.find(test_wide_key(100));
+    bool right = true;
+    // erases every other element from 100 on, each erase may merge or refill a node
+    while (it != m.end())
+    {
+        const int value = it->second;
+        it              = m.erase(it);
+        right &= it == m.end() || it->second == value + 1;
+        if (it != m.end())
+            ++it;
+    }
+    CHECK(right);
+    CHECK(m.size() == 300);
+
+    auto last = m.erase(m.find(test_wide_key(0)), m.find(test_wide_key(151)));
+    CHECK(last->first.value_ == 151);
+    CHECK(m.size() == 300 - 100 - 25);
+    CHECK(m.begin()->first.value_ == 151);
+    auto rest = m.erase(m.begin(), m.end());
+    CHECK(rest == m.end());
+    CHECK(m.empty());
+}
+
+TEST_CASE("builds a btree_map in bulk")
+{
+    for (int n : {0, 1, 13, 14, 15, 300, 5000})
+    {
+        std::vector<std::pair<int, int>> pairs;
+        for (int i = 0; i < n; ++i)
+            pairs.emplace_back(i * 2, i);
+        btree_map<int, int> m(sorted_unique, pairs.begin(), pairs.end());
+        CHECK(m.size() == static_cast<size_t>(n));
+        bool found = true;
+        for (int i = 0; i < n; ++i)
+            found &= m.contains(i * 2) && !m.contains(i * 2 + 1) && m.at(i * 2) == i;
+        CHECK(found);
+
+        // the bulk built tree takes inserts and erases as any other
+        for (int i = 0; i < n; i += 3)
+            m.erase(i * 2);
+        for (int i = 0; i < n; i += 2)
+            m.try_emplace(i * 2 + 1, -i);
+        std::map<int, int> expected;
+        for (int i = 0; i < n; ++i)
+        {
+            if (i % 3 != 0)
+                expected.emplace(i * 2, i);
+            if (i % 2 == 0)
+                expected.emplace(i * 2 + 1, -i);
+        }
+        CHECK(std::equal(m.begin(), m.end(), expected.begin(), expected.end(),
+                         [] (auto a, const auto &b) { return a.first == b.first && a.second == b.second; }));
+    }
+
+    // a non-empty tree inserts sorted input one element at a time
+    btree_map<int, int> m{{1, 1}, {10, 10}};
+    std::vector<std::pair<int, int>> more{{0, 0}, {5, 5}, {20, 20}};
+    m.insert(sorted_unique, more.begin(), more.end());
+    CHECK(m.size() == 5);
+    CHECK(m.begin()->first == 0);
+}
+
+TEST_CASE("copies, moves and compares btree maps")
+{
+    btree_map<std::string, int> m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(std::to_string(i), i);
+
+    btree_map<std::string, int> copy(m);
+    CHECK(copy == m);
+    copy["0"] = -1;
+    CHECK(!(copy == m));
+    CHECK(m.at("0") == 0);
+
+    btree_map<std::string, int> moved(std::move(copy));
+    CHECK(copy.empty());
+    CHECK(moved.size() == 1000);
+
+    copy = m;
+    CHECK(copy == m);
+    moved = std::move(copy);
+    CHECK(moved == m);
+    moved.clear();
+    CHECK(moved.empty());
+    CHECK(moved.begin() == moved.end());
+
+    swap(moved, m);
+    CHECK(m.empty());
+    CHECK(moved.size() == 1000);
+}
+
+TEST_CASE("failed inserts leave a btree_map unchanged")
+{
+    btree_map<int, test_throwing_value> m;
+    for (int i = 0; i < 1000; ++i)
+        m.try_emplace(i * 10, i);
+    const size_t height = m.height();
+
+    // into a leaf with room, into a full leaf and at the end
+    for (int key : {5, 15, 9995, 10000})
+    {
+        test_throwing_value::constructions_left = 0;
+        CHECK_THROWS_AS(m.try_emplace(key, 1), std::runtime_error);
+        test_throwing_value::constructions_left = -1;
+    }
+    CHECK(m.size() == 1000);
+    CHECK(m.height() == height);
+    bool intact = true;
+    int next    = 0;
+    for (auto [key, value] : m)
+    {
+        intact &= key == next * 10 && value.value_ == next;
+        ++next;
+    }
+    CHECK(intact);
+
+    std::vector<std::pair<int, int>> pairs{{1, 1}, {2, 2}, {3, 3}};
+    btree_map<int, test_throwing_value> built;
+    test_throwing_value::constructions_left = 2;
+    CHECK_THROWS_AS(built.insert(sorted_unique, pairs.begin(), pairs.end()), std::runtime_error);
+    test_throwing_value::constructions_left = -1;
+    CHECK(built.empty());
+}
+
+TEST_CASE_TEMPLATE("vector searched nodes agree with std::set", T, int8_t, uint8_t, int16_t, uint16_t, int32_t, uint32_t,
+                   int64_t, uint64_t, float, double)
+{
+    btree_set<T> s;
+    std::set<T> expected;
+    uint64_t state = 7;
+    for (int i = 0; i < 3000; ++i)
+    {
+        // spread over the whole range, so that the sign bits of signed and unsigned keys differ
+        const T key = static_cast<T>(static_cast<int64_t>(test_next(state) << 33 | test_next(state)) >> (64 - 8 * sizeof(T)));
+        s.insert(key);
+        expected.insert(key);
+    }
+    CHECK(s.size() == expected.size());
+    bool same = true;
+    state     = 8;
+    for (int i = 0; i < 3000; ++i)
+    {
+        const T key = static_cast<T>(static_cast<int64_t>(test_next(state) << 33 | test_next(state)) >> (64 - 8 * sizeof(T)));
+        auto lower  = expected.lower_bound(key);
+        auto upper  = expected.upper_bound(key);
+        same &= lower == expected.end() ? s.lower_bound(key) == s.end() : *s.lower_bound(key) == *lower;
+        same &= upper == expected.end() ? s.upper_bound(key) == s.end() : *s.upper_bound(key) == *upper;
+        same &= s.contains(key) == (expected.count(key) != 0);
+    }
+    CHECK(same);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,454 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.ConcurrentQueue.cpp
+
+Abstract:
+    Test Bounded Lock Free Queues.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("ConcurrentQueue");
+
+TEST_CASE("spsc_queue keeps head and tail on separate cache lines")
+{
+    using queue = dstl::spsc_queue<int, 16>;
+    CHECK(alignof(queue) >= dstl::detail::cache_line_size);
+    CHECK(sizeof(queue) >= 3 * dstl::detail::cache_line_size);
+    CHECK(queue::capacity() == 16);
+}
+
+TEST_CASE("spsc_queue pushes until full and pops in order")
+{
+    dstl::spsc_queue<int, 4> q;
+    CHECK(q.empty());
+
+    for (int i = 0; i < 4; ++i)
+        CHECK(q.try_push(i));
+    CHECK(!q.try_push(4));
+    CHECK(q.size() == 4);
+
+    int value = -1;
+    for (int i = 0; i < 4; ++i)
+    {
+        REQUIRE(q.try_pop(value));
+        CHECK(value == i);
+    }
+    CHECK(!q.try_pop(value));
+    CHECK(q.empty());
+
+    // indices keep growing past the capacity
+    for (int round = 0; round < 10; ++round)
+    {
+        CHECK(q.try_emplace(round));
+        REQUIRE(q.try_pop(value));
+        CHECK(value == round);
+    }
+}
+
+TEST_CASE("spsc_queue batches wrap around the end of the buffer")
+{
+    dstl::spsc_queue<uint32_t, 8> q;
+    uint32_t in[8];
+    uint32_t out[8];
+    for (uint32_t i = 0; i < 8; ++i)
+        in[i] = i + 100;
+
+    // move the indices to the middle of the buffer
+    CHECK(q.push_n(in, 5) == 5);
+    CHECK(q.pop_n(out, 5) == 5);
+
+    CHECK(q.push_n(in, 8) == 8);
+    CHECK(q.push_n(in, 1) == 0);
+    CHECK(q.pop_n(out, 3) == 3);
+    CHECK(out[0] == 100);
+    CHECK(out[2] == 102);
+
+    // only three slots are free
+    CHECK(q.push_n(in, 8) == 3);
+    CHECK(q.pop_n(out, 8) == 8);
+    for (uint32_t i = 0; i < 5; ++i)
+        CHECK(out[i] == i + 103);
+    for (uint32_t i = 0; i < 3; ++i)
+        CHECK(out[5 + i] == i + 100);
+    CHECK(q.pop_n(out, 8) == 0);
+}
+
+TEST_CASE("spsc_queue batches and destroys non-trivial elements")
+{
+    auto counter = std::make_shared<int>(0);
+    std::shared_ptr<int> in[6];
+    for (auto &p : in)
+        p = counter;
+    {
+        dstl::spsc_queue<std::shared_ptr<int>, 8> q;
+        CHECK(q.push_n(in, 6) == 6);
+        CHECK(counter.use_count() == 13);
+
+        std::shared_ptr<int> out[4];
+        CHECK(q.pop_n(out, 4) == 4);
+        CHECK(counter.use_count() == 13);
+        for (auto &p : out)
+            p.reset();
+        CHECK(counter.use_count() == 9);
+
+        CHECK(q.push_n(in, 6) == 6);
+        CHECK(counter.use_count() == 15);
+    }
+    // the queue destroys the eight elements it still holds
+    CHECK(counter.use_count() == 7);
+
+    dstl::spsc_queue<std::string, 4> q;
+    CHECK(q.try_push(std::string(40, 'a')));
+    CHECK(q.try_emplace(3, 'b'));
+    std::string value;
+    REQUIRE(q.try_pop(value));
+    CHECK(value == std::string(40, 'a'));
+    REQUIRE(q.try_pop(value));
+    CHECK(value == "bbb");
+}
+
+// counts live instances, its assignment throws on request
+struct test_throwing_assign
+{
+    static inline int live_         = 0;
+    static inline int assigns_left_ = -1;
+
+    int value_ = 0;
+
+    test_throwing_assign () { ++live_; }
+    explicit test_throwing_assign (int value) : value_(value) { ++live_; }
+    test_throwing_assign (const test_throwing_assign &other) : value_(other.value_) { ++live_; }
+    ~test_throwing_assign () { --live_; }
+
+    test_throwing_assign &operator= (test_throwing_assign &&other)
+    {
+        if (assigns_left_ == 0)
+            throw std::runtime_error("assign");
+        if (assigns_left_ > 0)
+            --assigns_left_;
+        value_ = other.value_;
+        return *this;
+    }
+};
+
+TEST_CASE("spsc_queue pop_n keeps the elements it did not hand out when an assignment throws")
+{
+    test_throwing_assign::live_ = 0;
+    {
+        dstl::spsc_queue<test_throwing_assign, 8> q;
+        for (int i = 0; i < 6; ++i)
+            CHECK(q.try_push(test_throwing_assign(i)));
+        CHECK(test_throwing_assign::live_ == 6);
+
+        test_throwing_assign out[6];
+        test_throwing_assign::assigns_left_ = 2;
+        CHECK_THROWS_AS(q.pop_n(out, 6), std::runtime_error);
+        test_throwing_assign::assigns_left_ = -1;
+
+        // the two popped elements are gone, the third is still at the head
+        CHECK(q.size() == 4);
+        CHECK(out[1].value_ == 1);
+        CHECK(test_throwing_assign::live_ == 6 + 4);
+        CHECK(q.pop_n(out, 6) == 4);
+        CHECK(out[0].value_ == 2);
+        CHECK(out[3].value_ == 5);
+        CHECK(test_throwing_assign::live_ == 6);
+
+        CHECK(q.try_push(test_throwing_assign(7)));
+    }
+    // the queue destroys the element it still holds, and only that one
+    CHECK(test_throwing_assign::live_ == 0);
+}
+
+TEST_CASE("spsc_queue hands every element from one thread to another in order")
+{
+    constexpr uint64_t count = 200000;
+    dstl::spsc_queue<uint64_t, 256> q;
+
+    std::thread producer([&q] {
+        uint64_t batch[32];
+        uint64_t next = 0;
+        while (next < count)
+        {
+            size_t pushed = 0;
+            if (next % 3 == 0)
+                pushed = q.try_push(next) ? 1 : 0;
+            else
+            {
+                size_t n = count - next < 32 ? size_t(count - next) : 32;
+                for (size_t i = 0; i < n; ++i)
+                    batch[i] = next + i;
+                pushed = q.push_n(batch, n);
+            }
+            if (pushed == 0)
+                std::this_thread::yield();
+            next += pushed;
+        }
+    });
+
+    uint64_t expected = 0;
+    bool in_order = true;
+    uint64_t batch[24];
+    while (expected < count)
+    {
+        size_t n = q.pop_n(batch, expected % 2 ? 1 : 24);
+        if (n == 0)
+            std::this_thread::yield();
+        for (size_t i = 0; i < n; ++i)
+            in_order &= batch[i] == expected++;
+    }
+    producer.join();
+
+    CHECK(in_order);
+    CHECK(q.empty());
+}
+
+namespace
+{
+    // may throw when moved, so mpmc_queue keeps it in a box
+    struct test_throwing_move
+    {
+        int value_;
+
+        explicit test_throwing_move (int value = 0) : value_(value)
+        {
+            if (value < 0)
+                throw std::invalid_argument("negative");
+        }
+        test_throwing_move (const test_throwing_move &) = default;
+        test_throwing_move (test_throwing_move &&other) : value_(other.value_) {}
+        test_throwing_move &operator= (const test_throwing_move &) = default;
+    };
+
+    // moves without throwing but may throw when constructed from an int
+    struct test_throwing_construct
+    {
+        int value_ = 0;
+
+        test_throwing_construct () = default;
+        explicit test_throwing_construct (int value) : value_(value)
+        {
+            if (value < 0)
+                throw std::invalid_argument("negative");
+        }
+    };
+}
+
+TEST_CASE("mpmc_queue picks the slot layout from the element type")
+{
+    CHECK(dstl::mpmc_queue<uint64_t>::stores_inline);
+    CHECK(dstl::mpmc_queue<std::string>::stores_inline);
+    CHECK(!dstl::mpmc_queue<test_throwing_move>::stores_inline);
+
+    // 16 byte slots, four to a cache line
+    CHECK(dstl::mpmc_queue<uint64_t>::slots_per_line == 4);
+    CHECK(dstl::mpmc_queue<int>::slots_per_line == 4);
+    struct large
+    {
+        char bytes_[100];
+    };
+    CHECK(dstl::mpmc_queue<large>::slots_per_line == 1);
+    CHECK(dstl::mpmc_queue<test_throwing_move>::slots_per_line == 4);
+
+    CHECK(dstl::mpmc_queue<int>(5).capacity() == 8);
+    CHECK(dstl::mpmc_queue<int>(100).capacity() == 128);
+    CHECK(dstl::mpmc_queue<int>(0).capacity() == 8);
+    CHECK_THROWS_AS(dstl::mpmc_queue<int>(~size_t(0)), std::length_error);
+}
+
+TEST_CASE("mpmc_queue pushes until full and pops in order")
+{
+    dstl::mpmc_queue<int> q(8);
+    CHECK(q.empty());
+    for (int i = 0; i < 8; ++i)
+        CHECK(q.try_push(i));
+    CHECK(!q.try_push(8));
+    CHECK(q.size() == 8);
+
+    int value = -1;
+    for (int i = 0; i < 8; ++i)
+    {
+        REQUIRE(q.try_pop(value));
+        CHECK(value == i);
+    }
+    CHECK(!q.try_pop(value));
+
+    // many laps around the ring
+    bool in_order = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        in_order &= q.try_emplace(i) && q.try_emplace(i + 1);
+        in_order &= q.try_pop(value) && value == i;
+        in_order &= q.try_pop(value) && value == i + 1;
+    }
+    CHECK(in_order);
+    CHECK(q.empty());
+}
+
+TEST_CASE("mpmc_queue destroys the values it still holds")
+{
+    auto counter = std::make_shared<int>(0);
+    {
+        dstl::mpmc_queue<std::shared_ptr<int>> q(4);
+        for (int i = 0; i < 3; ++i)
+            CHECK(q.try_push(counter));
+        std::shared_ptr<int> value;
+        REQUIRE(q.try_pop(value));
+        CHECK(counter.use_count() == 4);
+    }
+    CHECK(counter.use_count() == 1);
+
+    dstl::mpmc_queue<test_throwing_move> boxed(4);
+    CHECK(boxed.try_emplace(1));
+    CHECK(boxed.try_emplace(2));
+}
+
+TEST_CASE("mpmc_queue stays usable when constructing a value throws")
+{
+    dstl::mpmc_queue<test_throwing_move> boxed(8);
+    CHECK(boxed.try_emplace(1));
+    CHECK_THROWS_AS(boxed.try_emplace(-1), std::invalid_argument);
+    CHECK(boxed.try_emplace(2));
+
+    // the slot claimed by the failed push is skipped
+    test_throwing_move value;
+    REQUIRE(boxed.try_pop(value));
+    CHECK(value.value_ == 1);
+    REQUIRE(boxed.try_pop(value));
+    CHECK(value.value_ == 2);
+    CHECK(!boxed.try_pop(value));
+
+    dstl::mpmc_queue<test_throwing_construct> in_place(8);
+    CHECK_THROWS_AS(in_place.try_emplace(-1), std::invalid_argument);
+    CHECK(in_place.try_emplace(3));
+    test_throwing_construct constructed;
+    REQUIRE(in_place.try_pop(constructed));
+    CHECK(constructed.value_ == 3);
+    CHECK(!in_place.try_pop(constructed));
+}
+
+TEST_CASE("mpmc_queue hands every value over once across threads")
+{
+    constexpr size_t producers = 4;
+    constexpr size_t consumers = 4;
+    constexpr uint64_t per_producer = 20000;
+    dstl::mpmc_queue<uint64_t> q(64);
+
+    std::atomic<uint64_t> popped{0};
+    std::vector<std::vector<uint64_t>> seen(consumers);
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&q, p] {
+            for (uint64_t i = 0; i < per_producer;)
+            {
+                if (q.try_push(p * per_producer + i))
+                    ++i;
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (size_t c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c] {
+            uint64_t value;
+            while (popped.load(std::memory_order_relaxed) < producers * per_producer)
+            {
+                if (q.try_pop(value))
+                {
+                    seen[c].push_back(value);
+                    popped.fetch_add(1, std::memory_order_relaxed);
+                }
+                else
+                    std::this_thread::yield();
+            }
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    // every value once, and each consumer sees the values of one producer in order
+    std::vector<uint64_t> all;
+    bool in_order = true;
+    for (auto &values : seen)
+    {
+        uint64_t last[producers] = {};
+        bool first[producers]    = {true, true, true, true};
+        for (uint64_t value : values)
+        {
+            const size_t p = size_t(value / per_producer);
+            in_order &= first[p] || value > last[p];
+            first[p] = false;
+            last[p]  = value;
+        }
+        all.insert(all.end(), values.begin(), values.end());
+    }
+    std::sort(all.begin(), all.end());
+    bool all_once = all.size() == producers * per_producer;
+    for (size_t i = 0; all_once && i < all.size(); ++i)
+        all_once = all[i] == i;
+
+    CHECK(in_order);
+    CHECK(all_once);
+    CHECK(q.empty());
+}
+
+TEST_CASE("blocking_mpmc_queue waits for room and for values")
+{
+    constexpr size_t threads_per_side = 3;
+    constexpr uint64_t per_producer   = 20000;
+    dstl::blocking_mpmc_queue<uint64_t> q(8);
+
+    std::atomic<uint64_t> sum{0};
+    std::vector<std::thread> threads;
+    for (size_t p = 0; p < threads_per_side; ++p)
+    {
+        threads.emplace_back([&q] {
+            for (uint64_t i = 1; i <= per_producer; ++i)
+                q.push(i);
+        });
+    }
+    for (size_t c = 0; c < threads_per_side; ++c)
+    {
+        threads.emplace_back([&q, &sum] {
+            uint64_t local = 0;
+            uint64_t value;
+            for (uint64_t i = 0; i < per_producer; ++i)
+            {
+                q.pop(value);
+                local += value;
+            }
+            sum.fetch_add(local);
+        });
+    }
+    for (auto &t : threads)
+        t.join();
+
+    CHECK(sum.load() == threads_per_side * per_producer * (per_producer + 1) / 2);
+    CHECK(q.empty());
+
+    uint64_t value = 0;
+    CHECK(q.try_push(7));
+    CHECK(q.try_pop(value));
+    CHECK(value == 7);
+    CHECK(!q.try_pop(value));
+}
+
+TEST_SUITE_END();
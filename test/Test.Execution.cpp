@@ -0,0 +1,135 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Execution.cpp
+
+Abstract:
+    Test Execution Policies and Parallel Algorithms.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+
+#include <numeric>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("Execution");
+
+static std::vector<int64_t> test_parallel_input (size_t n)
+{
+    std::vector<int64_t> v(n);
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    for (auto &x : v)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        x = static_cast<int64_t>(state % 1000003) - 500000;
+    }
+    return v;
+}
+
+TEST_CASE("recognizes the execution policies")
+{
+    CHECK(dstl::is_execution_policy_v<dstl::execution::sequenced_policy>);
+    CHECK(dstl::is_execution_policy_v<dstl::execution::parallel_policy>);
+    CHECK(dstl::is_execution_policy_v<dstl::execution::parallel_unsequenced_policy>);
+    CHECK(!dstl::is_execution_policy_v<int>);
+}
+
+TEST_CASE("applies for_each and transform to every element under each policy")
+{
+    for (size_t n : {0u, 1u, 7u, 5000u, 100000u})
+    {
+        std::vector<int64_t> v = test_parallel_input(n);
+        std::vector<int64_t> expected(n);
+        std::transform(v.begin(), v.end(), expected.begin(), [] (int64_t x) { return x * 3 + 1; });
+
+        auto a = v;
+        auto b = v;
+        dstl::for_each(dstl::execution::seq, a.begin(), a.end(), [] (int64_t &x) { x = x * 3 + 1; });
+        dstl::for_each(dstl::execution::par, b.begin(), b.end(), [] (int64_t &x) { x = x * 3 + 1; });
+        CHECK(a == expected);
+        CHECK(b == expected);
+
+        std::vector<int64_t> out(n);
+        auto end = dstl::transform(dstl::execution::par_unseq, v.begin(), v.end(), out.begin(), [] (int64_t x) { return x * 3 + 1; });
+        CHECK(end == out.end());
+        CHECK(out == expected);
+
+        std::vector<int64_t> sums(n);
+        dstl::transform(dstl::execution::par, v.begin(), v.end(), expected.begin(), sums.begin(), std::plus<>());
+        bool summed = true;
+        for (size_t i = 0; i < n; ++i)
+            summed = summed && sums[i] == v[i] + expected[i];
+        CHECK(summed);
+
+        std::vector<int64_t> copied(n);
+        CHECK(dstl::copy(dstl::execution::par, v.begin(), v.end(), copied.begin()) == copied.end());
+        CHECK(copied == v);
+    }
+}
+
+TEST_CASE("reduces and scans like the sequential fold")
+{
+    for (size_t n : {0u, 1u, 2048u, 2049u, 100000u})
+    {
+        const std::vector<int64_t> v = test_parallel_input(n);
+        const int64_t sum            = std::accumulate(v.begin(), v.end(), int64_t(7));
+        CHECK(dstl::reduce(dstl::execution::par, v.begin(), v.end(), int64_t(7)) == sum);
+        CHECK(dstl::reduce(dstl::execution::seq, v.begin(), v.end(), int64_t(7)) == sum);
+        CHECK(dstl::reduce(dstl::execution::par, v.begin(), v.end()) == sum - 7);
+        CHECK(dstl::reduce(dstl::execution::par, v.begin(), v.end(), int64_t(-1000000000), [] (int64_t a, int64_t b) { return a > b ? a : b; }) ==
+              (n != 0 ? *std::max_element(v.begin(), v.end()) : -1000000000));
+
+        std::vector<int64_t> expected(n);
+        std::partial_sum(v.begin(), v.end(), expected.begin());
+        std::vector<int64_t> scanned(n);
+        CHECK(dstl::inclusive_scan(dstl::execution::par, v.begin(), v.end(), scanned.begin()) == scanned.end());
+        CHECK(scanned == expected);
+
+        for (auto &x : expected)
+            x += 100;
+        dstl::inclusive_scan(dstl::execution::par, v.begin(), v.end(), scanned.begin(), std::plus<>(), int64_t(100));
+        CHECK(scanned == expected);
+    }
+
+    // a non-commutative but associative fold keeps its order
+    std::vector<std::string> words;
+    for (int i = 0; i < 5000; ++i)
+        words.push_back(std::string(1, static_cast<char>('a' + i % 26)));
+    const std::string joined = std::accumulate(words.begin(), words.end(), std::string());
+    CHECK(dstl::reduce(dstl::execution::par, words.begin(), words.end(), std::string()) == joined);
+}
+
+TEST_CASE("sorts in parallel")
+{
+    for (size_t n : {0u, 1u, 100u, 16384u, 16385u, 300000u})
+    {
+        auto v        = test_parallel_input(n);
+        auto expected = v;
+        std::sort(expected.begin(), expected.end());
+        dstl::sort(dstl::execution::par, v.begin(), v.end());
+        CHECK(v == expected);
+
+        std::sort(expected.begin(), expected.end(), std::greater<>());
+        dstl::sort(dstl::execution::par, v.begin(), v.end(), [] (int64_t a, int64_t b) { return a > b; });
+        CHECK(v == expected);
+    }
+
+    std::vector<std::string> strings;
+    for (int i = 0; i < 40000; ++i)
+        strings.push_back(std::to_string((i * 7919) % 40009));
+    auto expected = strings;
+    std::sort(expected.begin(), expected.end());
+    dstl::sort(dstl::execution::par, strings.begin(), strings.end());
+    CHECK(strings == expected);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,269 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.FlatMap.cpp
+
+Abstract:
+    Test Sorted Array Map and Set.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <list>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("FlatMap");
+
+// throws from its copy constructor once armed
+struct test_throwing_copy
+{
+    static inline int copies_left = -1;
+
+    int value_ = 0;
+
+    test_throwing_copy (int value) : value_(value) {}
+
+    test_throwing_copy (const test_throwing_copy &other) : value_(other.value_)
+    {
+        if (copies_left == 0)
+            throw std::runtime_error("copy");
+        if (copies_left > 0)
+            --copies_left;
+    }
+
+    test_throwing_copy &operator= (const test_throwing_copy &) = default;
+};
+
+TEST_CASE("lower_bound and upper_bound agree with std on every position")
+{
+    for (size_t n = 0; n <= 40; ++n)
+    {
+        std::vector<int> values;
+        for (size_t i = 0; i < n; ++i)
+            values.push_back(static_cast<int>(i / 3) * 2);
+        bool all_match = true;
+        for (int key = -1; key <= static_cast<int>(n); ++key)
+        {
+            all_match &= dstl::lower_bound(values.begin(), values.end(), key) == std::lower_bound(values.begin(), values.end(), key);
+            all_match &= dstl::upper_bound(values.begin(), values.end(), key) == std::upper_bound(values.begin(), values.end(), key);
+            all_match &= dstl::lower_bound(values.rbegin(), values.rend(), key, std::greater<>()) ==
+                         std::lower_bound(values.rbegin(), values.rend(), key, std::greater<>());
+        }
+        CHECK(all_match);
+    }
+
+    std::list<int> list{1, 3, 5};
+    CHECK(*dstl::lower_bound(list.begin(), list.end(), 2) == 3);
+    CHECK(*dstl::upper_bound(list.begin(), list.end(), 3) == 5);
+}
+
+TEST_CASE("inserts, finds and erases keys of a flat_set")
+{
+    flat_set<int> s{5, 1, 3, 1, 9};
+    CHECK(s.size() == 4);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 3, 5, 9});
+
+    CHECK(s.insert(4).second);
+    CHECK(!s.insert(4).second);
+    CHECK(*s.insert(7).first == 7);
+    CHECK(s.emplace(0).second);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{0, 1, 3, 4, 5, 7, 9});
+
+    CHECK(s.contains(3));
+    CHECK(!s.contains(2));
+    CHECK(s.count(9) == 1);
+    CHECK(s.find(2) == s.end());
+    CHECK(*s.lower_bound(6) == 7);
+    CHECK(*s.upper_bound(7) == 9);
+    CHECK(s.equal_range(5).second - s.equal_range(5).first == 1);
+    CHECK(s.equal_range(6).first == s.equal_range(6).second);
+
+    CHECK(s.erase(3) == 1);
+    CHECK(s.erase(3) == 0);
+    CHECK(*s.erase(s.begin()) == 1);
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 4, 5, 7, 9});
+
+    flat_set<int, std::greater<int>> descending{1, 2, 3};
+    CHECK(*descending.begin() == 3);
+    CHECK(*descending.lower_bound(2) == 2);
+}
+
+TEST_CASE("bulk inserts merge into a flat_set")
+{
+    flat_set<int> s{10, 20, 30};
+    const std::vector<int> sorted{5, 20, 25, 40};
+    s.insert(sorted_unique, sorted.begin(), sorted.end());
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{5, 10, 20, 25, 30, 40});
+
+    // input that only extends the largest key is appended as it is
+    const std::vector<int> tail{50, 60};
+    s.insert(sorted_unique, tail.begin(), tail.end());
+    CHECK(s.size() == 8);
+    CHECK(*(s.end() - 1) == 60);
+
+    const std::vector<int> unsorted{3, 60, 3, 1, 27};
+    s.insert(unsorted.begin(), unsorted.end());
+    CHECK(std::vector<int>(s.begin(), s.end()) == std::vector<int>{1, 3, 5, 10, 20, 25, 27, 30, 40, 50, 60});
+
+    vector<int> keys = std::move(s).extract();
+    CHECK(keys.size() == 11);
+    CHECK(s.empty());
+    s.replace(std::move(keys));
+    CHECK(s.size() == 11);
+
+    flat_set<int> adopted(sorted_unique, vector<int>{1, 2, 3});
+    CHECK(adopted.contains(2));
+    CHECK(adopted == flat_set<int>{3, 2, 1});
+}
+
+TEST_CASE("bulk inserts agree with std::set")
+{
+    uint64_t state = 1;
+    flat_set<uint32_t> s;
+    std::set<uint32_t> expected;
+    for (int round = 0; round < 20; ++round)
+    {
+        std::vector<uint32_t> batch;
+        for (int i = 0; i < 50; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            batch.push_back(static_cast<uint32_t>(state >> 54));
+        }
+        s.insert(batch.begin(), batch.end());
+        expected.insert(batch.begin(), batch.end());
+    }
+    CHECK(std::vector<uint32_t>(s.begin(), s.end()) == std::vector<uint32_t>(expected.begin(), expected.end()));
+}
+
+TEST_CASE("accesses mapped values of a flat_map")
+{
+    flat_map<std::string, int> m{{"beta", 2}, {"alpha", 1}, {"beta", 3}};
+    CHECK(m.size() == 2);
+    CHECK(m.at("beta") == 2);
+    CHECK(m.keys()[0] == "alpha");
+    CHECK(m.values()[1] == 2);
+
+    m["gamma"] = 3;
+    ++m["alpha"];
+    CHECK(m.at("alpha") == 2);
+    CHECK_THROWS_AS(m.at("delta"), std::out_of_range);
+
+    CHECK(!m.try_emplace("gamma", 9).second);
+    CHECK(m.insert_or_assign("gamma", 9).first->second == 9);
+    CHECK(m.emplace("delta", 4).second);
+    CHECK(m.insert({"epsilon", 5}).second);
+    CHECK(m.size() == 5);
+
+    auto it = m.find("delta");
+    CHECK(it->first == "delta");
+    it->second = 40;
+    CHECK((*it).second == 40);
+    CHECK(m.find("zeta") == m.end());
+    CHECK(m.contains("epsilon"));
+    CHECK(m.lower_bound("c")->first == "delta");
+    CHECK(m.upper_bound("delta")->first == "epsilon");
+    CHECK(m.equal_range("beta").second - m.equal_range("beta").first == 1);
+
+    std::vector<std::string> order;
+    for (auto [key, value] : m)
+        order.push_back(key);
+    CHECK(order == std::vector<std::string>{"alpha", "beta", "delta", "epsilon", "gamma"});
+    CHECK((m.end() - 1)->first == "gamma");
+    CHECK(m.rbegin()->first == "gamma");
+    CHECK(m.begin()[2].second == 40);
+
+    CHECK(m.erase("beta") == 1);
+    CHECK(m.erase("beta") == 0);
+    CHECK(m.erase(m.begin())->first == "delta");
+    CHECK(m.erase(m.begin(), m.begin() + 2)->first == "gamma");
+    CHECK(m.size() == 1);
+
+    CHECK(std::random_access_iterator<flat_map<std::string, int>::iterator>);
+    const flat_map<std::string, int> &cm = m;
+    CHECK(cm.find("gamma")->second == 9);
+    CHECK(cm.at("gamma") == 9);
+    flat_map<std::string, int>::const_iterator cit = m.begin();
+    CHECK(cit == cm.begin());
+}
+
+TEST_CASE("builds a flat_map in bulk")
+{
+    std::vector<std::pair<int, int>> routes;
+    for (int i = 0; i < 100; ++i)
+        routes.emplace_back(i * 2, i);
+    flat_map<int, int> m(sorted_unique, routes.begin(), routes.end());
+    CHECK(m.size() == 100);
+    CHECK(m.at(198) == 99);
+
+    std::vector<std::pair<int, int>> more{{-1, -1}, {5, 5}, {6, 600}, {300, 300}};
+    m.insert(sorted_unique, more.begin(), more.end());
+    CHECK(m.size() == 103);
+    CHECK(m.at(6) == 3);
+    CHECK(m.at(5) == 5);
+    CHECK(m.begin()->first == -1);
+    CHECK(std::is_sorted(m.keys().begin(), m.keys().end()));
+
+    std::vector<std::pair<int, int>> unsorted{{7, 1}, {3, 2}, {7, 3}, {400, 4}};
+    m.insert(unsorted.begin(), unsorted.end());
+    CHECK(m.at(7) == 1);
+    CHECK(m.at(3) == 2);
+    CHECK(m.size() == 106);
+
+    // copying out of another flat_map iterates pairs of references
+    flat_map<int, int> copy(m.begin(), m.end());
+    CHECK(copy == m);
+
+    auto parts = std::move(m).extract();
+    CHECK(parts.keys_.size() == 106);
+    CHECK(parts.values_.size() == 106);
+    CHECK(m.empty());
+
+    flat_map<int, int> adopted(sorted_unique, std::move(parts.keys_), std::move(parts.values_));
+    CHECK(adopted == copy);
+    CHECK_THROWS_AS(adopted.replace(vector<int>{1, 2}, vector<int>{1}), std::invalid_argument);
+    CHECK(adopted.size() == 106);
+}
+
+TEST_CASE("failed inserts leave a flat_map unchanged")
+{
+    flat_map<int, test_throwing_copy> m;
+    for (int i = 0; i < 10; ++i)
+        m.try_emplace(i * 10, i);
+
+    test_throwing_copy::copies_left = 0;
+    const test_throwing_copy value(5);
+    CHECK_THROWS_AS(m.try_emplace(5, value), std::runtime_error);
+    test_throwing_copy::copies_left = -1;
+    CHECK(m.size() == 10);
+    CHECK(m.keys().size() == m.values().size());
+
+    // the merge copies, since test_throwing_copy may throw while moving
+    // room for the batch, so that the copies run out inside the merge and not while appending
+    std::vector<std::pair<int, test_throwing_copy>> batch{{1, 1}, {2, 2}};
+    m.reserve(20);
+    test_throwing_copy::copies_left = 5;
+    CHECK_THROWS_AS(m.insert(sorted_unique, batch.begin(), batch.end()), std::runtime_error);
+    test_throwing_copy::copies_left = -1;
+    CHECK(m.size() == 10);
+    CHECK(m.keys().size() == m.values().size());
+    bool intact = true;
+    for (int i = 0; i < 10; ++i)
+        intact &= m.at(i * 10).value_ == i;
+    CHECK(intact);
+
+    m.insert(sorted_unique, batch.begin(), batch.end());
+    CHECK(m.size() == 12);
+    CHECK(m.at(2).value_ == 2);
+}
+
+TEST_SUITE_END();
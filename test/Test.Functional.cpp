@@ -0,0 +1,261 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Functional.cpp
+
+Abstract:
+    Test Function Wrappers.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <array>
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_SUITE_BEGIN("Functional");
+
+// counts its instances and the ones allocated with new
+struct test_counted_callable
+{
+    static inline int alive       = 0;
+    static inline int allocations = 0;
+
+    int value_ = 0;
+    char padding_[40 - sizeof(int)] = {};
+
+    explicit test_counted_callable (int value) : value_(value) { ++alive; }
+    test_counted_callable (const test_counted_callable &other) : value_(other.value_) { ++alive; }
+    test_counted_callable (test_counted_callable &&other) noexcept : value_(other.value_) { ++alive; }
+    ~test_counted_callable () { --alive; }
+
+    static void *operator new (size_t size)
+    {
+        ++allocations;
+        return ::operator new(size);
+    }
+
+    static void operator delete (void *p) noexcept { ::operator delete(p); }
+
+    int operator() (int x) const { return value_ + x; }
+};
+
+// small enough for the inline buffer, but may throw while moving
+struct test_throwing_move_callable
+{
+    static inline int allocations = 0;
+
+    int value_ = 0;
+
+    explicit test_throwing_move_callable (int value) : value_(value) {}
+    test_throwing_move_callable (const test_throwing_move_callable &) = default;
+    test_throwing_move_callable (test_throwing_move_callable &&other) : value_(other.value_) {}
+
+    static void *operator new (size_t size)
+    {
+        ++allocations;
+        return ::operator new(size);
+    }
+
+    static void operator delete (void *p) noexcept { ::operator delete(p); }
+
+    int operator() (int x) const { return value_ * x; }
+};
+
+int test_square (int x) { return x * x; }
+
+struct test_point
+{
+    int x_ = 0;
+
+    int scaled (int factor) const { return x_ * factor; }
+};
+
+TEST_CASE("function keeps small callables inline and large ones on the heap")
+{
+    CHECK(sizeof(function<void()>) == detail::function_inline_size + 2 * sizeof(void *));
+
+    int base = 10;
+    const auto add_base = [&base] (int x) { return base + x; };
+    CHECK(function<int(int)>::stores_inline<decltype(add_base)>);
+    CHECK(!function<int(int)>::stores_inline<test_counted_callable>);
+    CHECK(!function<int(int)>::stores_inline<test_throwing_move_callable>);
+
+    function<int(int)> f = add_base;
+    CHECK(f);
+    CHECK(f(5) == 15);
+    base = 20;
+    CHECK(f(5) == 25);
+
+    test_throwing_move_callable::allocations = 0;
+    f = test_throwing_move_callable(3);
+    CHECK(test_throwing_move_callable::allocations == 1);
+    CHECK(f(4) == 12);
+
+    test_counted_callable::allocations = 0;
+    {
+        function<int(int)> g = test_counted_callable(7);
+        CHECK(test_counted_callable::allocations == 1);
+        CHECK(g(1) == 8);
+
+        // moving a heap callable moves the pointer
+        function<int(int)> h = std::move(g);
+        CHECK(!g);
+        CHECK(h(2) == 9);
+        CHECK(test_counted_callable::alive == 1);
+        CHECK(test_counted_callable::allocations == 1);
+
+        // copying one copies it
+        function<int(int)> copy = h;
+        CHECK(test_counted_callable::alive == 2);
+        CHECK(copy(3) == 10);
+
+        swap(copy, f);
+        CHECK(f(3) == 10);
+        CHECK(copy(4) == 12);
+    }
+    f = nullptr;
+    CHECK(test_counted_callable::alive == 0);
+}
+
+TEST_CASE("function calls functions, member pointers and converts results")
+{
+    function<int(int)> square = test_square;
+    CHECK(square(4) == 16);
+    CHECK(function<int(int)>(&test_square)(5) == 25);
+
+    function<int(const test_point &, int)> scaled = &test_point::scaled;
+    CHECK(scaled(test_point{3}, 4) == 12);
+    function<int(const test_point &)> x = &test_point::x_;
+    CHECK(x(test_point{9}) == 9);
+
+    // results convert to R, or are dropped for void
+    function<long(int)> widened = [] (int v) { return v * 2; };
+    CHECK(widened(21) == 42L);
+    int calls = 0;
+    function<void(int)> drop = [&calls] (int v) { calls += v; return v; };
+    drop(3);
+    CHECK(calls == 3);
+
+    // arguments are forwarded without copies
+    function<size_t(std::unique_ptr<int>)> take = [] (std::unique_ptr<int> p) { return static_cast<size_t>(*p); };
+    CHECK(take(std::make_unique<int>(6)) == 6);
+    function<void(std::string &)> append = [] (std::string &s) { s += "!"; };
+    std::string text = "hi";
+    append(text);
+    CHECK(text == "hi!");
+}
+
+TEST_CASE("empty function throws bad_function_call")
+{
+    function<int(int)> f;
+    CHECK(!f);
+    CHECK(f == nullptr);
+    CHECK_THROWS_AS(f(1), std::bad_function_call);
+
+    int (*null_function)(int) = nullptr;
+    function<int(int)> g = null_function;
+    CHECK(!g);
+    int test_point::*null_member = nullptr;
+    function<int(test_point &)> h = null_member;
+    CHECK(!h);
+
+    function<int(int)> copy = f;
+    CHECK(!copy);
+    copy = test_square;
+    CHECK(copy(3) == 9);
+    copy = f;
+    CHECK(!copy);
+}
+
+TEST_CASE("move_only_function holds move only callables with a chosen buffer")
+{
+    auto owner = [p = std::make_unique<int>(41)] (int x) { return *p + x; };
+    move_only_function<int(int)> f = std::move(owner);
+    CHECK(f(1) == 42);
+    CHECK((move_only_function<int(int)>::stores_inline<decltype(owner)>));
+
+    move_only_function<int(int)> g = std::move(f);
+    CHECK(!f);
+    CHECK(g(2) == 43);
+    f = std::move(g);
+    CHECK(f(3) == 44);
+    CHECK(!std::is_copy_constructible_v<move_only_function<int(int)>>);
+
+    // a larger buffer keeps the counted callable inline
+    CHECK((move_only_function<int(int), 48>::stores_inline<test_counted_callable>));
+    CHECK(sizeof(move_only_function<int(int), 48>) == 48 + 2 * sizeof(void *));
+    test_counted_callable::allocations = 0;
+    {
+        move_only_function<int(int), 48> big(std::in_place_type<test_counted_callable>, 5);
+        move_only_function<int(int), 48> moved = std::move(big);
+        CHECK(moved(1) == 6);
+        CHECK(test_counted_callable::alive == 1);
+        swap(big, moved);
+        CHECK(big(2) == 7);
+    }
+    CHECK(test_counted_callable::allocations == 0);
+    CHECK(test_counted_callable::alive == 0);
+
+    // a buffer of a single pointer still holds a lambda capturing one reference
+    int value = 3;
+    move_only_function<int(), 0> tiny = [&value] { return value; };
+    CHECK(tiny() == 3);
+
+    // callbacks of different sizes in one container
+    std::vector<move_only_function<void(std::vector<int> &)>> callbacks;
+    for (int i = 0; i < 10; ++i)
+    {
+        if (i % 3 == 0)
+            callbacks.emplace_back([p = std::make_unique<int>(i)] (std::vector<int> &out) { out.push_back(*p); });
+        else
+            callbacks.emplace_back([i, a = std::array<long, 8>{}] (std::vector<int> &out) { out.push_back(i + static_cast<int>(a[0])); });
+    }
+    std::vector<int> out;
+    for (auto &callback : callbacks)
+        callback(out);
+    CHECK(out == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9});
+}
+
+TEST_CASE("function_ref refers to callables without owning them")
+{
+    CHECK(sizeof(function_ref<void()>) == 2 * sizeof(void *));
+    CHECK(std::is_trivially_copyable_v<function_ref<int(int)>>);
+
+    int calls = 0;
+    auto count = [&calls] (int x) {
+        ++calls;
+        return x + calls;
+    };
+    function_ref<int(int)> ref = count;
+    CHECK(ref(10) == 11);
+    CHECK(ref(10) == 12);
+    CHECK(calls == 2);
+
+    const auto run = [] (function_ref<int(int)> f, int x) { return f(x); };
+    CHECK(run(test_square, 7) == 49);
+    CHECK(run(&test_square, 3) == 9);
+    CHECK(run([] (int x) { return -x; }, 5) == -5);
+
+    // refers to a wrapper, not to its callable
+    function<int(int)> f = [] (int x) { return x + 1; };
+    function_ref<long(int)> to_function = f;
+    CHECK(to_function(1) == 2L);
+    f = [] (int x) { return x + 100; };
+    CHECK(to_function(1) == 101L);
+
+    function_ref<int(int)> copy = ref;
+    copy = test_square;
+    CHECK(copy(6) == 36);
+    CHECK(ref(0) == 3);
+}
+
+TEST_SUITE_END();
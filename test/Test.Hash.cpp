@@ -0,0 +1,228 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Hash.cpp
+
+Abstract:
+    Test Hash Functions.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+
+#include <bit>
+#include <cstring>
+#include <set>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct test_hash_record
+{
+    uint64_t key_;
+    uint32_t shard_;
+    uint32_t flags_;
+    uint64_t stamp_;
+    uint64_t size_;
+    uint64_t offset_;
+
+    bool operator== (const test_hash_record &) const = default;
+};
+
+struct test_hash_padded
+{
+    char tag_;
+    int value_;
+
+    bool operator== (const test_hash_padded &) const = default;
+};
+
+// padding free, but equal whenever the ids are
+struct test_hash_keyed
+{
+    uint64_t id_;
+    uint64_t payload_;
+
+    bool operator== (const test_hash_keyed &other) const { return id_ == other.id_; }
+};
+
+template<>
+struct std::hash<test_hash_keyed>
+{
+    size_t operator() (const test_hash_keyed &k) const noexcept { return k.id_; }
+};
+
+template<>
+struct std::hash<test_hash_padded>
+{
+    size_t operator() (const test_hash_padded &p) const noexcept { return size_t(p.tag_) * 31 + size_t(p.value_); }
+};
+
+TEST_SUITE_BEGIN("Hash");
+
+TEST_CASE("hash_bytes depends on every byte, the length and the seed")
+{
+    std::vector<unsigned char> bytes(1100);
+    for (size_t i = 0; i < bytes.size(); ++i)
+        bytes[i] = static_cast<unsigned char>(i * 7 + 3);
+
+    // every prefix length, covering the short reads, the 16 and 48 byte loops and the stripe lanes
+    std::set<uint64_t> prefixes;
+    for (size_t n = 0; n <= bytes.size(); ++n)
+        prefixes.insert(dstl::hash_bytes(bytes.data(), n));
+    CHECK(prefixes.size() == bytes.size() + 1);
+
+    CHECK(dstl::hash_bytes(bytes.data(), 40) == dstl::hash_bytes(bytes.data(), 40));
+    CHECK(dstl::hash_bytes(bytes.data(), 40, 1) != dstl::hash_bytes(bytes.data(), 40, 2));
+    CHECK(dstl::hash_bytes(nullptr, 0) == dstl::hash_bytes(bytes.data(), 0));
+
+    // flipping any single input bit flips about half of the output bits
+    for (size_t n : {1, 3, 8, 13, 16, 17, 40, 48, 49, 100, 256, 257, 300, 1100})
+    {
+        const uint64_t base = dstl::hash_bytes(bytes.data(), n);
+        int flipped         = 0;
+        for (size_t bit = 0; bit < n * 8; ++bit)
+        {
+            bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+            flipped += std::popcount(base ^ dstl::hash_bytes(bytes.data(), n));
+            bytes[bit / 8] ^= static_cast<unsigned char>(1u << (bit % 8));
+        }
+        const double average = double(flipped) / double(n * 8);
+        CHECK(average > 28.0);
+        CHECK(average < 36.0);
+    }
+}
+
+TEST_CASE("vector and scalar stripe loops agree")
+{
+    std::vector<unsigned char> bytes(64 * 20);
+    uint64_t x = 1;
+    for (unsigned char &b : bytes)
+    {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        b = static_cast<unsigned char>(x >> 56);
+    }
+
+    uint64_t vector_acc[8];
+    uint64_t scalar_acc[8];
+    for (size_t i = 0; i < 8; ++i)
+        vector_acc[i] = scalar_acc[i] = dstl::detail::hash_keys.key_[i] * (i + 1);
+    for (size_t stripes : {0, 1, 5, 16})
+    {
+        dstl::detail::hash_accumulate(vector_acc, bytes.data(), stripes, dstl::detail::hash_keys.key_);
+        dstl::detail::hash_accumulate_scalar(scalar_acc, bytes.data(), stripes, dstl::detail::hash_keys.key_);
+        CHECK(std::equal(vector_acc, vector_acc + 8, scalar_acc));
+    }
+}
+
+TEST_CASE("hash_bytes128 extends hash_bytes")
+{
+    std::vector<unsigned char> bytes(2000, 0x5a);
+    std::set<uint64_t> highs;
+    for (size_t n : {0, 1, 7, 16, 100, 256, 257, 1024, 2000})
+    {
+        const dstl::hash128 h = dstl::hash_bytes128(bytes.data(), n, 9);
+        CHECK(h.low_ == dstl::hash_bytes(bytes.data(), n, 9));
+        CHECK(h.high_ != h.low_);
+        CHECK(dstl::hash_bytes128(bytes.data(), n, 10) != h);
+        highs.insert(h.high_);
+    }
+    CHECK(highs.size() == 9);
+}
+
+TEST_CASE("hash mixes integral keys and hashes bytewise comparable types as bytes")
+{
+    CHECK(dstl::is_bytewise_comparable_v<test_hash_record>);
+    CHECK(!dstl::is_bytewise_comparable_v<test_hash_padded>);
+    CHECK(!dstl::is_bytewise_comparable_v<double>);
+
+    test_hash_record record{42, 3, 1, 1000, 4096, 8192};
+    CHECK(dstl::hash<test_hash_record>()(record) == dstl::hash_bytes(&record, sizeof(record)));
+    test_hash_record other = record;
+    CHECK(dstl::hash<test_hash_record>()(other) == dstl::hash<test_hash_record>()(record));
+    other.offset_ += 1;
+    CHECK(dstl::hash<test_hash_record>()(other) != dstl::hash<test_hash_record>()(record));
+
+    CHECK(dstl::hash<uint32_t>()(12345) == dstl::detail::hash_mix(12345));
+    CHECK(dstl::hash<int>()(-1) == dstl::detail::hash_mix(~uint64_t(0)));
+    CHECK(dstl::hash<char>()('a') == dstl::detail::hash_mix('a'));
+
+    // consecutive integers spread over the low 7 bits the tables use
+    std::set<size_t> low_bits;
+    for (uint64_t i = 0; i < 128; ++i)
+        low_bits.insert(dstl::hash<uint64_t>()(i) & 0x7F);
+    CHECK(low_bits.size() > 70);
+
+    // types with padding, or with a std::hash of their own, keep using std::hash
+    test_hash_padded padded{'a', 5};
+    CHECK(dstl::hash<test_hash_padded>()(padded) == std::hash<test_hash_padded>()(padded));
+    CHECK(dstl::is_bytewise_comparable_v<test_hash_keyed>);
+    CHECK(dstl::hash<test_hash_keyed>()({1, 2}) == dstl::hash<test_hash_keyed>()({1, 3}));
+
+    CHECK(dstl::detail::is_avalanching_v<dstl::hash<test_hash_record>>);
+    CHECK(dstl::detail::is_avalanching_v<dstl::hash<long>>);
+    CHECK(dstl::detail::is_avalanching_v<dstl::hash<std::string>>);
+    CHECK(!dstl::detail::is_avalanching_v<dstl::hash<test_hash_padded>>);
+    CHECK(!dstl::detail::is_avalanching_v<std::hash<int>>);
+}
+
+TEST_CASE("hash hashes strings and string views as bytes")
+{
+    const std::string text = "the quick brown fox";
+    CHECK(dstl::hash<std::string>()(text) == dstl::hash_bytes(text.data(), text.size()));
+    CHECK(dstl::hash<std::string_view>()(text) == dstl::hash<std::string>()(text));
+    CHECK(dstl::hash<std::string>()("abc") != dstl::hash<std::string>()("abd"));
+
+    const std::u16string wide = u"wide";
+    CHECK(dstl::hash<std::u16string>()(wide) == dstl::hash_bytes(wide.data(), wide.size() * 2));
+    CHECK(dstl::hash<std::u16string_view>()(wide) == dstl::hash<std::u16string>()(wide));
+}
+
+TEST_CASE("hash_n hashes every key like hash")
+{
+    std::vector<std::string> words;
+    for (int i = 0; i < 50; ++i)
+        words.push_back(std::string(size_t(i), 'x') + std::to_string(i));
+    std::vector<size_t> hashes(words.size());
+    dstl::hash_n(words.data(), words.size(), hashes.data());
+    bool all_match = true;
+    for (size_t i = 0; i < words.size(); ++i)
+        all_match &= hashes[i] == dstl::hash<std::string>()(words[i]);
+    CHECK(all_match);
+
+    const int numbers[5] = {5, 4, 3, 2, 1};
+    size_t number_hashes[5];
+    dstl::hash_n(numbers, 5, number_hashes, std::hash<int>());
+    CHECK(number_hashes[0] == std::hash<int>()(5));
+    CHECK(number_hashes[4] == std::hash<int>()(1));
+    dstl::hash_n(numbers, 0, number_hashes);
+}
+
+TEST_CASE("hash tables take hash results that avalanche as they are")
+{
+    dstl::flat_hash_map<test_hash_record, int> map;
+    for (uint64_t i = 0; i < 1000; ++i)
+        map.emplace(test_hash_record{i, uint32_t(i % 7), 0, i * 3, 64, i * 64}, int(i));
+    CHECK(map.size() == 1000);
+
+    bool all_found = true;
+    for (uint64_t i = 0; i < 1000; ++i)
+    {
+        auto it = map.find(test_hash_record{i, uint32_t(i % 7), 0, i * 3, 64, i * 64});
+        all_found &= it != map.end() && it->second == int(i);
+    }
+    CHECK(all_found);
+    CHECK(map.find(test_hash_record{1, 1, 1, 1, 1, 1}) == map.end());
+
+    // a std::hash that ignores part of the key still finds equal keys
+    dstl::flat_hash_set<test_hash_keyed> keyed{{1, 10}, {2, 20}};
+    CHECK(keyed.find({1, 99}) != keyed.end());
+    CHECK(keyed.size() == 2);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,188 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.HashTable.cpp
+
+Abstract:
+    Test Open Addressing Hash Table.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <string>
+#include <unordered_map>
+
+TEST_SUITE_BEGIN("HashTable");
+
+// hashes every key to the same value to force long probe sequences
+struct test_colliding_hash
+{
+    size_t operator() (int) const noexcept { return 42; }
+};
+
+TEST_CASE("inserts, finds and erases keys of a flat_hash_map")
+{
+    flat_hash_map<int, int> m;
+    CHECK(m.empty());
+    CHECK(m.find(1) == m.end());
+    CHECK(m.begin() == m.end());
+
+    for (int i = 0; i < 1000; ++i)
+        CHECK(m.insert({i, i * 2}).second);
+    CHECK(m.size() == 1000);
+    CHECK(!m.insert({5, 0}).second);
+    CHECK(m.load_factor() <= m.max_load_factor());
+
+    bool found = true;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto it = m.find(i);
+        found   = found && it != m.end() && it->first == i && it->second == i * 2;
+    }
+    CHECK(found);
+    CHECK(!m.contains(1000));
+    CHECK(m.count(10) == 1);
+
+    for (int i = 0; i < 1000; i += 2)
+        CHECK(m.erase(i) == 1);
+    CHECK(m.erase(0) == 0);
+    CHECK(m.size() == 500);
+    CHECK(!m.contains(2));
+    CHECK(m.contains(3));
+
+    size_t visited = 0;
+    for (auto &kv : m)
+    {
+        CHECK(kv.first % 2 == 1);
+        ++visited;
+    }
+    CHECK(visited == 500);
+
+    m.clear();
+    CHECK(m.empty());
+    CHECK(m.begin() == m.end());
+    CHECK(!m.contains(3));
+}
+
+TEST_CASE("accesses mapped values of a flat_hash_map")
+{
+    flat_hash_map<std::string, int> m;
+    m["one"] = 1;
+    m["two"] = 2;
+    ++m["one"];
+    CHECK(m.at("one") == 2);
+    CHECK(m.at("two") == 2);
+    CHECK_THROWS_AS(m.at("three"), std::out_of_range);
+
+    CHECK(!m.try_emplace("one", 10).second);
+    CHECK(m["one"] == 2);
+    CHECK(!m.insert_or_assign("one", 10).second);
+    CHECK(m["one"] == 10);
+    CHECK(m.emplace("three", 3).second);
+    CHECK(m.size() == 3);
+}
+
+TEST_CASE("matches std::unordered_map under a random insert and erase mix")
+{
+    flat_hash_map<uint64_t, uint64_t> m;
+    std::unordered_map<uint64_t, uint64_t> ref;
+
+    uint64_t state = 0x9E3779B97F4A7C15ULL;
+    bool same      = true;
+    for (int i = 0; i < 100000; ++i)
+    {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        const uint64_t key = state % 4096;
+        if (state & 0x100)
+        {
+            m.insert_or_assign(key, state);
+            ref[key] = state;
+        }
+        else
+        {
+            same = same && m.erase(key) == ref.erase(key);
+        }
+    }
+
+    same = same && m.size() == ref.size();
+    for (const auto &kv : ref)
+    {
+        auto it = m.find(kv.first);
+        same    = same && it != m.end() && it->second == kv.second;
+    }
+    CHECK(same);
+}
+
+TEST_CASE("probes past full groups when every key collides")
+{
+    flat_hash_set<int, test_colliding_hash> s;
+    for (int i = 0; i < 100; ++i)
+        s.insert(i);
+    for (int i = 0; i < 100; i += 3)
+        s.erase(i);
+
+    bool ok = true;
+    for (int i = 0; i < 100; ++i)
+        ok = ok && s.contains(i) == (i % 3 != 0);
+    CHECK(ok);
+    CHECK(s.size() == 66);
+
+    s.rehash(0);
+    ok = true;
+    for (int i = 0; i < 100; ++i)
+        ok = ok && s.contains(i) == (i % 3 != 0);
+    CHECK(ok);
+}
+
+TEST_CASE("copies and moves a flat_hash_set")
+{
+    flat_hash_set<std::string> a{"alpha", "beta", "gamma"};
+    CHECK(a.size() == 3);
+
+    flat_hash_set<std::string> b(a);
+    CHECK(b.size() == 3);
+    CHECK(b.contains("beta"));
+
+    flat_hash_set<std::string> c(std::move(a));
+    CHECK(c.size() == 3);
+    CHECK(a.empty());
+
+    b.erase("beta");
+    c = b;
+    CHECK(c.size() == 2);
+    CHECK(!c.contains("beta"));
+
+    auto it = c.find("alpha");
+    it      = c.erase(it);
+    CHECK(c.size() == 1);
+
+    swap(a, c);
+    CHECK(a.contains("gamma"));
+    CHECK(c.empty());
+}
+
+TEST_CASE("reserves room for elements up front")
+{
+    flat_hash_map<int, double> m;
+    m.reserve(1000);
+    const size_t capacity = m.capacity();
+    CHECK(capacity >= 1000);
+    for (int i = 0; i < 1000; ++i)
+        m[i] = i;
+    CHECK(m.capacity() == capacity);
+
+    flat_hash_map<int, double> copy(m);
+    CHECK(copy.size() == 1000);
+    CHECK(copy.at(999) == 999.0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,122 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Memory.cpp
+
+Abstract:
+    Test Uninitialized Memory Algorithms.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+TEST_SUITE_BEGIN("Memory");
+
+// owns a heap allocated int, relocatable with a bitwise copy
+struct test_unique_int
+{
+    static inline int live_ = 0;
+
+    int *ptr_ = nullptr;
+
+    explicit test_unique_int (int value) : ptr_(new int(value)) { ++live_; }
+    test_unique_int (test_unique_int &&other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; ++live_; }
+    ~test_unique_int () { delete ptr_; --live_; }
+};
+
+namespace dstl
+{
+template<>
+struct is_trivially_relocatable<test_unique_int> : true_type {};
+}
+
+// same as test_unique_int, but relocated through the move constructor
+struct test_moving_int
+{
+    static inline int live_ = 0;
+
+    int *ptr_ = nullptr;
+
+    explicit test_moving_int (int value) : ptr_(new int(value)) { ++live_; }
+    test_moving_int (test_moving_int &&other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; ++live_; }
+    ~test_moving_int () { delete ptr_; --live_; }
+};
+
+template<class T>
+struct test_buffer
+{
+    alignas(T) unsigned char bytes_[sizeof(T) * 8];
+
+    T *at (size_t i) { return reinterpret_cast<T *>(bytes_) + i; }
+};
+
+TEST_CASE_TEMPLATE("relocates a range into uninitialized storage", T, test_unique_int, test_moving_int)
+{
+    T::live_ = 0;
+    test_buffer<T> src;
+    test_buffer<T> dst;
+    for (int i = 0; i < 4; ++i)
+        ::new (src.at(i)) T(i);
+
+    T *end = uninitialized_relocate(src.at(0), src.at(4), dst.at(0));
+    CHECK(end == dst.at(4));
+    CHECK(T::live_ == 4);
+    for (int i = 0; i < 4; ++i)
+        CHECK(*dst.at(i)->ptr_ == i);
+
+    relocate_at(dst.at(3), src.at(0));
+    CHECK(*src.at(0)->ptr_ == 3);
+    CHECK(T::live_ == 4);
+
+    destroy(dst.at(0), dst.at(3));
+    destroy_at(src.at(0));
+    CHECK(T::live_ == 0);
+}
+
+TEST_CASE_TEMPLATE("relocates a range within overlapping storage", T, test_unique_int, test_moving_int)
+{
+    T::live_ = 0;
+    test_buffer<T> buf;
+    for (int i = 0; i < 4; ++i)
+        ::new (buf.at(i)) T(i);
+
+    // shift right by two
+    relocate(buf.at(0), buf.at(4), buf.at(2));
+    CHECK(T::live_ == 4);
+    for (int i = 0; i < 4; ++i)
+        CHECK(*buf.at(i + 2)->ptr_ == i);
+
+    // shift left by one
+    relocate(buf.at(2), buf.at(6), buf.at(1));
+    for (int i = 0; i < 4; ++i)
+        CHECK(*buf.at(i + 1)->ptr_ == i);
+
+    destroy(buf.at(1), buf.at(5));
+    CHECK(T::live_ == 0);
+}
+
+TEST_CASE("grows a vector of trivially relocatable elements")
+{
+    test_unique_int::live_ = 0;
+    {
+        vector<test_unique_int> v;
+        for (int i = 0; i < 100; ++i)
+            v.emplace_back(i);
+        v.emplace(v.begin(), -1);
+        v.erase(v.begin() + 50);
+        CHECK(v.size() == 100);
+        CHECK(*v.front().ptr_ == -1);
+        CHECK(*v[49].ptr_ == 48);
+        CHECK(*v[50].ptr_ == 50);
+        CHECK(test_unique_int::live_ == 100);
+    }
+    CHECK(test_unique_int::live_ == 0);
+}
+
+TEST_SUITE_END();
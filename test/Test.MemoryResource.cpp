@@ -0,0 +1,169 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.MemoryResource.cpp
+
+Abstract:
+    Test Polymorphic Memory Resources.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <string>
+
+TEST_SUITE_BEGIN("MemoryResource");
+
+// forwards to new_delete_resource and counts the bytes currently held
+struct test_counting_resource : memory_resource
+{
+    size_t held_   = 0;
+    size_t blocks_ = 0;
+
+    void *do_allocate (size_t bytes, size_t alignment) override
+    {
+        held_ += bytes;
+        ++blocks_;
+        return new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate (void *ptr, size_t bytes, size_t alignment) override
+    {
+        held_ -= bytes;
+        --blocks_;
+        new_delete_resource()->deallocate(ptr, bytes, alignment);
+    }
+
+    bool do_is_equal (const memory_resource &other) const noexcept override { return this == &other; }
+};
+
+struct test_arena_object
+{
+    static inline int live_ = 0;
+
+    std::string name_;
+
+    explicit test_arena_object (std::string name) : name_(std::move(name)) { ++live_; }
+    ~test_arena_object () { --live_; }
+};
+
+TEST_CASE("bumps through chained blocks and releases them at once")
+{
+    test_counting_resource upstream;
+    {
+        monotonic_buffer_resource arena(&upstream);
+        CHECK(arena.upstream_resource() == &upstream);
+
+        char *prev = nullptr;
+        bool ok    = true;
+        for (int i = 0; i < 10000; ++i)
+        {
+            auto *p = static_cast<char *>(arena.allocate(24, 8));
+            ok      = ok && reinterpret_cast<uintptr_t>(p) % 8 == 0 && p != prev;
+            std::memset(p, i & 0xFF, 24);
+            prev = p;
+        }
+        CHECK(ok);
+        // geometric growth keeps the number of upstream blocks logarithmic
+        CHECK(upstream.blocks_ > 1);
+        CHECK(upstream.blocks_ < 16);
+
+        void *big = arena.allocate(1 << 20, 64);
+        CHECK(reinterpret_cast<uintptr_t>(big) % 64 == 0);
+
+        arena.deallocate(big, 1 << 20, 64);
+        CHECK(upstream.held_ >= (1u << 20));
+
+        arena.release();
+        CHECK(upstream.held_ == 0);
+        CHECK(upstream.blocks_ == 0);
+
+        (void) arena.allocate(16);
+        CHECK(upstream.blocks_ == 1);
+    }
+    CHECK(upstream.held_ == 0);
+}
+
+TEST_CASE("serves allocations from the initial buffer first")
+{
+    alignas(std::max_align_t) unsigned char buffer[256];
+    test_counting_resource upstream;
+    monotonic_buffer_resource arena(buffer, sizeof(buffer), &upstream);
+
+    void *a = arena.allocate(100, 1);
+    void *b = arena.allocate(100, 1);
+    CHECK(a == buffer);
+    CHECK(static_cast<unsigned char *>(b) == buffer + 100);
+    CHECK(upstream.blocks_ == 0);
+
+    (void) arena.allocate(100, 1);
+    CHECK(upstream.blocks_ == 1);
+
+    arena.release();
+    CHECK(upstream.blocks_ == 0);
+    CHECK(arena.allocate(8, 8) == buffer);
+
+    monotonic_buffer_resource empty(buffer, sizeof(buffer), null_memory_resource());
+    (void) empty.allocate(200);
+    CHECK_THROWS_AS((void) empty.allocate(200), std::bad_alloc);
+}
+
+TEST_CASE("runs the destructors of created objects on release")
+{
+    test_arena_object::live_ = 0;
+    monotonic_buffer_resource arena;
+
+    for (int i = 0; i < 100; ++i)
+        arena.create<test_arena_object>("object number " + std::to_string(i));
+    int *value = arena.create<int>(42);
+    CHECK(*value == 42);
+    CHECK(test_arena_object::live_ == 100);
+
+    arena.release();
+    CHECK(test_arena_object::live_ == 0);
+}
+
+TEST_CASE("allocates and constructs through a polymorphic_allocator")
+{
+    test_counting_resource upstream;
+    polymorphic_allocator<int> alloc(&upstream);
+    CHECK(alloc.resource() == &upstream);
+
+    int *ints = alloc.allocate(10);
+    CHECK(upstream.held_ == 10 * sizeof(int));
+    alloc.deallocate(ints, 10);
+    CHECK(upstream.held_ == 0);
+
+    polymorphic_allocator<> bytes(alloc);
+    CHECK(bytes == alloc);
+    auto *s = bytes.new_object<std::string>("text");
+    CHECK(*s == "text");
+    bytes.delete_object(s);
+    CHECK(upstream.held_ == 0);
+
+    CHECK_THROWS_AS((void) alloc.allocate(static_cast<size_t>(-1)), std::bad_array_new_length);
+    CHECK(alloc.select_on_container_copy_construction().resource() == get_default_resource());
+
+    test_counting_resource other;
+    CHECK(polymorphic_allocator<int>(&other) != alloc);
+}
+
+TEST_CASE("replaces the default resource")
+{
+    test_counting_resource upstream;
+    memory_resource *previous = set_default_resource(&upstream);
+    CHECK(previous == new_delete_resource());
+    CHECK(get_default_resource() == &upstream);
+    CHECK(polymorphic_allocator<int>().resource() == &upstream);
+
+    CHECK(set_default_resource(nullptr) == &upstream);
+    CHECK(get_default_resource() == new_delete_resource());
+}
+
+TEST_SUITE_END();
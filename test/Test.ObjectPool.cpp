@@ -0,0 +1,145 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.ObjectPool.cpp
+
+Abstract:
+    Test Object Pool and Slab Allocator.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <list>
+#include <map>
+#include <string>
+#include <thread>
+
+TEST_SUITE_BEGIN("ObjectPool");
+
+struct alignas(64) test_cache_line
+{
+    unsigned char bytes_[40];
+};
+
+struct test_pooled
+{
+    static inline std::atomic<int> live_ = 0;
+
+    std::string name_;
+
+    explicit test_pooled (std::string name) : name_(std::move(name)) { ++live_; }
+    ~test_pooled () { --live_; }
+};
+
+TEST_CASE("derives size classes from size and alignment")
+{
+    CHECK(alignment_of_v<char> == 1);
+    CHECK(alignment_of_v<double> == alignof(double));
+    CHECK(alignment_of_v<test_cache_line> == 64);
+
+    CHECK(detail::slab_class<char>::size == sizeof(detail::slab_node));
+    CHECK(detail::slab_class<char[17]>::size == 2 * sizeof(detail::slab_node));
+    CHECK(detail::slab_class<test_cache_line>::size == 64);
+    CHECK(detail::slab_class<test_cache_line>::align == 64);
+
+    // types of the same class share one pool
+    CHECK(is_same_v<detail::slab_pool_for<int>, detail::slab_pool_for<short>>);
+}
+
+TEST_CASE("creates, destroys and reuses pooled objects")
+{
+    test_pooled::live_ = 0;
+    object_pool<test_pooled> pool;
+
+    test_pooled *a = pool.create("alpha");
+    CHECK(a->name_ == "alpha");
+    CHECK(test_pooled::live_ == 1);
+
+    pool.destroy(a);
+    CHECK(test_pooled::live_ == 0);
+
+    // the thread cache hands back the slot freed last
+    test_pooled *b = pool.create("beta");
+    CHECK(b == a);
+    pool.destroy(b);
+    pool.destroy(nullptr);
+
+    object_pool<test_cache_line> aligned;
+    bool ok = true;
+    std::vector<test_cache_line *> lines;
+    for (int i = 0; i < 1000; ++i)
+    {
+        lines.push_back(aligned.create());
+        ok = ok && reinterpret_cast<uintptr_t>(lines.back()) % 64 == 0;
+    }
+    CHECK(ok);
+    std::sort(lines.begin(), lines.end());
+    CHECK(std::adjacent_find(lines.begin(), lines.end()) == lines.end());
+    for (auto *line : lines)
+        aligned.destroy(line);
+}
+
+TEST_CASE("serves node based containers through slab_allocator")
+{
+    std::map<int, std::string, std::less<int>, slab_allocator<std::pair<const int, std::string>>> m;
+    for (int i = 0; i < 10000; ++i)
+        m.emplace(i, std::to_string(i));
+    CHECK(m.size() == 10000);
+    CHECK(m.at(1234) == "1234");
+    for (int i = 0; i < 10000; i += 2)
+        m.erase(i);
+    CHECK(m.size() == 5000);
+
+    std::list<int, slab_allocator<int>> l(100, 7);
+    CHECK(l.size() == 100);
+
+    slab_allocator<int> ints;
+    int *array = ints.allocate(10);
+    ints.deallocate(array, 10);
+    CHECK(ints == slab_allocator<double>());
+}
+
+TEST_CASE("frees objects created on other threads")
+{
+    test_pooled::live_ = 0;
+    object_pool<test_pooled> pool;
+    constexpr int per_thread = 20000;
+
+    std::vector<test_pooled *> created(4 * per_thread);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < per_thread; ++i)
+                created[t * per_thread + i] = pool.create(std::to_string(i));
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    threads.clear();
+    CHECK(test_pooled::live_ == 4 * per_thread);
+
+    // each thread frees objects made by its neighbour
+    for (int t = 0; t < 4; ++t)
+    {
+        threads.emplace_back([&, t] {
+            const int from = (t + 1) % 4;
+            for (int i = 0; i < per_thread; ++i)
+                pool.destroy(created[from * per_thread + i]);
+            for (int i = 0; i < per_thread; ++i)
+                pool.destroy(pool.create("churn"));
+        });
+    }
+    for (auto &thread : threads)
+        thread.join();
+    CHECK(test_pooled::live_ == 0);
+}
+
+TEST_SUITE_END();
@@ -0,0 +1,97 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Perf.cpp
+
+Abstract:
+    Test Hardware Performance Counters.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+TEST_SUITE_BEGIN("Perf");
+
+static uint64_t test_spin (uint64_t rounds)
+{
+    volatile uint64_t acc = 0;
+    for (uint64_t i = 0; i < rounds; ++i)
+        acc = acc + i;
+    return acc;
+}
+
+TEST_CASE("counts a scope with or without hardware events")
+{
+    perf_counter counter;
+    {
+        perf_scope scope(counter);
+        test_spin(1000000);
+    }
+
+    const perf_sample first = counter.read();
+    CHECK(first.nanoseconds_ > 0);
+    // a multiplexed group that was never scheduled reports a sample without hardware events
+    CHECK((!first.hardware_ || counter.hardware()));
+    if (first.hardware_)
+    {
+        if (counter.available(perf_counter::instructions))
+            CHECK(first.instructions_ >= 1000000);
+        if (counter.available(perf_counter::cycles) && counter.available(perf_counter::instructions))
+            CHECK(first.ipc() > 0.0);
+    }
+    else
+    {
+        CHECK(first.instructions_ == 0);
+        CHECK(first.cache_misses_ == 0);
+        CHECK(first.branch_misses_ == 0);
+    }
+
+    // nothing is counted outside of start and stop
+    test_spin(1000000);
+    CHECK(counter.read().nanoseconds_ == first.nanoseconds_);
+
+    // counts accumulate until reset
+    {
+        perf_scope scope(counter);
+        test_spin(1000000);
+    }
+    CHECK(counter.read().nanoseconds_ > first.nanoseconds_);
+
+    counter.reset();
+    const perf_sample cleared = counter.read();
+    CHECK(cleared.nanoseconds_ == 0);
+    CHECK(cleared.cycles_ == 0);
+    CHECK(cleared.instructions_ == 0);
+}
+
+TEST_CASE("sums samples")
+{
+    perf_sample a;
+    a.cycles_       = 100;
+    a.instructions_ = 250;
+    perf_sample b;
+    b.cycles_       = 100;
+    b.instructions_ = 150;
+    b.hardware_     = true;
+
+    a += b;
+    CHECK(a.cycles_ == 200);
+    CHECK(a.instructions_ == 400);
+    CHECK(a.hardware_);
+    CHECK(a.ipc() == doctest::Approx(2.0));
+    CHECK(perf_sample{}.ipc() == 0.0);
+
+    // time stamp counter ticks make no instructions per cycle
+    perf_sample ticks;
+    ticks.cycles_       = 100;
+    ticks.instructions_ = 300;
+    CHECK(ticks.ipc() == 0.0);
+}
+
+TEST_SUITE_END();
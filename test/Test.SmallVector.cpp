@@ -0,0 +1,164 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.SmallVector.cpp
+
+Abstract:
+    Test Small Vector.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <string>
+
+TEST_SUITE_BEGIN("SmallVector");
+
+template<class V>
+static bool test_small_values_are (const V &v, std::initializer_list<int> expected)
+{
+    return v.size() == expected.size() && std::equal(v.begin(), v.end(), expected.begin());
+}
+
+TEST_CASE("fits small_vector<int, 8> into one cache line")
+{
+    CHECK(sizeof(small_vector<int, 8>) <= 64);
+    CHECK(sizeof(small_vector<int, 8>) == sizeof(void *) + 8 + 8 * sizeof(int));
+    CHECK(alignof(small_vector<double, 4>) == alignof(double *));
+}
+
+TEST_CASE("keeps elements inline until they spill to the heap")
+{
+    small_vector<int, 4> v;
+    CHECK(v.empty());
+    CHECK(v.is_inline());
+    CHECK(v.capacity() == 4);
+
+    for (int i = 0; i < 4; ++i)
+        v.push_back(i);
+    CHECK(v.is_inline());
+    CHECK(test_small_values_are(v, {0, 1, 2, 3}));
+
+    v.push_back(v[0]);
+    CHECK(!v.is_inline());
+    CHECK(v.capacity() == 8);
+    CHECK(test_small_values_are(v, {0, 1, 2, 3, 0}));
+
+    v.erase(v.begin(), v.begin() + 2);
+    v.shrink_to_fit();
+    CHECK(v.is_inline());
+    CHECK(test_small_values_are(v, {2, 3, 0}));
+
+    v.insert(v.begin() + 1, 2, 9);
+    CHECK(test_small_values_are(v, {2, 9, 9, 3, 0}));
+    v.insert(v.begin(), {7, 8});
+    CHECK(test_small_values_are(v, {7, 8, 2, 9, 9, 3, 0}));
+    v.emplace(v.end() - 1, 5);
+    CHECK(test_small_values_are(v, {7, 8, 2, 9, 9, 3, 5, 0}));
+
+    v.resize(2);
+    CHECK(test_small_values_are(v, {7, 8}));
+    v.resize(4, 1);
+    CHECK(test_small_values_are(v, {7, 8, 1, 1}));
+    v.pop_back();
+    CHECK(v.back() == 1);
+    CHECK_THROWS_AS(v.at(3), std::out_of_range);
+
+    small_vector<int, 4> reserved;
+    reserved.reserve(4);
+    reserved.resize(3);
+    CHECK(reserved.is_inline());
+
+    // a capacity past 32 bits is refused instead of truncated
+    CHECK(small_vector<int, 4>::max_size() == static_cast<uint32_t>(-1));
+    CHECK_THROWS_AS(reserved.reserve(size_t(small_vector<int, 4>::max_size()) + 1), std::length_error);
+    CHECK(reserved.is_inline());
+    CHECK(reserved.capacity() == 4);
+}
+
+TEST_CASE_TEMPLATE("copies, moves and swaps inline and heap storage", V, small_vector<int, 4>, small_vector<std::string, 4>)
+{
+    using T   = typename V::value_type;
+    auto make = [] (int first, int count) {
+        V v;
+        for (int i = 0; i < count; ++i)
+        {
+            if constexpr (is_same_v<T, int>)
+                v.push_back(first + i);
+            else
+                v.push_back(std::to_string(first + i) + " is long enough to defeat the string sso");
+        }
+        return v;
+    };
+
+    for (int a_count : {0, 3, 4, 9})
+    {
+        for (int b_count : {0, 2, 6})
+        {
+            const V a_ref = make(0, a_count);
+            const V b_ref = make(100, b_count);
+
+            V a(a_ref);
+            V b(b_ref);
+            CHECK(a == a_ref);
+            CHECK(a.is_inline() == (a_count <= 4));
+
+            swap(a, b);
+            CHECK(a == b_ref);
+            CHECK(b == a_ref);
+            CHECK(a.is_inline() == (b_count <= 4));
+
+            V moved(std::move(a));
+            CHECK(moved == b_ref);
+            CHECK(a.empty());
+            CHECK(a.is_inline());
+
+            a = std::move(b);
+            CHECK(a == a_ref);
+            b = a;
+            CHECK(b == a_ref);
+            b = moved;
+            CHECK(b == b_ref);
+        }
+    }
+}
+
+TEST_CASE("destroys every non-trivial element")
+{
+    static int live = 0;
+    struct counted
+    {
+        int value_;
+        explicit counted (int value) : value_(value) { ++live; }
+        counted (const counted &other) : value_(other.value_) { ++live; }
+        counted (counted &&other) noexcept : value_(other.value_) { ++live; }
+        ~counted () { --live; }
+        counted &operator= (const counted &) = default;
+        counted &operator= (counted &&) noexcept = default;
+    };
+
+    {
+        small_vector<counted, 2> v;
+        for (int i = 0; i < 10; ++i)
+            v.emplace_back(i);
+        v.emplace(v.begin(), -1);
+        v.erase(v.begin() + 3);
+        CHECK(live == 10);
+        CHECK(v[0].value_ == -1);
+        CHECK(v[3].value_ == 3);
+
+        small_vector<counted, 2> w(v);
+        CHECK(live == 20);
+        w.clear();
+        CHECK(live == 10);
+    }
+    CHECK(live == 0);
+}
+
+TEST_SUITE_END();
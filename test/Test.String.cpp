@@ -0,0 +1,447 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.String.cpp
+
+Abstract:
+    Test String.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+
+TEST_SUITE_BEGIN("String");
+
+// characters of s widened to CharT
+template<class CharT>
+std::basic_string<CharT> widen (std::string_view s)
+{
+    return std::basic_string<CharT>(s.begin(), s.end());
+}
+
+TEST_CASE("keeps short strings inline in three words")
+{
+    CHECK(sizeof(string) == 3 * sizeof(void *));
+    CHECK(sizeof(u16string) == 3 * sizeof(void *));
+    CHECK(sizeof(u32string) == 3 * sizeof(void *));
+
+    const size_t inline_chars = 3 * sizeof(void *) - 1;
+    string s;
+    CHECK(s.empty());
+    CHECK(s.capacity() == inline_chars);
+    CHECK(*s.c_str() == '\0');
+
+    // a full inline string ends at the byte that held its remaining room
+    const std::string full(inline_chars, 'x');
+    s = full.c_str();
+    CHECK(s.size() == inline_chars);
+    CHECK(s.capacity() == inline_chars);
+    CHECK(std::string_view(s.c_str()) == full);
+    CHECK(reinterpret_cast<const char *>(&s) == s.data());
+
+    s.push_back('y');
+    CHECK(s.size() == inline_chars + 1);
+    CHECK(s.capacity() > inline_chars);
+    CHECK(std::string_view(s.c_str()) == full + 'y');
+
+    s.pop_back();
+    s.shrink_to_fit();
+    CHECK(s.capacity() == inline_chars);
+    CHECK(std::string_view(s) == full);
+
+    u16string w(u"eleven char");
+    CHECK(w.size() == 11);
+    CHECK(w.capacity() == 3 * sizeof(void *) / 2 - 1);
+    CHECK(w.c_str()[11] == 0);
+}
+
+TEST_CASE("copies, moves and swaps short and long strings")
+{
+    const string small("short");
+    const string large("a string much too long to be kept inline");
+
+    string a = small;
+    string b = large;
+    CHECK(a == small);
+    CHECK(b == large);
+    CHECK(b.data() != large.data());
+
+    string c = std::move(b);
+    CHECK(c == large);
+    CHECK(b.empty());
+
+    a = large;
+    c = small;
+    CHECK(a == large);
+    CHECK(c == small);
+
+    a.swap(c);
+    CHECK(a == small);
+    CHECK(c == large);
+
+    a = std::move(c);
+    CHECK(a == large);
+    a = a;
+    CHECK(a == large);
+}
+
+TEST_CASE("relocates into a growing vector with memcpy")
+{
+    CHECK(is_trivially_relocatable_v<string>);
+    CHECK(is_trivially_relocatable_v<u32string>);
+
+    // the buffers of long strings stay where they are, short strings are copied whole
+    vector<string> v;
+    std::vector<const char *> buffers;
+    for (int i = 0; i < 200; ++i)
+    {
+        v.push_back(i % 2 == 0 ? string(std::to_string(i)) : string(48, static_cast<char>('a' + i % 26)));
+        buffers.push_back(v.back().data());
+    }
+    CHECK(v.capacity() > 1);
+    bool kept = true;
+    for (int i = 0; i < 200; ++i)
+    {
+        if (i % 2 == 0)
+            kept = kept && v[i] == std::to_string(i).c_str();
+        else
+            kept = kept && v[i] == string(48, static_cast<char>('a' + i % 26)) && v[i].data() == buffers[i];
+    }
+    CHECK(kept);
+}
+
+TEST_CASE("appends, inserts and erases like std::string")
+{
+    uint64_t state = 7;
+    string s;
+    std::string expected;
+    for (int round = 0; round < 2000; ++round)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const size_t op    = (state >> 33) % 6;
+        const size_t count = (state >> 40) % 20;
+        const char ch      = static_cast<char>('a' + (state >> 50) % 26);
+        const size_t pos   = expected.empty() ? 0 : (state >> 20) % (expected.size() + 1);
+        switch (op)
+        {
+        case 0:
+            s.append(count, ch);
+            expected.append(count, ch);
+            break;
+        case 1:
+            s.push_back(ch);
+            expected.push_back(ch);
+            break;
+        case 2:
+            s.insert(pos, std::string(count, ch));
+            expected.insert(pos, std::string(count, ch));
+            break;
+        case 3:
+            s.erase(pos, count);
+            expected.erase(pos, count);
+            break;
+        case 4:
+            s.resize(count * 3, ch);
+            expected.resize(count * 3, ch);
+            break;
+        default:
+            // parts of the string itself
+            s.append(s.data() + pos, expected.size() - pos);
+            expected.append(expected.data() + pos, expected.size() - pos);
+            s.insert(0, s.data() + pos / 2, count < expected.size() - pos / 2 ? count : 0);
+            expected.insert(0, expected.data() + pos / 2, count < expected.size() - pos / 2 ? count : 0);
+            break;
+        }
+        if (std::string_view(s) != expected || s.c_str()[s.size()] != '\0')
+        {
+            FAIL_CHECK("string diverged in round " << round);
+            break;
+        }
+        if (expected.size() > 200)
+        {
+            s.erase(100);
+            expected.erase(100);
+        }
+    }
+
+    CHECK_THROWS_AS(s.at(s.size()), std::out_of_range);
+    CHECK_THROWS_AS(s.insert(s.size() + 1, "x"), std::out_of_range);
+    CHECK_THROWS_AS(s.substr(s.size() + 1), std::out_of_range);
+    CHECK_THROWS_AS(s.reserve(string::max_size() + 1), std::length_error);
+}
+
+TEST_CASE("resize_and_overwrite hands out the new characters unfilled")
+{
+    string s("prefix-");
+    s.resize_and_overwrite(64, [] (char *p, size_t count) {
+        CHECK(std::string_view(p, 7) == "prefix-");
+        for (size_t i = 7; i < count; ++i)
+            p[i] = static_cast<char>('0' + i % 10);
+        return count - 4;
+    });
+    CHECK(s.size() == 60);
+    CHECK(s.starts_with("prefix-789"));
+    CHECK(s.c_str()[60] == '\0');
+
+    s.resize_and_overwrite(3, [] (char *, size_t count) { return count; });
+    CHECK(s == "pre");
+}
+
+TEST_CASE_TEMPLATE("finds characters and substrings like std::string", CharT, char, char8_t, char16_t, char32_t, wchar_t)
+{
+    using str = basic_string<CharT>;
+    using std_str = std::basic_string<CharT>;
+
+    // long enough for several vectors, with matches near the ends
+    std::string text;
+    for (int i = 0; i < 40; ++i)
+        text += "the quick brown fox jumps over the lazy dog ";
+    text += "!end";
+
+    const std_str expected = widen<CharT>(text);
+    const str s(expected.data(), expected.size());
+
+    const char *needles[] = {"", "t", "!", "dog", "lazy dog ", "!end", "fox jumps over the lazy dog the", "zzz", "end!"};
+    bool all_match = true;
+    for (const char *needle : needles)
+    {
+        const std_str n = widen<CharT>(needle);
+        for (size_t pos : {size_t(0), size_t(1), size_t(45), expected.size() - 3, expected.size(), expected.size() + 1})
+        {
+            all_match &= s.find(n, pos) == expected.find(n, pos);
+            all_match &= s.rfind(n, pos) == expected.rfind(n, pos);
+            all_match &= s.find_first_of(n, pos) == expected.find_first_of(n, pos);
+            all_match &= s.find_last_of(n, pos) == expected.find_last_of(n, pos);
+            all_match &= s.find_first_not_of(n, pos) == expected.find_first_not_of(n, pos);
+            if (!n.empty())
+                all_match &= s.find(n[0], pos) == expected.find(n[0], pos);
+        }
+    }
+    CHECK(all_match);
+
+    // sets past the vector limit, for a single byte they go through a table
+    const std_str many = widen<CharT>("!@#$%^&*()xyz");
+    CHECK(s.find_first_of(many) == expected.find_first_of(many));
+    CHECK(s.find_first_of(many, 100) == expected.find_first_of(many, 100));
+    CHECK(s.contains(widen<CharT>("jumps")));
+    CHECK(!s.contains(widen<CharT>("jumped")));
+    CHECK(s.ends_with(widen<CharT>("!end")));
+}
+
+TEST_CASE_TEMPLATE("compares like std::string", CharT, char, char16_t, char32_t)
+{
+    using str = basic_string<CharT>;
+
+    // a difference at every position, in both directions, with unsigned order for high characters
+    const std::basic_string<CharT> base = widen<CharT>("abcdefghijklmnopqrstuvwxyz0123456789ABCDEFGHIJ");
+    const str s(base.data(), base.size());
+    bool all_match = true;
+    for (size_t i = 0; i < base.size(); ++i)
+    {
+        for (CharT ch : {CharT(0), CharT('a'), static_cast<CharT>(-1)})
+        {
+            std::basic_string<CharT> other = base;
+            other[i] = ch;
+            const str t(other.data(), other.size());
+            const int expected = base.compare(other);
+            all_match &= (s.compare(t) < 0) == (expected < 0) && (s.compare(t) > 0) == (expected > 0);
+            all_match &= (s == t) == (base == other);
+            all_match &= (s < t) == (base < other);
+        }
+        const str prefix(base.data(), i);
+        all_match &= prefix < s && s > prefix && prefix != s;
+    }
+    CHECK(all_match);
+}
+
+TEST_CASE("concatenates and converts to views")
+{
+    const string a("hello");
+    const string b(", world");
+    CHECK(a + b == "hello, world");
+    CHECK(a + std::string_view("!") == "hello!");
+    CHECK(std::string_view("> ") + a == "> hello");
+    CHECK(string("x") + std::string_view("y") == "xy");
+
+    string s = a;
+    s += ' ';
+    s += "there";
+    s += std::string_view(", and more text to move it to the heap");
+    CHECK(s == "hello there, and more text to move it to the heap");
+    CHECK(s.substr(6, 5) == "there");
+    CHECK(s.substr(6, 5).size() == 5);
+
+    const std::vector<char> chars{'a', 'b', 'c'};
+    CHECK(string(chars.begin(), chars.end()) == "abc");
+    CHECK(string(3, 'z') == "zzz");
+    CHECK(string{'o', 'k'} == "ok");
+
+    std::string_view view = s;
+    CHECK(view.size() == s.size());
+    CHECK(std::string(s.begin(), s.end()) == view);
+}
+
+TEST_CASE("hashes like its view")
+{
+    const string s("a key of some length");
+    CHECK(hash<string>()(s) == hash<std::string_view>()(std::string_view(s)));
+    CHECK(hash<u16string>()(u16string(u"key")) == hash<std::u16string_view>()(u"key"));
+    CHECK(detail::is_avalanching_v<hash<string>>);
+}
+
+// char traits that compare letters regardless of case, which the vector kernels do not know of
+struct test_case_insensitive_traits : std::char_traits<char>
+{
+    static char fold (char ch) noexcept { return ch >= 'A' && ch <= 'Z' ? static_cast<char>(ch - 'A' + 'a') : ch; }
+    static bool eq (char a, char b) noexcept { return fold(a) == fold(b); }
+    static bool lt (char a, char b) noexcept { return static_cast<unsigned char>(fold(a)) < static_cast<unsigned char>(fold(b)); }
+
+    static int compare (const char *a, const char *b, size_t n) noexcept
+    {
+        for (size_t i = 0; i < n; ++i)
+            if (!eq(a[i], b[i]))
+                return lt(a[i], b[i]) ? -1 : 1;
+        return 0;
+    }
+
+    static const char *find (const char *p, size_t n, char ch) noexcept
+    {
+        for (size_t i = 0; i < n; ++i)
+            if (eq(p[i], ch))
+                return p + i;
+        return nullptr;
+    }
+};
+
+TEST_CASE_TEMPLATE("string_view finds needles of every length like std::string_view", CharT, char, char16_t, char32_t)
+{
+    // texts over two and three letters are full of periodic needles and near misses
+    uint64_t state = 11;
+    bool all_match = true;
+    for (int round = 0; round < 300; ++round)
+    {
+        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+        const size_t letters = 2 + (state >> 60) % 2;
+        const size_t n       = (state >> 20) % 400;
+        std::basic_string<CharT> text;
+        for (size_t i = 0; i < n; ++i)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            text += static_cast<CharT>('a' + (state >> 40) % letters);
+        }
+
+        for (int k = 0; k < 8; ++k)
+        {
+            state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+            const size_t m = (state >> 30) % 80;
+            std::basic_string<CharT> needle;
+            if (n != 0 && k % 2 == 0 && m <= n)
+                needle = text.substr((state >> 10) % (n - m + 1), m);
+            else
+                for (size_t i = 0; i < m; ++i)
+                    needle += static_cast<CharT>('a' + (state >> (i % 40)) % letters);
+
+            const std::basic_string_view<CharT> expected(text);
+            const basic_string_view<CharT> view(text);
+            const size_t pos = n == 0 ? 0 : (state >> 50) % n;
+            all_match &= view.find(needle) == expected.find(needle);
+            all_match &= view.find(needle, pos) == expected.find(needle, pos);
+            all_match &= basic_searcher<CharT>(needle).find(view, pos) == expected.find(needle, pos);
+            // other traits take the two-way algorithm for short needles too
+            if constexpr (std::is_same_v<CharT, char>)
+            {
+                const basic_string_view<char, test_case_insensitive_traits> folded(text.data(), text.size());
+                all_match &= folded.find(needle.data(), pos, needle.size()) == expected.find(needle, pos);
+            }
+        }
+    }
+    CHECK(all_match);
+}
+
+TEST_CASE("string_view searches long periodic needles in linear time")
+{
+    // a naive search compares every needle character at every position here
+    const std::string text(1 << 20, 'a');
+    const std::string needle = std::string(1000, 'a') + 'b';
+    CHECK(string_view(text).find(needle) == string_view::npos);
+    CHECK(string_view(text + needle).find(needle) == text.size());
+
+    const std::string periodic = "abaabaabaabaabaabaabaabaabaabaabaabaabaab";
+    const std::string haystack = std::string(5000, 'x') + "abaabaabaaba" + periodic + "yy";
+    CHECK(string_view(haystack).find(periodic) == haystack.find(periodic));
+}
+
+TEST_CASE("string_view works wherever std::string_view does")
+{
+    const string_view view("key=value; other=thing");
+    CHECK(view.find('=') == 3);
+    CHECK(view.find("other") == 11);
+    CHECK(view.find("other", 12) == string_view::npos);
+    CHECK(view.find("", 22) == 22);
+    CHECK(view.find("", 23) == string_view::npos);
+    CHECK(view.find("valueX", 0, 5) == 4);
+    CHECK(view.contains("thing"));
+    CHECK(!view.contains('#'));
+    CHECK(view.substr(4, 5) == "value");
+    CHECK(view.substr(4).find(';') == 5);
+    CHECK(view.starts_with("key"));
+
+    // converts from and to the standard views and strings
+    const std::string_view plain = view;
+    CHECK(plain.size() == view.size());
+    const string owned("a string that lives on the heap");
+    const string_view from_string = owned;
+    CHECK(from_string.find("heap") == owned.find("heap"));
+    const std::string std_owned(owned.begin(), owned.end());
+    CHECK(string_view(std_owned).find("lives") == 14);
+    CHECK(hash<string_view>()(view) == hash<std::string_view>()(plain));
+
+    const basic_string_view<char, test_case_insensitive_traits> folded("Content-Type: TEXT/plain");
+    CHECK(folded.find("text/PLAIN") == 14);
+    CHECK(folded.find('t') == 3);
+    CHECK(folded.find("content-type: text/plain; charset") == folded.npos);
+}
+
+TEST_CASE("searcher finds a needle repeatedly and with std::search")
+{
+    const std::string needle = "connection refused by the remote host while reading";
+    const searcher find_refused(needle);
+    CHECK(find_refused.needle() == needle);
+
+    std::vector<std::string> lines;
+    for (int i = 0; i < 50; ++i)
+        lines.push_back(std::string(i * 3, '.') + (i % 7 == 0 ? needle : "connection reset") + " at line " + std::to_string(i));
+
+    size_t hits = 0;
+    bool all_match = true;
+    for (const std::string &line : lines)
+    {
+        const size_t found = find_refused.find(line);
+        all_match &= found == line.find(needle);
+        hits += found != searcher::npos;
+    }
+    CHECK(all_match);
+    CHECK(hits == 8);
+
+    const std::string &line = lines[14];
+    const auto it = std::search(line.begin(), line.end(), find_refused);
+    CHECK(static_cast<size_t>(it - line.begin()) == line.find(needle));
+    CHECK(std::search(lines[1].begin(), lines[1].end(), find_refused) == lines[1].end());
+
+    const searcher empty("");
+    CHECK(empty.find("abc", 2) == 2);
+    CHECK(std::search(line.begin(), line.end(), empty) == line.begin());
+}
+
+TEST_SUITE_END();
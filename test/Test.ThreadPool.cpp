@@ -0,0 +1,212 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.ThreadPool.cpp
+
+Abstract:
+    Test Work Stealing Thread Pool.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_SUITE_BEGIN("ThreadPool");
+
+TEST_CASE("keeps small callables in place and moves large ones to the heap")
+{
+    int calls = 0;
+    auto small = [&calls] { ++calls; };
+    struct
+    {
+        int *calls_;
+        char padding_[128];
+        void operator() () const { ++*calls_; }
+    } large{&calls, {}};
+
+    CHECK(dstl::detail::task::stores_inline<decltype(small)>);
+    CHECK(!dstl::detail::task::stores_inline<decltype(large)>);
+
+    dstl::detail::task a(small);
+    dstl::detail::task b(large);
+    dstl::detail::task moved(std::move(b));
+    CHECK(!b);
+    a();
+    moved();
+    a = std::move(moved);
+    a();
+    CHECK(calls == 3);
+
+    // the captured state is destroyed with the task
+    auto owned = std::make_shared<int>(0);
+    {
+        dstl::detail::task c([owned] { ++*owned; });
+        c();
+        CHECK(owned.use_count() == 2);
+    }
+    CHECK(owned.use_count() == 1);
+    CHECK(*owned == 1);
+}
+
+TEST_CASE("pops the newest job and steals the oldest from the deque")
+{
+    dstl::detail::work_deque deque;
+    std::vector<dstl::detail::pool_job> jobs(1000);
+    for (auto &job : jobs)
+        deque.push(&job);
+
+    bool contended = false;
+    CHECK(deque.pop() == &jobs[999]);
+    CHECK(deque.steal(contended) == &jobs[0]);
+    CHECK(deque.steal(contended) == &jobs[1]);
+    CHECK(!contended);
+
+    size_t left = 0;
+    while (deque.pop() != nullptr)
+        ++left;
+    CHECK(left == 997);
+    CHECK(deque.empty());
+    CHECK(deque.pop() == nullptr);
+    CHECK(deque.steal(contended) == nullptr);
+}
+
+TEST_CASE("hands every job to exactly one thread under contention")
+{
+    constexpr size_t count = 100000;
+    dstl::detail::work_deque deque;
+    std::vector<dstl::detail::pool_job> jobs(count);
+    std::vector<std::atomic<int>> taken(count);
+    std::atomic<bool> done{false};
+
+    auto take = [&] (dstl::detail::pool_job *job) { taken[static_cast<size_t>(job - jobs.data())].fetch_add(1); };
+    std::vector<std::thread> thieves;
+    for (int i = 0; i < 3; ++i)
+    {
+        thieves.emplace_back([&] {
+            while (!done.load())
+            {
+                bool contended = false;
+                if (auto *job = deque.steal(contended))
+                    take(job);
+            }
+        });
+    }
+
+    // the owner pushes in bursts and pops some of its own jobs in between
+    for (size_t i = 0; i < count; ++i)
+    {
+        deque.push(&jobs[i]);
+        if (i % 3 == 0)
+        {
+            if (auto *job = deque.pop())
+                take(job);
+        }
+    }
+    while (auto *job = deque.pop())
+        take(job);
+    done.store(true);
+    for (auto &thief : thieves)
+        thief.join();
+
+    bool once = true;
+    for (auto &t : taken)
+        once = once && t.load() == 1;
+    CHECK(once);
+}
+
+TEST_CASE("returns results and exceptions through futures")
+{
+    dstl::thread_pool pool(3);
+    CHECK(pool.size() == 3);
+    CHECK(pool.concurrency() == 4);
+
+    std::vector<dstl::future<int>> futures;
+    for (int i = 0; i < 1000; ++i)
+        futures.push_back(pool.submit([i] { return i * i; }));
+    long long sum = 0;
+    for (auto &f : futures)
+        sum += f.get();
+    CHECK(sum == 332833500);
+    CHECK(!futures[0].valid());
+
+    auto text = pool.submit([] { return std::string(100, 'x'); });
+    CHECK(text.get() == std::string(100, 'x'));
+
+    std::atomic<int> ran{0};
+    auto nothing = pool.submit([&ran] { ran.fetch_add(1); });
+    nothing.wait();
+    CHECK(nothing.ready());
+    nothing.get();
+    CHECK(ran.load() == 1);
+
+    auto failing = pool.submit([] () -> int { throw std::runtime_error("job failed"); });
+    CHECK_THROWS_AS(failing.get(), std::runtime_error);
+
+    // a future dropped before its job ran
+    {
+        auto dropped = pool.submit([] { return std::make_unique<int>(7); });
+    }
+}
+
+TEST_CASE("waits for nested jobs without deadlocking the workers")
+{
+    dstl::thread_pool pool(2);
+
+    // every job submits more jobs and waits for them, far more than there are workers
+    std::function<long long(int)> fib = [&] (int n) -> long long {
+        if (n < 2)
+            return n;
+        auto left = pool.submit([&fib, n] { return fib(n - 1); });
+        long long right = fib(n - 2);
+        return left.get() + right;
+    };
+    CHECK(pool.submit([&fib] { return fib(18); }).get() == 2584);
+}
+
+TEST_CASE("runs jobs on the waiting thread when the pool has no workers")
+{
+    dstl::thread_pool pool(0);
+    CHECK(pool.concurrency() == 1);
+    auto f = pool.submit([] { return 42; });
+    CHECK(f.get() == 42);
+
+    // the destructor runs what is still pending
+    std::atomic<int> ran{0};
+    {
+        dstl::thread_pool idle(0);
+        auto ignored = idle.submit([&ran] { ran.fetch_add(1); });
+    }
+    CHECK(ran.load() == 1);
+}
+
+TEST_CASE("accepts jobs from many threads at once")
+{
+    dstl::thread_pool pool(4);
+    std::atomic<long long> total{0};
+    std::vector<std::thread> producers;
+    for (int t = 0; t < 4; ++t)
+    {
+        producers.emplace_back([&pool, &total, t] {
+            std::vector<dstl::future<int>> futures;
+            for (int i = 0; i < 2000; ++i)
+                futures.push_back(pool.submit([t, i] { return t * 10000 + i; }));
+            for (auto &f : futures)
+                total.fetch_add(f.get());
+        });
+    }
+    for (auto &producer : producers)
+        producer.join();
+    CHECK(total.load() == 4 * 1999000LL + 2000LL * 10000 * (0 + 1 + 2 + 3));
+}
+
+TEST_SUITE_END();
@@ -26,6 +26,57 @@ struct test_struct
     double f_;
 };
 
+struct test_throwing_conversion
+{
+    operator int () const { return 0; }
+};
+
+struct test_invocable_member
+{
+    double value_;
+    int twice (int x) const { return x * 2; }
+};
+
+struct test_throwing_move
+{
+    explicit test_throwing_move (int) noexcept {}
+    test_throwing_move (const test_throwing_move &) noexcept = default;
+    test_throwing_move (test_throwing_move &&) {}
+};
+
+struct test_swappable
+{
+    friend void swap (test_swappable &, test_swappable &) noexcept {}
+    friend void swap (test_swappable &, int &) {}
+    friend void swap (int &, test_swappable &) {}
+};
+
+struct test_immovable
+{
+    test_immovable ()                                   = default;
+    test_immovable (const test_immovable &)            = delete;
+    test_immovable &operator= (const test_immovable &) = delete;
+};
+
+struct test_padded
+{
+    char c_;
+    int i_;
+};
+
+struct test_virtual_base {};
+struct test_virtual_derived : virtual test_virtual_base {};
+struct test_standard_layout_derived : test_empty_struct
+{
+    int i_;
+};
+
+struct test_common_base {};
+struct test_common_derived : test_common_base {};
+
+enum test_unscoped_enum : short { test_unscoped_value };
+enum class test_scoped_enum : unsigned char { value };
+
 union test_union
 {
     int i_;
@@ -453,6 +504,159 @@ TEST_CASE("checks if a type is a aggregate type")
     CHECK(!is_aggregate_v<test_derived_class>);
 }
 
+TEST_CASE("checks if a type is a signed or an unsigned arithmetic type")
+{
+    CHECK(is_signed_v<int>);
+    CHECK(is_signed_v<const long long>);
+    CHECK(is_signed_v<double>);
+    CHECK(!is_signed_v<unsigned>);
+    CHECK(!is_signed_v<test_unscoped_enum>);
+    CHECK(!is_signed_v<int *>);
+
+    CHECK(is_unsigned_v<unsigned char>);
+    CHECK(is_unsigned_v<bool>);
+    CHECK(!is_unsigned_v<float>);
+    CHECK(!is_unsigned_v<test_scoped_enum>);
+    CHECK(!is_unsigned_v<void>);
+}
+
+TEST_CASE("checks if a type is a scoped enumeration type")
+{
+    CHECK(is_scoped_enum_v<test_scoped_enum>);
+    CHECK(!is_scoped_enum_v<test_unscoped_enum>);
+    CHECK(!is_scoped_enum_v<int>);
+    CHECK(!is_scoped_enum_v<test_class>);
+}
+
+TEST_CASE("checks if a type has a constructor for specific arguments")
+{
+    CHECK(is_constructible_v<int, long>);
+    CHECK(is_constructible_v<test_struct, int, double>);
+    CHECK(!is_constructible_v<test_struct, int, double, int>);
+    CHECK(is_constructible_v<test_throwing_move, int>);
+    CHECK(!is_constructible_v<test_throwing_move, int *>);
+    CHECK(!is_convertible_v<int, test_throwing_move>);
+    CHECK(!is_constructible_v<void>);
+    CHECK(!is_constructible_v<int[]>);
+    CHECK(!is_constructible_v<test_base_interface>);
+    CHECK(is_constructible_v<const int &, int>);
+    CHECK(!is_constructible_v<int &, int>);
+    CHECK(is_constructible_v<test_base_class &, test_derived_class &>);
+    CHECK(!is_constructible_v<int &, int &, int &>);
+
+    CHECK(is_default_constructible_v<test_struct>);
+    CHECK(!is_default_constructible_v<test_throwing_move>);
+    CHECK(!is_default_constructible_v<int &>);
+    CHECK(is_copy_constructible_v<test_throwing_move>);
+    CHECK(is_move_constructible_v<test_throwing_move>);
+    CHECK(!is_copy_constructible_v<void>);
+}
+
+TEST_CASE("checks if a type has a non-throwing constructor for specific arguments")
+{
+    CHECK(is_nothrow_constructible_v<int, long>);
+    CHECK(is_nothrow_constructible_v<test_throwing_move, int>);
+    CHECK(!is_nothrow_constructible_v<test_throwing_move, int *>);
+    CHECK(is_nothrow_constructible_v<const int &, int>);
+    CHECK(!is_nothrow_constructible_v<int, test_throwing_conversion>);
+    CHECK(is_nothrow_default_constructible_v<test_struct>);
+    CHECK(is_nothrow_copy_constructible_v<test_throwing_move>);
+    CHECK(!is_nothrow_move_constructible_v<test_throwing_move>);
+    CHECK(is_nothrow_move_constructible_v<test_struct>);
+    CHECK(is_nothrow_move_constructible_v<int &>);
+}
+
+TEST_CASE("checks if a type has a trivial constructor for specific arguments")
+{
+    CHECK(is_trivially_constructible_v<test_struct, const test_struct &>);
+    CHECK(is_trivially_default_constructible_v<test_struct>);
+    CHECK(!is_trivially_default_constructible_v<test_class>);
+    CHECK(is_trivially_copy_constructible_v<int>);
+    CHECK(is_trivially_move_constructible_v<test_struct>);
+    CHECK(!is_trivially_move_constructible_v<test_throwing_move>);
+    CHECK(!is_trivially_copy_constructible_v<test_base_class>);
+}
+
+TEST_CASE("checks if a type has an assignment operator for a specific argument")
+{
+    CHECK(is_assignable_v<int &, long>);
+    CHECK(!is_assignable_v<int, int>);
+    CHECK(!is_assignable_v<const int &, int>);
+    CHECK(is_assignable_v<test_struct &, test_struct>);
+    CHECK(!is_assignable_v<test_struct &, int>);
+
+    CHECK(is_copy_assignable_v<test_class>);
+    CHECK(!is_copy_assignable_v<test_immovable>);
+    CHECK(!is_copy_assignable_v<void>);
+    CHECK(is_move_assignable_v<test_base_class>);
+    CHECK(!is_move_assignable_v<const int>);
+
+    CHECK(is_trivially_assignable_v<int &, int>);
+    CHECK(is_trivially_copy_assignable_v<test_struct>);
+    CHECK(!is_trivially_copy_assignable_v<test_base_class>);
+    CHECK(is_trivially_move_assignable_v<int *>);
+
+    CHECK(is_nothrow_assignable_v<int &, double>);
+    CHECK(!is_nothrow_assignable_v<int &, test_throwing_conversion>);
+    CHECK(is_nothrow_copy_assignable_v<test_struct>);
+    CHECK(is_nothrow_move_assignable_v<test_class>);
+    CHECK(!is_nothrow_move_assignable_v<test_immovable>);
+}
+
+TEST_CASE("checks if objects of a type can be swapped with objects of same or different type")
+{
+    CHECK(is_swappable_v<int>);
+    CHECK(is_swappable_v<test_struct[3]>);
+    CHECK(!is_swappable_v<const int>);
+    CHECK(!is_swappable_v<void>);
+    CHECK(!is_swappable_v<test_immovable>);
+    CHECK(is_swappable_with_v<test_swappable &, int &>);
+    CHECK(!is_swappable_with_v<test_swappable &, long &>);
+    CHECK(!is_swappable_with_v<int, int>);
+
+    CHECK(is_nothrow_swappable_v<int>);
+    CHECK(is_nothrow_swappable_v<test_swappable>);
+    CHECK(!is_nothrow_swappable_with_v<test_swappable &, int &>);
+}
+
+TEST_CASE("checks destructor and object representation properties")
+{
+    struct throwing_destructor
+    {
+        ~throwing_destructor () noexcept(false) {}
+    };
+    CHECK(is_nothrow_destructible_v<int>);
+    CHECK(is_nothrow_destructible_v<test_class[2]>);
+    CHECK(is_nothrow_destructible_v<int &>);
+    CHECK(!is_nothrow_destructible_v<throwing_destructor>);
+    CHECK(!is_nothrow_destructible_v<void>);
+    CHECK(!is_nothrow_destructible_v<int[]>);
+
+    CHECK(has_virtual_destructor_v<test_base_class>);
+    CHECK(has_virtual_destructor_v<test_derived_class>);
+    CHECK(!has_virtual_destructor_v<test_class>);
+
+    CHECK(has_unique_object_representations_v<int>);
+    CHECK(has_unique_object_representations_v<int[4]>);
+    CHECK(has_unique_object_representations_v<test_scoped_enum>);
+    CHECK(!has_unique_object_representations_v<test_padded>);
+    CHECK(!has_unique_object_representations_v<float>);
+}
+
+TEST_CASE("checks if a reference is bound to a temporary")
+{
+    CHECK(reference_constructs_from_temporary_v<const int &, int>);
+    CHECK(reference_constructs_from_temporary_v<int &&, int>);
+    CHECK(reference_constructs_from_temporary_v<const long &, int &>);
+    CHECK(!reference_constructs_from_temporary_v<const int &, int &>);
+    CHECK(!reference_constructs_from_temporary_v<const test_base_class &, test_derived_class &>);
+    CHECK(!reference_constructs_from_temporary_v<int &, int>);
+    CHECK(!reference_constructs_from_temporary_v<int, int>);
+
+    CHECK(reference_converts_from_temporary_v<const int &, short>);
+    CHECK(!reference_converts_from_temporary_v<const int &, const int &>);
+}
+
 TEST_CASE("obtains the number of dimensions of a array type")
 {
     CHECK(rank<int>{} == 0);
@@ -477,6 +681,22 @@ TEST_CASE("checks if two types are the same")
     CHECK(!is_same_v<int, double>);
 }
 
+TEST_CASE("checks relations between class layouts")
+{
+    CHECK(is_virtual_base_of_v<test_virtual_base, test_virtual_derived>);
+    CHECK(!is_virtual_base_of_v<test_base_class, test_derived_class>);
+    CHECK(!is_virtual_base_of_v<test_virtual_base, test_virtual_base>);
+    CHECK(!is_virtual_base_of_v<int, int>);
+
+    CHECK(is_layout_compatible_v<test_struct, const test_struct>);
+    CHECK(!is_layout_compatible_v<int, unsigned>);
+
+    CHECK(is_pointer_interconvertible_base_of_v<test_empty_struct, test_standard_layout_derived>);
+    CHECK(is_pointer_interconvertible_base_of_v<test_struct, test_struct>);
+    CHECK(!is_pointer_interconvertible_base_of_v<test_virtual_base, test_virtual_derived>);
+    CHECK(!is_pointer_interconvertible_base_of_v<int, int>);
+}
+
 TEST_CASE("removes const and/or volatile specifiers from the given type")
 {
     CHECK(is_same_v<remove_cv_t<int>, int>);
@@ -496,6 +716,53 @@ TEST_CASE("checks if a type is a base of the other type")
     CHECK(!is_base_of_v<test_base_class, test_derived_interface>);
 }
 
+TEST_CASE("checks if a type can be implicitly converted to another type")
+{
+    CHECK(is_convertible_v<int, long>);
+    CHECK(is_convertible_v<test_derived_class *, test_base_class *>);
+    CHECK(!is_convertible_v<test_base_class *, test_derived_class *>);
+    CHECK(is_convertible_v<void, void>);
+    CHECK(!is_convertible_v<int, void>);
+    CHECK(!is_convertible_v<int, int[2]>);
+    CHECK(is_convertible_v<int (&)[2], int *>);
+
+    CHECK(is_nothrow_convertible_v<int, double>);
+    CHECK(!is_nothrow_convertible_v<test_throwing_conversion, int>);
+    CHECK(is_convertible_v<test_throwing_conversion, int>);
+}
+
+TEST_CASE("checks if a type can be invoked with the given argument types")
+{
+    auto lambda = [] (int x) noexcept { return x * 2; };
+    CHECK(is_invocable_v<decltype(lambda), int>);
+    CHECK(!is_invocable_v<decltype(lambda), int *>);
+    CHECK(is_nothrow_invocable_v<decltype(lambda), short>);
+    CHECK(is_same_v<invoke_result_t<decltype(lambda), int>, int>);
+
+    CHECK(is_invocable_v<int (*)(double), float>);
+    CHECK(!is_nothrow_invocable_v<int (*)(double), float>);
+    CHECK(is_invocable_v<int (&)()>);
+
+    CHECK(is_invocable_r_v<long, int (*)()>);
+    CHECK(is_invocable_r_v<void, int (*)()>);
+    CHECK(!is_invocable_r_v<int *, int (*)()>);
+    CHECK(is_nothrow_invocable_r_v<long, decltype(lambda), int>);
+    CHECK(!is_nothrow_invocable_r_v<int, decltype(lambda) &, test_throwing_conversion>);
+
+    // pointers to members apply to objects, references, pointers and reference_wrappers
+    using member_fn   = int (test_invocable_member::*)(int) const;
+    using member_data = double test_invocable_member::*;
+    CHECK(is_invocable_v<member_fn, const test_invocable_member &, int>);
+    CHECK(is_invocable_v<member_fn, test_invocable_member *, int>);
+    CHECK(is_invocable_v<member_fn, std::reference_wrapper<test_invocable_member>, int>);
+    CHECK(!is_invocable_v<member_fn, test_invocable_member &>);
+    CHECK(!is_invocable_v<member_fn, int *, int>);
+    CHECK(is_same_v<invoke_result_t<member_data, test_invocable_member &>, double &>);
+    CHECK(is_same_v<invoke_result_t<member_data, test_invocable_member &&>, double &&>);
+    CHECK(is_same_v<invoke_result_t<member_data, const test_invocable_member *>, const double &>);
+    CHECK(!is_invocable_v<member_data, test_invocable_member &, int>);
+}
+
 TEST_CASE("adds const and/or volatile specifiers to the given type")
 {
     CHECK(is_same_v<add_const_t<int>, const int>);
@@ -518,6 +785,24 @@ TEST_CASE("adds a lvalue or rvalue reference to the given type")
     CHECK(is_reference_v<void_ref> == false);
 }
 
+TEST_CASE("obtains the corresponding signed or unsigned integral type")
+{
+    CHECK(is_same_v<make_signed_t<unsigned>, int>);
+    CHECK(is_same_v<make_signed_t<const unsigned char>, const signed char>);
+    CHECK(is_same_v<make_signed_t<char>, signed char>);
+    CHECK(is_same_v<make_signed_t<long>, long>);
+    CHECK(is_same_v<make_signed_t<volatile unsigned long long>, volatile long long>);
+    CHECK(is_same_v<make_signed_t<test_unscoped_enum>, short>);
+    CHECK(sizeof(make_signed_t<wchar_t>) == sizeof(wchar_t));
+
+    CHECK(is_same_v<make_unsigned_t<int>, unsigned>);
+    CHECK(is_same_v<make_unsigned_t<const volatile short>, const volatile unsigned short>);
+    CHECK(is_same_v<make_unsigned_t<unsigned long>, unsigned long>);
+    CHECK(is_same_v<make_unsigned_t<long long>, unsigned long long>);
+    CHECK(is_same_v<make_unsigned_t<test_scoped_enum>, unsigned char>);
+    CHECK(is_same_v<make_unsigned_t<char32_t>, unsigned>);
+}
+
 TEST_CASE("removes extent from the given array type")
 {
     float a0;
@@ -593,6 +878,56 @@ bool test_enable_if ()
     return true;
 }
 
+template<class, class = void>
+inline constexpr bool test_has_common_type = false;
+template<class T>
+inline constexpr bool test_has_common_type<T, void_t<typename T::type>> = true;
+
+TEST_CASE("determines the common type of a group of types")
+{
+    CHECK(is_same_v<common_type_t<int>, int>);
+    CHECK(is_same_v<common_type_t<const int &>, int>);
+    CHECK(is_same_v<common_type_t<int, long, short>, long>);
+    CHECK(is_same_v<common_type_t<int, double>, double>);
+    CHECK(is_same_v<common_type_t<char, unsigned char>, int>);
+    CHECK(is_same_v<common_type_t<test_derived_class *, test_base_class *>, test_base_class *>);
+    CHECK(is_same_v<common_type_t<int (&)[2], const int *>, const int *>);
+    CHECK(is_same_v<common_type_t<void, void>, void>);
+    CHECK(!test_has_common_type<common_type<>>);
+    CHECK(!test_has_common_type<common_type<int, test_struct>>);
+    CHECK(!test_has_common_type<common_type<int, int *, long>>);
+}
+
+TEST_CASE("determines the common reference type of a group of types")
+{
+    CHECK(is_same_v<common_reference_t<int &>, int &>);
+    CHECK(is_same_v<common_reference_t<int &, const int &>, const int &>);
+    CHECK(is_same_v<common_reference_t<int &&, const int &>, const int &>);
+    CHECK(is_same_v<common_reference_t<int &&, int &&>, int &&>);
+    CHECK(is_same_v<common_reference_t<int &&, const int &&>, const int &&>);
+    CHECK(is_same_v<common_reference_t<test_common_derived &, test_common_base &>, test_common_base &>);
+    CHECK(is_same_v<common_reference_t<int &, long>, long>);
+    CHECK(is_same_v<common_reference_t<int, short>, int>);
+    CHECK(is_same_v<common_reference_t<int &, int &, const int &>, const int &>);
+    CHECK(!test_has_common_type<common_reference<int &, test_struct &>>);
+}
+
+TEST_CASE("obtains the underlying integer type for a given enumeration type")
+{
+    CHECK(is_same_v<underlying_type_t<test_unscoped_enum>, short>);
+    CHECK(is_same_v<underlying_type_t<test_scoped_enum>, unsigned char>);
+    CHECK(!test_has_common_type<underlying_type<int>>);
+}
+
+TEST_CASE("gets the referenced type wrapped in reference_wrapper")
+{
+    CHECK(is_same_v<unwrap_reference_t<int>, int>);
+    CHECK(is_same_v<unwrap_reference_t<std::reference_wrapper<int>>, int &>);
+    CHECK(is_same_v<unwrap_reference_t<const std::reference_wrapper<int>>, const std::reference_wrapper<int>>);
+    CHECK(is_same_v<unwrap_ref_decay_t<const std::reference_wrapper<int> &>, int &>);
+    CHECK(is_same_v<unwrap_ref_decay_t<const int &>, int>);
+}
+
 TEST_CASE("conditionally removes a function overload or template specialization from overload resolution")
 {
     CHECK(test_enable_if<int>());
@@ -623,4 +958,35 @@ TEST_CASE("checks if a type is trivial")
     CHECK(!is_trivial_v<test_class>);
 }
 
+struct test_relocatable_owner
+{
+    int *ptr_ = nullptr;
+
+    test_relocatable_owner () = default;
+    test_relocatable_owner (test_relocatable_owner &&other) noexcept : ptr_(other.ptr_) { other.ptr_ = nullptr; }
+    ~test_relocatable_owner () { delete ptr_; }
+};
+
+namespace dstl
+{
+template<>
+struct is_trivially_relocatable<test_relocatable_owner> : true_type {};
+}
+
+TEST_CASE("checks if a type is trivially relocatable")
+{
+    CHECK(is_trivially_relocatable_v<int>);
+    CHECK(is_trivially_relocatable_v<const int>);
+    CHECK(is_trivially_relocatable_v<int *>);
+    CHECK(is_trivially_relocatable_v<test_struct>);
+    CHECK(is_trivially_relocatable_v<test_struct[4]>);
+    CHECK(!is_trivially_relocatable_v<test_base_class>);
+    CHECK(!is_trivially_relocatable_v<test_class&>);
+
+    CHECK(!is_trivially_copyable_v<test_relocatable_owner>);
+    CHECK(is_trivially_relocatable_v<test_relocatable_owner>);
+    CHECK(is_trivially_relocatable_v<const test_relocatable_owner>);
+    CHECK(is_trivially_relocatable_v<test_relocatable_owner[2]>);
+}
+
 TEST_SUITE_END  ();
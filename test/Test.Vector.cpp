@@ -0,0 +1,318 @@
+/*++
+
+Copyright (c) 2024.  D.Stars <d.stars@163.com>
+All rights reserved.
+
+Module Name:
+    Test.Vector.cpp
+
+Abstract:
+    Test Vector.
+
+--*/
+
+#include "doctest.h"
+
+#include "DSTL.hpp"
+using namespace dstl;
+
+#include <vector>
+
+TEST_SUITE_BEGIN("Vector");
+
+struct test_pod
+{
+    int key_;
+    double value_;
+};
+
+// counts live instances to check that every constructed element gets destroyed
+struct test_tracked
+{
+    static inline int live_ = 0;
+
+    int value_ = 0;
+
+    test_tracked () { ++live_; }
+    explicit test_tracked (int value) : value_(value) { ++live_; }
+    test_tracked (const test_tracked &other) : value_(other.value_) { ++live_; }
+    test_tracked (test_tracked &&other) noexcept : value_(other.value_) { other.value_ = -1; ++live_; }
+    ~test_tracked () { --live_; }
+
+    test_tracked &operator= (const test_tracked &) = default;
+    test_tracked &operator= (test_tracked &&) noexcept = default;
+
+    bool operator== (const test_tracked &other) const { return value_ == other.value_; }
+};
+
+// copyable with a move constructor that may throw, and a copy constructor that throws on request
+struct test_throwing_move
+{
+    static inline int copies_left_ = -1;
+
+    int value_ = 0;
+
+    explicit test_throwing_move (int value) : value_(value) {}
+    test_throwing_move (const test_throwing_move &other) : value_(other.value_)
+    {
+        if (copies_left_ == 0)
+            throw std::runtime_error("copy");
+        if (copies_left_ > 0)
+            --copies_left_;
+    }
+    test_throwing_move (test_throwing_move &&other) : value_(other.value_) { other.value_ = -1; }
+
+    test_throwing_move &operator= (const test_throwing_move &) = default;
+
+    explicit operator int () const { return value_; }
+};
+
+template<class V>
+static bool test_values_are (const V &v, std::initializer_list<int> expected)
+{
+    if (v.size() != expected.size())
+        return false;
+    auto it = expected.begin();
+    for (const auto &e : v)
+    {
+        if (static_cast<int>(e) != *it++)
+            return false;
+    }
+    return true;
+}
+
+TEST_CASE("selects the relocation path from the element type traits")
+{
+    CHECK(is_trivially_copyable_v<test_pod>);
+    CHECK(is_trivially_destructible_v<test_pod>);
+    CHECK(!is_trivially_copyable_v<test_tracked>);
+    CHECK(!is_trivially_destructible_v<test_tracked>);
+}
+
+TEST_CASE("constructs, copies and moves a vector")
+{
+    vector<int> empty;
+    CHECK(empty.empty());
+    CHECK(empty.size() == 0);
+    CHECK(empty.data() == nullptr);
+
+    vector<int> filled(3, 7);
+    CHECK(test_values_are(filled, {7, 7, 7}));
+
+    vector<int> init{1, 2, 3, 4};
+    CHECK(test_values_are(init, {1, 2, 3, 4}));
+
+    vector<int> copied(init);
+    CHECK(copied == init);
+    CHECK(copied.data() != init.data());
+
+    vector<int> moved(std::move(copied));
+    CHECK(moved == init);
+    CHECK(copied.empty());
+
+    vector<int> assigned;
+    assigned = init;
+    CHECK(assigned == init);
+    assigned = {9, 8};
+    CHECK(test_values_are(assigned, {9, 8}));
+
+    vector<int> sized(5);
+    CHECK(test_values_are(sized, {0, 0, 0, 0, 0}));
+}
+
+TEST_CASE("grows a vector of trivially copyable elements")
+{
+    vector<test_pod> v;
+    for (int i = 0; i < 1000; ++i)
+        v.push_back({i, i * 0.5});
+
+    CHECK(v.size() == 1000);
+    CHECK(v.capacity() >= 1000);
+    bool ok = true;
+    for (int i = 0; i < 1000; ++i)
+        ok = ok && v[i].key_ == i && v[i].value_ == i * 0.5;
+    CHECK(ok);
+
+    v.shrink_to_fit();
+    CHECK(v.capacity() == 1000);
+}
+
+TEST_CASE("grows a vector of vectors by relocating the inner ones")
+{
+    CHECK(is_trivially_relocatable_v<vector<int>>);
+    CHECK(is_trivially_relocatable_v<vector<test_tracked>>);
+
+    vector<vector<int>> nested;
+    std::vector<const int *> buffers;
+    for (int i = 0; i < 300; ++i)
+    {
+        nested.push_back({i, i + 1, i + 2});
+        buffers.push_back(nested.back().data());
+    }
+    nested.insert(nested.begin(), vector<int>{-1});
+    nested.erase(nested.begin() + 100);
+    buffers.erase(buffers.begin() + 99);
+
+    CHECK(nested.size() == 300);
+    CHECK(test_values_are(nested[0], {-1}));
+    bool kept = true;
+    for (size_t i = 1; i < nested.size(); ++i)
+    {
+        const int first = static_cast<int>(i < 100 ? i - 1 : i);
+        kept = kept && nested[i].data() == buffers[i - 1] && test_values_are(nested[i], {first, first + 1, first + 2});
+    }
+    CHECK(kept);
+
+    test_tracked::live_ = 0;
+    {
+        vector<vector<test_tracked>> tracked;
+        for (int i = 0; i < 50; ++i)
+            tracked.emplace_back(3, test_tracked(i));
+        CHECK(test_tracked::live_ == 150);
+    }
+    CHECK(test_tracked::live_ == 0);
+}
+
+TEST_CASE("resizes within the capacity without reallocating")
+{
+    vector<int> v;
+    v.reserve(16);
+    const int *data = v.data();
+    v.resize(4);
+    v.resize(16);
+    CHECK(v.capacity() == 16);
+    CHECK(v.data() == data);
+
+    // past the capacity it grows geometrically
+    v.resize(17);
+    CHECK(v.capacity() == 32);
+    CHECK(v.size() == 17);
+    CHECK(v[16] == 0);
+}
+
+TEST_CASE("keeps the capacity within what an object may hold")
+{
+    constexpr size_t max_bytes = static_cast<size_t>(std::numeric_limits<ptrdiff_t>::max());
+    CHECK(vector<int>::max_size() == max_bytes / sizeof(int));
+    CHECK(vector<test_pod>::max_size() == max_bytes / sizeof(test_pod));
+
+    // growth doubles the capacity until that would pass max_size, then stops at it
+    constexpr size_t max = vector<test_pod>::max_size();
+    CHECK(detail::recommend_capacity(8, 9, max) == 16);
+    CHECK(detail::recommend_capacity(8, 20, max) == 20);
+    CHECK(detail::recommend_capacity(max / 2 - 1, max / 2, max) == max - 3);
+    CHECK(detail::recommend_capacity(max / 2, max / 2 + 1, max) == max);
+    CHECK(detail::recommend_capacity(max - 1, max, max) == max);
+    CHECK(detail::recommend_capacity(max / 2, max / 2 + 1, max) * sizeof(test_pod) <= max_bytes);
+
+    vector<test_pod> v;
+    CHECK_THROWS_AS(v.reserve(max + 1), std::length_error);
+    CHECK(v.capacity() == 0);
+}
+
+TEST_CASE("keeps its elements when growth throws")
+{
+    vector<test_throwing_move> v;
+    v.reserve(4);
+    for (int i = 0; i < 4; ++i)
+        v.emplace_back(i);
+    const test_throwing_move *data = v.data();
+
+    // the slot of the new element is copied first, then the old elements, the third copy throws
+    const test_throwing_move extra(9);
+    test_throwing_move::copies_left_ = 2;
+    CHECK_THROWS_AS(v.push_back(extra), std::runtime_error);
+    CHECK(v.data() == data);
+    CHECK(v.capacity() == 4);
+    CHECK(test_values_are(v, {0, 1, 2, 3}));
+
+    test_throwing_move::copies_left_ = 1;
+    CHECK_THROWS_AS(v.reserve(100), std::runtime_error);
+    CHECK(test_values_are(v, {0, 1, 2, 3}));
+    CHECK_THROWS_AS(v.insert(v.begin() + 1, extra), std::runtime_error);
+    CHECK(test_values_are(v, {0, 1, 2, 3}));
+
+    test_throwing_move::copies_left_ = -1;
+    v.push_back(extra);
+    v.insert(v.begin(), extra);
+    CHECK(test_values_are(v, {9, 0, 1, 2, 3, 9}));
+}
+
+TEST_CASE("inserts and erases elements of trivially copyable type")
+{
+    vector<int> v{1, 2, 3};
+    v.insert(v.begin(), 0);
+    CHECK(test_values_are(v, {0, 1, 2, 3}));
+
+    v.insert(v.begin() + 2, 2, 9);
+    CHECK(test_values_are(v, {0, 1, 9, 9, 2, 3}));
+
+    const int tail[] = {7, 8};
+    v.insert(v.end(), tail, tail + 2);
+    CHECK(test_values_are(v, {0, 1, 9, 9, 2, 3, 7, 8}));
+
+    // the inserted value refers to an element that gets shifted
+    v.reserve(64);
+    v.insert(v.begin(), v[7]);
+    CHECK(test_values_are(v, {8, 0, 1, 9, 9, 2, 3, 7, 8}));
+
+    v.erase(v.begin() + 3, v.begin() + 5);
+    CHECK(test_values_are(v, {8, 0, 1, 2, 3, 7, 8}));
+
+    v.erase(v.begin());
+    CHECK(test_values_are(v, {0, 1, 2, 3, 7, 8}));
+
+    v.pop_back();
+    v.resize(3);
+    CHECK(test_values_are(v, {0, 1, 2}));
+    v.resize(5, 4);
+    CHECK(test_values_are(v, {0, 1, 2, 4, 4}));
+
+    CHECK_THROWS_AS(v.at(5), std::out_of_range);
+}
+
+TEST_CASE("inserts and erases elements of non-trivial type")
+{
+    test_tracked::live_ = 0;
+    {
+        vector<test_tracked> v;
+        for (int i = 0; i < 100; ++i)
+            v.emplace_back(i);
+        CHECK(test_tracked::live_ == 100);
+
+        v.emplace(v.begin(), -5);
+        CHECK(v.front().value_ == -5);
+        CHECK(v[1].value_ == 0);
+        CHECK(v.size() == 101);
+
+        v.insert(v.begin() + 1, 3, test_tracked(42));
+        CHECK(v[1].value_ == 42);
+        CHECK(v[3].value_ == 42);
+        CHECK(v[4].value_ == 0);
+
+        v.erase(v.begin(), v.begin() + 4);
+        CHECK(v.front().value_ == 0);
+        CHECK(v.back().value_ == 99);
+        CHECK(test_tracked::live_ == 100);
+
+        v.resize(10);
+        CHECK(test_tracked::live_ == 10);
+
+        v.clear();
+        CHECK(test_tracked::live_ == 0);
+        v.resize(4);
+        CHECK(test_tracked::live_ == 4);
+    }
+    CHECK(test_tracked::live_ == 0);
+}
+
+TEST_CASE("swaps two vectors")
+{
+    vector<int> a{1, 2};
+    vector<int> b{3};
+    swap(a, b);
+    CHECK(test_values_are(a, {3}));
+    CHECK(test_values_are(b, {1, 2}));
+}
+
+TEST_SUITE_END();